@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using EpicGames.Core;
+using UnrealBuildTool;
+
+public class NullDrv : ModuleRules
+{
+	public NullDrv(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PrivateDependencyModuleNames.AddAll(
+			"RHICore",
+			"RenderCore"
+		);
+
+		PublicDependencyModuleNames.AddAll(
+			"Core",
+			"RHI"
+		);
+	}
+}
@@ -0,0 +1,624 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NullRHIPrivate.h"
+#include "HAL/IConsoleManager.h"
+#include "Modules/ModuleManager.h"
+#include "RenderResource.h"
+#include "RHICommandList.h"
+#include "RHICoreBufferInitializer.h"
+#include "RHICoreInitializerCommon.h"
+#include "RHICoreTextureInitializer.h"
+#include "RHIResourceReplace.h"
+#include "RHIStrings.h"
+#include "RHITextureUtils.h"
+#include "ShaderParameterStruct.h"
+#include <atomic>
+
+IMPLEMENT_MODULE(FNullDynamicRHIModule, NullDrv);
+
+FDynamicRHI* FNullDynamicRHIModule::CreateRHI(ERHIFeatureLevel::Type RequestedFeatureLevel)
+{
+	return new FNullDynamicRHI();
+}
+
+//
+// Stats
+//
+
+namespace UE::NullRHI
+{
+	struct FStatCounters
+	{
+		std::atomic<uint64> NumCommands[(int32)ENullRHICommand::Num] = {};
+		std::atomic<uint64> NumResourcesCreated[RRT_Num] = {};
+		std::atomic<uint64> BufferBytesCreated { 0 };
+		std::atomic<uint64> TextureBytesCreated { 0 };
+		std::atomic<uint64> NumContexts { 0 };
+		std::atomic<uint64> NumCommandListsSubmitted { 0 };
+		std::atomic<uint64> NumSubmits { 0 };
+		std::atomic<uint64> NumFrames { 0 };
+		std::atomic<uint64> TranslateCycles { 0 };
+		std::atomic<uint64> SubmitCycles { 0 };
+	};
+
+	static FStatCounters GStats;
+
+	void RecordResourceCreated(ERHIResourceType Type, uint64 SizeInBytes)
+	{
+		GStats.NumResourcesCreated[Type].fetch_add(1, std::memory_order_relaxed);
+
+		if (Type == RRT_Buffer)
+		{
+			GStats.BufferBytesCreated.fetch_add(SizeInBytes, std::memory_order_relaxed);
+		}
+		else if (SizeInBytes)
+		{
+			GStats.TextureBytesCreated.fetch_add(SizeInBytes, std::memory_order_relaxed);
+		}
+	}
+
+	void RecordContextObtained()
+	{
+		GStats.NumContexts.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void RecordSubmit(const FNullCommandCounters& Counters, int32 NumCommandLists, uint64 SubmitCycles)
+	{
+		for (int32 Index = 0; Index < (int32)ENullRHICommand::Num; ++Index)
+		{
+			if (Counters.NumCommands[Index])
+			{
+				GStats.NumCommands[Index].fetch_add(Counters.NumCommands[Index], std::memory_order_relaxed);
+			}
+		}
+
+		GStats.TranslateCycles.fetch_add(Counters.TranslateCycles, std::memory_order_relaxed);
+		GStats.SubmitCycles.fetch_add(SubmitCycles, std::memory_order_relaxed);
+		GStats.NumCommandListsSubmitted.fetch_add(NumCommandLists, std::memory_order_relaxed);
+		GStats.NumSubmits.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void RecordFrame()
+	{
+		GStats.NumFrames.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static void DumpStats()
+	{
+		const FNullRHIStats Stats = GetNullRHIStats();
+
+		UE_LOG(LogRHI, Display, TEXT("Null RHI stats (%llu frames):"), Stats.NumFrames);
+		UE_LOG(LogRHI, Display, TEXT("  Contexts: %llu, command lists submitted: %llu in %llu submits"), Stats.NumContexts, Stats.NumCommandListsSubmitted, Stats.NumSubmits);
+		UE_LOG(LogRHI, Display, TEXT("  Translate: %.3f ms, submit: %.3f ms"), FPlatformTime::ToMilliseconds64(Stats.TranslateCycles), FPlatformTime::ToMilliseconds64(Stats.SubmitCycles));
+		UE_LOG(LogRHI, Display, TEXT("  Commands: %llu"), Stats.GetTotalCommands());
+
+		for (int32 Index = 0; Index < (int32)ENullRHICommand::Num; ++Index)
+		{
+			if (Stats.NumCommands[Index])
+			{
+				UE_LOG(LogRHI, Display, TEXT("    %-24s %llu"), GetNullRHICommandName((ENullRHICommand)Index), Stats.NumCommands[Index]);
+			}
+		}
+
+		UE_LOG(LogRHI, Display, TEXT("  Resources created (buffers: %.2f MB, textures: %.2f MB):"), Stats.BufferBytesCreated / (1024.0 * 1024.0), Stats.TextureBytesCreated / (1024.0 * 1024.0));
+
+		for (int32 Index = 0; Index < RRT_Num; ++Index)
+		{
+			if (Stats.NumResourcesCreated[Index])
+			{
+				UE_LOG(LogRHI, Display, TEXT("    %-24s %llu"), StringFromRHIResourceType((ERHIResourceType)Index), Stats.NumResourcesCreated[Index]);
+			}
+		}
+	}
+
+	static FAutoConsoleCommand CmdDumpStats(
+		TEXT("r.NullRHI.DumpStats"),
+		TEXT("Logs the command counts, translate/submit timings and resource creation counts recorded by the null RHI."),
+		FConsoleCommandDelegate::CreateStatic(&DumpStats));
+
+	static FAutoConsoleCommand CmdResetStats(
+		TEXT("r.NullRHI.ResetStats"),
+		TEXT("Clears the stats recorded by the null RHI."),
+		FConsoleCommandDelegate::CreateStatic(&ResetNullRHIStats));
+}
+
+const TCHAR* GetNullRHICommandName(ENullRHICommand Command)
+{
+	switch (Command)
+	{
+	case ENullRHICommand::SetComputePipelineState:  return TEXT("SetComputePipelineState");
+	case ENullRHICommand::SetGraphicsPipelineState: return TEXT("SetGraphicsPipelineState");
+	case ENullRHICommand::SetShaderParameters:      return TEXT("SetShaderParameters");
+	case ENullRHICommand::SetStaticUniformBuffers:  return TEXT("SetStaticUniformBuffers");
+	case ENullRHICommand::SetRasterState:           return TEXT("SetRasterState");
+	case ENullRHICommand::Dispatch:                 return TEXT("Dispatch");
+	case ENullRHICommand::DispatchIndirect:         return TEXT("DispatchIndirect");
+	case ENullRHICommand::Draw:                     return TEXT("Draw");
+	case ENullRHICommand::DrawIndexed:              return TEXT("DrawIndexed");
+	case ENullRHICommand::DrawIndirect:             return TEXT("DrawIndirect");
+	case ENullRHICommand::Transition:               return TEXT("Transition");
+	case ENullRHICommand::ClearUAV:                 return TEXT("ClearUAV");
+	case ENullRHICommand::BeginRenderPass:          return TEXT("BeginRenderPass");
+	case ENullRHICommand::EndRenderPass:            return TEXT("EndRenderPass");
+	case ENullRHICommand::Copy:                     return TEXT("Copy");
+	case ENullRHICommand::RenderQuery:              return TEXT("RenderQuery");
+	case ENullRHICommand::Breadcrumb:               return TEXT("Breadcrumb");
+	default:                                        return TEXT("Unknown");
+	}
+}
+
+FNullRHIStats GetNullRHIStats()
+{
+	using namespace UE::NullRHI;
+
+	FNullRHIStats Stats;
+	for (int32 Index = 0; Index < (int32)ENullRHICommand::Num; ++Index)
+	{
+		Stats.NumCommands[Index] = GStats.NumCommands[Index].load(std::memory_order_relaxed);
+	}
+	for (int32 Index = 0; Index < RRT_Num; ++Index)
+	{
+		Stats.NumResourcesCreated[Index] = GStats.NumResourcesCreated[Index].load(std::memory_order_relaxed);
+	}
+	Stats.BufferBytesCreated       = GStats.BufferBytesCreated.load(std::memory_order_relaxed);
+	Stats.TextureBytesCreated      = GStats.TextureBytesCreated.load(std::memory_order_relaxed);
+	Stats.NumContexts              = GStats.NumContexts.load(std::memory_order_relaxed);
+	Stats.NumCommandListsSubmitted = GStats.NumCommandListsSubmitted.load(std::memory_order_relaxed);
+	Stats.NumSubmits               = GStats.NumSubmits.load(std::memory_order_relaxed);
+	Stats.NumFrames                = GStats.NumFrames.load(std::memory_order_relaxed);
+	Stats.TranslateCycles          = GStats.TranslateCycles.load(std::memory_order_relaxed);
+	Stats.SubmitCycles             = GStats.SubmitCycles.load(std::memory_order_relaxed);
+	return Stats;
+}
+
+void ResetNullRHIStats()
+{
+	using namespace UE::NullRHI;
+
+	for (std::atomic<uint64>& Counter : GStats.NumCommands)
+	{
+		Counter.store(0, std::memory_order_relaxed);
+	}
+	for (std::atomic<uint64>& Counter : GStats.NumResourcesCreated)
+	{
+		Counter.store(0, std::memory_order_relaxed);
+	}
+	GStats.BufferBytesCreated.store(0, std::memory_order_relaxed);
+	GStats.TextureBytesCreated.store(0, std::memory_order_relaxed);
+	GStats.NumContexts.store(0, std::memory_order_relaxed);
+	GStats.NumCommandListsSubmitted.store(0, std::memory_order_relaxed);
+	GStats.NumSubmits.store(0, std::memory_order_relaxed);
+	GStats.NumFrames.store(0, std::memory_order_relaxed);
+	GStats.TranslateCycles.store(0, std::memory_order_relaxed);
+	GStats.SubmitCycles.store(0, std::memory_order_relaxed);
+}
+
+//
+// Resources
+//
+
+uint8* FNullTexture::GetData()
+{
+	void* Result = Data.load(std::memory_order_acquire);
+	if (!Result)
+	{
+		const uint64 Size = UE::RHITextureUtils::CalculateTextureSize(GetDesc());
+		Result = UE::NullRHI::AllocateHostCopy(Data, FMath::Max<uint64>(Size, 1));
+	}
+	return (uint8*)Result;
+}
+
+FNullUniformBuffer::FNullUniformBuffer(const FRHIUniformBufferLayout* InLayout, const void* Contents)
+	: FRHIUniformBuffer(InLayout)
+{
+	ConstantData.SetNumZeroed(InLayout->ConstantBufferSize);
+	ResourceTable.SetNum(InLayout->Resources.Num());
+
+	if (Contents)
+	{
+		Update(Contents);
+	}
+}
+
+void FNullUniformBuffer::Update(const void* Contents)
+{
+	const FRHIUniformBufferLayout& Layout = GetLayout();
+
+	if (ConstantData.Num())
+	{
+		FMemory::Memcpy(ConstantData.GetData(), Contents, ConstantData.Num());
+	}
+
+	for (int32 Index = 0; Index < Layout.Resources.Num(); ++Index)
+	{
+		const FRHIUniformBufferResource& Parameter = Layout.Resources[Index];
+		ResourceTable[Index] = GetShaderParameterResourceRHI(Contents, Parameter.MemberOffset, Parameter.MemberType);
+	}
+}
+
+void FNullViewport::Resize(uint32 InSizeX, uint32 InSizeY, EPixelFormat InPixelFormat)
+{
+	const FRHITextureCreateDesc Desc =
+		FRHITextureCreateDesc::Create2D(TEXT("NullBackBuffer"), InSizeX, InSizeY, InPixelFormat == PF_Unknown ? PF_B8G8R8A8 : InPixelFormat)
+		.SetFlags(ETextureCreateFlags::RenderTargetable | ETextureCreateFlags::ShaderResource | ETextureCreateFlags::Presentable)
+		.SetInitialState(ERHIAccess::Present);
+
+	BackBuffer = new FNullTexture(Desc);
+}
+
+class FNullRenderQuery : public FRHIRenderQuery
+{
+public:
+	FNullRenderQuery(ERenderQueryType InQueryType)
+		: QueryType(InQueryType)
+	{
+	}
+
+	const ERenderQueryType QueryType;
+};
+
+//
+// Dynamic RHI
+//
+
+FNullDynamicRHI::FNullDynamicRHI()
+	: DefaultContext(ERHIPipeline::Graphics, true)
+{
+	GMaxRHIFeatureLevel = ERHIFeatureLevel::SM5;
+	GMaxRHIShaderPlatform = SP_PCD3D_SM5;
+
+	// Contexts are pooled under a lock, so parallel translation works and is worth measuring.
+	GRHISupportsRHIThread = true;
+	GRHISupportsParallelRHIExecute = true;
+	GRHISupportsAsyncTextureCreation = false;
+	GSupportsParallelOcclusionQueries = true;
+}
+
+FNullDynamicRHI::~FNullDynamicRHI()
+{
+	for (TArray<FNullCommandContext*>& Pool : ContextPool)
+	{
+		for (FNullCommandContext* Context : Pool)
+		{
+			delete Context;
+		}
+		Pool.Reset();
+	}
+}
+
+void FNullDynamicRHI::Init()
+{
+	UE_LOG(LogRHI, Log, TEXT("Using the null RHI. No GPU work will be performed; use r.NullRHI.DumpStats to inspect the recorded commands."));
+
+	DefaultContext.Begin();
+
+	FRenderResource::InitPreRHIResources();
+	GIsRHIInitialized = true;
+}
+
+void FNullDynamicRHI::Shutdown()
+{
+	GIsRHIInitialized = false;
+}
+
+void FNullDynamicRHI::RHIEndFrame(const FRHIEndFrameArgs& Args)
+{
+	UE::NullRHI::RecordFrame();
+}
+
+FSamplerStateRHIRef FNullDynamicRHI::RHICreateSamplerState(const FSamplerStateInitializerRHI& Initializer)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_SamplerState);
+	return new FRHISamplerState();
+}
+
+FRasterizerStateRHIRef FNullDynamicRHI::RHICreateRasterizerState(const FRasterizerStateInitializerRHI& Initializer)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_RasterizerState);
+	return new FRHIRasterizerState();
+}
+
+FDepthStencilStateRHIRef FNullDynamicRHI::RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI& Initializer)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_DepthStencilState);
+	return new FRHIDepthStencilState();
+}
+
+FBlendStateRHIRef FNullDynamicRHI::RHICreateBlendState(const FBlendStateInitializerRHI& Initializer)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_BlendState);
+	return new FRHIBlendState();
+}
+
+FVertexDeclarationRHIRef FNullDynamicRHI::RHICreateVertexDeclaration(const FVertexDeclarationElementList& Elements)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_VertexDeclaration);
+	return new FRHIVertexDeclaration();
+}
+
+template <typename TShaderType>
+static TShaderType* CreateNullShader(const FSHAHash& Hash)
+{
+	TShaderType* Shader = new TShaderType();
+	Shader->SetHash(Hash);
+	UE::NullRHI::RecordResourceCreated(Shader->GetType());
+	return Shader;
+}
+
+FPixelShaderRHIRef FNullDynamicRHI::RHICreatePixelShader(TArrayView<const uint8> Code, const FSHAHash& Hash)
+{
+	return CreateNullShader<FRHIPixelShader>(Hash);
+}
+
+FVertexShaderRHIRef FNullDynamicRHI::RHICreateVertexShader(TArrayView<const uint8> Code, const FSHAHash& Hash)
+{
+	return CreateNullShader<FRHIVertexShader>(Hash);
+}
+
+FGeometryShaderRHIRef FNullDynamicRHI::RHICreateGeometryShader(TArrayView<const uint8> Code, const FSHAHash& Hash)
+{
+	return CreateNullShader<FRHIGeometryShader>(Hash);
+}
+
+FComputeShaderRHIRef FNullDynamicRHI::RHICreateComputeShader(TArrayView<const uint8> Code, const FSHAHash& Hash)
+{
+	return CreateNullShader<FRHIComputeShader>(Hash);
+}
+
+FGPUFenceRHIRef FNullDynamicRHI::RHICreateGPUFence(const FName& Name)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_GPUFence);
+	return new FNullGPUFence(Name);
+}
+
+FBoundShaderStateRHIRef FNullDynamicRHI::RHICreateBoundShaderState(FRHIVertexDeclaration* VertexDeclaration, FRHIVertexShader* VertexShader, FRHIPixelShader* PixelShader, FRHIGeometryShader* GeometryShader)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_BoundShaderState);
+	return new FRHIBoundShaderState();
+}
+
+FBoundShaderStateRHIRef FNullDynamicRHI::RHICreateBoundShaderState(FRHIAmplificationShader* AmplificationShader, FRHIMeshShader* MeshShader, FRHIPixelShader* PixelShader)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_BoundShaderState);
+	return new FRHIBoundShaderState();
+}
+
+FGraphicsPipelineStateRHIRef FNullDynamicRHI::RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializer& Initializer)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_GraphicsPipelineState);
+	return FDynamicRHIPSOFallback::RHICreateGraphicsPipelineState(Initializer);
+}
+
+FComputePipelineStateRHIRef FNullDynamicRHI::RHICreateComputePipelineState(const FComputePipelineStateInitializer& Initializer)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_ComputePipelineState);
+	return FDynamicRHIPSOFallback::RHICreateComputePipelineState(Initializer);
+}
+
+FUniformBufferRHIRef FNullDynamicRHI::RHICreateUniformBuffer(const void* Contents, const FRHIUniformBufferLayout* Layout, EUniformBufferUsage Usage, EUniformBufferValidation Validation)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_UniformBuffer);
+	return new FNullUniformBuffer(Layout, Contents);
+}
+
+void FNullDynamicRHI::RHIUpdateUniformBuffer(FRHICommandListBase& RHICmdList, FRHIUniformBuffer* UniformBufferRHI, const void* Contents)
+{
+	FNullUniformBuffer* UniformBuffer = static_cast<FNullUniformBuffer*>(UniformBufferRHI);
+
+	if (RHICmdList.Bypass())
+	{
+		UniformBuffer->Update(Contents);
+		return;
+	}
+
+	// Snapshot the contents now, the update itself happens in command list order like on a real RHI.
+	const uint32 NumBytes = UniformBuffer->GetSize();
+	void* CmdListContents = RHICmdList.Alloc(NumBytes, SHADER_PARAMETER_STRUCT_ALIGNMENT);
+	FMemory::Memcpy(CmdListContents, Contents, NumBytes);
+
+	RHICmdList.EnqueueLambda(TEXT("FNullDynamicRHI::RHIUpdateUniformBuffer"), [UniformBuffer, CmdListContents](FRHICommandListBase&)
+	{
+		UniformBuffer->Update(CmdListContents);
+	});
+}
+
+void FNullDynamicRHI::RHIReplaceResources(FRHICommandListBase& RHICmdList, TArray<FRHIResourceReplaceInfo>&& ReplaceInfos)
+{
+	RHICmdList.EnqueueLambda(TEXT("FNullDynamicRHI::RHIReplaceResources"), [ReplaceInfos = MoveTemp(ReplaceInfos)](FRHICommandListBase&)
+	{
+		for (FRHIResourceReplaceInfo const& Info : ReplaceInfos)
+		{
+			if (Info.GetType() != FRHIResourceReplaceInfo::EType::Buffer)
+			{
+				continue;
+			}
+
+			FNullBuffer* Dst = static_cast<FNullBuffer*>(Info.GetBuffer().Dst);
+			FNullBuffer* Src = static_cast<FNullBuffer*>(Info.GetBuffer().Src);
+
+			if (Src)
+			{
+				Dst->TakeOwnership(*Src);
+			}
+			else
+			{
+				Dst->ReleaseOwnership();
+			}
+		}
+	});
+}
+
+FRHIBufferInitializer FNullDynamicRHI::RHICreateBufferInitializer(FRHICommandListBase& RHICmdList, const FRHIBufferCreateDesc& CreateDesc)
+{
+	FNullBuffer* Buffer = new FNullBuffer(CreateDesc);
+	UE::NullRHI::RecordResourceCreated(RRT_Buffer, CreateDesc.Size);
+
+	if (CreateDesc.IsNull() || CreateDesc.InitAction == ERHIBufferInitAction::Default)
+	{
+		return UE::RHICore::FDefaultBufferInitializer(RHICmdList, Buffer);
+	}
+
+	// Only buffers that are given initial contents get host memory up front; everything else allocates on first lock.
+	return UE::RHICore::CreateUnifiedMemoryBufferInitializer(RHICmdList, CreateDesc, Buffer, Buffer->GetData());
+}
+
+void* FNullDynamicRHI::LockBuffer_BottomOfPipe(FRHICommandListBase& RHICmdList, FRHIBuffer* BufferRHI, uint32 Offset, uint32 SizeRHI, EResourceLockMode LockMode)
+{
+	FNullBuffer* Buffer = static_cast<FNullBuffer*>(BufferRHI);
+	check(Offset + SizeRHI <= Buffer->GetSize());
+	return (uint8*)Buffer->GetData() + Offset;
+}
+
+FRHICalcTextureSizeResult FNullDynamicRHI::RHICalcTexturePlatformSize(FRHITextureDesc const& Desc, uint32 FirstMipIndex)
+{
+	FRHICalcTextureSizeResult Result;
+	Result.Size = Desc.CalcMemorySizeEstimate(FirstMipIndex);
+	Result.Align = 16;
+	return Result;
+}
+
+void FNullDynamicRHI::RHIGetTextureMemoryStats(FTextureMemoryStats& OutStats)
+{
+	// No video memory to report.
+}
+
+FRHITextureInitializer FNullDynamicRHI::RHICreateTextureInitializer(FRHICommandListBase& RHICmdList, const FRHITextureCreateDesc& CreateDesc)
+{
+	FNullTexture* Texture = new FNullTexture(CreateDesc);
+	UE::NullRHI::RecordResourceCreated(Texture->GetType(), CreateDesc.CalcMemorySizeEstimate());
+
+	if (CreateDesc.InitAction == ERHITextureInitAction::BulkData)
+	{
+		check(CreateDesc.BulkData);
+		CreateDesc.BulkData->Discard();
+	}
+	else if (CreateDesc.InitAction == ERHITextureInitAction::Initializer)
+	{
+		// Let the caller write into the texture's host copy, which uses the default subresource layout.
+		return UE::RHICore::FDefaultLayoutTextureInitializer(RHICmdList, Texture, Texture->GetData(), UE::RHITextureUtils::CalculateTextureSize(CreateDesc),
+			[Texture = TRefCountPtr<FRHITexture>(Texture)](FRHICommandListBase&) mutable
+			{
+				return MoveTemp(Texture);
+			});
+	}
+
+	return UE::RHICore::FDefaultTextureInitializer(RHICmdList, Texture);
+}
+
+FTextureRHIRef FNullDynamicRHI::RHIAsyncCreateTexture2D(uint32 SizeX, uint32 SizeY, uint8 Format, uint32 NumMips, ETextureCreateFlags Flags, ERHIAccess InResourceState, void** InitialMipData, uint32 NumInitialMips, const TCHAR* DebugName, FGraphEventRef& OutCompletionEvent)
+{
+	const FRHITextureCreateDesc Desc =
+		FRHITextureCreateDesc::Create2D(DebugName, SizeX, SizeY, (EPixelFormat)Format)
+		.SetNumMips(NumMips)
+		.SetFlags(Flags)
+		.SetInitialState(InResourceState);
+
+	UE::NullRHI::RecordResourceCreated(RRT_Texture2D, Desc.CalcMemorySizeEstimate());
+
+	OutCompletionEvent = nullptr;
+	return new FNullTexture(Desc);
+}
+
+FShaderResourceViewRHIRef FNullDynamicRHI::RHICreateShaderResourceView(FRHICommandListBase& RHICmdList, FRHIViewableResource* Resource, FRHIViewDesc const& ViewDesc)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_ShaderResourceView);
+	return new FRHIShaderResourceView(Resource, ViewDesc);
+}
+
+FUnorderedAccessViewRHIRef FNullDynamicRHI::RHICreateUnorderedAccessView(FRHICommandListBase& RHICmdList, FRHIViewableResource* Resource, FRHIViewDesc const& ViewDesc)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_UnorderedAccessView);
+	return new FRHIUnorderedAccessView(Resource, ViewDesc);
+}
+
+uint32 FNullDynamicRHI::RHIComputeMemorySize(FRHITexture* TextureRHI)
+{
+	return TextureRHI ? (uint32)TextureRHI->GetDesc().CalcMemorySizeEstimate() : 0;
+}
+
+FTextureRHIRef FNullDynamicRHI::RHIAsyncReallocateTexture2D(FRHITexture* Texture2D, int32 NewMipCount, int32 NewSizeX, int32 NewSizeY, FThreadSafeCounter* RequestStatus)
+{
+	FRHITextureCreateDesc Desc(Texture2D->GetDesc(), RHIGetDefaultResourceState(Texture2D->GetDesc().Flags, false), TEXT("NullReallocatedTexture"));
+	Desc.Extent = FIntPoint(NewSizeX, NewSizeY);
+	Desc.NumMips = NewMipCount;
+
+	UE::NullRHI::RecordResourceCreated(RRT_Texture2D, Desc.CalcMemorySizeEstimate());
+
+	if (RequestStatus)
+	{
+		RequestStatus->Decrement();
+	}
+
+	return new FNullTexture(Desc);
+}
+
+FRHILockTextureResult FNullDynamicRHI::RHILockTexture(FRHICommandListImmediate& RHICmdList, const FRHILockTextureArgs& Arguments)
+{
+	FNullTexture* Texture = static_cast<FNullTexture*>(Arguments.Texture);
+
+	uint64 Stride = 0;
+	uint64 Size = 0;
+	const uint64 Offset = UE::RHITextureUtils::CalculateSubresourceOffset(Texture->GetDesc(), Arguments.FaceIndex, Arguments.ArrayIndex, Arguments.MipIndex, Stride, Size);
+
+	FRHILockTextureResult Result;
+	Result.Data = Texture->GetData() + Offset;
+	Result.ByteCount = Size;
+	Result.Stride = (uint32)Stride;
+	return Result;
+}
+
+void FNullDynamicRHI::RHIReadSurfaceData(FRHITexture* Texture, FIntRect Rect, TArray<FColor>& OutData, FReadSurfaceDataFlags InFlags)
+{
+	OutData.SetNumZeroed(Rect.Width() * Rect.Height());
+}
+
+void FNullDynamicRHI::RHIMapStagingSurface(FRHITexture* TextureRHI, FRHIGPUFence* Fence, void*& OutData, int32& OutWidth, int32& OutHeight, uint32 GPUIndex)
+{
+	FNullTexture* Texture = static_cast<FNullTexture*>(TextureRHI);
+
+	OutData = Texture->GetData();
+	OutWidth = Texture->GetDesc().Extent.X;
+	OutHeight = Texture->GetDesc().Extent.Y;
+}
+
+void FNullDynamicRHI::RHIReadSurfaceFloatData(FRHITexture* Texture, FIntRect Rect, TArray<FFloat16Color>& OutData, ECubeFace CubeFace, int32 ArrayIndex, int32 MipIndex)
+{
+	OutData.SetNumZeroed(Rect.Width() * Rect.Height());
+}
+
+void FNullDynamicRHI::RHIRead3DSurfaceFloatData(FRHITexture* Texture, FIntRect Rect, FIntPoint ZMinMax, TArray<FFloat16Color>& OutData)
+{
+	OutData.SetNumZeroed(Rect.Width() * Rect.Height() * (ZMinMax.Y - ZMinMax.X));
+}
+
+FRenderQueryRHIRef FNullDynamicRHI::RHICreateRenderQuery(ERenderQueryType QueryType)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_RenderQuery);
+	return new FNullRenderQuery(QueryType);
+}
+
+bool FNullDynamicRHI::RHIGetRenderQueryResult(FRHIRenderQuery* RenderQuery, uint64& OutResult, bool bWait, uint32 GPUIndex)
+{
+	// Timestamps report the CPU clock so that GPU timing code sees monotonic values. Nothing is rasterized, so occlusion queries
+	// report a sample as passed; returning zero would make occlusion culling hide everything that gets tested.
+	const FNullRenderQuery* Query = static_cast<FNullRenderQuery*>(RenderQuery);
+	OutResult = Query->QueryType == RQT_AbsoluteTime ? (uint64)(FPlatformTime::Seconds() * 1000000.0) : 1;
+	return true;
+}
+
+FTextureRHIRef FNullDynamicRHI::RHIGetViewportBackBuffer(FRHIViewport* Viewport)
+{
+	return static_cast<FNullViewport*>(Viewport)->GetBackBuffer();
+}
+
+FViewportRHIRef FNullDynamicRHI::RHICreateViewport(void* WindowHandle, uint32 SizeX, uint32 SizeY, bool bIsFullscreen, EPixelFormat PreferredPixelFormat)
+{
+	UE::NullRHI::RecordResourceCreated(RRT_Viewport);
+	return new FNullViewport(SizeX, SizeY, PreferredPixelFormat);
+}
+
+void FNullDynamicRHI::RHIResizeViewport(FRHIViewport* Viewport, uint32 SizeX, uint32 SizeY, bool bIsFullscreen)
+{
+	FNullViewport* NullViewport = static_cast<FNullViewport*>(Viewport);
+	NullViewport->Resize(SizeX, SizeY, NullViewport->GetBackBuffer()->GetFormat());
+}
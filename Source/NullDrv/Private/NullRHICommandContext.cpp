@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NullRHIPrivate.h"
+#include "Misc/ScopeLock.h"
+
+void FNullCommandContext::Begin()
+{
+	BeginCycles = FPlatformTime::Cycles64();
+}
+
+void FNullCommandContext::Finalize(FNullPlatformCommandList& CommandList)
+{
+	Counters.TranslateCycles += FPlatformTime::Cycles64() - BeginCycles;
+	CommandList.Counters.Accumulate(Counters);
+
+	Counters = FNullCommandCounters();
+	RenderPassInfo = FRHIRenderPassInfo();
+	BeginCycles = FPlatformTime::Cycles64();
+}
+
+IRHICommandContext* FNullDynamicRHI::RHIGetDefaultContext()
+{
+	return &DefaultContext;
+}
+
+FNullCommandContext* FNullDynamicRHI::ObtainContext(ERHIPipeline Pipeline)
+{
+	FNullCommandContext* Context = nullptr;
+	{
+		FScopeLock Lock(&ContextPoolCS);
+		Context = ContextPool[Pipeline].Num() ? ContextPool[Pipeline].Pop(EAllowShrinking::No) : nullptr;
+	}
+
+	if (!Context)
+	{
+		Context = new FNullCommandContext(Pipeline, false);
+	}
+
+	return Context;
+}
+
+void FNullDynamicRHI::ReleaseContext(FNullCommandContext* Context)
+{
+	FScopeLock Lock(&ContextPoolCS);
+	ContextPool[Context->GetPipeline()].Push(Context);
+}
+
+IRHIComputeContext* FNullDynamicRHI::RHIGetCommandContext(ERHIPipeline Pipeline, FRHIGPUMask GPUMask)
+{
+	FNullCommandContext* Context = ObtainContext(Pipeline);
+	Context->Begin();
+
+	UE::NullRHI::RecordContextObtained();
+	return Context;
+}
+
+void FNullDynamicRHI::RHIFinalizeContext(FRHIFinalizeContextArgs&& Args, TRHIPipelineArray<IRHIPlatformCommandList*>& Output)
+{
+	for (IRHIComputeContext* ComputeContext : Args.Contexts)
+	{
+		FNullCommandContext* Context = static_cast<FNullCommandContext*>(ComputeContext);
+		const ERHIPipeline Pipeline = Context->GetPipeline();
+
+		FNullPlatformCommandList* CommandList = static_cast<FNullPlatformCommandList*>(Output[Pipeline]);
+		if (!CommandList)
+		{
+			CommandList = new FNullPlatformCommandList();
+			Output[Pipeline] = CommandList;
+		}
+
+		Context->Finalize(*CommandList);
+
+		if (!Context->IsDefaultContext())
+		{
+			ReleaseContext(Context);
+		}
+	}
+}
+
+void FNullDynamicRHI::RHISubmitCommandLists(FRHISubmitCommandListsArgs&& Args)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// Nothing to execute; the command lists only carry what was recorded into them.
+	FNullCommandCounters Counters;
+	for (IRHIPlatformCommandList* CommandList : Args.CommandLists)
+	{
+		FNullPlatformCommandList* NullCommandList = static_cast<FNullPlatformCommandList*>(CommandList);
+		Counters.Accumulate(NullCommandList->Counters);
+		delete NullCommandList;
+	}
+
+	UE::NullRHI::RecordSubmit(Counters, Args.CommandLists.Num(), FPlatformTime::Cycles64() - StartCycles);
+}
@@ -0,0 +1,374 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "NullRHI.h"
+#include "DynamicRHI.h"
+#include "RHIContext.h"
+#include "RHIResources.h"
+#include "Containers/StaticArray.h"
+#include "HAL/CriticalSection.h"
+#include "Modules/ModuleInterface.h"
+#include <atomic>
+
+//
+// Resources. None of these own GPU memory; buffers and textures only allocate host memory when something locks them.
+//
+
+namespace UE::NullRHI
+{
+	/**
+	 * Publishes a zeroed host allocation of NumBytes into Data. When several threads race, the first one to publish wins and
+	 * the others free their allocation. Returns the published pointer.
+	 */
+	inline void* AllocateHostCopy(std::atomic<void*>& Data, uint64 NumBytes)
+	{
+		void* NewData = FMemory::MallocZeroed(NumBytes, 16);
+		void* Expected = nullptr;
+
+		if (Data.compare_exchange_strong(Expected, NewData, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			return NewData;
+		}
+
+		FMemory::Free(NewData);
+		return Expected;
+	}
+}
+
+class FNullBuffer : public FRHIBuffer
+{
+public:
+	FNullBuffer(const FRHIBufferCreateDesc& CreateDesc)
+		: FRHIBuffer(CreateDesc)
+	{
+	}
+
+	virtual ~FNullBuffer()
+	{
+		FMemory::Free(Data.load(std::memory_order_relaxed));
+	}
+
+	/** Returns the host copy of the buffer, allocating it on first use. Safe to call from several threads at once. */
+	void* GetData()
+	{
+		void* Result = Data.load(std::memory_order_acquire);
+		if (!Result)
+		{
+			Result = UE::NullRHI::AllocateHostCopy(Data, FMath::Max<uint32>(GetSize(), 1));
+		}
+		return Result;
+	}
+
+	void TakeOwnership(FNullBuffer& Other)
+	{
+		FRHIBuffer::TakeOwnership(Other);
+		FMemory::Free(Data.exchange(Other.Data.exchange(nullptr)));
+	}
+
+	void ReleaseOwnership()
+	{
+		FRHIBuffer::ReleaseOwnership();
+		FMemory::Free(Data.exchange(nullptr));
+	}
+
+private:
+	std::atomic<void*> Data { nullptr };
+};
+
+class FNullTexture : public FRHITexture
+{
+public:
+	FNullTexture(const FRHITextureCreateDesc& CreateDesc)
+		: FRHITexture(CreateDesc)
+	{
+	}
+
+	virtual ~FNullTexture()
+	{
+		FMemory::Free(Data.load(std::memory_order_relaxed));
+	}
+
+	/** Returns the host copy of the whole texture, allocating it on first use. Safe to call from several threads at once. */
+	uint8* GetData();
+
+private:
+	std::atomic<void*> Data { nullptr };
+};
+
+class FNullUniformBuffer : public FRHIUniformBuffer
+{
+public:
+	FNullUniformBuffer(const FRHIUniformBufferLayout* InLayout, const void* Contents);
+
+	void Update(const void* Contents);
+
+private:
+	TArray<uint8> ConstantData;
+};
+
+class FNullGPUFence : public FRHIGPUFence
+{
+public:
+	FNullGPUFence(FName InName)
+		: FRHIGPUFence(InName)
+	{
+	}
+
+	// There is no GPU timeline, so every fence is signaled as soon as it is written.
+	virtual void Clear() override {}
+	virtual bool Poll() const override { return true; }
+	virtual void Wait(FRHICommandListImmediate& RHICmdList, FRHIGPUMask GPUMask) const override {}
+};
+
+class FNullViewport : public FRHIViewport
+{
+public:
+	FNullViewport(uint32 InSizeX, uint32 InSizeY, EPixelFormat InPixelFormat)
+	{
+		Resize(InSizeX, InSizeY, InPixelFormat);
+	}
+
+	void Resize(uint32 InSizeX, uint32 InSizeY, EPixelFormat InPixelFormat);
+
+	FRHITexture* GetBackBuffer() const { return BackBuffer; }
+
+private:
+	TRefCountPtr<FNullTexture> BackBuffer;
+};
+
+//
+// Command recording
+//
+
+/** Counters gathered by one context between RHIGetCommandContext and RHIFinalizeContext. */
+struct FNullCommandCounters
+{
+	TStaticArray<uint32, (int32)ENullRHICommand::Num> NumCommands{ InPlace, 0 };
+	uint64 TranslateCycles = 0;
+
+	void Accumulate(const FNullCommandCounters& Other)
+	{
+		for (int32 Index = 0; Index < NumCommands.Num(); ++Index)
+		{
+			NumCommands[Index] += Other.NumCommands[Index];
+		}
+		TranslateCycles += Other.TranslateCycles;
+	}
+};
+
+/** The finalized form of one or more contexts, handed back to the RHI in RHISubmitCommandLists. */
+class FNullPlatformCommandList : public IRHIPlatformCommandList
+{
+public:
+	FNullCommandCounters Counters;
+};
+
+class FNullCommandContext final : public IRHICommandContext
+{
+public:
+	FNullCommandContext(ERHIPipeline InPipeline, bool bInIsDefaultContext)
+		: Pipeline(InPipeline)
+		, bIsDefaultContext(bInIsDefaultContext)
+	{
+	}
+
+	bool IsDefaultContext() const { return bIsDefaultContext; }
+
+	/** Called when the context is handed out to start a new recording. */
+	void Begin();
+
+	/** Moves the counters recorded since Begin() into a platform command list and resets the context. */
+	void Finalize(FNullPlatformCommandList& CommandList);
+
+	virtual ERHIPipeline GetPipeline() const override { return Pipeline; }
+
+	// IRHIComputeContext
+	virtual void RHISetComputePipelineState(FRHIComputePipelineState* ComputePipelineState) override              { Record(ENullRHICommand::SetComputePipelineState); }
+	virtual void RHIDispatchComputeShader(uint32 ThreadGroupCountX, uint32 ThreadGroupCountY, uint32 ThreadGroupCountZ) override { Record(ENullRHICommand::Dispatch); }
+	virtual void RHIDispatchIndirectComputeShader(FRHIBuffer* ArgumentBuffer, uint32 ArgumentOffset) override     { Record(ENullRHICommand::DispatchIndirect); }
+	virtual void RHIBeginTransitions(TArrayView<const FRHITransition*> Transitions) override                      { Record(ENullRHICommand::Transition, Transitions.Num()); }
+	virtual void RHIEndTransitions(TArrayView<const FRHITransition*> Transitions) override                        { Record(ENullRHICommand::Transition, Transitions.Num()); }
+	virtual void RHIClearUAVFloat(FRHIUnorderedAccessView* UnorderedAccessViewRHI, const FVector4f& Values) override { Record(ENullRHICommand::ClearUAV); }
+	virtual void RHIClearUAVUint(FRHIUnorderedAccessView* UnorderedAccessViewRHI, const FUintVector4& Values) override { Record(ENullRHICommand::ClearUAV); }
+	virtual void RHISetStaticUniformBuffers(const FUniformBufferStaticBindings& InUniformBuffers) override         { Record(ENullRHICommand::SetStaticUniformBuffers); }
+	virtual void RHISetStaticUniformBuffer(FUniformBufferStaticSlot Slot, FRHIUniformBuffer* UniformBuffer) override { Record(ENullRHICommand::SetStaticUniformBuffers); }
+	virtual void RHICopyToStagingBuffer(FRHIBuffer* SourceBufferRHI, FRHIStagingBuffer* DestinationStagingBufferRHI, uint32 InOffset, uint32 InNumBytes) override { Record(ENullRHICommand::Copy); }
+	virtual void RHIWriteGPUFence(FRHIGPUFence* FenceRHI) override                                                 {}
+
+	virtual void RHISetShaderParameters(FRHIComputeShader* ComputeShader, TConstArrayView<uint8> InParametersData, TConstArrayView<FRHIShaderParameter> InParameters, TConstArrayView<FRHIShaderParameterResource> InResourceParameters, TConstArrayView<FRHIShaderParameterResource> InBindlessParameters) override
+	{
+		Record(ENullRHICommand::SetShaderParameters);
+	}
+
+#if WITH_RHI_BREADCRUMBS
+	virtual void RHIBeginBreadcrumbGPU(FRHIBreadcrumbNode* Breadcrumb) override { Record(ENullRHICommand::Breadcrumb); }
+	virtual void RHIEndBreadcrumbGPU  (FRHIBreadcrumbNode* Breadcrumb) override { Record(ENullRHICommand::Breadcrumb); }
+#endif
+
+	// IRHICommandContext
+	virtual void RHISetMultipleViewports(uint32 Count, const FViewportBounds* Data) override                      { Record(ENullRHICommand::SetRasterState); }
+	virtual void RHIBeginRenderQuery(FRHIRenderQuery* RenderQuery) override                                      { Record(ENullRHICommand::RenderQuery); }
+	virtual void RHIEndRenderQuery(FRHIRenderQuery* RenderQuery) override                                        { Record(ENullRHICommand::RenderQuery); }
+	virtual void RHIEndDrawingViewport(FRHIViewport* Viewport, bool bPresent, bool bLockToVsync) override        {}
+	virtual void RHISetStreamSource(uint32 StreamIndex, FRHIBuffer* VertexBuffer, uint32 Offset) override         { Record(ENullRHICommand::SetRasterState); }
+	virtual void RHISetViewport(float MinX, float MinY, float MinZ, float MaxX, float MaxY, float MaxZ) override  { Record(ENullRHICommand::SetRasterState); }
+	virtual void RHISetScissorRect(bool bEnable, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY) override    { Record(ENullRHICommand::SetRasterState); }
+	virtual void RHISetDepthBounds(float MinDepth, float MaxDepth) override                                      { Record(ENullRHICommand::SetRasterState); }
+	virtual void RHISetStencilRef(uint32 StencilRef) override                                                    { Record(ENullRHICommand::SetRasterState); }
+
+	virtual void RHISetGraphicsPipelineState(FRHIGraphicsPipelineState* GraphicsState, uint32 StencilRef, bool bApplyAdditionalState) override
+	{
+		Record(ENullRHICommand::SetGraphicsPipelineState);
+	}
+
+#if PLATFORM_USE_FALLBACK_PSO
+	virtual void RHISetGraphicsPipelineState(const FGraphicsPipelineStateInitializer& PsoInit, uint32 StencilRef, bool bApplyAdditionalState) override
+	{
+		Record(ENullRHICommand::SetGraphicsPipelineState);
+	}
+#endif
+
+	virtual void RHISetShaderParameters(FRHIGraphicsShader* Shader, TConstArrayView<uint8> InParametersData, TConstArrayView<FRHIShaderParameter> InParameters, TConstArrayView<FRHIShaderParameterResource> InResourceParameters, TConstArrayView<FRHIShaderParameterResource> InBindlessParameters) override
+	{
+		Record(ENullRHICommand::SetShaderParameters);
+	}
+
+	virtual void RHIDrawPrimitive(uint32 BaseVertexIndex, uint32 NumPrimitives, uint32 NumInstances) override    { Record(ENullRHICommand::Draw); }
+	virtual void RHIDrawPrimitiveIndirect(FRHIBuffer* ArgumentBuffer, uint32 ArgumentOffset) override            { Record(ENullRHICommand::DrawIndirect); }
+	virtual void RHIDrawIndexedIndirect(FRHIBuffer* IndexBufferRHI, FRHIBuffer* ArgumentsBufferRHI, int32 DrawArgumentsIndex, uint32 NumInstances) override { Record(ENullRHICommand::DrawIndirect); }
+	virtual void RHIDrawIndexedPrimitive(FRHIBuffer* IndexBuffer, int32 BaseVertexIndex, uint32 FirstInstance, uint32 NumVertices, uint32 StartIndex, uint32 NumPrimitives, uint32 NumInstances) override { Record(ENullRHICommand::DrawIndexed); }
+	virtual void RHIDrawIndexedPrimitiveIndirect(FRHIBuffer* IndexBuffer, FRHIBuffer* ArgumentBuffer, uint32 ArgumentOffset) override { Record(ENullRHICommand::DrawIndirect); }
+
+	virtual void RHIBeginRenderPass(const FRHIRenderPassInfo& InInfo, const TCHAR* InName) override
+	{
+		RenderPassInfo = InInfo;
+		Record(ENullRHICommand::BeginRenderPass);
+	}
+
+	virtual void RHIEndRenderPass() override
+	{
+		RenderPassInfo = FRHIRenderPassInfo();
+		Record(ENullRHICommand::EndRenderPass);
+	}
+
+	virtual void RHICopyTexture(FRHITexture* SourceTexture, FRHITexture* DestTexture, const FRHICopyTextureInfo& CopyInfo) override { Record(ENullRHICommand::Copy); }
+	virtual void RHICopyBufferRegion(FRHIBuffer* DestBuffer, uint64 DstOffset, FRHIBuffer* SourceBuffer, uint64 SrcOffset, uint64 NumBytes) override { Record(ENullRHICommand::Copy); }
+
+private:
+	FORCEINLINE void Record(ENullRHICommand Command, uint32 Count = 1)
+	{
+		Counters.NumCommands[(int32)Command] += Count;
+	}
+
+	FNullCommandCounters Counters;
+	uint64 BeginCycles = 0;
+	const ERHIPipeline Pipeline;
+	const bool bIsDefaultContext;
+};
+
+//
+// Dynamic RHI
+//
+
+class FNullDynamicRHI final : public FDynamicRHIPSOFallback
+{
+public:
+	FNullDynamicRHI();
+	virtual ~FNullDynamicRHI();
+
+	// FDynamicRHI interface.
+	virtual void Init() override;
+	virtual void Shutdown() override;
+	virtual const TCHAR* GetName() override { return TEXT("Null"); }
+	virtual ERHIInterfaceType GetInterfaceType() const override { return ERHIInterfaceType::Null; }
+
+	virtual void RHIEndFrame(const FRHIEndFrameArgs& Args) override;
+
+	virtual FSamplerStateRHIRef RHICreateSamplerState(const FSamplerStateInitializerRHI& Initializer) override;
+	virtual FRasterizerStateRHIRef RHICreateRasterizerState(const FRasterizerStateInitializerRHI& Initializer) override;
+	virtual FDepthStencilStateRHIRef RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI& Initializer) override;
+	virtual FBlendStateRHIRef RHICreateBlendState(const FBlendStateInitializerRHI& Initializer) override;
+	virtual FVertexDeclarationRHIRef RHICreateVertexDeclaration(const FVertexDeclarationElementList& Elements) override;
+	virtual FPixelShaderRHIRef RHICreatePixelShader(TArrayView<const uint8> Code, const FSHAHash& Hash) override;
+	virtual FVertexShaderRHIRef RHICreateVertexShader(TArrayView<const uint8> Code, const FSHAHash& Hash) override;
+	virtual FGeometryShaderRHIRef RHICreateGeometryShader(TArrayView<const uint8> Code, const FSHAHash& Hash) override;
+	virtual FComputeShaderRHIRef RHICreateComputeShader(TArrayView<const uint8> Code, const FSHAHash& Hash) override;
+	virtual FGPUFenceRHIRef RHICreateGPUFence(const FName& Name) override;
+	virtual FBoundShaderStateRHIRef RHICreateBoundShaderState(FRHIVertexDeclaration* VertexDeclaration, FRHIVertexShader* VertexShader, FRHIPixelShader* PixelShader, FRHIGeometryShader* GeometryShader) override;
+	virtual FBoundShaderStateRHIRef RHICreateBoundShaderState(FRHIAmplificationShader* AmplificationShader, FRHIMeshShader* MeshShader, FRHIPixelShader* PixelShader) override;
+	virtual FGraphicsPipelineStateRHIRef RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializer& Initializer) override;
+	virtual FComputePipelineStateRHIRef RHICreateComputePipelineState(const FComputePipelineStateInitializer& Initializer) override;
+	virtual FUniformBufferRHIRef RHICreateUniformBuffer(const void* Contents, const FRHIUniformBufferLayout* Layout, EUniformBufferUsage Usage, EUniformBufferValidation Validation) override;
+	virtual void RHIUpdateUniformBuffer(FRHICommandListBase& RHICmdList, FRHIUniformBuffer* UniformBufferRHI, const void* Contents) override;
+	virtual void RHIReplaceResources(FRHICommandListBase& RHICmdList, TArray<FRHIResourceReplaceInfo>&& ReplaceInfos) override;
+	virtual FRHIBufferInitializer RHICreateBufferInitializer(FRHICommandListBase& RHICmdList, const FRHIBufferCreateDesc& CreateDesc) override;
+	virtual void RHIUpdateAllocationTags(FRHICommandListBase& RHICmdList, FRHIBuffer* Buffer) override {}
+	virtual void* LockBuffer_BottomOfPipe(FRHICommandListBase& RHICmdList, FRHIBuffer* Buffer, uint32 Offset, uint32 SizeRHI, EResourceLockMode LockMode) override;
+	virtual void UnlockBuffer_BottomOfPipe(FRHICommandListBase& RHICmdList, FRHIBuffer* Buffer) override {}
+	virtual FRHICalcTextureSizeResult RHICalcTexturePlatformSize(FRHITextureDesc const& Desc, uint32 FirstMipIndex) override;
+	virtual void RHIGetTextureMemoryStats(FTextureMemoryStats& OutStats) override;
+	virtual bool RHIGetTextureMemoryVisualizeData(FColor* TextureData, int32 SizeX, int32 SizeY, int32 Pitch, int32 PixelSize) override { return false; }
+	virtual FRHITextureInitializer RHICreateTextureInitializer(FRHICommandListBase& RHICmdList, const FRHITextureCreateDesc& CreateDesc) override;
+	virtual FTextureRHIRef RHIAsyncCreateTexture2D(uint32 SizeX, uint32 SizeY, uint8 Format, uint32 NumMips, ETextureCreateFlags Flags, ERHIAccess InResourceState, void** InitialMipData, uint32 NumInitialMips, const TCHAR* DebugName, FGraphEventRef& OutCompletionEvent) override;
+	virtual FShaderResourceViewRHIRef RHICreateShaderResourceView(FRHICommandListBase& RHICmdList, FRHIViewableResource* Resource, FRHIViewDesc const& ViewDesc) override;
+	virtual FUnorderedAccessViewRHIRef RHICreateUnorderedAccessView(FRHICommandListBase& RHICmdList, FRHIViewableResource* Resource, FRHIViewDesc const& ViewDesc) override;
+	virtual uint32 RHIComputeMemorySize(FRHITexture* TextureRHI) override;
+	virtual FTextureRHIRef RHIAsyncReallocateTexture2D(FRHITexture* Texture2D, int32 NewMipCount, int32 NewSizeX, int32 NewSizeY, FThreadSafeCounter* RequestStatus) override;
+	virtual FRHILockTextureResult RHILockTexture(FRHICommandListImmediate& RHICmdList, const FRHILockTextureArgs& Arguments) override;
+	virtual void RHIUnlockTexture(FRHICommandListImmediate& RHICmdList, const FRHILockTextureArgs& Arguments) override {}
+	virtual void RHIUpdateTexture2D(FRHICommandListBase& RHICmdList, FRHITexture* Texture, uint32 MipIndex, const FUpdateTextureRegion2D& UpdateRegion, uint32 SourcePitch, const uint8* SourceData) override {}
+	virtual void RHIUpdateTexture3D(FRHICommandListBase& RHICmdList, FRHITexture* Texture, uint32 MipIndex, const FUpdateTextureRegion3D& UpdateRegion, uint32 SourceRowPitch, uint32 SourceDepthPitch, const uint8* SourceData) override {}
+	virtual void RHIReadSurfaceData(FRHITexture* Texture, FIntRect Rect, TArray<FColor>& OutData, FReadSurfaceDataFlags InFlags) override;
+	virtual void RHIMapStagingSurface(FRHITexture* Texture, FRHIGPUFence* Fence, void*& OutData, int32& OutWidth, int32& OutHeight, uint32 GPUIndex = 0) override;
+	virtual void RHIUnmapStagingSurface(FRHITexture* Texture, uint32 GPUIndex = 0) override {}
+	virtual void RHIReadSurfaceFloatData(FRHITexture* Texture, FIntRect Rect, TArray<FFloat16Color>& OutData, ECubeFace CubeFace, int32 ArrayIndex, int32 MipIndex) override;
+	virtual void RHIRead3DSurfaceFloatData(FRHITexture* Texture, FIntRect Rect, FIntPoint ZMinMax, TArray<FFloat16Color>& OutData) override;
+	virtual FRenderQueryRHIRef RHICreateRenderQuery(ERenderQueryType QueryType) override;
+	virtual bool RHIGetRenderQueryResult(FRHIRenderQuery* RenderQuery, uint64& OutResult, bool bWait, uint32 GPUIndex = INDEX_NONE) override;
+	virtual FTextureRHIRef RHIGetViewportBackBuffer(FRHIViewport* Viewport) override;
+	virtual void RHIAdvanceFrameForGetViewportBackBuffer(FRHIViewport* Viewport, bool bPresent) override {}
+	virtual void RHIFlushResources() override {}
+	virtual FViewportRHIRef RHICreateViewport(void* WindowHandle, uint32 SizeX, uint32 SizeY, bool bIsFullscreen, EPixelFormat PreferredPixelFormat) override;
+	virtual void RHIResizeViewport(FRHIViewport* Viewport, uint32 SizeX, uint32 SizeY, bool bIsFullscreen) override;
+	virtual void RHITick(float DeltaTime) override {}
+	virtual void RHIBlockUntilGPUIdle() override {}
+	virtual bool RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate) override { return false; }
+	virtual void RHIGetSupportedResolution(uint32& Width, uint32& Height) override {}
+	virtual void* RHIGetNativeDevice() override { return nullptr; }
+	virtual void* RHIGetNativeInstance() override { return nullptr; }
+
+	virtual IRHICommandContext* RHIGetDefaultContext() override;
+	virtual IRHIComputeContext* RHIGetCommandContext(ERHIPipeline Pipeline, FRHIGPUMask GPUMask) override;
+	virtual void RHIFinalizeContext(FRHIFinalizeContextArgs&& Args, TRHIPipelineArray<IRHIPlatformCommandList*>& Output) override;
+	virtual void RHISubmitCommandLists(FRHISubmitCommandListsArgs&& Args) override;
+
+private:
+	FNullCommandContext* ObtainContext(ERHIPipeline Pipeline);
+	void ReleaseContext(FNullCommandContext* Context);
+
+	FNullCommandContext DefaultContext;
+
+	FCriticalSection ContextPoolCS;
+	TRHIPipelineArray<TArray<FNullCommandContext*>> ContextPool;
+};
+
+class FNullDynamicRHIModule : public IDynamicRHIModule
+{
+public:
+	// IModuleInterface
+	virtual bool SupportsDynamicReloading() override { return false; }
+
+	// IDynamicRHIModule
+	virtual bool IsSupported() override { return true; }
+	virtual FDynamicRHI* CreateRHI(ERHIFeatureLevel::Type RequestedFeatureLevel = ERHIFeatureLevel::Num) override;
+};
+
+/** Stats helpers shared by the resource and context code. */
+namespace UE::NullRHI
+{
+	void RecordResourceCreated(ERHIResourceType Type, uint64 SizeInBytes = 0);
+	void RecordContextObtained();
+	void RecordSubmit(const FNullCommandCounters& Counters, int32 NumCommandLists, uint64 SubmitCycles);
+	void RecordFrame();
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "RHIDefinitions.h"
+#include "HAL/Platform.h"
+
+/**
+ * The null RHI is a CPU-only FDynamicRHI selected with -nullrhi (or whenever the application cannot render).
+ * It creates resources without any GPU backing and records what the command contexts were asked to do, so that
+ * RDG compilation, command list translation and the RHI caches can be profiled on machines without a GPU.
+ */
+
+/** Buckets of commands recorded by the null RHI command contexts. */
+enum class ENullRHICommand : uint8
+{
+	SetComputePipelineState,
+	SetGraphicsPipelineState,
+	SetShaderParameters,
+	SetStaticUniformBuffers,
+	SetRasterState,
+	Dispatch,
+	DispatchIndirect,
+	Draw,
+	DrawIndexed,
+	DrawIndirect,
+	Transition,
+	ClearUAV,
+	BeginRenderPass,
+	EndRenderPass,
+	Copy,
+	RenderQuery,
+	Breadcrumb,
+	Num
+};
+
+NULLDRV_API const TCHAR* GetNullRHICommandName(ENullRHICommand Command);
+
+/** Snapshot of the work recorded by the null RHI since startup or the last ResetNullRHIStats(). */
+struct FNullRHIStats
+{
+	/** Number of commands recorded per bucket, counted when the owning command list is submitted. */
+	uint64 NumCommands[(int32)ENullRHICommand::Num] = {};
+
+	/** Number of resources created per type. */
+	uint64 NumResourcesCreated[RRT_Num] = {};
+
+	uint64 BufferBytesCreated = 0;
+	uint64 TextureBytesCreated = 0;
+
+	/** Number of contexts handed out by RHIGetCommandContext. */
+	uint64 NumContexts = 0;
+
+	/** Number of platform command lists produced by RHIFinalizeContext and passed to RHISubmitCommandLists. */
+	uint64 NumCommandListsSubmitted = 0;
+	uint64 NumSubmits = 0;
+	uint64 NumFrames = 0;
+
+	/** Cycles spent between a context being handed out and it being finalized, i.e. command list translation. */
+	uint64 TranslateCycles = 0;
+
+	/** Cycles spent inside RHISubmitCommandLists. */
+	uint64 SubmitCycles = 0;
+
+	uint64 GetTotalCommands() const
+	{
+		uint64 Total = 0;
+		for (uint64 Count : NumCommands)
+		{
+			Total += Count;
+		}
+		return Total;
+	}
+};
+
+/** Returns the stats recorded so far. Only meaningful while the null RHI is the active GDynamicRHI. */
+NULLDRV_API FNullRHIStats GetNullRHIStats();
+
+/** Clears all recorded stats, e.g. between benchmark iterations. */
+NULLDRV_API void ResetNullRHIStats();
@@ -6,10 +6,75 @@
 
 #include "BoundShaderStateCache.h"
 #include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
 
+/**
+ * Concurrent map from bound shader state keys to cache entries, split into shards that each have their own read/write lock.
+ * Lookups of different keys rarely touch the same shard, and lookups of the same key only share a read lock, so the
+ * parallel translate threads no longer serialize on a single critical section.
+ */
+template <typename ValueType>
+class TShardedBoundShaderStateMap
+{
+public:
+	static constexpr uint32 NumShardsLog2 = 5;
+	static constexpr uint32 NumShards = 1u << NumShardsLog2;
+
+	void Add(const FBoundShaderStateLookupKey& Key, ValueType Value)
+	{
+		const uint32 KeyHash = GetTypeHash(Key);
+		FShard& Shard = GetShard(KeyHash);
+		FRWScopeLock Lock(Shard.Lock, SLT_Write);
+		Shard.Map.AddByHash(KeyHash, Key, Value);
+	}
+
+	void Remove(const FBoundShaderStateLookupKey& Key)
+	{
+		const uint32 KeyHash = GetTypeHash(Key);
+		FShard& Shard = GetShard(KeyHash);
+		FRWScopeLock Lock(Shard.Lock, SLT_Write);
+		Shard.Map.RemoveByHash(KeyHash, Key);
+	}
+
+	/** Calls Visitor with a pointer to the value cached for Key, or nullptr, while the key's shard is read locked. */
+	template <typename VisitorType>
+	auto Visit(const FBoundShaderStateLookupKey& Key, VisitorType&& Visitor)
+	{
+		const uint32 KeyHash = GetTypeHash(Key);
+		FShard& Shard = GetShard(KeyHash);
+		FRWScopeLock Lock(Shard.Lock, SLT_ReadOnly);
+		return Visitor(Shard.Map.FindByHash(KeyHash, Key));
+	}
+
+	void Empty()
+	{
+		for (FShard& Shard : Shards)
+		{
+			FRWScopeLock Lock(Shard.Lock, SLT_Write);
+			Shard.Map.Empty(0);
+		}
+	}
+
+private:
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FShard
+	{
+		FRWLock Lock;
+		TMap<FBoundShaderStateLookupKey, ValueType> Map;
+	};
+
+	FShard& GetShard(uint32 KeyHash)
+	{
+		// The key hash XORs pointers together, so mix it before taking the top bits.
+		return Shards[(KeyHash * 0x9E3779B1u) >> (32 - NumShardsLog2)];
+	}
+
+	FShard Shards[NumShards];
+};
 
 typedef TMap<FBoundShaderStateLookupKey,FCachedBoundShaderStateLink*> FBoundShaderStateCache;
-typedef TMap<FBoundShaderStateLookupKey,FCachedBoundShaderStateLink_Threadsafe*> FBoundShaderStateCache_Threadsafe;
+typedef TShardedBoundShaderStateMap<FCachedBoundShaderStateLink_Threadsafe*> FBoundShaderStateCache_Threadsafe;
 
 static FBoundShaderStateCache GBoundShaderStateCache;
 static FBoundShaderStateCache_Threadsafe GBoundShaderStateCache_ThreadSafe;
@@ -26,8 +91,6 @@ static FBoundShaderStateCache_Threadsafe& GetBoundShaderStateCache_Threadsafe()
 	return GBoundShaderStateCache_ThreadSafe;
 }
 
-static FCriticalSection BoundShaderStateCacheLock;
-
 
 FCachedBoundShaderStateLink::FCachedBoundShaderStateLink(
 	FRHIVertexDeclaration* VertexDeclaration,
@@ -115,12 +178,10 @@ FCachedBoundShaderStateLink* GetCachedBoundShaderState(
 
 void FCachedBoundShaderStateLink_Threadsafe::AddToCache()
 {
-	FScopeLock Lock(&BoundShaderStateCacheLock);
 	GetBoundShaderStateCache_Threadsafe().Add(Key,this);
 }
 void FCachedBoundShaderStateLink_Threadsafe::RemoveFromCache()
 {
-	FScopeLock Lock(&BoundShaderStateCacheLock);
 	GetBoundShaderStateCache_Threadsafe().Remove(Key);
 }
 
@@ -134,33 +195,122 @@ FBoundShaderStateRHIRef GetCachedBoundShaderState_Threadsafe(
 	FRHIAmplificationShader* AmplificationShader
 	)
 {
-	FScopeLock Lock(&BoundShaderStateCacheLock);
+	const FBoundShaderStateLookupKey Key = MeshShader
+		? FBoundShaderStateLookupKey(MeshShader, AmplificationShader, PixelShader)
+		: FBoundShaderStateLookupKey(VertexDeclaration, VertexShader, PixelShader, GeometryShader);
 
-	// Find the existing bound shader state in the cache.
-	FCachedBoundShaderStateLink_Threadsafe* CachedBoundShaderStateLink;
-	if (MeshShader)
+	// Find the existing bound shader state in the cache. The reference must be taken while the shard is locked, since the
+	// link is removed from the cache before its bound shader state is destroyed.
+	return GetBoundShaderStateCache_Threadsafe().Visit(Key, [](FCachedBoundShaderStateLink_Threadsafe* const* CachedBoundShaderStateLink)
 	{
-		CachedBoundShaderStateLink = GetBoundShaderStateCache_Threadsafe().FindRef(
-			FBoundShaderStateLookupKey(MeshShader, AmplificationShader, PixelShader)
-		);
+		if (CachedBoundShaderStateLink && (*CachedBoundShaderStateLink)->BoundShaderState->IsValid())
+		{
+			// If we've already created a bound shader state with these parameters, reuse it.
+			return FBoundShaderStateRHIRef((*CachedBoundShaderStateLink)->BoundShaderState);
+		}
+		return FBoundShaderStateRHIRef();
+	});
+}
+
+void EmptyCachedBoundShaderStates()
+{
+	GetBoundShaderStateCache().Empty(0);
+	GetBoundShaderStateCache_Threadsafe().Empty();
+}
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+/** Stresses the thread-safe cache from many threads, comparing the sharded map against the single-lock map it replaced. */
+static void BenchmarkBoundShaderStateCache(const TArray<FString>& Args)
+{
+	const int32 NumThreads = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 8;
+	const int32 NumKeys = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 4096;
+	const int32 NumOpsPerThread = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 1000000;
+	// One operation in this many adds or removes an entry, the rest are lookups, like when new PSOs get created mid-frame.
+	const int32 WriteInterval = 64;
+
+	// Keys are never dereferenced, so made-up, aligned addresses are enough.
+	TArray<FBoundShaderStateLookupKey> Keys;
+	Keys.Reserve(NumKeys);
+	for (int32 KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+	{
+		const UPTRINT Base = UPTRINT(0x10000) + UPTRINT(KeyIndex) * 256;
+		Keys.Emplace((FRHIVertexDeclaration*)(Base + 64), (FRHIVertexShader*)(Base + 128), (FRHIPixelShader*)(Base + 192));
 	}
-	else
+
+	auto RunThreads = [&](auto&& Lookup, auto&& Add, auto&& Remove)
 	{
-		CachedBoundShaderStateLink = GetBoundShaderStateCache_Threadsafe().FindRef(
-			FBoundShaderStateLookupKey(VertexDeclaration, VertexShader, PixelShader, GeometryShader)
-		);
+		const double StartTime = FPlatformTime::Seconds();
+		std::atomic<int64> NumHits{ 0 };
+		ParallelFor(NumThreads, [&](int32 ThreadIndex)
+		{
+			FRandomStream Rand(ThreadIndex * 7919 + 1);
+			int64 ThreadHits = 0;
+			for (int32 OpIndex = 0; OpIndex < NumOpsPerThread; ++OpIndex)
+			{
+				const int32 KeyIndex = Rand.RandHelper(NumKeys);
+				if (OpIndex % WriteInterval == WriteInterval - 1)
+				{
+					if (Rand.RandHelper(2))
+					{
+						Add(Keys[KeyIndex], UPTRINT(KeyIndex) + 1);
+					}
+					else
+					{
+						Remove(Keys[KeyIndex]);
+					}
+				}
+				else
+				{
+					ThreadHits += Lookup(Keys[KeyIndex]) != 0 ? 1 : 0;
+				}
+			}
+			NumHits += ThreadHits;
+		}, EParallelForFlags::Unbalanced);
+		return FPlatformTime::Seconds() - StartTime;
+	};
+
+	// Baseline: the single critical section protected TMap.
+	double SingleLockSeconds;
+	{
+		FCriticalSection Lock;
+		TMap<FBoundShaderStateLookupKey, UPTRINT> Map;
+		for (int32 KeyIndex = 0; KeyIndex < NumKeys; KeyIndex += 2)
+		{
+			Map.Add(Keys[KeyIndex], UPTRINT(KeyIndex) + 1);
+		}
+
+		SingleLockSeconds = RunThreads(
+			[&](const FBoundShaderStateLookupKey& Key) { FScopeLock ScopeLock(&Lock); return Map.FindRef(Key); },
+			[&](const FBoundShaderStateLookupKey& Key, UPTRINT Value) { FScopeLock ScopeLock(&Lock); Map.Add(Key, Value); },
+			[&](const FBoundShaderStateLookupKey& Key) { FScopeLock ScopeLock(&Lock); Map.Remove(Key); });
 	}
-	
-	if(CachedBoundShaderStateLink && CachedBoundShaderStateLink->BoundShaderState->IsValid())
+
+	double ShardedSeconds;
 	{
-		// If we've already created a bound shader state with these parameters, reuse it.
-		return CachedBoundShaderStateLink->BoundShaderState;
+		TUniquePtr<TShardedBoundShaderStateMap<UPTRINT>> Map = MakeUnique<TShardedBoundShaderStateMap<UPTRINT>>();
+		for (int32 KeyIndex = 0; KeyIndex < NumKeys; KeyIndex += 2)
+		{
+			Map->Add(Keys[KeyIndex], UPTRINT(KeyIndex) + 1);
+		}
+
+		ShardedSeconds = RunThreads(
+			[&](const FBoundShaderStateLookupKey& Key) { return Map->Visit(Key, [](const UPTRINT* Value) { return Value ? *Value : 0; }); },
+			[&](const FBoundShaderStateLookupKey& Key, UPTRINT Value) { Map->Add(Key, Value); },
+			[&](const FBoundShaderStateLookupKey& Key) { Map->Remove(Key); });
 	}
-	return FBoundShaderStateRHIRef();
-}
 
-void EmptyCachedBoundShaderStates()
-{
-	GetBoundShaderStateCache().Empty(0);
-	GetBoundShaderStateCache_Threadsafe().Empty(0);
+	const double NumOps = double(NumThreads) * NumOpsPerThread;
+	UE_LOG(LogRHI, Display, TEXT("Bound shader state cache: %d threads, %d keys, %d ops per thread, 1 write per %d ops"), NumThreads, NumKeys, NumOpsPerThread, WriteInterval);
+	UE_LOG(LogRHI, Display, TEXT("  Single lock: %.1f ns/op"), SingleLockSeconds * 1.0e9 / NumOps);
+	UE_LOG(LogRHI, Display, TEXT("  Sharded (%u shards): %.1f ns/op (%.2fx)"), TShardedBoundShaderStateMap<UPTRINT>::NumShards, ShardedSeconds * 1.0e9 / NumOps, ShardedSeconds > 0.0 ? SingleLockSeconds / ShardedSeconds : 0.0);
 }
+
+static FAutoConsoleCommand GBenchmarkBoundShaderStateCacheCmd(
+	TEXT("r.BoundShaderStateCache.Benchmark"),
+	TEXT("Stresses the thread-safe bound shader state cache from several threads and compares it against a single-lock map.\n")
+	TEXT("Usage: r.BoundShaderStateCache.Benchmark [NumThreads] [NumKeys] [NumOpsPerThread]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBoundShaderStateCache)
+);
+
+#endif
@@ -5,6 +5,9 @@
 #include "Stats/StatsMisc.h"
 #include "RHI.h"
 #include "Stats/Stats.h"
+#include "Algo/Sort.h"
+#include "Math/RandomStream.h"
+#include "HAL/FileManager.h"
 
 DECLARE_STATS_GROUP(TEXT("TexturePool"), STATGROUP_TexturePool, STATCAT_ADVANCED);
 
@@ -94,33 +97,276 @@ void FGPUDefragAllocator::FMemoryChunk::LinkFree(FMemoryChunk* FirstFreeChunkToS
 
 	#else
 
-		if (BestFitAllocator.FirstFreeChunk)
+		// The address tree finds the insertion point directly, so the search hint is no longer needed.
+		if (FMemoryChunk* InsertAfter = BestFitAllocator.FindPreviousFreeChunk(Base))
 		{
-			FMemoryChunk* InsertBefore = (FirstFreeChunkToSearch && FirstFreeChunkToSearch->bIsAvailable) ? FirstFreeChunkToSearch : BestFitAllocator.FirstFreeChunk;
-			while (Base > InsertBefore->Base && InsertBefore->NextFreeChunk)
+			PreviousFreeChunk = InsertAfter;
+			NextFreeChunk = InsertAfter->NextFreeChunk;
+			if (NextFreeChunk)
+			{
+				NextFreeChunk->PreviousFreeChunk = this;
+			}
+			InsertAfter->NextFreeChunk = this;
+		}
+		else
+		{
+			PreviousFreeChunk = nullptr;
+			NextFreeChunk = BestFitAllocator.FirstFreeChunk;
+			if (NextFreeChunk)
 			{
-				InsertBefore = InsertBefore->NextFreeChunk;
+				NextFreeChunk->PreviousFreeChunk = this;
 			}
-			NextFreeChunk = InsertBefore;
-			PreviousFreeChunk = InsertBefore->PreviousFreeChunk;
-			if (InsertBefore->PreviousFreeChunk)
+			BestFitAllocator.FirstFreeChunk = this;
+		}
+
+	#endif
+
+	BestFitAllocator.AddToFreeIndex(this);
+}
+
+/*-----------------------------------------------------------------------------
+Free chunk index.
+
+Free chunks are kept in two intrusive treaps: one ordered by base address, used to keep the free list sorted, and
+one ordered by (size, base address), used for best-fit searches. Both give logarithmic inserts, removals and searches.
+-----------------------------------------------------------------------------*/
+
+namespace UE::GPUDefragAllocator::Private
+{
+	using FMemoryChunk = FGPUDefragAllocator::FMemoryChunk;
+	using FTreeLinks = FGPUDefragAllocator::FFreeChunkTreeLinks;
+
+	struct FAddressTreeTraits
+	{
+		static FTreeLinks& GetLinks(FMemoryChunk* Chunk)
+		{
+			return Chunk->FreeAddressLinks;
+		}
+
+		static bool Less(const FMemoryChunk* A, const FMemoryChunk* B)
+		{
+			return A->Base < B->Base;
+		}
+	};
+
+	struct FSizeTreeTraits
+	{
+		static FTreeLinks& GetLinks(FMemoryChunk* Chunk)
+		{
+			return Chunk->FreeSizeLinks;
+		}
+
+		static bool Less(const FMemoryChunk* A, const FMemoryChunk* B)
+		{
+			return A->Size < B->Size || (A->Size == B->Size && A->Base < B->Base);
+		}
+	};
+
+	template <typename TreeTraits>
+	static FMemoryChunk* TreeInsert(FMemoryChunk* Node, FMemoryChunk* Chunk)
+	{
+		if (!Node)
+		{
+			TreeTraits::GetLinks(Chunk) = FTreeLinks();
+			return Chunk;
+		}
+
+		FTreeLinks& Links = TreeTraits::GetLinks(Node);
+
+		if (TreeTraits::Less(Chunk, Node))
+		{
+			Links.Left = TreeInsert<TreeTraits>(Links.Left, Chunk);
+
+			// Rotate right.
+			if (Links.Left->FreeTreePriority > Node->FreeTreePriority)
+			{
+				FMemoryChunk* Left = Links.Left;
+				Links.Left = TreeTraits::GetLinks(Left).Right;
+				TreeTraits::GetLinks(Left).Right = Node;
+				return Left;
+			}
+		}
+		else
+		{
+			Links.Right = TreeInsert<TreeTraits>(Links.Right, Chunk);
+
+			// Rotate left.
+			if (Links.Right->FreeTreePriority > Node->FreeTreePriority)
+			{
+				FMemoryChunk* Right = Links.Right;
+				Links.Right = TreeTraits::GetLinks(Right).Left;
+				TreeTraits::GetLinks(Right).Left = Node;
+				return Right;
+			}
+		}
+
+		return Node;
+	}
+
+	template <typename TreeTraits>
+	static FMemoryChunk* TreeMerge(FMemoryChunk* Left, FMemoryChunk* Right)
+	{
+		if (!Left || !Right)
+		{
+			return Left ? Left : Right;
+		}
+
+		if (Left->FreeTreePriority > Right->FreeTreePriority)
+		{
+			TreeTraits::GetLinks(Left).Right = TreeMerge<TreeTraits>(TreeTraits::GetLinks(Left).Right, Right);
+			return Left;
+		}
+		else
+		{
+			TreeTraits::GetLinks(Right).Left = TreeMerge<TreeTraits>(Left, TreeTraits::GetLinks(Right).Left);
+			return Right;
+		}
+	}
+
+	template <typename TreeTraits>
+	static FMemoryChunk* TreeRemove(FMemoryChunk* Node, FMemoryChunk* Chunk)
+	{
+		check(Node);
+
+		if (Node == Chunk)
+		{
+			FTreeLinks& Links = TreeTraits::GetLinks(Chunk);
+			FMemoryChunk* Merged = TreeMerge<TreeTraits>(Links.Left, Links.Right);
+			Links = FTreeLinks();
+			return Merged;
+		}
+
+		FTreeLinks& Links = TreeTraits::GetLinks(Node);
+
+		if (TreeTraits::Less(Chunk, Node))
+		{
+			Links.Left = TreeRemove<TreeTraits>(Links.Left, Chunk);
+		}
+		else
+		{
+			Links.Right = TreeRemove<TreeTraits>(Links.Right, Chunk);
+		}
+
+		return Node;
+	}
+}
+
+void FGPUDefragAllocator::AddToFreeIndex(FMemoryChunk* Chunk)
+{
+	using namespace UE::GPUDefragAllocator::Private;
+
+	// Xorshift32.
+	FreeTreeSeed ^= FreeTreeSeed << 13;
+	FreeTreeSeed ^= FreeTreeSeed >> 17;
+	FreeTreeSeed ^= FreeTreeSeed << 5;
+	Chunk->FreeTreePriority = FreeTreeSeed;
+
+	FreeAddressTreeRoot = TreeInsert<FAddressTreeTraits>(FreeAddressTreeRoot, Chunk);
+	FreeSizeTreeRoot = TreeInsert<FSizeTreeTraits>(FreeSizeTreeRoot, Chunk);
+}
+
+void FGPUDefragAllocator::RemoveFromFreeIndex(FMemoryChunk* Chunk)
+{
+	using namespace UE::GPUDefragAllocator::Private;
+
+	FreeAddressTreeRoot = TreeRemove<FAddressTreeTraits>(FreeAddressTreeRoot, Chunk);
+	FreeSizeTreeRoot = TreeRemove<FSizeTreeTraits>(FreeSizeTreeRoot, Chunk);
+}
+
+void FGPUDefragAllocator::SetChunkExtent(FMemoryChunk* Chunk, uint8* NewBase, int64 NewSize)
+{
+	using namespace UE::GPUDefragAllocator::Private;
+
+	if (Chunk->bIsAvailable)
+	{
+		// Moving the base never reorders free chunks by address, so only the size tree needs to be re-keyed.
+		FreeSizeTreeRoot = TreeRemove<FSizeTreeTraits>(FreeSizeTreeRoot, Chunk);
+		Chunk->Base = NewBase;
+		Chunk->Size = NewSize;
+		FreeSizeTreeRoot = TreeInsert<FSizeTreeTraits>(FreeSizeTreeRoot, Chunk);
+	}
+	else
+	{
+		Chunk->Base = NewBase;
+		Chunk->Size = NewSize;
+	}
+}
+
+FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::FindBestFit(int64 AllocationSize) const
+{
+	int64 MinSize = AllocationSize;
+	const uint8* MinBase = nullptr;
+
+	for (;;)
+	{
+		// Find the first chunk ordered at or after (MinSize, MinBase).
+		FMemoryChunk* Candidate = nullptr;
+		for (FMemoryChunk* Node = FreeSizeTreeRoot; Node; )
+		{
+			if (Node->Size > MinSize || (Node->Size == MinSize && Node->Base >= MinBase))
 			{
-				InsertBefore->PreviousFreeChunk->NextFreeChunk = this;
+				Candidate = Node;
+				Node = Node->FreeSizeLinks.Left;
 			}
 			else
 			{
-				BestFitAllocator.FirstFreeChunk = this;
+				Node = Node->FreeSizeLinks.Right;
 			}
-			InsertBefore->PreviousFreeChunk = this;
+		}
+
+		// Chunks with GPU relocations in flight may not be usable in full yet, so keep looking at the next larger one.
+		// There are only ever a handful of those.
+		if (!Candidate || Candidate->GetAvailableSize() >= AllocationSize)
+		{
+			return Candidate;
+		}
+
+		MinSize = Candidate->Size;
+		MinBase = Candidate->Base + 1;
+	}
+}
+
+FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::FindBestFitLinear(int64 AllocationSize) const
+{
+	FMemoryChunk* BestChunk = nullptr;
+	int64 BestSize = MAX_int64;
+
+	for (FMemoryChunk* CurrentChunk = FirstFreeChunk; CurrentChunk; CurrentChunk = CurrentChunk->NextFreeChunk)
+	{
+		const int64 AvailableSize = CurrentChunk->GetAvailableSize();
+		if (AvailableSize >= AllocationSize && AvailableSize < BestSize)
+		{
+			BestSize = AvailableSize;
+			BestChunk = CurrentChunk;
+
+			if (AvailableSize == AllocationSize)
+			{
+				break;
+			}
+		}
+	}
+
+	return BestChunk;
+}
+
+FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::FindPreviousFreeChunk(const uint8* Base) const
+{
+	FMemoryChunk* Result = nullptr;
+
+	for (FMemoryChunk* Node = FreeAddressTreeRoot; Node; )
+	{
+		if (!Base || Node->Base < Base)
+		{
+			Result = Node;
+			Node = Node->FreeAddressLinks.Right;
 		}
 		else
 		{
-			PreviousFreeChunk = nullptr;
-			NextFreeChunk = nullptr;
-			BestFitAllocator.FirstFreeChunk = this;
+			Node = Node->FreeAddressLinks.Left;
 		}
+	}
 
-	#endif
+	return Result;
 }
 
 /*-----------------------------------------------------------------------------
@@ -140,49 +386,23 @@ void* FGPUDefragAllocator::Allocate(int64 AllocationSize, int32 Alignment, TStat
 	SCOPE_SECONDS_COUNTER(TimeSpentInAllocator);
 	FScopeLock Lock(&SynchronizationObject);
 	check(FirstChunk);
+	// Chunk bases and sizes are always multiples of AllocationAlignment, so with this restriction every chunk that is large enough
+	// is also suitably aligned. That is why FindBestFit can search by size alone without accounting for alignment padding.
 	check(Alignment <= AllocationAlignment);
 	const int64 OrigSize = AllocationSize;
 	// Make sure everything is appropriately aligned.
 	AllocationSize = Align(AllocationSize, AllocationAlignment);
 
-	// Perform a "best fit" search, returning first perfect fit if there is one.
-	FMemoryChunk* CurrentChunk = FirstFreeChunk;
-	FMemoryChunk* BestChunk = nullptr;
-	int64 BestSize = MAX_int64;
-	int32 Iteration = 0;
-	do
-	{
-		while (CurrentChunk)
-		{
-			// Check whether chunk is available and large enough to hold allocation.
-			check(CurrentChunk->bIsAvailable);
-			int64 AvailableSize = CurrentChunk->GetAvailableSize();
-			if (AvailableSize >= AllocationSize)
-			{
-				// Tighter fits are preferred.
-				if (AvailableSize < BestSize)
-				{
-					BestSize = AvailableSize;
-					BestChunk = CurrentChunk;
-				}
-
-				// We have a perfect fit, no need to iterate further.
-				if (AvailableSize == AllocationSize)
-				{
-					break;
-				}
-			}
-			CurrentChunk = CurrentChunk->NextFreeChunk;
-		}
+	// Perform a "best fit" search through the size-ordered free chunk tree.
+	FMemoryChunk* BestChunk = FindBestFit(AllocationSize);
 
-		// If we didn't find any chunk to allocate, and we're currently doing some async defragmentation...
-		if (!BestChunk && NumRelocationsInProgress > 0 && !bAllowFailure)
-		{
-			// Wait for all relocations to finish and try again.
-			FinishAllRelocations();
-			CurrentChunk = FirstFreeChunk;
-		}
-	} while (!BestChunk && CurrentChunk);
+	// If we didn't find any chunk to allocate, and we're currently doing some async defragmentation...
+	if (!BestChunk && NumRelocationsInProgress > 0 && !bAllowFailure)
+	{
+		// Wait for all relocations to finish and try again.
+		FinishAllRelocations();
+		BestChunk = FindBestFit(AllocationSize);
+	}
 
 	// Dump allocation info and return nullptr if we weren't able to satisfy allocation request.
 	if (!BestChunk)
@@ -224,6 +444,15 @@ void* FGPUDefragAllocator::Allocate(int64 AllocationSize, int32 Alignment, TStat
 	MemoryTrace_Alloc((uint64)AllocatedChunk->Base, AllocationSize, Alignment);
 	LLM_IF_ENABLED(FLowLevelMemTracker::Get().OnLowLevelAlloc(ELLMTracker::Default, AllocatedChunk->Base, AllocationSize));
 
+#if GPU_DEFRAG_TRACE_RECORDING
+	if (bRecordingTrace)
+	{
+		const uint32 AllocationId = NextTraceAllocationId++;
+		TraceAllocationIds.Add(AllocatedChunk->Base, AllocationId);
+		TraceEvents.Add({ FAllocationTraceEvent::EType::Allocate, AllocationId, OrigSize });
+	}
+#endif
+
 	return AllocatedChunk->Base;
 }
 
@@ -374,6 +603,14 @@ void FGPUDefragAllocator::Free(void* Pointer)
 	check(MatchingChunk->Base == Pointer);
 	checkf(MatchingChunk->LockCount == 0, TEXT("Chunk with base address: 0x%p is being freed with %i outstanding locks.  This is a data corruption hazard."), Pointer, MatchingChunk->LockCount);
 
+#if GPU_DEFRAG_TRACE_RECORDING
+	uint32 TraceAllocationId;
+	if (bRecordingTrace && TraceAllocationIds.RemoveAndCopyValue(Pointer, TraceAllocationId))
+	{
+		TraceEvents.Add({ FAllocationTraceEvent::EType::Free, TraceAllocationId, 0 });
+	}
+#endif
+
 	int64 PaddingWaste = MatchingChunk->Size - MatchingChunk->OrigSize;
 	FPlatformAtomics::InterlockedAdd(&PaddingWasteSize, -PaddingWaste);
 
@@ -536,11 +773,12 @@ FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::Grow(FMemoryChunk* Chunk
 		PointerToChunkMap.Remove(OldBaseAddress);
 
 		// Shrink the previous and grow the current chunk.
-		PrevChunk->Size -= GrowAmount;
+		SetChunkExtent(PrevChunk, PrevChunk->Base, PrevChunk->Size - GrowAmount);
 		Chunk->Base -= GrowAmount;
 		Chunk->Size += GrowAmount;
 
 		PointerToChunkMap.Add(Chunk->Base, Chunk);
+		RetargetTracedAllocation(OldBaseAddress, Chunk->Base);
 
 		if (PrevChunk->Size == 0)
 		{
@@ -581,7 +819,7 @@ FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::Shrink(FMemoryChunk* Chu
 
 		// Grow the previous chunk.
 		int64 OriginalPrevSize = NewFreeChunk->Size;
-		NewFreeChunk->Size += ShrinkAmount;
+		SetChunkExtent(NewFreeChunk, NewFreeChunk->Base, NewFreeChunk->Size + ShrinkAmount);
 
 		// If the previous chunk was "in use", split it and insert a 2nd free chunk.
 		if (!NewFreeChunk->bIsAvailable)
@@ -616,6 +854,7 @@ FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::Shrink(FMemoryChunk* Chu
 
 	PointerToChunkMap.Remove(OldBaseAddress);
 	PointerToChunkMap.Add(Chunk->Base, Chunk);
+	RetargetTracedAllocation(OldBaseAddress, Chunk->Base);
 	Chunk->UserPayload = UserPayload;
 
 	// Update usage stats in a thread safe way.
@@ -731,6 +970,7 @@ void FGPUDefragAllocator::SortFreeList(int32& NumFreeChunks, int64& LargestFreeC
 				}
 				ChunkToSort->UnlinkFree();
 				ChunkToSort->bIsAvailable = true;	// Set it back to 'free'
+				AddToFreeIndex(ChunkToSort);
 				ChunkToSort->PreviousFreeChunk = InsertBefore->PreviousFreeChunk;
 				ChunkToSort->NextFreeChunk = InsertBefore;
 				if (InsertBefore->PreviousFreeChunk)
@@ -788,14 +1028,7 @@ FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::FindAdjacent(FMemoryChun
 */
 FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::FindAdjacentToHole(FMemoryChunk* FreeChunk)
 {
-	//@TODO: Maintain LastFreeChunk for speed
-	FMemoryChunk* LastFreeChunk = LastChunk;
-	while (LastFreeChunk && !LastFreeChunk->bIsAvailable)
-	{
-		LastFreeChunk = LastFreeChunk->PreviousChunk;
-	}
-
-	FMemoryChunk* Chunk = LastFreeChunk;
+	FMemoryChunk* Chunk = FindPreviousFreeChunk(nullptr);
 	while (Chunk && Chunk->Base > FreeChunk->Base)
 	{
 		// Check Right
@@ -999,6 +1232,7 @@ FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::RelocateIntoFreeChunk(FR
 	// Update our book-keeping.
 	PointerToChunkMap.Remove(SourceOldBase);
 	PointerToChunkMap.Add(NewBaseAddress, DestinationChunk);
+	RetargetTracedAllocation(SourceOldBase, NewBaseAddress);
 	SourceChunk->Stat = TStatId();
 	DestinationChunk->Stat = SourceStat;	
 
@@ -1272,6 +1506,16 @@ static FAutoConsoleVariableRef CVarGPUDefragAllowOverlappedMoves(
 	ECVF_Default
 	);
 
+static int32 GGPUDefragCompactionPlanner = 0;
+static FAutoConsoleVariableRef CVarGPUDefragCompactionPlanner(
+	TEXT("r.GPUDefrag.CompactionPlanner"),
+	GGPUDefragCompactionPlanner,
+	TEXT("Replaces the greedy partial defrag with a planner that empties the window of chunks giving the largest free chunk growth per byte copied.\n")
+	TEXT(" 0: greedy partial defrag (default)\n")
+	TEXT(" 1: compaction planner\n"),
+	ECVF_Default
+	);
+
 /**
 * Performs a partial defrag while trying to process any pending async reallocation requests.
 *
@@ -1294,6 +1538,12 @@ FGPUDefragAllocator::FMemoryChunk* FGPUDefragAllocator::RelocateAllowed(FMemoryC
 	return AllowedChunk;
 }
 
+int32 FGPUDefragAllocator::RandomDefragCounter(int32 MinCounter, int32 MaxCounter)
+{
+	const int32 Range = MaxCounter - MinCounter;
+	return MinCounter + (DefragRandomStream ? DefragRandomStream->RandHelper(Range) : FMath::RandHelper(Range));
+}
+
 void FGPUDefragAllocator::PartialDefragmentationFast(FRelocationStats& Stats, double StartTime)
 {
 	FMemoryChunk* FreeChunk = FirstFreeChunk;
@@ -1333,11 +1583,11 @@ void FGPUDefragAllocator::PartialDefragmentationFast(FRelocationStats& Stats, do
 				// Don't try it again for a while.
 				if (FreeChunk->Size < DEFRAG_SMALL_CHUNK_SIZE)
 				{
-					FreeChunk->DefragCounter = DEFRAG_SMALL_CHUNK_COUNTER_MIN + FMath::RandHelper(DEFRAG_SMALL_CHUNK_COUNTER_MAX - DEFRAG_SMALL_CHUNK_COUNTER_MIN);
+					FreeChunk->DefragCounter = RandomDefragCounter(DEFRAG_SMALL_CHUNK_COUNTER_MIN, DEFRAG_SMALL_CHUNK_COUNTER_MAX);
 				}
 				else
 				{
-					FreeChunk->DefragCounter = DEFRAG_CHUNK_COUNTER_MIN + FMath::RandHelper(DEFRAG_CHUNK_COUNTER_MAX - DEFRAG_CHUNK_COUNTER_MIN);
+					FreeChunk->DefragCounter = RandomDefragCounter(DEFRAG_CHUNK_COUNTER_MIN, DEFRAG_CHUNK_COUNTER_MAX);
 				}
 			}
 
@@ -1388,11 +1638,11 @@ void FGPUDefragAllocator::PartialDefragmentationSlow(FRelocationStats& Stats, do
 				// Don't try it again for a while.
 				if (FreeChunk->Size < DEFRAG_SMALL_CHUNK_SIZE)
 				{
-					FreeChunk->DefragCounter = DEFRAG_SMALL_CHUNK_COUNTER_MIN + FMath::RandHelper(DEFRAG_SMALL_CHUNK_COUNTER_MAX - DEFRAG_SMALL_CHUNK_COUNTER_MIN);
+					FreeChunk->DefragCounter = RandomDefragCounter(DEFRAG_SMALL_CHUNK_COUNTER_MIN, DEFRAG_SMALL_CHUNK_COUNTER_MAX);
 				}
 				else
 				{
-					FreeChunk->DefragCounter = DEFRAG_CHUNK_COUNTER_MIN + FMath::RandHelper(DEFRAG_CHUNK_COUNTER_MAX - DEFRAG_CHUNK_COUNTER_MIN);
+					FreeChunk->DefragCounter = RandomDefragCounter(DEFRAG_CHUNK_COUNTER_MIN, DEFRAG_CHUNK_COUNTER_MAX);
 				}
 			}
 
@@ -1408,6 +1658,209 @@ void FGPUDefragAllocator::PartialDefragmentationSlow(FRelocationStats& Stats, do
 	}
 }
 
+/**
+* Plans a set of relocations that empties a window of consecutive chunks into free chunks outside of it.
+*
+* @param ByteBudget		Maximum number of bytes to relocate
+* @param MaxMoves		Maximum number of relocations
+* @param OutMoves		[out] Planned relocations, to be executed in order
+* @return				Size of the free chunk created by the plan
+*/
+int64 FGPUDefragAllocator::PlanCompaction(int64 ByteBudget, int32 MaxMoves, TArray<FCompactionMove>& OutMoves) const
+{
+	OutMoves.Reset();
+
+	if (ByteBudget <= 0 || MaxMoves <= 0)
+	{
+		return 0;
+	}
+
+	TArray<FMemoryChunk*, TInlineAllocator<256>> Chunks;
+	int64 LargestFreeSize = 0;
+	for (FMemoryChunk* Chunk = FirstChunk; Chunk; Chunk = Chunk->NextChunk)
+	{
+		Chunks.Add(Chunk);
+		if (Chunk->bIsAvailable)
+		{
+			LargestFreeSize = FMath::Max(LargestFreeSize, Chunk->Size);
+		}
+	}
+
+	struct FWindow
+	{
+		int32	First;
+		int32	Last;
+		int64	Span;
+		int64	BytesToMove;
+		double	Score;
+	};
+	TArray<FWindow> Windows;
+
+	// Slide a window over the chunks in address order. For every last chunk, the window starts at the first chunk that
+	// keeps the used chunks inside of it relocatable and within budget. Free chunks cost nothing, so the window is
+	// always extended over an adjacent free chunk on the left, which also keeps destinations from touching the window.
+	int32 First = 0;
+	int64 BytesToMove = 0;
+	int32 NumMoves = 0;
+	for (int32 Last = 0; Last < Chunks.Num(); ++Last)
+	{
+		const FMemoryChunk* LastChunkInWindow = Chunks[Last];
+		if (!LastChunkInWindow->bIsAvailable)
+		{
+			// Chunks moved by an earlier plan this tick are still being copied by the GPU.
+			if (LastChunkInWindow->IsRelocating() || !CanRelocate(LastChunkInWindow) || LastChunkInWindow->Size > ByteBudget)
+			{
+				First = Last + 1;
+				BytesToMove = 0;
+				NumMoves = 0;
+				continue;
+			}
+
+			BytesToMove += LastChunkInWindow->Size;
+			NumMoves++;
+			while (BytesToMove > ByteBudget || NumMoves > MaxMoves)
+			{
+				const FMemoryChunk* FirstChunkInWindow = Chunks[First++];
+				if (!FirstChunkInWindow->bIsAvailable)
+				{
+					BytesToMove -= FirstChunkInWindow->Size;
+					NumMoves--;
+				}
+			}
+		}
+
+		// Only windows ending on a used chunk need evaluating; the free chunk following it extends the window for free.
+		if (LastChunkInWindow->bIsAvailable || NumMoves == 0)
+		{
+			continue;
+		}
+
+		int32 WindowFirst = First;
+		if (WindowFirst > 0 && Chunks[WindowFirst - 1]->bIsAvailable)
+		{
+			WindowFirst--;
+		}
+		int32 WindowLast = Last;
+		if (WindowLast + 1 < Chunks.Num() && Chunks[WindowLast + 1]->bIsAvailable)
+		{
+			WindowLast++;
+		}
+
+		const int64 Span = (Chunks[WindowLast]->Base + Chunks[WindowLast]->Size) - Chunks[WindowFirst]->Base;
+		if (Span > LargestFreeSize)
+		{
+			Windows.Add({ WindowFirst, WindowLast, Span, BytesToMove, double(Span - LargestFreeSize) / double(BytesToMove) });
+		}
+	}
+
+	// Best growth of the largest free chunk per byte copied first; ties go to the larger span.
+	Algo::Sort(Windows, [](const FWindow& A, const FWindow& B)
+	{
+		return A.Score > B.Score || (A.Score == B.Score && A.Span > B.Span);
+	});
+
+	struct FHole
+	{
+		uint8*	Base;
+		int64	Size;
+	};
+	TArray<FHole, TInlineAllocator<64>> Holes;
+	TArray<FMemoryChunk*, TInlineAllocator<16>> Sources;
+
+	// Only a handful of candidates are checked for placement, most windows either fit or the pool is too full for any.
+	const int32 MaxCandidates = FMath::Min(Windows.Num(), 8);
+	for (int32 CandidateIndex = 0; CandidateIndex < MaxCandidates; ++CandidateIndex)
+	{
+		const FWindow& Window = Windows[CandidateIndex];
+		const uint8* WindowBegin = Chunks[Window.First]->Base;
+		const uint8* WindowEnd = Chunks[Window.Last]->Base + Chunks[Window.Last]->Size;
+
+		Holes.Reset();
+		for (FMemoryChunk* FreeChunk = FirstFreeChunk; FreeChunk; FreeChunk = FreeChunk->NextFreeChunk)
+		{
+			// Free chunks whose memory the GPU is still copying from can't be written to yet.
+			if (!FreeChunk->IsRelocating() && (FreeChunk->Base + FreeChunk->Size <= WindowBegin || FreeChunk->Base >= WindowEnd))
+			{
+				Holes.Add({ FreeChunk->Base, FreeChunk->Size });
+			}
+		}
+
+		Sources.Reset();
+		for (int32 ChunkIndex = Window.First; ChunkIndex <= Window.Last; ++ChunkIndex)
+		{
+			if (!Chunks[ChunkIndex]->bIsAvailable)
+			{
+				Sources.Add(Chunks[ChunkIndex]);
+			}
+		}
+
+		// Place the largest sources first, each into the tightest hole.
+		Algo::Sort(Sources, [](const FMemoryChunk* A, const FMemoryChunk* B)
+		{
+			return A->Size > B->Size || (A->Size == B->Size && A->Base < B->Base);
+		});
+
+		OutMoves.Reset();
+		for (FMemoryChunk* Source : Sources)
+		{
+			int32 BestHole = INDEX_NONE;
+			for (int32 HoleIndex = 0; HoleIndex < Holes.Num(); ++HoleIndex)
+			{
+				if (Holes[HoleIndex].Size >= Source->Size && (BestHole == INDEX_NONE || Holes[HoleIndex].Size < Holes[BestHole].Size))
+				{
+					BestHole = HoleIndex;
+				}
+			}
+
+			if (BestHole == INDEX_NONE)
+			{
+				break;
+			}
+
+			OutMoves.Add({ Source, Holes[BestHole].Base });
+			Holes[BestHole].Base += Source->Size;
+			Holes[BestHole].Size -= Source->Size;
+		}
+
+		if (OutMoves.Num() == Sources.Num())
+		{
+			return Window.Span;
+		}
+	}
+
+	OutMoves.Reset();
+	return 0;
+}
+
+/**
+* Performs a partial defrag by executing compaction plans until the relocation budget is spent.
+*
+* @param Stats			[out] Stats
+* @param StartTime		Start time, used for limiting the Tick() time
+*/
+void FGPUDefragAllocator::PlannedDefragmentation(FRelocationStats& Stats, double StartTime)
+{
+	TArray<FCompactionMove> Moves;
+	while (PlanCompaction(Settings.MaxDefragRelocations - Stats.NumBytesRelocated, GGPUDefragMaxRelocations - Stats.NumRelocations, Moves) > 0)
+	{
+		for (const FCompactionMove& Move : Moves)
+		{
+			// Earlier moves of the plan have split the destination, the remainder starts where the plan expects it.
+			FMemoryChunk* FreeChunk = FindPreviousFreeChunk(Move.DestinationBase + 1);
+			check(FreeChunk && FreeChunk->Base == Move.DestinationBase && FreeChunk->Size >= Move.Source->Size);
+
+			RelocateIntoFreeChunk(Stats, FreeChunk, Move.Source);
+		}
+
+		// Limit time spent
+		double TimeSpent = FPlatformTime::Seconds() - StartTime;
+		if ((GGPUDefragEnableTimeLimits != 0) && (TimeSpent > PARTIALDEFRAG_TIMELIMIT))
+		{
+			break;
+		}
+	}
+}
+
 /**
 * Performs a partial defrag by shifting down memory to fill holes, in a brute-force manner.
 * Takes consideration to async reallocations, but processes the all memory in order.
@@ -1517,12 +1970,23 @@ int32 FGPUDefragAllocator::Tick(FRelocationStats& Stats, bool bPanicDefrag)
 	Relocations.Empty();	
 #endif
 
+#if GPU_DEFRAG_TRACE_RECORDING
+	if (bRecordingTrace)
+	{
+		TraceEvents.Add({ bPanicDefrag ? FAllocationTraceEvent::EType::PanicTick : FAllocationTraceEvent::EType::Tick, 0, 0 });
+	}
+#endif
+
 	// Sort the Free chunks.
 	SortFreeList(Stats.NumHoles, Stats.LargestHoleSize);
 
 	//if (ReallocationRequests.Num() || ReallocationRequestsInProgress.Num() || bPanicDefrag)
 	{
-		if (!bPanicDefrag)
+		if (!bPanicDefrag && UseCompactionPlannerOverride.Get(GGPUDefragCompactionPlanner != 0))
+		{
+			PlannedDefragmentation(Stats, StartTime);
+		}
+		else if (!bPanicDefrag)
 		{
 			// Smart defrag
 			PartialDefragmentationFast(Stats, StartTime);
@@ -1900,8 +2364,7 @@ void FGPUDefragAllocator::Coalesce(FMemoryChunk* FreedChunk)
 #endif
 
 	// Merge.
-	FreedChunk->Base -= LeftSize;
-	FreedChunk->Size += LeftSize + RightSize;
+	SetChunkExtent(FreedChunk, FreedChunk->Base - LeftSize, FreedChunk->Size + LeftSize + RightSize);
 	FreedChunk->SetSyncIndex(LatestSyncIndex, LatestSyncSize);
 
 #if TRACK_RELOCATIONS
@@ -1912,6 +2375,386 @@ void FGPUDefragAllocator::Coalesce(FMemoryChunk* FreedChunk)
 #endif
 }
 
+/**
+* Fragments the pool with random allocations and compares the indexed best-fit search against a full free list walk.
+*
+* @param MinChunkSize	Minimum number of bytes per random chunk
+* @param MaxChunkSize	Maximum number of bytes per random chunk
+* @param FreeRatio		Fraction 0.0-1.0 of the random chunks to free before searching
+*/
+void FGPUDefragAllocator::BenchmarkBestFit(int32 MinChunkSize, int32 MaxChunkSize, float FreeRatio)
+{
+	const int32 NumSearches = 100000;
+	FRandomStream Rand(0x1ee7c0de);
+	TArray<void*> Allocations;
+	Allocations.Reserve(4096);
+
+	// Fill the pool with randomly sized allocations...
+	for (;;)
+	{
+		const int64 AllocationSize = Align((int64)Rand.RandRange(MinChunkSize, MaxChunkSize), AllocationAlignment);
+		void* Pointer = Allocate(AllocationSize, AllocationAlignment, TStatId(), true);
+		if (!Pointer)
+		{
+			break;
+		}
+		Allocations.Add(Pointer);
+	}
+
+	// ... and punch random holes into it.
+	const int32 NumToFree = FMath::Clamp(FMath::TruncToInt32(Allocations.Num() * FreeRatio), 0, Allocations.Num());
+	for (int32 FreeIndex = 0; FreeIndex < NumToFree; ++FreeIndex)
+	{
+		const int32 AllocationIndex = Rand.RandHelper(Allocations.Num());
+		Free(Allocations[AllocationIndex]);
+		Allocations.RemoveAtSwap(AllocationIndex);
+	}
+
+	int32 NumFreeChunks = 0;
+	double IndexedSeconds = 0.0;
+	double LinearSeconds = 0.0;
+	{
+		FScopeLock Lock(&SynchronizationObject);
+
+		for (FMemoryChunk* Chunk = FirstFreeChunk; Chunk; Chunk = Chunk->NextFreeChunk)
+		{
+			++NumFreeChunks;
+		}
+
+		TArray<int64> SearchSizes;
+		SearchSizes.SetNumUninitialized(NumSearches);
+		for (int64& SearchSize : SearchSizes)
+		{
+			SearchSize = Align((int64)Rand.RandRange(MinChunkSize, MaxChunkSize), AllocationAlignment);
+		}
+
+		int64 IndexedChecksum = 0;
+		double StartTime = FPlatformTime::Seconds();
+		for (int64 SearchSize : SearchSizes)
+		{
+			const FMemoryChunk* Chunk = FindBestFit(SearchSize);
+			IndexedChecksum += Chunk ? Chunk->Size : 0;
+		}
+		IndexedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		int64 LinearChecksum = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int64 SearchSize : SearchSizes)
+		{
+			const FMemoryChunk* Chunk = FindBestFitLinear(SearchSize);
+			LinearChecksum += Chunk ? Chunk->Size : 0;
+		}
+		LinearSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// Both searches return the tightest fit; they may only pick different chunks of the same size.
+		ensureMsgf(NumRelocationsInProgress > 0 || IndexedChecksum == LinearChecksum, TEXT("Best-fit searches disagree (%" INT64_FMT " vs %" INT64_FMT ")"), IndexedChecksum, LinearChecksum);
+	}
+
+	for (void* Pointer : Allocations)
+	{
+		Free(Pointer);
+	}
+
+	UE_LOG(LogRHI, Log, TEXT("GPUDefragAllocator best-fit: %d free chunks, %d searches, indexed %.1f ns/search, linear %.1f ns/search (%.1fx)"),
+		NumFreeChunks, NumSearches,
+		IndexedSeconds * 1.0e9 / NumSearches,
+		LinearSeconds * 1.0e9 / NumSearches,
+		IndexedSeconds > 0.0 ? LinearSeconds / IndexedSeconds : 0.0);
+}
+
+#if GPU_DEFRAG_TRACE_RECORDING
+void FGPUDefragAllocator::StartTraceRecording()
+{
+	FScopeLock Lock(&SynchronizationObject);
+	bRecordingTrace = true;
+	NextTraceAllocationId = 0;
+	TraceEvents.Reset();
+	TraceAllocationIds.Reset();
+}
+
+void FGPUDefragAllocator::StopTraceRecording(TArray<FAllocationTraceEvent>& OutEvents)
+{
+	FScopeLock Lock(&SynchronizationObject);
+	bRecordingTrace = false;
+	OutEvents = MoveTemp(TraceEvents);
+	TraceAllocationIds.Empty();
+}
+#endif
+
+/**
+* CPU-only allocator used to replay allocation traces. Relocations only count the bytes they would copy, so the pool
+* memory is never touched.
+*/
+class FTraceReplayDefragAllocator final : public FGPUDefragAllocator
+{
+public:
+	FTraceReplayDefragAllocator(int64 PoolSize, int32 InAllocationAlignment, const FSettings& InSettings, bool bUseCompactionPlanner)
+	{
+		UseCompactionPlannerOverride = bUseCompactionPlanner;
+		DefragRandomStream = &RandomStream;
+		SetSettings(InSettings);
+
+		// The pool is only used for its address range.
+		PoolMemory = (uint8*)FMemory::Malloc(PoolSize, InAllocationAlignment);
+		Initialize(PoolMemory, PoolSize, InAllocationAlignment);
+	}
+
+	virtual ~FTraceReplayDefragAllocator()
+	{
+		FinishAllRelocations();
+		while (FirstChunk)
+		{
+			delete FirstChunk;
+		}
+		FMemory::Free(PoolMemory);
+	}
+
+	double GetFragmentation() const
+	{
+		int64 LargestHole = 0;
+		for (FMemoryChunk* Chunk = FirstFreeChunk; Chunk; Chunk = Chunk->NextFreeChunk)
+		{
+			LargestHole = FMath::Max(LargestHole, Chunk->Size);
+		}
+		return AvailableMemorySize > 0 ? 1.0 - double(LargestHole) / double(AvailableMemorySize) : 0.0;
+	}
+
+	/** Updates the current base address of every live allocation, identified by its user payload. */
+	void UpdateLiveAllocations(TMap<uint32, void*>& LiveAllocations) const
+	{
+		for (FMemoryChunk* Chunk = FirstChunk; Chunk; Chunk = Chunk->NextChunk)
+		{
+			// Locked chunks are the in-flight tails of adjacent relocations, not allocations of the trace.
+			if (!Chunk->bIsAvailable && !Chunk->IsLocked() && Chunk->UserPayload)
+			{
+				if (void** Pointer = LiveAllocations.Find(uint32(UPTRINT(Chunk->UserPayload) - 1)))
+				{
+					*Pointer = Chunk->Base;
+				}
+			}
+		}
+	}
+
+protected:
+	virtual void	PlatformRelocate(void* Dest, const void* Source, int64 Size, void* UserPayload) override { NumBytesCopied += Size; }
+	virtual uint64	PlatformInsertFence() override { return 0; }
+	virtual void	PlatformBlockOnFence(uint64 Fence) override {}
+	virtual bool	PlatformCanRelocate(const void* Source, void* UserPayload) const override { return true; }
+	virtual void	PlatformNotifyReallocationFinished(FAsyncReallocationRequest* FinishedRequest, void* UserPayload) override {}
+
+public:
+	/** Bytes actually copied. Unlike FRelocationStats::NumBytesRelocated, overlapped moves aren't penalized. */
+	int64 NumBytesCopied = 0;
+
+private:
+	uint8* PoolMemory;
+
+	/** Seeded identically for every replay so the greedy defrag retry delays are reproducible. */
+	FRandomStream RandomStream { 0x1ee7c0de };
+};
+
+/**
+* Replays an allocation trace on a CPU-only allocator.
+*/
+void FGPUDefragAllocator::ReplayTrace(TConstArrayView<FAllocationTraceEvent> Events, int64 PoolSize, int32 AllocationAlignment, const FSettings& Settings, bool bUseCompactionPlanner, FTraceReplayStats& OutStats)
+{
+	OutStats = FTraceReplayStats();
+
+	// Time limits would make the replay depend on the machine. The random retry delays of the greedy defrag come from the
+	// replay allocator's own seeded stream, so the global random state is left alone.
+	TGuardValue<int32> TimeLimitsGuard(GGPUDefragEnableTimeLimits, 0);
+
+	FTraceReplayDefragAllocator Allocator(Align(PoolSize, AllocationAlignment), AllocationAlignment, Settings, bUseCompactionPlanner);
+	TMap<uint32, void*> LiveAllocations;
+	double FragmentationSum = 0.0;
+
+	for (const FAllocationTraceEvent& Event : Events)
+	{
+		switch (Event.Type)
+		{
+		case FAllocationTraceEvent::EType::Allocate:
+			if (void* Pointer = Allocator.Allocate(Event.Size, AllocationAlignment, TStatId(), true))
+			{
+				// The payload follows the allocation through relocations, see UpdateLiveAllocations().
+				Allocator.SetUserPayload(Pointer, (void*)(UPTRINT(Event.AllocationId) + 1));
+				LiveAllocations.Add(Event.AllocationId, Pointer);
+			}
+			else
+			{
+				OutStats.NumFailedAllocations++;
+			}
+			break;
+
+		case FAllocationTraceEvent::EType::Free:
+			{
+				void* Pointer = nullptr;
+				if (LiveAllocations.RemoveAndCopyValue(Event.AllocationId, Pointer))
+				{
+					Allocator.Free(Pointer);
+				}
+			}
+			break;
+
+		case FAllocationTraceEvent::EType::Tick:
+		case FAllocationTraceEvent::EType::PanicTick:
+			{
+				FRelocationStats Stats;
+				Allocator.Tick(Stats, Event.Type == FAllocationTraceEvent::EType::PanicTick);
+				OutStats.NumRelocations += Stats.NumRelocations;
+				OutStats.NumTicks++;
+				FragmentationSum += Allocator.GetFragmentation();
+
+				// Allocations only move during ticks.
+				if (Stats.NumRelocations > 0)
+				{
+					Allocator.UpdateLiveAllocations(LiveAllocations);
+				}
+			}
+			break;
+		}
+	}
+
+	Allocator.FinishAllRelocations();
+	OutStats.NumBytesRelocated = Allocator.NumBytesCopied;
+	OutStats.AverageFragmentation = OutStats.NumTicks > 0 ? FragmentationSum / OutStats.NumTicks : 0.0;
+	OutStats.FinalFragmentation = Allocator.GetFragmentation();
+
+	for (const TPair<uint32, void*>& Allocation : LiveAllocations)
+	{
+		Allocator.Free(Allocation.Value);
+	}
+}
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+/**
+* Generates a deterministic streaming-like trace: every frame allocates a few textures of random sizes, frees random
+* older ones to keep the pool about 75% full, and ticks the allocator.
+*/
+static void GenerateSyntheticDefragTrace(int64 PoolSize, int32 NumFrames, TArray<FGPUDefragAllocator::FAllocationTraceEvent>& OutEvents)
+{
+	using FAllocationTraceEvent = FGPUDefragAllocator::FAllocationTraceEvent;
+
+	FRandomStream Rand(0x1ee7c0de);
+	TArray<TPair<uint32, int64>> Live;
+	uint32 NextAllocationId = 0;
+	int64 LiveSize = 0;
+	const int64 TargetLiveSize = PoolSize * 3 / 4;
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const int32 NumAllocations = Rand.RandRange(1, 8);
+		for (int32 AllocationIndex = 0; AllocationIndex < NumAllocations; ++AllocationIndex)
+		{
+			// Mostly small mips, sometimes whole textures.
+			const int64 Size = int64(4 * 1024) << Rand.RandRange(0, Rand.FRand() < 0.9f ? 6 : 10);
+			OutEvents.Add({ FAllocationTraceEvent::EType::Allocate, NextAllocationId, Size });
+			Live.Emplace(NextAllocationId++, Size);
+			LiveSize += Size;
+		}
+
+		while (LiveSize > TargetLiveSize && Live.Num() > 0)
+		{
+			const int32 LiveIndex = Rand.RandHelper(Live.Num());
+			OutEvents.Add({ FAllocationTraceEvent::EType::Free, Live[LiveIndex].Key, 0 });
+			LiveSize -= Live[LiveIndex].Value;
+			Live.RemoveAtSwap(LiveIndex);
+		}
+
+		OutEvents.Add({ FAllocationTraceEvent::EType::Tick, 0, 0 });
+	}
+}
+
+static FAutoConsoleCommand GGPUDefragReplayTraceCmd(
+	TEXT("r.GPUDefrag.ReplayTrace"),
+	TEXT("Replays an allocation trace on a CPU-only allocator with both the greedy partial defrag and the compaction planner,\n")
+	TEXT("and logs bytes moved and fragmentation for each.\n")
+	TEXT("Usage: r.GPUDefrag.ReplayTrace [Filename] [PoolSizeMB] [BudgetKB]\n")
+	TEXT(" Filename: serialized TArray<FAllocationTraceEvent> from StopTraceRecording(). Uses a synthetic trace when omitted or '-'.\n")
+	TEXT(" PoolSizeMB: pool size, defaults to 256 MB for the synthetic trace and to 125% of the peak live size otherwise.\n")
+	TEXT(" BudgetKB: bytes that may be relocated per tick, defaults to the allocator default."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		using FAllocationTraceEvent = FGPUDefragAllocator::FAllocationTraceEvent;
+
+		const int32 AllocationAlignment = 4096;
+		int64 PoolSize = Args.Num() > 1 ? int64(FCString::Atoi(*Args[1])) * 1024 * 1024 : 0;
+		FGPUDefragAllocator::FSettings Settings;
+		if (Args.Num() > 2)
+		{
+			Settings.MaxDefragRelocations = FCString::Atoi(*Args[2]) * 1024;
+		}
+
+		TArray<FAllocationTraceEvent> Events;
+		if (Args.Num() > 0 && Args[0] != TEXT("-"))
+		{
+			TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Args[0]));
+			if (!Ar)
+			{
+				UE_LOG(LogRHI, Error, TEXT("r.GPUDefrag.ReplayTrace: Failed to open %s"), *Args[0]);
+				return;
+			}
+			*Ar << Events;
+
+			if (PoolSize <= 0)
+			{
+				TMap<uint32, int64> LiveSizes;
+				int64 LiveSize = 0;
+				int64 PeakLiveSize = 0;
+				for (const FAllocationTraceEvent& Event : Events)
+				{
+					if (Event.Type == FAllocationTraceEvent::EType::Allocate)
+					{
+						const int64 Size = Align(Event.Size, AllocationAlignment);
+						LiveSizes.Add(Event.AllocationId, Size);
+						LiveSize += Size;
+						PeakLiveSize = FMath::Max(PeakLiveSize, LiveSize);
+					}
+					else if (Event.Type == FAllocationTraceEvent::EType::Free)
+					{
+						int64 Size = 0;
+						if (LiveSizes.RemoveAndCopyValue(Event.AllocationId, Size))
+						{
+							LiveSize -= Size;
+						}
+						else
+						{
+							UE_LOG(LogRHI, Warning, TEXT("r.GPUDefrag.ReplayTrace: Skipping free of unknown allocation %u"), Event.AllocationId);
+						}
+					}
+				}
+				PoolSize = PeakLiveSize + PeakLiveSize / 4;
+			}
+		}
+		else
+		{
+			if (PoolSize <= 0)
+			{
+				PoolSize = 256 * 1024 * 1024;
+			}
+			GenerateSyntheticDefragTrace(PoolSize, 2000, Events);
+		}
+
+		UE_LOG(LogRHI, Display, TEXT("Replaying %d events on a %.1f MB pool, relocating up to %d KB per tick:"), Events.Num(), PoolSize / 1024.0 / 1024.0, Settings.MaxDefragRelocations / 1024);
+
+		for (int32 PolicyIndex = 0; PolicyIndex < 2; ++PolicyIndex)
+		{
+			const bool bUseCompactionPlanner = PolicyIndex == 1;
+			FGPUDefragAllocator::FTraceReplayStats Stats;
+			FGPUDefragAllocator::ReplayTrace(Events, PoolSize, AllocationAlignment, Settings, bUseCompactionPlanner, Stats);
+
+			UE_LOG(LogRHI, Display, TEXT("  %-8s: %.2f MB moved in %d relocations over %d ticks, fragmentation %.1f%% avg / %.1f%% final, %d failed allocations"),
+				bUseCompactionPlanner ? TEXT("Planner") : TEXT("Greedy"),
+				Stats.NumBytesRelocated / 1024.0 / 1024.0,
+				Stats.NumRelocations,
+				Stats.NumTicks,
+				Stats.AverageFragmentation * 100.0,
+				Stats.FinalFragmentation * 100.0,
+				Stats.NumFailedAllocations);
+		}
+	})
+);
+#endif
+
 /**
 * Performs a benchmark of the allocator and outputs the result to the log.
 *
@@ -1925,6 +2768,10 @@ void FGPUDefragAllocator::Coalesce(FMemoryChunk* FreedChunk)
 */
 void FGPUDefragAllocator::Benchmark(int32 MinChunkSize, int32 MaxChunkSize, float FreeRatio, float LockRatio, bool bFullDefrag, bool bSaveImages, const TCHAR* Filename)
 {
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	BenchmarkBestFit(MinChunkSize, MaxChunkSize, FreeRatio);
+#endif
+
 //untested
 #if 0
 #if !(UE_BUILD_SHIPPING ||UE_BUILD_TEST)
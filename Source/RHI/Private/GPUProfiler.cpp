@@ -779,12 +779,23 @@ namespace UE::RHI::GPUProfiler
 	{
 		TRACE_CPUPROFILER_EVENT_SCOPE(UE::RHI::GPUProfiler::ProcessEvents);
 
-		TArray<TSharedRef<FEventStream>> SharedStreams;
-		SharedStreams.Reserve(EventStreams.Num());
+		TArray<TSharedRef<FEventStream>, TInlineAllocator<8>> SharedStreams;
 
 		for (FEventStream& Stream : EventStreams)
 		{
-			if (!Stream.IsEmpty())
+			if (Stream.IsEmpty())
+			{
+				continue;
+			}
+
+			// Sinks consume each queue's streams in order, so streams for the same queue can be linked
+			// together. This hands the sinks one stream per queue rather than one per command list.
+			TSharedRef<FEventStream>* Existing = SharedStreams.FindByPredicate([&Stream](TSharedRef<FEventStream> const& Other) { return Other->Queue == Stream.Queue; });
+			if (Existing)
+			{
+				(*Existing)->Append(MoveTemp(Stream));
+			}
+			else
 			{
 				SharedStreams.Emplace(MakeShared<FEventStream>(MoveTemp(Stream)));
 			}
@@ -807,6 +818,80 @@ namespace UE::RHI::GPUProfiler
 		}
 	}
 
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	// Measures recording events into per-context streams, linking them per queue and walking them the way the sinks do.
+	// Never instantiated, so it is not registered as a sink. It derives from FEventSink only to use FIterator.
+	struct FEventStreamBenchmark : public FEventSink
+	{
+		static void Run(int32 NumEvents, int32 NumStreams)
+		{
+			const FQueue Queue(FQueue::EType::Graphics, 0, 0);
+			const int32 EventsPerStream = FMath::Max(NumEvents / NumStreams, 1);
+
+			TArray<FEventStream> Streams;
+			Streams.Reserve(NumStreams);
+
+			const uint64 RecordStart = FPlatformTime::Cycles64();
+			for (int32 StreamIndex = 0; StreamIndex < NumStreams; ++StreamIndex)
+			{
+				FEventStream& Stream = Streams.Emplace_GetRef(Queue);
+				for (int32 EventIndex = 0; EventIndex < EventsPerStream; EventIndex += 3)
+				{
+					Stream.Emplace<FEvent::FBeginWork>(RecordStart + EventIndex);
+					Stream.Emplace<FEvent::FStats>() = { 1, 0, 3, 3 };
+					Stream.Emplace<FEvent::FEndWork>(RecordStart + EventIndex + 1);
+				}
+			}
+			const uint64 RecordEnd = FPlatformTime::Cycles64();
+
+			TSharedRef<FEventStream> Merged = MakeShared<FEventStream>(Queue);
+			for (FEventStream& Stream : Streams)
+			{
+				Merged->Append(MoveTemp(Stream));
+			}
+
+			uint64 NumConsumed = 0;
+			uint64 NumDraws = 0;
+			{
+				FIterator Iterator(Merged);
+				while (FEvent const* Event = Iterator.Pop())
+				{
+					if (Event->GetType() == FEvent::EType::Stats)
+					{
+						NumDraws += Event->Value.Get<FEvent::FStats>().NumDraws;
+					}
+					++NumConsumed;
+				}
+			}
+			const uint64 ConsumeEnd = FPlatformTime::Cycles64();
+
+			Streams.Reset();
+			Merged = MakeShared<FEventStream>(Queue);
+			const uint64 FreeEnd = FPlatformTime::Cycles64();
+
+			const double RecordSeconds = FPlatformTime::ToSeconds64(RecordEnd - RecordStart);
+			const double ConsumeSeconds = FPlatformTime::ToSeconds64(ConsumeEnd - RecordEnd);
+			const double FreeSeconds = FPlatformTime::ToSeconds64(FreeEnd - ConsumeEnd);
+
+			UE_LOG(LogRHI, Display, TEXT("GPU profiler event stream: %llu events (%llu draws) in %d streams."), NumConsumed, NumDraws, NumStreams);
+			UE_LOG(LogRHI, Display, TEXT("  Record:  %8.3f ms (%.1f M events/s)"), RecordSeconds * 1000.0, RecordSeconds > 0.0 ? NumConsumed / RecordSeconds / 1e6 : 0.0);
+			UE_LOG(LogRHI, Display, TEXT("  Consume: %8.3f ms (%.1f M events/s)"), ConsumeSeconds * 1000.0, ConsumeSeconds > 0.0 ? NumConsumed / ConsumeSeconds / 1e6 : 0.0);
+			UE_LOG(LogRHI, Display, TEXT("  Free:    %8.3f ms"), FreeSeconds * 1000.0);
+		}
+	};
+
+	static FAutoConsoleCommand GCommand_BenchmarkEventStream(
+		TEXT("r.GPUProfiler.BenchmarkEventStream"),
+		TEXT("Records, links and consumes synthetic GPU profiler events on the calling thread and logs the event throughput.\n")
+		TEXT("Usage: r.GPUProfiler.BenchmarkEventStream [NumEvents=1000000] [NumStreams=64]. Run it twice to measure with a warm chunk pool."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumEvents = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000000;
+			const int32 NumStreams = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 64;
+			FEventStreamBenchmark::Run(NumEvents, NumStreams);
+		}));
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
 #if WITH_PROFILEGPU
 	template <uint32 Width>
 	struct TUnicodeHorizontalBar
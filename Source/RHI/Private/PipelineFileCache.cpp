@@ -25,6 +25,8 @@ PipelineFileCache.cpp: Pipeline state cache implementation.
 #include "String/LexFromString.h"
 #include "String/ParseTokens.h"
 #include "Misc/ScopeExit.h"
+#include "Async/MappedFileHandle.h"
+#include "Algo/StableSort.h"
 #include <Algo/ForEach.h>
 
 static FString JOURNAL_FILE_EXTENSION(TEXT(".jnl"));
@@ -86,12 +88,14 @@ enum class EPipelineCacheFileFormatVersions : uint32
 	AddingDepthBounds = 28,
 	AddRTPSOShaderBindingLayout = 29,
 	VariableRateShading = 30,
+	FixedStrideTOC = 31,
+	CompileCost = 32,
 };
 
 const uint64 FPipelineCacheFileFormatMagic = 0x5049504543414348; // PIPECACH
 const uint64 FPipelineCacheTOCFileFormatMagic = 0x544F435354415232; // TOCSTAR2
 const uint64 FPipelineCacheEOFFileFormatMagic = 0x454F462D4D41524B; // EOF-MARK
-const RHI_API uint32 FPipelineCacheFileFormatCurrentVersion = (uint32)EPipelineCacheFileFormatVersions::AddRTPSOShaderBindingLayout;
+const RHI_API uint32 FPipelineCacheFileFormatCurrentVersion = (uint32)EPipelineCacheFileFormatVersions::CompileCost;
 const int32  FPipelineCacheGraphicsDescPartsNum = 67; // parser will expect this number of parts in a description string
 
 /**
@@ -162,6 +166,47 @@ static TAutoConsoleVariable<int32> CVarLazyLoadShadersWhenPSOCacheIsPresent(
 	TEXT("Non-Zero: If we load a PSO cache, then lazy load from the shader code library. This assumes the PSO cache is more or less complete. This will only work on RHIs that support the library+Hash CreateShader API (GRHISupportsLazyShaderCodeLoading == true)."),
 	ECVF_RenderThreadSafe);
 
+static TAutoConsoleVariable<int32> CVarPSOFileCacheMapBundledTOC(
+	TEXT("r.ShaderPipelineCache.MapBundledTOC"),
+	1,
+	TEXT("1 (default) memory-maps the table of contents of the bundled PSO cache and decodes entries on demand instead of deserializing the whole table at startup. ")
+	TEXT("Falls back to a single read of the table if the platform cannot map files. 0 always deserializes the table."),
+	ECVF_ReadOnly);
+
+static float GPSOFileCacheCostModelDefaultCompileTimeMs = 5.0f;
+static FAutoConsoleVariableRef CVarPSOFileCacheCostModelDefaultCompileTimeMs(
+	TEXT("r.ShaderPipelineCache.CostModel.DefaultCompileTimeMs"),
+	GPSOFileCacheCostModelDefaultCompileTimeMs,
+	TEXT("Creation time (in ms) assumed by the CostModel sort order for PSOs whose creation time was never recorded."),
+	ECVF_Default
+);
+
+static int32 GPSOFileCacheCostModelFirstUseFrames = 600;
+static FAutoConsoleVariableRef CVarPSOFileCacheCostModelFirstUseFrames(
+	TEXT("r.ShaderPipelineCache.CostModel.FirstUseFrames"),
+	GPSOFileCacheCostModelFirstUseFrames,
+	TEXT("Frame scale of the CostModel sort order: a PSO first used this many frames into a run weighs half as much as one needed on the first frame."),
+	ECVF_Default
+);
+
+/**
+ * Expected hitch cost used by PSOOrder::CostModel: the recorded creation time, scaled up by how often creating the PSO hitched,
+ * by how much it is used and by how early in a run it is first needed. PSOs that were never used rank last.
+ */
+static double GetPSOPrecompilePriority(int64 FirstFrameUsed, int64 TotalBindCount, int32 MaxCompileTimeUs, int32 RuntimeHitchCount)
+{
+	const double CompileTimeMs = MaxCompileTimeUs > 0 ? MaxCompileTimeUs / 1000.0 : (double)GPSOFileCacheCostModelDefaultCompileTimeMs;
+	const double HitchWeight = 1.0 + FMath::Max(RuntimeHitchCount, 0);
+	const double UseWeight = FMath::Loge(2.0 + (double)FMath::Max<int64>(TotalBindCount, 0));
+	const double Urgency = FirstFrameUsed >= 0 ? 1.0 / (1.0 + (double)FirstFrameUsed / FMath::Max(GPSOFileCacheCostModelFirstUseFrames, 1)) : 0.0;
+	return CompileTimeMs * HitchWeight * UseWeight * Urgency;
+}
+
+static double GetPSOPrecompilePriority(FPipelineStateStats const& Stats)
+{
+	return GetPSOPrecompilePriority(Stats.FirstFrameUsed, Stats.TotalBindCount, Stats.MaxCompileTimeUs, Stats.RuntimeHitchCount);
+}
+
 static TAutoConsoleVariable<int32> CVarClearOSPSOFileCache(
 														   TEXT("r.ShaderPipelineCache.ClearOSCache"),
 														   0,
@@ -251,6 +296,29 @@ void FPipelineStateStats::UpdateStats(FPipelineStateStats* Stats)
 	}
 }
 
+void FPipelineStateStats::UpdateCompileStats(FPipelineStateStats* Stats, uint64 CompileCycles, bool bRuntimeHitch)
+{
+	if (Stats)
+	{
+		const int32 CompileTimeUs = (int32)FMath::Min(FPlatformTime::ToMilliseconds64(CompileCycles) * 1000.0, (double)MAX_int32);
+		int32 Current = FPlatformAtomics::AtomicRead(&Stats->MaxCompileTimeUs);
+		while (CompileTimeUs > Current)
+		{
+			const int32 Previous = FPlatformAtomics::InterlockedCompareExchange(&Stats->MaxCompileTimeUs, CompileTimeUs, Current);
+			if (Previous == Current)
+			{
+				break;
+			}
+			Current = Previous;
+		}
+
+		if (bRuntimeHitch)
+		{
+			FPlatformAtomics::InterlockedIncrement(&Stats->RuntimeHitchCount);
+		}
+	}
+}
+
 struct FPipelineCacheFileFormatHeader
 {
 	uint64 Magic;			// Sanity check
@@ -286,6 +354,12 @@ FArchive& operator<<( FArchive& Ar, FPipelineStateStats& Info )
 	Ar << Info.CreateCount;
 	Ar << Info.TotalBindCount;
 	Ar << Info.PSOHash;
+
+	if (Ar.GameNetVer() >= (uint32)EPipelineCacheFileFormatVersions::CompileCost)
+	{
+		Ar << Info.MaxCompileTimeUs;
+		Ar << Info.RuntimeHitchCount;
+	}
 	
 	return Ar;
 }
@@ -1719,6 +1793,69 @@ FPipelineCacheFileFormatPSO& FPipelineCacheFileFormatPSO::operator=(const FPipel
 	return *this;
 }
 
+/**
+ * Fixed-stride TOC record used from EPipelineCacheFileFormatVersions::FixedStrideTOC onwards.
+ * Records are stored sorted by PSO hash so that the table can be binary searched in place, and are serialized
+ * field by field in declaration order so that the on-disk layout matches this struct (the struct has no padding).
+ */
+struct FPipelineCacheFileFormatTOCEntry
+{
+	uint64 FileOffset;
+	uint64 FileSize;
+	uint64 UsageMask;
+	int64  LastUsedUnixTime;
+	int64  FirstFrameUsed;
+	int64  LastFrameUsed;
+	uint64 CreateCount;
+	int64  TotalBindCount;
+	uint32 PSOHash;
+	uint32 FirstShader;		// index of the first shader hash in the TOC shader table
+	uint32 GuidIndex;		// index into the TOC guid table
+	uint16 NumShaders;
+	uint16 EngineFlags;
+	int32  MaxCompileTimeUs;	// from EPipelineCacheFileFormatVersions::CompileCost
+	int32  RuntimeHitchCount;	// from EPipelineCacheFileFormatVersions::CompileCost
+
+	/** Size of a record in a TOC saved with the given file format version. */
+	static uint64 GetSerializedSize(uint32 Version)
+	{
+		return Version >= (uint32)EPipelineCacheFileFormatVersions::CompileCost ? sizeof(FPipelineCacheFileFormatTOCEntry) : STRUCT_OFFSET(FPipelineCacheFileFormatTOCEntry, MaxCompileTimeUs);
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FPipelineCacheFileFormatTOCEntry& Entry)
+	{
+		Ar << Entry.FileOffset;
+		Ar << Entry.FileSize;
+		Ar << Entry.UsageMask;
+		Ar << Entry.LastUsedUnixTime;
+		Ar << Entry.FirstFrameUsed;
+		Ar << Entry.LastFrameUsed;
+		Ar << Entry.CreateCount;
+		Ar << Entry.TotalBindCount;
+		Ar << Entry.PSOHash;
+		Ar << Entry.FirstShader;
+		Ar << Entry.GuidIndex;
+		Ar << Entry.NumShaders;
+		Ar << Entry.EngineFlags;
+		if (Ar.GameNetVer() >= (uint32)EPipelineCacheFileFormatVersions::CompileCost)
+		{
+			Ar << Entry.MaxCompileTimeUs;
+			Ar << Entry.RuntimeHitchCount;
+		}
+		else if (Ar.IsLoading())
+		{
+			Entry.MaxCompileTimeUs = 0;
+			Entry.RuntimeHitchCount = 0;
+		}
+		return Ar;
+	}
+};
+static_assert(sizeof(FPipelineCacheFileFormatTOCEntry) == 88, "FPipelineCacheFileFormatTOCEntry must not contain padding, it is read in place from mapped TOCs.");
+static_assert(sizeof(FSHAHash) == 20 && sizeof(FGuid) == 16, "Mapped TOC tables assume packed shader hashes and guids.");
+
+/** Size of the fixed-stride TOC prefix: TOC magic, sorted order, then entry, shader and guid counts. */
+static constexpr uint64 FPipelineCacheFixedStrideTOCPrefixSize = sizeof(uint64) + sizeof(uint32) * 4;
+
 struct FPipelineCacheFileFormatTOC
 {
 	FPipelineCacheFileFormatTOC()
@@ -1737,11 +1874,194 @@ struct FPipelineCacheFileFormatTOC
 		UE_LOG(LogRHI, VeryVerbose, TEXT("Total PSOs %d"), MetaData.Num());
 	}
 
+	static bool CheckMagic(FArchive& Ar)
+	{
+		uint64 TOCMagic = 0;
+		Ar << TOCMagic;
+		if (FPipelineCacheTOCFileFormatMagic != TOCMagic)
+		{
+			return false;
+		}
+
+		uint64 EOFMagic = 0;
+		const int64 FileSize = Ar.TotalSize();
+		const int64 FilePosition = Ar.Tell();
+		Ar.Seek(FileSize - sizeof(FPipelineCacheEOFFileFormatMagic));
+		Ar << EOFMagic;
+		Ar.Seek(FilePosition);
+
+		return FPipelineCacheEOFFileFormatMagic == EOFMagic;
+	}
+
+	/**
+	 * Fixed-stride layout: prefix, entries sorted by PSO hash, the entry indices in SortedOrder, the shader hash table, the guid table and the EOF marker.
+	 * FPipelineCacheFileMappedTOC reads the same layout in place.
+	 */
+	static void SerializeFixedStride(FArchive& Ar, FPipelineCacheFileFormatTOC& Info)
+	{
+		TArray<FPipelineCacheFileFormatTOCEntry> Entries;
+		TArray<uint32> Order;
+		TArray<FSHAHash> Shaders;
+		TArray<FGuid> Guids;
+
+		if (Ar.IsLoading())
+		{
+			if (!CheckMagic(Ar))
+			{
+				Ar.SetError();
+				return;
+			}
+		}
+		else
+		{
+			uint64 TOCMagic = FPipelineCacheTOCFileFormatMagic;
+			Ar << TOCMagic;
+
+			TMap<FGuid, uint32> GuidIndices;
+			Entries.Reserve(Info.MetaData.Num());
+
+			for (const TPair<uint32, FPipelineCacheFileFormatPSOMetaData>& Pair : Info.MetaData)
+			{
+				const FPipelineCacheFileFormatPSOMetaData& Meta = Pair.Value;
+				check(Meta.Shaders.Num() <= MAX_uint16);
+
+				FPipelineCacheFileFormatTOCEntry& Entry = Entries.AddDefaulted_GetRef();
+				Entry.FileOffset = Meta.FileOffset;
+				Entry.FileSize = Meta.FileSize;
+				Entry.UsageMask = Meta.UsageMask;
+				Entry.LastUsedUnixTime = Meta.LastUsedUnixTime;
+				Entry.FirstFrameUsed = Meta.Stats.FirstFrameUsed;
+				Entry.LastFrameUsed = Meta.Stats.LastFrameUsed;
+				Entry.CreateCount = Meta.Stats.CreateCount;
+				Entry.TotalBindCount = Meta.Stats.TotalBindCount;
+				Entry.MaxCompileTimeUs = Meta.Stats.MaxCompileTimeUs;
+				Entry.RuntimeHitchCount = Meta.Stats.RuntimeHitchCount;
+				Entry.PSOHash = Pair.Key;
+				Entry.FirstShader = Shaders.Num();
+				Entry.NumShaders = uint16(Meta.Shaders.Num());
+				Entry.EngineFlags = Meta.EngineFlags;
+
+				for (const FSHAHash& Shader : Meta.Shaders)
+				{
+					Shaders.Add(Shader);
+				}
+
+				uint32* GuidIndex = GuidIndices.Find(Meta.FileGuid);
+				Entry.GuidIndex = GuidIndex ? *GuidIndex : GuidIndices.Add(Meta.FileGuid, Guids.Add(Meta.FileGuid));
+			}
+
+			// The map iteration order is the sorted order, remember it before sorting the records by hash.
+			TArray<uint32> SortedIndices;
+			SortedIndices.SetNumUninitialized(Entries.Num());
+			for (int32 Index = 0; Index < Entries.Num(); ++Index)
+			{
+				SortedIndices[Index] = Index;
+			}
+			SortedIndices.Sort([&Entries](uint32 A, uint32 B) { return Entries[A].PSOHash < Entries[B].PSOHash; });
+
+			TArray<FPipelineCacheFileFormatTOCEntry> SortedEntries;
+			SortedEntries.SetNumUninitialized(Entries.Num());
+			Order.SetNumUninitialized(Entries.Num());
+			for (int32 Position = 0; Position < SortedIndices.Num(); ++Position)
+			{
+				SortedEntries[Position] = Entries[SortedIndices[Position]];
+				Order[SortedIndices[Position]] = Position;
+			}
+			Entries = MoveTemp(SortedEntries);
+		}
+
+		Ar << Info.SortedOrder;
+
+		uint32 NumEntries = Entries.Num();
+		uint32 NumShaders = Shaders.Num();
+		uint32 NumGuids = Guids.Num();
+		Ar << NumEntries;
+		Ar << NumShaders;
+		Ar << NumGuids;
+
+		if (Ar.IsLoading())
+		{
+			const uint64 TableSize = uint64(NumEntries) * (FPipelineCacheFileFormatTOCEntry::GetSerializedSize(Ar.GameNetVer()) + sizeof(uint32)) + uint64(NumShaders) * sizeof(FSHAHash) + uint64(NumGuids) * sizeof(FGuid);
+			if (Ar.Tell() + TableSize + sizeof(FPipelineCacheEOFFileFormatMagic) > uint64(Ar.TotalSize()))
+			{
+				Ar.SetError();
+				return;
+			}
+
+			Entries.SetNumUninitialized(NumEntries);
+			Order.SetNumUninitialized(NumEntries);
+			Shaders.SetNum(NumShaders);
+			Guids.SetNum(NumGuids);
+		}
+
+		for (FPipelineCacheFileFormatTOCEntry& Entry : Entries)
+		{
+			Ar << Entry;
+		}
+		for (uint32& Index : Order)
+		{
+			Ar << Index;
+		}
+		for (FSHAHash& Shader : Shaders)
+		{
+			Ar << Shader;
+		}
+		for (FGuid& Guid : Guids)
+		{
+			Ar << Guid;
+		}
+
+		if (Ar.IsSaving())
+		{
+			uint64 EOFMagic = FPipelineCacheEOFFileFormatMagic;
+			Ar << EOFMagic;
+		}
+		else
+		{
+			Info.MetaData.Empty(NumEntries);
+
+			for (uint32 Position : Order)
+			{
+				if (Position >= NumEntries || Entries[Position].FirstShader + uint64(Entries[Position].NumShaders) > NumShaders || Entries[Position].GuidIndex >= NumGuids)
+				{
+					Ar.SetError();
+					return;
+				}
+
+				const FPipelineCacheFileFormatTOCEntry& Entry = Entries[Position];
+				FPipelineCacheFileFormatPSOMetaData& Meta = Info.MetaData.Add(Entry.PSOHash);
+				Meta.FileOffset = Entry.FileOffset;
+				Meta.FileSize = Entry.FileSize;
+				Meta.FileGuid = Guids[Entry.GuidIndex];
+				Meta.Stats.FirstFrameUsed = Entry.FirstFrameUsed;
+				Meta.Stats.LastFrameUsed = Entry.LastFrameUsed;
+				Meta.Stats.CreateCount = Entry.CreateCount;
+				Meta.Stats.TotalBindCount = Entry.TotalBindCount;
+				Meta.Stats.MaxCompileTimeUs = Entry.MaxCompileTimeUs;
+				Meta.Stats.RuntimeHitchCount = Entry.RuntimeHitchCount;
+				Meta.Stats.PSOHash = Entry.PSOHash;
+				for (uint32 ShaderIndex = Entry.FirstShader; ShaderIndex < Entry.FirstShader + Entry.NumShaders; ++ShaderIndex)
+				{
+					Meta.Shaders.Add(Shaders[ShaderIndex]);
+				}
+				Meta.UsageMask = Entry.UsageMask;
+				Meta.LastUsedUnixTime = Entry.LastUsedUnixTime;
+				Meta.EngineFlags = Entry.EngineFlags;
+			}
+		}
+	}
+
 	friend FArchive& operator<<(FArchive& Ar, FPipelineCacheFileFormatTOC& Info)
 	{
 		// TOC is assumed to be at the end of the file
 		// If this changes then the EOF read check and write need to moved out of here
 
+		if (Ar.GameNetVer() >= (uint32)EPipelineCacheFileFormatVersions::FixedStrideTOC)
+		{
+			SerializeFixedStride(Ar, Info);
+			return Ar;
+		}
+
 		// if all entries are using the same GUID (which is the norm when saving a packaged cache with the "buildsc" command of the commandlet),
 		// do not save it with every entry, reducing the surface of changes (GUID is regenerated on each save even if entries are the same)
 		bool bAllEntriesUseSameGuid = true;
@@ -1749,22 +2069,7 @@ struct FPipelineCacheFileFormatTOC
 
 		if(Ar.IsLoading())
 		{
-			uint64 TOCMagic = 0;
-			Ar << TOCMagic;
-			if(FPipelineCacheTOCFileFormatMagic != TOCMagic)
-			{
-				Ar.SetError();
-				return Ar;
-			}
-			
-			uint64 EOFMagic = 0;
-			const int64 FileSize = Ar.TotalSize();
-			const int64 FilePosition = Ar.Tell();
-			Ar.Seek(FileSize - sizeof(FPipelineCacheEOFFileFormatMagic));
-			Ar << EOFMagic;
-			Ar.Seek(FilePosition);
-
-			if(FPipelineCacheEOFFileFormatMagic != EOFMagic)
+			if (!CheckMagic(Ar))
 			{
 				Ar.SetError();
 				return Ar;
@@ -1838,6 +2143,232 @@ struct FPipelineCacheFileFormatTOC
 	}
 };
 
+/**
+ * Read-only view of a fixed-stride TOC that stays in the cache file. The table is memory-mapped when the platform supports it
+ * and read with a single request otherwise; records are only decoded when they are looked up.
+ */
+class FPipelineCacheFileMappedTOC
+{
+public:
+	static TUniquePtr<FPipelineCacheFileMappedTOC> Open(const FString& FilePath, uint64 TableOffset)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+		const int64 FileSize = PlatformFile.FileSize(*FilePath);
+		if (FileSize <= 0 || TableOffset + FPipelineCacheFixedStrideTOCPrefixSize + sizeof(FPipelineCacheEOFFileFormatMagic) > uint64(FileSize))
+		{
+			return nullptr;
+		}
+
+		const int64 TableSize = FileSize - int64(TableOffset);
+		TUniquePtr<FPipelineCacheFileMappedTOC> TOC(new FPipelineCacheFileMappedTOC);
+
+		FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*FilePath);
+		if (MappedResult.HasValue())
+		{
+			TOC->MappedFileHandle = MappedResult.StealValue();
+			TOC->MappedFileRegion.Reset(TOC->MappedFileHandle->MapRegion(int64(TableOffset), TableSize));
+		}
+
+		if (TOC->MappedFileRegion.IsValid())
+		{
+			TOC->Data = TOC->MappedFileRegion->GetMappedPtr();
+			TOC->DataSize = TOC->MappedFileRegion->GetMappedSize();
+		}
+		else
+		{
+			TOC->MappedFileHandle.Reset();
+
+			TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenRead(*FilePath));
+			TOC->FallbackData.SetNumUninitialized(TableSize);
+			if (!FileHandle.IsValid() || !FileHandle->Seek(int64(TableOffset)) || !FileHandle->Read(TOC->FallbackData.GetData(), TableSize))
+			{
+				return nullptr;
+			}
+
+			TOC->Data = TOC->FallbackData.GetData();
+			TOC->DataSize = TOC->FallbackData.Num();
+		}
+
+		if (!TOC->ParseTables())
+		{
+			return nullptr;
+		}
+
+		UE_LOG(LogRHI, Log, TEXT("FPipelineCacheFile: %s TOC of %s with %u entries"), TOC->MappedFileRegion.IsValid() ? TEXT("mapped") : TEXT("read"), *FilePath, TOC->NumEntries);
+		return TOC;
+	}
+
+	int32 Num() const
+	{
+		return int32(NumEntries);
+	}
+
+	FPipelineFileCacheManager::PSOOrder GetSortedOrder() const
+	{
+		return SortedOrder;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return FallbackData.GetAllocatedSize();
+	}
+
+	FPipelineCacheFileFormatTOCEntry GetEntry(int32 Index) const
+	{
+		check(uint32(Index) < NumEntries);
+		FPipelineCacheFileFormatTOCEntry Entry;
+		FMemory::Memcpy(&Entry, Entries + Index * sizeof(FPipelineCacheFileFormatTOCEntry), sizeof(Entry));
+		return Entry;
+	}
+
+	uint32 GetPSOHash(int32 Index) const
+	{
+		return Read<uint32>(Entries + Index * sizeof(FPipelineCacheFileFormatTOCEntry) + STRUCT_OFFSET(FPipelineCacheFileFormatTOCEntry, PSOHash));
+	}
+
+	/** Index of the entry at the given position of the order the TOC was sorted in when saved. */
+	int32 GetEntryIndexInSortedOrder(int32 Position) const
+	{
+		check(uint32(Position) < NumEntries);
+		return int32(Read<uint32>(Order + Position * sizeof(uint32)));
+	}
+
+	int32 FindEntry(uint32 PSOHash) const
+	{
+		int32 First = 0;
+		int32 Count = int32(NumEntries);
+		while (Count > 0)
+		{
+			const int32 Step = Count / 2;
+			if (GetPSOHash(First + Step) < PSOHash)
+			{
+				First += Step + 1;
+				Count -= Step + 1;
+			}
+			else
+			{
+				Count = Step;
+			}
+		}
+		return (First < int32(NumEntries) && GetPSOHash(First) == PSOHash) ? First : INDEX_NONE;
+	}
+
+	FGuid GetFileGuid(const FPipelineCacheFileFormatTOCEntry& Entry) const
+	{
+		return ensure(Entry.GuidIndex < NumGuids) ? Read<FGuid>(Guids + Entry.GuidIndex * sizeof(FGuid)) : FGuid();
+	}
+
+	void GetShaders(const FPipelineCacheFileFormatTOCEntry& Entry, TSet<FSHAHash>& OutShaders) const
+	{
+		if (ensure(Entry.FirstShader + uint64(Entry.NumShaders) <= NumShaders))
+		{
+			OutShaders.Reserve(Entry.NumShaders);
+			for (uint32 Index = Entry.FirstShader; Index < Entry.FirstShader + Entry.NumShaders; ++Index)
+			{
+				OutShaders.Add(Read<FSHAHash>(Shaders + Index * sizeof(FSHAHash)));
+			}
+		}
+	}
+
+	void GetMetaData(const FPipelineCacheFileFormatTOCEntry& Entry, FPipelineCacheFileFormatPSOMetaData& OutMeta) const
+	{
+		OutMeta.FileOffset = Entry.FileOffset;
+		OutMeta.FileSize = Entry.FileSize;
+		OutMeta.FileGuid = GetFileGuid(Entry);
+		OutMeta.Stats.FirstFrameUsed = Entry.FirstFrameUsed;
+		OutMeta.Stats.LastFrameUsed = Entry.LastFrameUsed;
+		OutMeta.Stats.CreateCount = Entry.CreateCount;
+		OutMeta.Stats.TotalBindCount = Entry.TotalBindCount;
+		OutMeta.Stats.MaxCompileTimeUs = Entry.MaxCompileTimeUs;
+		OutMeta.Stats.RuntimeHitchCount = Entry.RuntimeHitchCount;
+		OutMeta.Stats.PSOHash = Entry.PSOHash;
+		OutMeta.UsageMask = Entry.UsageMask;
+		OutMeta.LastUsedUnixTime = Entry.LastUsedUnixTime;
+		OutMeta.EngineFlags = Entry.EngineFlags;
+		GetShaders(Entry, OutMeta.Shaders);
+	}
+
+	/** Decodes every entry, in sorted order, e.g. when merging caches. */
+	void AppendMetaData(TMap<uint32, FPipelineCacheFileFormatPSOMetaData>& OutMetaData) const
+	{
+		OutMetaData.Reserve(OutMetaData.Num() + Num());
+		for (int32 Position = 0; Position < Num(); ++Position)
+		{
+			const FPipelineCacheFileFormatTOCEntry Entry = GetEntry(GetEntryIndexInSortedOrder(Position));
+			GetMetaData(Entry, OutMetaData.Add(Entry.PSOHash));
+		}
+	}
+
+private:
+	FPipelineCacheFileMappedTOC() = default;
+
+	template<typename ValueType>
+	static ValueType Read(const uint8* Source)
+	{
+		// Records have no alignment guarantee inside the file.
+		ValueType Value;
+		FMemory::Memcpy(&Value, Source, sizeof(ValueType));
+		return Value;
+	}
+
+	bool ParseTables()
+	{
+		if (DataSize < FPipelineCacheFixedStrideTOCPrefixSize + sizeof(FPipelineCacheEOFFileFormatMagic) ||
+			Read<uint64>(Data) != FPipelineCacheTOCFileFormatMagic ||
+			Read<uint64>(Data + DataSize - sizeof(FPipelineCacheEOFFileFormatMagic)) != FPipelineCacheEOFFileFormatMagic)
+		{
+			return false;
+		}
+
+		SortedOrder = (FPipelineFileCacheManager::PSOOrder)Read<uint32>(Data + sizeof(uint64));
+		NumEntries = Read<uint32>(Data + sizeof(uint64) + sizeof(uint32));
+		NumShaders = Read<uint32>(Data + sizeof(uint64) + sizeof(uint32) * 2);
+		NumGuids = Read<uint32>(Data + sizeof(uint64) + sizeof(uint32) * 3);
+
+		const uint64 EntriesOffset = FPipelineCacheFixedStrideTOCPrefixSize;
+		const uint64 OrderOffset = EntriesOffset + uint64(NumEntries) * sizeof(FPipelineCacheFileFormatTOCEntry);
+		const uint64 ShadersOffset = OrderOffset + uint64(NumEntries) * sizeof(uint32);
+		const uint64 GuidsOffset = ShadersOffset + uint64(NumShaders) * sizeof(FSHAHash);
+		const uint64 EndOffset = GuidsOffset + uint64(NumGuids) * sizeof(FGuid);
+
+		if (EndOffset + sizeof(FPipelineCacheEOFFileFormatMagic) > DataSize)
+		{
+			return false;
+		}
+
+		Entries = Data + EntriesOffset;
+		Order = Data + OrderOffset;
+		Shaders = Data + ShadersOffset;
+		Guids = Data + GuidsOffset;
+
+		for (uint32 Position = 0; Position < NumEntries; ++Position)
+		{
+			if (Read<uint32>(Order + Position * sizeof(uint32)) >= NumEntries)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	TUniquePtr<IMappedFileHandle> MappedFileHandle;
+	TUniquePtr<IMappedFileRegion> MappedFileRegion;
+	TArray<uint8> FallbackData;
+
+	const uint8* Data = nullptr;
+	uint64 DataSize = 0;
+	const uint8* Entries = nullptr;
+	const uint8* Order = nullptr;
+	const uint8* Shaders = nullptr;
+	const uint8* Guids = nullptr;
+
+	FPipelineFileCacheManager::PSOOrder SortedOrder = FPipelineFileCacheManager::PSOOrder::Default;
+	uint32 NumEntries = 0;
+	uint32 NumShaders = 0;
+	uint32 NumGuids = 0;
+};
+
 static bool ShouldDeleteExistingUserCache()
 {
 	static bool bOnce = false;
@@ -1859,6 +2390,8 @@ class FPipelineCacheFile
 	uint64 TOCOffset;
 
 	FPipelineCacheFileFormatTOC TOC;
+	// Bundled caches keep their TOC in the file and decode entries on demand; TOC.MetaData stays empty in that case.
+	TUniquePtr<FPipelineCacheFileMappedTOC> MappedTOC;
 	FGuid FileGuid;
 	FString FilePath;
 	TSharedPtr<IAsyncReadFileHandle, ESPMode::ThreadSafe> AsyncFileHandle;
@@ -1883,10 +2416,43 @@ public:
 	}
 	~FPipelineCacheFile()
 	{
-		DEC_MEMORY_STAT_BY(STAT_FileCacheMemory, TOC.MetaData.GetAllocatedSize());
+		DEC_MEMORY_STAT_BY(STAT_FileCacheMemory, GetTOCAllocatedSize());
+	}
+
+	SIZE_T GetTOCAllocatedSize() const
+	{
+		return TOC.MetaData.GetAllocatedSize() + (MappedTOC.IsValid() ? MappedTOC->GetAllocatedSize() : 0);
+	}
+
+	/** Looks up an entry either in the deserialized TOC or in the mapped one, decoding only that entry. */
+	const FPipelineCacheFileFormatPSOMetaData* FindMetaData(uint32 PSOHash, FPipelineCacheFileFormatPSOMetaData& DecodedMeta) const
+	{
+		if (MappedTOC.IsValid())
+		{
+			const int32 Index = MappedTOC->FindEntry(PSOHash);
+			if (Index == INDEX_NONE)
+			{
+				return nullptr;
+			}
+			MappedTOC->GetMetaData(MappedTOC->GetEntry(Index), DecodedMeta);
+			return &DecodedMeta;
+		}
+		return TOC.MetaData.Find(PSOHash);
 	}
 
-	static bool OpenPipelineFileCache(const FString& FilePath, EShaderPlatform ShaderPlatform, FGuid& Guid, TSharedPtr<IAsyncReadFileHandle, ESPMode::ThreadSafe>& Handle, FPipelineCacheFileFormatTOC& Content, uint64& TOCOffsetOUT)
+	void AppendTOCMetaData(TMap<uint32, FPipelineCacheFileFormatPSOMetaData>& OutMetaData) const
+	{
+		if (MappedTOC.IsValid())
+		{
+			MappedTOC->AppendMetaData(OutMetaData);
+		}
+		else
+		{
+			OutMetaData.Append(TOC.MetaData);
+		}
+	}
+
+	static bool OpenPipelineFileCache(const FString& FilePath, EShaderPlatform ShaderPlatform, FGuid& Guid, TSharedPtr<IAsyncReadFileHandle, ESPMode::ThreadSafe>& Handle, FPipelineCacheFileFormatTOC& Content, uint64& TOCOffsetOUT, TUniquePtr<FPipelineCacheFileMappedTOC>* OutMappedTOC = nullptr)
 	{
 		bool bSuccess = false;
 
@@ -1908,11 +2474,24 @@ public:
 				
 				if(Header.TableOffset < (uint64)FileReader->TotalSize())
 				{
-					FileReader->Seek(Header.TableOffset);
-					*FileReader << Content;
-					
-					// FPipelineCacheFileFormatTOC archive read can set the FArchive to error on failure
-					bSuccess = !FileReader->IsError();
+					if (OutMappedTOC && CVarPSOFileCacheMapBundledTOC.GetValueOnAnyThread())
+					{
+						*OutMappedTOC = FPipelineCacheFileMappedTOC::Open(FilePath, Header.TableOffset);
+					}
+
+					if (OutMappedTOC && OutMappedTOC->IsValid())
+					{
+						Content.SortedOrder = (*OutMappedTOC)->GetSortedOrder();
+						bSuccess = true;
+					}
+					else
+					{
+						FileReader->Seek(Header.TableOffset);
+						*FileReader << Content;
+
+						// FPipelineCacheFileFormatTOC archive read can set the FArchive to error on failure
+						bSuccess = !FileReader->IsError();
+					}
 				}
 				
 				if(!bSuccess)
@@ -1941,13 +2520,18 @@ public:
 			
 			delete FileReader;
 			FileReader = nullptr;
+
+			if (!bSuccess && OutMappedTOC)
+			{
+				OutMappedTOC->Reset();
+			}
 			
 			if(bSuccess)
 			{
 				Handle = MakeShareable(FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*FilePath));
 				if(Handle.IsValid())
 				{
-					UE_LOG(LogRHI, Log, TEXT("Opened FPipelineCacheFile: %s (GUID: %s) with %d entries."), *FilePath, *Header.Guid.ToString(), Content.MetaData.Num());
+					UE_LOG(LogRHI, Log, TEXT("Opened FPipelineCacheFile: %s (GUID: %s) with %d entries."), *FilePath, *Header.Guid.ToString(), (OutMappedTOC && OutMappedTOC->IsValid()) ? (*OutMappedTOC)->Num() : Content.MetaData.Num());
 					
 					Guid = Header.Guid;
 					TOCOffsetOUT = Header.TableOffset;
@@ -2155,6 +2739,7 @@ public:
 		OutGameFileGuid = FGuid();
 		TOC.SortedOrder = FPipelineFileCacheManager::PSOOrder::Default;
 		TOC.MetaData.Empty();
+		MappedTOC.Reset();
 		
 		Name = NameIn;
 		
@@ -2168,7 +2753,7 @@ public:
 			GamePath.Empty();
 		}
 
-		const bool bGameFileOk = OpenPipelineFileCache(GamePath, ShaderPlatform, FileGuid, AsyncFileHandle, TOC, TOCOffset);
+		const bool bGameFileOk = OpenPipelineFileCache(GamePath, ShaderPlatform, FileGuid, AsyncFileHandle, TOC, TOCOffset, &MappedTOC);
 
 		if (bGameFileOk)
 		{
@@ -2186,36 +2771,52 @@ public:
 #if !UE_BUILD_SHIPPING
 		uint32 InvalidEntryCount = 0;
 #endif
-		
-        for (auto const& Entry : TOC.MetaData)
-        {
-            FPipelineStateStats* Stat = FPipelineFileCacheManager::Stats.FindRef(Entry.Key);
+
+		auto RegisterEntry = [&](uint32 PSOHash, uint16 EngineFlags)
+		{
+            FPipelineStateStats* Stat = FPipelineFileCacheManager::Stats.FindRef(PSOHash);
             if (!Stat)
             {
                 Stat = new FPipelineStateStats;
-                Stat->PSOHash = Entry.Key;
+                Stat->PSOHash = PSOHash;
                 Stat->TotalBindCount = -1;
-                FPipelineFileCacheManager::Stats.Add(Entry.Key, Stat);
+                FPipelineFileCacheManager::Stats.Add(PSOHash, Stat);
             }
 
-			UE_CLOG(!!FPipelineFileCacheManager::NewPSOUsage.Find(Entry.Key), LogRHI, Warning, TEXT("loaded PSOFC %s contains entry (%u) previously marked as new "), *Name, (Entry.Key));
+			UE_CLOG(!!FPipelineFileCacheManager::NewPSOUsage.Find(PSOHash), LogRHI, Warning, TEXT("loaded PSOFC %s contains entry (%u) previously marked as new "), *Name, PSOHash);
 			
 #if !UE_BUILD_SHIPPING
-			if((Entry.Value.EngineFlags & FPipelineCacheFlagInvalidPSO) != 0)
+			if((EngineFlags & FPipelineCacheFlagInvalidPSO) != 0)
 			{
 				++InvalidEntryCount;
 			}
 #endif
-        }
+		};
+
+		if (MappedTOC.IsValid())
+		{
+			for (int32 Index = 0; Index < MappedTOC->Num(); ++Index)
+			{
+				const FPipelineCacheFileFormatTOCEntry Entry = MappedTOC->GetEntry(Index);
+				RegisterEntry(Entry.PSOHash, Entry.EngineFlags);
+			}
+		}
+		else
+		{
+			for (auto const& Entry : TOC.MetaData)
+			{
+				RegisterEntry(Entry.Key, Entry.Value.EngineFlags);
+			}
+		}
 		
 #if !UE_BUILD_SHIPPING
 		if(InvalidEntryCount > 0)
         {
-        	UE_LOG(LogRHI, Warning, TEXT("Found %d / %d PSO entries marked as invalid."), InvalidEntryCount, TOC.MetaData.Num());
+        	UE_LOG(LogRHI, Warning, TEXT("Found %d / %d PSO entries marked as invalid."), InvalidEntryCount, GetTOCMetaDataSize());
         }
 #endif
 		
-		INC_MEMORY_STAT_BY(STAT_FileCacheMemory, TOC.MetaData.GetAllocatedSize());
+		INC_MEMORY_STAT_BY(STAT_FileCacheMemory, GetTOCAllocatedSize());
 
 		UE_LOG(LogRHI, VeryVerbose, TEXT("-- opened bundled %s cache:"), *NameIn);
 		TOC.DumpToLog();
@@ -2574,6 +3175,15 @@ public:
 									UE_LOG(LogRHI, VeryVerbose, TEXT("Incremental save is appending new PSOs (%u)"), PSOHash);
 								}
                             }
+							// Keep the compile cost of every PSO created this run, whether its entry is new or not.
+							for (auto const& Pair : Stats)
+							{
+								if (FPipelineCacheFileFormatPSOMetaData* Meta = TOC.MetaData.Find(Pair.Key))
+								{
+									MergePSOCompileStats(Meta->Stats, *Pair.Value);
+								}
+							}
+
 							// We're appending to the current user cache here, Our TOC is the total.
 							TotalEntries = TOC.MetaData.Num();
 
@@ -2608,7 +3218,7 @@ public:
 							// Merge all of the existing PSO caches together, including this (user cache)
 							for (TPair<FString, TUniquePtr<class FPipelineCacheFile>>& PipelineCachePair : FPipelineFileCacheManager::FileCacheMap)
 							{
-								TempTOC.MetaData.Append(PipelineCachePair.Value->TOC.MetaData);
+								PipelineCachePair.Value->AppendTOCMetaData(TempTOC.MetaData);
 							}
 
                             TMap<uint32, FPipelineCacheFileFormatPSO> PSOs;
@@ -2649,6 +3259,7 @@ public:
                                         Meta.Stats.LastFrameUsed = Pair.Value->LastFrameUsed;
                                     }
 									Meta.Stats.TotalBindCount = (int64)FMath::Min((uint64)INT64_MAX, (uint64)FMath::Max(Meta.Stats.TotalBindCount, 0ll) + (uint64)FMath::Max(Pair.Value->TotalBindCount, 0ll));
+									MergePSOCompileStats(Meta.Stats, *Pair.Value);
                                 }
                             }
                             
@@ -2824,7 +3435,8 @@ public:
 	{
 		uint32 PSOHash = GetTypeHash(NewEntry);
 		check(!EntryData || EntryData->PSOHash == PSOHash);
-		FPipelineCacheFileFormatPSOMetaData const * const Existing = TOC.MetaData.Find(PSOHash);
+		FPipelineCacheFileFormatPSOMetaData DecodedMeta;
+		FPipelineCacheFileFormatPSOMetaData const * const Existing = FindMetaData(PSOHash, DecodedMeta);
 		
 		if(Existing != nullptr && EntryData != nullptr)
 		{
@@ -2861,6 +3473,21 @@ public:
 				TempShaders.Add(NewEntry.GraphicsDesc.AmplificationShader);
 			}
 
+			if (MappedTOC.IsValid())
+			{
+				TSet<FSHAHash> EntryShaders;
+				for (int32 Index = 0; Index < MappedTOC->Num() && !bResult; ++Index)
+				{
+					const FPipelineCacheFileFormatTOCEntry Entry = MappedTOC->GetEntry(Index);
+					if (Entry.NumShaders == TempShaders.Num())
+					{
+						EntryShaders.Reset();
+						MappedTOC->GetShaders(Entry, EntryShaders);
+						bResult = LegacyCompareEqual(TempShaders, EntryShaders);
+					}
+				}
+			}
+
 			for (auto const& Hash : TOC.MetaData)
 			{
 				if (LegacyCompareEqual(TempShaders, Hash.Value.Shaders))
@@ -2874,6 +3501,13 @@ public:
 		return bResult;
 	}
 	
+	/** Compile costs are merged by keeping the worst run, so that saving repeatedly within a run or across runs does not inflate them. */
+	static void MergePSOCompileStats(FPipelineStateStats& Stats, FPipelineStateStats const& RunStats)
+	{
+		Stats.MaxCompileTimeUs = FMath::Max(Stats.MaxCompileTimeUs, RunStats.MaxCompileTimeUs);
+		Stats.RuntimeHitchCount = FMath::Max(Stats.RuntimeHitchCount, RunStats.RuntimeHitchCount);
+	}
+
 	static void SortMetaData(TMap<uint32, FPipelineCacheFileFormatPSOMetaData>& MetaData, FPipelineFileCacheManager::PSOOrder Order)
 	{
 		// Only sorting metadata ordering - this should not affect PSO data offsets / lookups
@@ -2889,6 +3523,12 @@ public:
 				MetaData.ValueSort([](const FPipelineCacheFileFormatPSOMetaData& A, const FPipelineCacheFileFormatPSOMetaData& B) {return A.Stats.TotalBindCount > B.Stats.TotalBindCount;});
 				break;
 			}
+			case FPipelineFileCacheManager::PSOOrder::CostModel:
+			{
+				// Highest priority first, like the other orders: precompilation consumes the ordered list from the front.
+				MetaData.ValueStableSort([](const FPipelineCacheFileFormatPSOMetaData& A, const FPipelineCacheFileFormatPSOMetaData& B) {return GetPSOPrecompilePriority(A.Stats) > GetPSOPrecompilePriority(B.Stats);});
+				break;
+			}
 			case FPipelineFileCacheManager::PSOOrder::Default:
 			default:
 			{
@@ -2900,6 +3540,12 @@ public:
 	
 	void GetOrderedPSOHashes(TArray<FPipelineCachePSOHeader>& PSOHashes, FPipelineFileCacheManager::PSOOrder Order, int64 MinBindCount, TSet<uint32> const& AlreadyCompiledHashes)
 	{
+		if (MappedTOC.IsValid())
+		{
+			GetOrderedPSOHashesFromMappedTOC(PSOHashes, Order, MinBindCount, AlreadyCompiledHashes);
+			return;
+		}
+
 		if(Order != TOC.SortedOrder)
 		{
 			SortMetaData(TOC.MetaData, Order);
@@ -2921,6 +3567,63 @@ public:
 		}
 	}
 	
+	void GetOrderedPSOHashesFromMappedTOC(TArray<FPipelineCachePSOHeader>& PSOHashes, FPipelineFileCacheManager::PSOOrder Order, int64 MinBindCount, TSet<uint32> const& AlreadyCompiledHashes)
+	{
+		// Filter on the fixed-stride records first so that shader sets are only decoded for the PSOs that will be precompiled.
+		TArray<int32> EntryIndices;
+		EntryIndices.Reserve(MappedTOC->Num());
+		for (int32 Position = 0; Position < MappedTOC->Num(); ++Position)
+		{
+			const int32 Index = MappedTOC->GetEntryIndexInSortedOrder(Position);
+			const FPipelineCacheFileFormatTOCEntry Entry = MappedTOC->GetEntry(Index);
+			if ((Entry.EngineFlags & FPipelineCacheFlagInvalidPSO) == 0 &&
+				FPipelineFileCacheManager::MaskComparisonFn(FPipelineFileCacheManager::GameUsageMask, Entry.UsageMask) &&
+				Entry.TotalBindCount >= MinBindCount &&
+				!AlreadyCompiledHashes.Contains(Entry.PSOHash))
+			{
+				EntryIndices.Add(Index);
+			}
+		}
+
+		// Same orders as SortMetaData(); Default keeps the order the file was saved in.
+		if (Order != MappedTOC->GetSortedOrder())
+		{
+			switch (Order)
+			{
+			case FPipelineFileCacheManager::PSOOrder::FirstToLatestUsed:
+				Algo::StableSortBy(EntryIndices, [this](int32 Index) { return MappedTOC->GetEntry(Index).FirstFrameUsed; }, TGreater<>());
+				break;
+			case FPipelineFileCacheManager::PSOOrder::MostToLeastUsed:
+				Algo::StableSortBy(EntryIndices, [this](int32 Index) { return MappedTOC->GetEntry(Index).TotalBindCount; }, TGreater<>());
+				break;
+			case FPipelineFileCacheManager::PSOOrder::CostModel:
+			{
+				TArray<double> Priorities;
+				Priorities.SetNumUninitialized(MappedTOC->Num());
+				for (int32 Index : EntryIndices)
+				{
+					const FPipelineCacheFileFormatTOCEntry Entry = MappedTOC->GetEntry(Index);
+					Priorities[Index] = GetPSOPrecompilePriority(Entry.FirstFrameUsed, Entry.TotalBindCount, Entry.MaxCompileTimeUs, Entry.RuntimeHitchCount);
+				}
+				Algo::StableSortBy(EntryIndices, [&Priorities](int32 Index) { return Priorities[Index]; }, TGreater<>());
+				break;
+			}
+			case FPipelineFileCacheManager::PSOOrder::Default:
+			default:
+				break;
+			}
+		}
+
+		PSOHashes.Reserve(PSOHashes.Num() + EntryIndices.Num());
+		for (int32 Index : EntryIndices)
+		{
+			const FPipelineCacheFileFormatTOCEntry Entry = MappedTOC->GetEntry(Index);
+			FPipelineCachePSOHeader& Header = PSOHashes.AddDefaulted_GetRef();
+			Header.Hash = Entry.PSOHash;
+			MappedTOC->GetShaders(Entry, Header.Shaders);
+		}
+	}
+
 	bool OnExternalReadCallback(FPipelineCacheFileFormatPSORead* Entry, double RemainingTime)
 	{
 		TSharedPtr<IAsyncReadRequest, ESPMode::ThreadSafe> LocalReadRequest = Entry->ReadRequest;
@@ -2946,7 +3649,10 @@ public:
 		for (TDoubleLinkedList<FPipelineCacheFileFormatPSORead*>::TIterator It(Batch.GetHead()); It; ++It)
 		{
 			FPipelineCacheFileFormatPSORead* Entry = *It;
-			FPipelineCacheFileFormatPSOMetaData const& Meta = TOC.MetaData.FindChecked(Entry->Hash);
+			FPipelineCacheFileFormatPSOMetaData DecodedMeta;
+			FPipelineCacheFileFormatPSOMetaData const* MetaPtr = FindMetaData(Entry->Hash, DecodedMeta);
+			check(MetaPtr);
+			FPipelineCacheFileFormatPSOMetaData const& Meta = *MetaPtr;
 			
 			if((Meta.EngineFlags & FPipelineCacheFlagInvalidPSO) != 0)
 			{
@@ -2958,7 +3664,7 @@ public:
 		
 			if (Meta.FileGuid == FileGuid)
 			{
-				FPipelineCacheFileFormatPSOMetaData const* GameMeta = TOC.MetaData.Find(Entry->Hash);
+				FPipelineCacheFileFormatPSOMetaData const* GameMeta = &Meta;
 
 				if (GameMeta && ensure(AsyncFileHandle.IsValid()))
 				{
@@ -3016,7 +3722,7 @@ public:
 
 	const int32 GetTOCMetaDataSize() const
 	{
-		return TOC.MetaData.Num();
+		return MappedTOC.IsValid() ? MappedTOC->Num() : TOC.MetaData.Num();
 	}
 };
 uint32 FPipelineCacheFile::GameVersion = 0;
@@ -4268,6 +4974,7 @@ bool FPipelineFileCacheManager::MergePipelineFileCaches(FString const& PathA, FS
 			{
 				ExistingMetaEntry->UsageMask |=  Entry.Value.UsageMask;
 				ExistingMetaEntry->EngineFlags |= Entry.Value.EngineFlags;
+				FPipelineCacheFile::MergePSOCompileStats(ExistingMetaEntry->Stats, Entry.Value.Stats);
 				++MergeCount;
 			}
 			else
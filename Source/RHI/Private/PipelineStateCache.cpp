@@ -12,6 +12,9 @@ PipelineStateCache.cpp: Pipeline state cache implementation.
 #include "Misc/ScopeRWLock.h"
 #include "Misc/App.h"
 #include "Misc/TimeGuard.h"
+#include "Misc/ScopedTimers.h"
+#include "Math/RandomStream.h"
+#include "PsoLruCache.h"
 #include "DataDrivenShaderPlatformInfo.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "RHICommandList.h"
@@ -223,6 +226,104 @@ static FAutoConsoleCommand DumpPipelineCmd(
 	FConsoleCommandDelegate::CreateStatic(DumpPipelineCacheStats)
 );
 
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+static void BenchmarkPsoLruCache(const TArray<FString>& Args)
+{
+	const int32 NumOperations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 4 * 1024 * 1024;
+	const int32 Capacities[] = { 10 * 1000, 100 * 1000, 1000 * 1000 };
+
+	// Values are pointer sized like the RHI resources the PSO caches hold.
+	using FCache = TPsoLruCache<uint64, void*>;
+
+	auto ToMOpsPerSecond = [NumOperations](double Seconds)
+	{
+		return NumOperations / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER) / 1.0e6;
+	};
+
+	UE_LOG(LogRHI, Display, TEXT("TPsoLruCache churn, %d operations per phase (Mops/s):"), NumOperations);
+
+	for (int32 Capacity : Capacities)
+	{
+		FRandomStream Random(Capacity);
+		FCache Cache(Capacity);
+
+		// Keys [NextKey - Capacity, NextKey) are resident once the cache is full.
+		uint64 NextKey = 0;
+		for (; NextKey < (uint64)Capacity; ++NextKey)
+		{
+			Cache.Add(NextKey, reinterpret_cast<void*>(NextKey));
+		}
+
+		TArray<uint64> HitKeys;
+		HitKeys.SetNumUninitialized(NumOperations);
+		for (uint64& Key : HitKeys)
+		{
+			Key = NextKey - 1 - (uint64)Random.RandHelper(Capacity);
+		}
+
+		uint64 Checksum = 0;
+
+		double HitSeconds = 0.0;
+		{
+			FScopedDurationTimer Timer(HitSeconds);
+			for (uint64 Key : HitKeys)
+			{
+				Checksum += reinterpret_cast<uint64>(*Cache.FindAndTouch(Key));
+			}
+		}
+
+		// Every insert into a full cache evicts the least recent entry, as the PSO caches do.
+		double InsertSeconds = 0.0;
+		{
+			FScopedDurationTimer Timer(InsertSeconds);
+			for (int32 Index = 0; Index < NumOperations; ++Index, ++NextKey)
+			{
+				Checksum += reinterpret_cast<uint64>(Cache.RemoveLeastRecent());
+				Cache.Add(NextKey, reinterpret_cast<void*>(NextKey));
+			}
+		}
+
+		// Mixed: lookups over twice the resident key range, so about half miss and replace the least recent entry.
+		for (uint64& Key : HitKeys)
+		{
+			Key = NextKey - 1 - (uint64)Random.RandHelper(Capacity * 2);
+		}
+
+		int32 NumMisses = 0;
+		double MixedSeconds = 0.0;
+		{
+			FScopedDurationTimer Timer(MixedSeconds);
+			for (uint64 Key : HitKeys)
+			{
+				if (void* const* Value = Cache.FindAndTouch(Key))
+				{
+					Checksum += reinterpret_cast<uint64>(*Value);
+				}
+				else
+				{
+					Checksum += reinterpret_cast<uint64>(Cache.RemoveLeastRecent());
+					Cache.Add(Key, reinterpret_cast<void*>(Key));
+					++NumMisses;
+				}
+			}
+		}
+
+		UE_LOG(LogRHI, Display, TEXT("  %8d entries: hit %7.2f, insert+evict %7.2f, mixed %7.2f (%.0f%% miss) [%llu]"),
+			Capacity, ToMOpsPerSecond(HitSeconds), ToMOpsPerSecond(InsertSeconds), ToMOpsPerSecond(MixedSeconds),
+			100.0 * NumMisses / NumOperations, Checksum);
+	}
+}
+
+static FAutoConsoleCommand BenchmarkPsoLruCacheCmd(
+	TEXT("r.BenchmarkPsoLruCache"),
+	TEXT("Measures TPsoLruCache hit, insert+evict and mixed throughput at 10k, 100k and 1M entries.\n")
+	TEXT("Usage: r.BenchmarkPsoLruCache [NumOperations=4194304]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(BenchmarkPsoLruCache)
+);
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
 int32 GPSOPrecacheUnhealthyCacheHitchThresholdMs = 80;
 static FAutoConsoleVariableRef CVarPSOPrecacheUnhealthyCacheHitchThresholdMs(
 	TEXT("r.PSOPrecache.UnhealthyCacheHitchThresholdMs"),
@@ -256,17 +357,22 @@ struct FPSOCompilationDebugData
 #endif // WITH_RHI_BREADCRUMBS
 };
 
-static inline void CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType PSOType, bool bIsRuntimePSO, const FPSOCompilationDebugData& PSOCompilationDebugData, uint64 StartTime, EPSOPrecacheResult PSOPrecacheResult)
+static inline void CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType PSOType, bool bIsRuntimePSO, const FPSOCompilationDebugData& PSOCompilationDebugData, uint64 StartTime, EPSOPrecacheResult PSOPrecacheResult, FPipelineStateStats* Stats)
 {
+	const uint64 PSOCreationCycles = FPlatformTime::Cycles64() - StartTime;
+
 	if (!bIsRuntimePSO)
 	{
+		// Still feed the creation time to the file cache so that PSOOrder::CostModel knows what this PSO costs.
+		FPipelineStateStats::UpdateCompileStats(Stats, PSOCreationCycles, false);
 		return;
 	}
 
 	RuntimePSOCreationCount.fetch_add(1, std::memory_order_relaxed);
 
 	int32 RuntimePSOCreationHitchThreshold = CVarPSORuntimeCreationHitchThreshold.GetValueOnAnyThread();
-	double PSOCreationTimeMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartTime);
+	double PSOCreationTimeMs = FPlatformTime::ToMilliseconds64(PSOCreationCycles);
+	FPipelineStateStats::UpdateCompileStats(Stats, PSOCreationCycles, PSOCreationTimeMs > RuntimePSOCreationHitchThreshold);
 	if (PSOCreationTimeMs > RuntimePSOCreationHitchThreshold)
 	{
 		if (PSOType == FPSOPrecacheRequestID::EType::Graphics)
@@ -3375,7 +3481,7 @@ public:
 
 		uint64 StartTime = FPlatformTime::Cycles64();
 		GfxPipeline->RHIPipeline = bSkipCreation ? nullptr : RHICreateGraphicsPipelineState(Initializer);
-		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Graphics, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult);
+		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Graphics, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult, GfxPipeline->Stats);
 
 		if (GfxPipeline->RHIPipeline)
 		{
@@ -3500,7 +3606,7 @@ public:
 
 		// TODO: Send the priority to the RHI.
 		ComputePipeline->RHIPipeline = RHICreateComputePipelineState(Initializer);
-		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Compute, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult);
+		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Compute, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult, ComputePipeline->Stats);
 
 		if (!ComputePipeline->RHIPipeline)
 		{
@@ -3687,7 +3793,7 @@ static void InternalCreateComputePipelineState(const FComputePipelineStateInitia
 		check(GraphEvent == nullptr);
 		uint64 StartTime = FPlatformTime::Cycles64();
 		CachedState->RHIPipeline = RHICreateComputePipelineState(Initializer);
-		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Compute, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult);
+		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Compute, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult, CachedState->Stats);
 
 		if (Initializer.bPSOPrecache)
 		{
@@ -4172,7 +4278,7 @@ static void InternalCreateGraphicsPipelineState(const FGraphicsPipelineStateInit
 		check(GraphEvent == nullptr);
 		uint64 StartTime = FPlatformTime::Cycles64();
 		CachedState->RHIPipeline = RHICreateGraphicsPipelineState(Initializer);
-		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Graphics, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult);
+		CheckAndUpdateHitchCountStat(FPSOPrecacheRequestID::EType::Graphics, !IsPrecachedPSO(Initializer), PSOCompilationDebugData, StartTime, PSOPrecacheResult, CachedState->Stats);
 
 		if (Initializer.bPSOPrecache)
 		{
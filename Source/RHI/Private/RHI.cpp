@@ -509,8 +509,80 @@ bool operator==(const FBlendStateInitializerRHI::FRenderTarget& A, const FBlendS
 
 #if RHI_ENABLE_RESOURCE_INFO
 
-static FCriticalSection GRHIResourceTrackingCriticalSection;
-static TSet<FRHIResource*> GRHITrackedResources;
+// Tracked resources are spread over a fixed number of shards keyed by address, so resource creation and destruction
+// on different threads rarely contend. Dumps never lock more than one shard at a time; they take a snapshot of each
+// shard and do all filtering, sorting and formatting afterwards without holding any lock.
+class FRHITrackedResourceRegistry
+{
+public:
+	static constexpr uint32 NumShards = 64;
+
+	void Add(FRHIResource* Resource)
+	{
+		FShard& Shard = GetShard(Resource);
+		FScopeLock Lock(&Shard.CriticalSection);
+
+		Resource->bBeingTracked = true;
+		Shard.Resources.Add(Resource);
+	}
+
+	void Remove(FRHIResource* Resource)
+	{
+		FShard& Shard = GetShard(Resource);
+		FScopeLock Lock(&Shard.CriticalSection);
+
+		Shard.Resources.Remove(Resource);
+		Resource->bBeingTracked = false;
+	}
+
+	void Empty()
+	{
+		for (FShard& Shard : Shards)
+		{
+			FScopeLock Lock(&Shard.CriticalSection);
+			for (FRHIResource* Resource : Shard.Resources)
+			{
+				Resource->bBeingTracked = false;
+			}
+			Shard.Resources.Empty();
+		}
+	}
+
+	// Calls Function for every tracked resource, holding the lock of the resource's shard for the duration of the call.
+	// Resources are guaranteed to stay alive only until the function returns, so it must copy out anything it needs.
+	template <typename TFunction>
+	int32 ForEachLocked(TFunction&& Function) const
+	{
+		int32 Num = 0;
+		for (FShard const& Shard : Shards)
+		{
+			FScopeLock Lock(&Shard.CriticalSection);
+			Num += Shard.Resources.Num();
+
+			for (FRHIResource const* Resource : Shard.Resources)
+			{
+				Function(Resource);
+			}
+		}
+		return Num;
+	}
+
+private:
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FShard
+	{
+		mutable FCriticalSection CriticalSection;
+		TSet<FRHIResource*> Resources;
+	};
+
+	FShard& GetShard(FRHIResource const* Resource)
+	{
+		return Shards[PointerHash(Resource) % NumShards];
+	}
+
+	FShard Shards[NumShards];
+};
+
+static FRHITrackedResourceRegistry GRHITrackedResources;
 static bool GRHITrackingResources = false;
 
 bool FRHIResource::GetResourceInfo(FRHIResourceInfo& OutResourceInfo) const
@@ -528,10 +600,6 @@ void FRHIResource::BeginTrackingResource(FRHIResource* InResource)
 		LLM_TAGSET_SCOPE_CLEAR(ELLMTagSet::AssetClasses);
 		UE_TRACE_METADATA_CLEAR_SCOPE();
 
-		FScopeLock Lock(&GRHIResourceTrackingCriticalSection);
-
-		InResource->bBeingTracked = true;
-
 		GRHITrackedResources.Add(InResource);
 	}
 }
@@ -544,9 +612,8 @@ void FRHIResource::EndTrackingResource(FRHIResource* InResource)
 		LLM_TAGSET_SCOPE_CLEAR(ELLMTagSet::Assets);
 		LLM_TAGSET_SCOPE_CLEAR(ELLMTagSet::AssetClasses);
 		UE_TRACE_METADATA_CLEAR_SCOPE();
-		FScopeLock Lock(&GRHIResourceTrackingCriticalSection);
+
 		GRHITrackedResources.Remove(InResource);
-		InResource->bBeingTracked = false;
 	}
 }
 
@@ -561,16 +628,9 @@ void FRHIResource::StopTrackingAllResources()
 	LLM_TAGSET_SCOPE_CLEAR(ELLMTagSet::Assets);
 	LLM_TAGSET_SCOPE_CLEAR(ELLMTagSet::AssetClasses);
 	UE_TRACE_METADATA_CLEAR_SCOPE();
-	FScopeLock Lock(&GRHIResourceTrackingCriticalSection);
-	for (FRHIResource* Resource : GRHITrackedResources)
-	{
-		if (Resource)
-		{
-			Resource->bBeingTracked = false;
-		}
-	}
-	GRHITrackedResources.Empty();
+
 	GRHITrackingResources = false;
+	GRHITrackedResources.Empty();
 }
 
 enum class EBooleanFilter
@@ -607,23 +667,14 @@ static FAutoConsoleCommandWithWorldArgsAndOutputDevice GDumpRHIResourceCountsCmd
 
 	FRHIResourceInfo ResourceInfo;
 
+	TotalResources = GRHITrackedResources.ForEachLocked([&ResourceCounts](const FRHIResource* Resource)
 	{
-		FScopeLock Lock(&GRHIResourceTrackingCriticalSection);
-
-		TotalResources = GRHITrackedResources.Num();
-
-		for (const FRHIResource* Resource : GRHITrackedResources)
+		ERHIResourceType ResourceType = Resource->GetType();
+		if (ResourceType > 0 && ResourceType < RRT_Num)
 		{
-			if (Resource)
-			{
-				ERHIResourceType ResourceType = Resource->GetType();
-				if (ResourceType > 0 && ResourceType < RRT_Num)
-				{
-					ResourceCounts[ResourceType]++;
-				}
-			}
+			ResourceCounts[ResourceType]++;
 		}
-	}
+	});
 
 	FBufferedOutputDevice BufferedOutput;
 	FName CategoryName(TEXT("RHIResources"));
@@ -648,12 +699,6 @@ static FAutoConsoleCommandWithWorldArgsAndOutputDevice GDumpRHIResourceCountsCmd
 
 namespace RHIInternal
 {
-	struct FResourceEntry
-	{
-		const FRHIResource* Resource;
-		FRHIResourceInfo ResourceInfo;
-	};
-
 	struct FResourceFlags
 	{
 		bool bResident = false;
@@ -714,6 +759,17 @@ namespace RHIInternal
 		}
 	};
 
+	// Everything a dump needs from a tracked resource, copied out while its registry shard is locked.
+	// The resource itself may be destroyed as soon as the snapshot moves on, so entries never point back at it.
+	struct FResourceEntry
+	{
+		FRHIResourceInfo ResourceInfo;
+		FName OwnerName;
+		FResourceFlags Flags;
+	};
+
+	FResourceFlags GetResourceFlagsInternal(const FRHIResource* Resource, const FRHIResourceInfo& ResourceInfo);
+
 	void GetTrackedResourcesInternal(const FString& NameFilter, ERHIResourceType TypeFilter, EBooleanFilter TransientFilter, TArray<FResourceEntry>& OutResources, int32& OutNumberOfResourcesToShow,
 		int32& OutTotalResourcesWithInfo, int32& OutTotalTrackedResources, int64& OutTotalTrackedResourceSize, int64& OutTotalTrackedTransientResourceSize)
 	{
@@ -756,17 +812,15 @@ namespace RHIInternal
 
 		{
 			FRHIResourceInfo ResourceInfo;
-			OutTotalTrackedResources = GRHITrackedResources.Num();
-
-			for (const FRHIResource* Resource : GRHITrackedResources)
+			OutTotalTrackedResources = GRHITrackedResources.ForEachLocked([&](const FRHIResource* Resource)
 			{
-				if (Resource && Resource->GetResourceInfo(ResourceInfo))
+				if (Resource->GetResourceInfo(ResourceInfo))
 				{
 					ResourceInfo.bValid = Resource->IsValid();
 
 					if (ShouldIncludeResource(Resource, ResourceInfo))
 					{
-						OutResources.Emplace(FResourceEntry{ Resource, ResourceInfo });
+						OutResources.Emplace(FResourceEntry{ ResourceInfo, Resource->GetOwnerName(), GetResourceFlagsInternal(Resource, ResourceInfo) });
 					}
 
 					OutTotalResourcesWithInfo++;
@@ -779,7 +833,7 @@ namespace RHIInternal
 						OutTotalTrackedResourceSize += ResourceInfo.VRamAllocation.AllocationSize;
 					}
 				}
-			}
+			});
 		}
 
 		if (OutNumberOfResourcesToShow < 0 || OutNumberOfResourcesToShow > OutResources.Num())
@@ -793,24 +847,24 @@ namespace RHIInternal
 		});
 	}
 
-	FResourceFlags GetResourceFlagsInternal(const FResourceEntry& Resource)
+	FResourceFlags GetResourceFlagsInternal(const FRHIResource* Resource, const FRHIResourceInfo& ResourceInfo)
 	{
 		FResourceFlags Flags;
-		Flags.bResident = Resource.ResourceInfo.bResident;
-		Flags.bMarkedForDelete = !Resource.ResourceInfo.bValid;
-		Flags.bTransient = Resource.ResourceInfo.IsTransient;
+		Flags.bResident = ResourceInfo.bResident;
+		Flags.bMarkedForDelete = !ResourceInfo.bValid;
+		Flags.bTransient = ResourceInfo.IsTransient;
 
-		if (Resource.ResourceInfo.Type == RRT_Texture)
+		if (ResourceInfo.Type == RRT_Texture)
 		{
-			FRHITexture* Texture = (FRHITexture*)Resource.Resource;
+			const FRHITexture* Texture = (const FRHITexture*)Resource;
 			Flags.bRT = EnumHasAnyFlags(Texture->GetFlags(), TexCreate_RenderTargetable);
 			Flags.bDS = EnumHasAnyFlags(Texture->GetFlags(), TexCreate_DepthStencilTargetable);
 			Flags.bUAV = EnumHasAnyFlags(Texture->GetFlags(), TexCreate_UAV);
 			Flags.bStreaming = EnumHasAnyFlags(Texture->GetFlags(), TexCreate_Streamable);
 		}
-		else if (Resource.ResourceInfo.Type == RRT_Buffer)
+		else if (ResourceInfo.Type == RRT_Buffer)
 		{
-			FRHIBuffer* Buffer = (FRHIBuffer*)Resource.Resource;
+			const FRHIBuffer* Buffer = (const FRHIBuffer*)Resource;
 			Flags.bUAV = EnumHasAnyFlags((EBufferUsageFlags)Buffer->GetUsage(), BUF_UnorderedAccess);
 			Flags.bRTAS = EnumHasAnyFlags((EBufferUsageFlags)Buffer->GetUsage(), BUF_AccelerationStructure);
 		}
@@ -823,7 +877,6 @@ namespace RHIInternal
 void RHIGetTrackedResourceStats(TArray<TSharedPtr<FRHIResourceStats>>& OutResourceStats)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(RHIGetTrackedResourceStats);
-	FScopeLock Lock(&GRHIResourceTrackingCriticalSection);
 
 	TArray<RHIInternal::FResourceEntry> Resources;
 	int32 TotalResourcesWithInfo = 0;
@@ -837,12 +890,11 @@ void RHIGetTrackedResourceStats(TArray<TSharedPtr<FRHIResourceStats>>& OutResour
 	OutResourceStats.SetNum(Resources.Num());
 	ParallelFor(Resources.Num(), [&](int32 Index)
 	{
-		const FRHIResource* Resource = Resources[Index].Resource;
 		const FRHIResourceInfo& ResourceInfo = Resources[Index].ResourceInfo;
 		const TCHAR* ResourceType = StringFromRHIResourceType(ResourceInfo.Type);
 		const int64 SizeInBytes = ResourceInfo.VRamAllocation.AllocationSize;
-		RHIInternal::FResourceFlags Flags = GetResourceFlagsInternal(Resources[Index]);
-		OutResourceStats[Index] = MakeShared<FRHIResourceStats>(ResourceInfo.Name, Resource->GetOwnerName(), ResourceType, Flags.GetString(), SizeInBytes,
+		RHIInternal::FResourceFlags Flags = Resources[Index].Flags;
+		OutResourceStats[Index] = MakeShared<FRHIResourceStats>(ResourceInfo.Name, Resources[Index].OwnerName, ResourceType, Flags.GetString(), SizeInBytes,
 									Flags.bResident, Flags.bMarkedForDelete, Flags.bTransient, Flags.bStreaming, Flags.bRT, Flags.bDS, Flags.bUAV, Flags.bRTAS, Flags.bHasFlags);
 	});
 }
@@ -856,8 +908,6 @@ void RHIDumpResourceMemory(const FString& NameFilter, ERHIResourceType TypeFilte
 		CSVFile = IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_AllowRead);
 	}
 
-	FScopeLock Lock(&GRHIResourceTrackingCriticalSection);
-
 	TArray<RHIInternal::FResourceEntry> Resources;
 	int32 TotalResourcesWithInfo = 0;
 	int32 TotalTrackedResources = 0;
@@ -904,9 +954,9 @@ void RHIDumpResourceMemory(const FString& NameFilter, ERHIResourceType TypeFilte
 			ResourceInfo.Name.ToString(ResourceNameBuffer);
 			const TCHAR* ResourceType = StringFromRHIResourceType(ResourceInfo.Type);
 			const int64 SizeInBytes = ResourceInfo.VRamAllocation.AllocationSize;			
-			Resources[Index].Resource->GetOwnerName().ToString(ResourceOwnerBuffer);
+			Resources[Index].OwnerName.ToString(ResourceOwnerBuffer);
 
-			RHIInternal::FResourceFlags Flags = GetResourceFlagsInternal(Resources[Index]);
+			RHIInternal::FResourceFlags Flags = Resources[Index].Flags;
 
 			if (bSummaryOutput == false)
 			{
@@ -8,6 +8,9 @@
 #include "RHIUniformBufferLayoutInitializer.h"
 #include "Stats/Stats.h"
 #include "RHIGlobals.h"
+#include "DynamicRHI.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
 
 UE::TConsumeAllMpmcQueue<FRHIResource*> PendingDeletes;
 UE::TConsumeAllMpmcQueue<FRHIResource*> PendingDeletesWithLifetimeExtension;
@@ -58,12 +61,60 @@ void FRHIResource::MarkForDelete() const
 	}
 }
 
+static TAutoConsoleVariable<int32> CVarRHIParallelResourceDeletionMinBatchSize(
+	TEXT("r.RHI.ParallelResourceDeletion.MinBatchSize"),
+	256,
+	TEXT("Minimum number of pending deletes of one resource type before they are destroyed on task worker threads, for types the platform RHI allows (see RHICanDeleteResourcesInParallel).\n")
+	TEXT("0 disables parallel deletion."),
+	ECVF_Default);
+
 void FRHIResource::DeleteResources(TArray<FRHIResource*> const& Resources)
 {
+	// Group the resources by type so the platform RHI gets one batch per type, rather than interleaved destructors.
+	// Deleting() must only be called once per resource, so it's resolved while counting.
+	TArray<FRHIResource*> ResourcesToDelete;
+	ResourcesToDelete.Reserve(Resources.Num());
+
+	int32 TypeOffsets[RRT_Num + 1] = {};
 	for (FRHIResource* Resource : Resources)
 	{
 		if (Resource->AtomicFlags.Deleting())
 		{
+			ResourcesToDelete.Add(Resource);
+			TypeOffsets[Resource->ResourceType + 1]++;
+		}
+	}
+
+	if (ResourcesToDelete.IsEmpty())
+	{
+		return;
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < RRT_Num; ++TypeIndex)
+	{
+		TypeOffsets[TypeIndex + 1] += TypeOffsets[TypeIndex];
+	}
+
+	TArray<FRHIResource*> SortedResources;
+	SortedResources.SetNumUninitialized(ResourcesToDelete.Num());
+	{
+		int32 WriteOffsets[RRT_Num];
+		FMemory::Memcpy(WriteOffsets, TypeOffsets, sizeof(WriteOffsets));
+		for (FRHIResource* Resource : ResourcesToDelete)
+		{
+			SortedResources[WriteOffsets[Resource->ResourceType]++] = Resource;
+		}
+	}
+
+	auto DeleteBatch = [](ERHIResourceType ResourceType, TConstArrayView<FRHIResource*> Batch)
+	{
+		if (GDynamicRHI)
+		{
+			GDynamicRHI->RHIBeginDeleteResources(ResourceType, Batch);
+		}
+
+		for (FRHIResource* Resource : Batch)
+		{
 #if DO_CHECK
 			CurrentlyDeleting = Resource;
 #endif
@@ -73,6 +124,42 @@ void FRHIResource::DeleteResources(TArray<FRHIResource*> const& Resources)
 			check(CurrentlyDeleting == nullptr);
 #endif
 		}
+
+		if (GDynamicRHI)
+		{
+			GDynamicRHI->RHIEndDeleteResources(ResourceType);
+		}
+	};
+
+	const int32 MinParallelBatchSize = CVarRHIParallelResourceDeletionMinBatchSize.GetValueOnAnyThread();
+
+	// Higher resource types tend to reference lower ones (views reference textures, pipelines reference shaders), so
+	// destroy from the highest type down. Resources in one gather were all unreferenced already, so this only matters
+	// for platform RHIs that keep non-refcounted links between objects.
+	for (int32 TypeIndex = RRT_Num - 1; TypeIndex >= 0; --TypeIndex)
+	{
+		const ERHIResourceType ResourceType = ERHIResourceType(TypeIndex);
+		TConstArrayView<FRHIResource*> Batch = MakeArrayView(SortedResources).Slice(TypeOffsets[TypeIndex], TypeOffsets[TypeIndex + 1] - TypeOffsets[TypeIndex]);
+		if (Batch.IsEmpty())
+		{
+			continue;
+		}
+
+		if (MinParallelBatchSize > 0 && Batch.Num() >= MinParallelBatchSize && GDynamicRHI && GDynamicRHI->RHICanDeleteResourcesInParallel(ResourceType))
+		{
+			const int32 NumResourcesPerTask = FMath::Max(MinParallelBatchSize / 4, 32);
+			const int32 NumTasks = FMath::DivideAndRoundUp(Batch.Num(), NumResourcesPerTask);
+
+			ParallelFor(TEXT("RHI.DeleteResources"), NumTasks, 1, [&](int32 TaskIndex)
+			{
+				const int32 First = TaskIndex * NumResourcesPerTask;
+				DeleteBatch(ResourceType, Batch.Slice(First, FMath::Min(NumResourcesPerTask, Batch.Num() - First)));
+			});
+		}
+		else
+		{
+			DeleteBatch(ResourceType, Batch);
+		}
 	}
 }
 
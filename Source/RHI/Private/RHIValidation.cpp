@@ -11,6 +11,7 @@
 #include "HAL/PlatformStackWalk.h"
 #include "Misc/CommandLine.h"
 #include "Misc/OutputDeviceRedirector.h"
+#include "Misc/ScopeLock.h"
 #include "RHIContext.h"
 #include "RHIStrings.h"
 #include "RHIUniformBufferUtilities.h"
@@ -782,12 +783,13 @@ void FValidationRHI::RHISubmitCommandLists(FRHISubmitCommandListsArgs&& Args)
 	for (IRHIPlatformCommandList* CmdList : Args.CommandLists)
 	{
 		FValidationCommandList* OuterCommandList = static_cast<FValidationCommandList*>(CmdList);
+		RHIValidation::FOpQueueState::FOpsList OpsList(MoveTemp(OuterCommandList->CompletedOpList));
 #if WITH_RHI_BREADCRUMBS
-		OuterCommandList->CompletedOpList.Insert(RHIValidation::FOperation::SetBreadcrumbRange(CmdList->BreadcrumbRange), 0);
+		OpsList.BreadcrumbRange = CmdList->BreadcrumbRange;
 #endif
 
 		// Replay or queue any barrier operations to validate resource barrier usage.
-		RHIValidation::FTracker::SubmitValidationOps(OuterCommandList->Pipeline, MoveTemp(OuterCommandList->CompletedOpList));
+		RHIValidation::FTracker::SubmitValidationOps(OuterCommandList->Pipeline, MoveTemp(OpsList));
 
 		for(IRHIPlatformCommandList* InnerCmdList : OuterCommandList->InnerCommandLists)
 		{
@@ -2604,48 +2606,39 @@ namespace RHIValidation
 		State.bExplicitAllowUAVOverlap = bAllow;
 	}
 
-	inline void FResource::EnumerateSubresources(FSubresourceRange const& SubresourceRange, TFunctionRef<void(FSubresourceState&, FSubresourceIndex const&)> Callback, bool bBeginTransition)
+	template <typename TCallback>
+	inline void FResource::EnumerateSubresources(FSubresourceRange const& SubresourceRange, TCallback&& Callback, bool bBeginTransition)
 	{
 		bool bWholeResource = SubresourceRange.IsWholeResource(*this);
 		if (bWholeResource && SubresourceStates.Num() == 0)
 		{
 			Callback(WholeResourceState, FSubresourceIndex());
+			return;
 		}
-		else
+
+		if (SubresourceStates.Num() == 0)
 		{
-			if (SubresourceStates.Num() == 0)
-			{
-				const uint32 NumSubresources = NumMips * NumArraySlices * NumPlanes;
-				SubresourceStates.Reserve(NumSubresources);
+			// Copy the whole resource state into all the subresource slots
+			SubresourceStates.Init(WholeResourceState, NumMips * NumArraySlices * NumPlanes);
+		}
 
-				// Copy the whole resource state into all the subresource slots
-				for (uint32 Index = 0; Index < NumSubresources; ++Index)
-				{
-					SubresourceStates.Add(WholeResourceState);
-				}
-			}
+		uint32 LastMip = SubresourceRange.MipIndex + SubresourceRange.NumMips;
+		uint32 LastArraySlice = SubresourceRange.ArraySlice + SubresourceRange.NumArraySlices;
+		uint32 LastPlaneIndex = SubresourceRange.PlaneIndex + SubresourceRange.NumPlanes;
 
-			if (SubresourceStates.Num() != 0)
+		for (uint32 PlaneIndex = SubresourceRange.PlaneIndex; PlaneIndex < LastPlaneIndex; ++PlaneIndex)
+		{
+			for (uint32 MipIndex = SubresourceRange.MipIndex; MipIndex < LastMip; ++MipIndex)
 			{
-				uint32 LastMip = SubresourceRange.MipIndex + SubresourceRange.NumMips;
-				uint32 LastArraySlice = SubresourceRange.ArraySlice + SubresourceRange.NumArraySlices;
-				uint32 LastPlaneIndex = SubresourceRange.PlaneIndex + SubresourceRange.NumPlanes;
-
-				for (uint32 PlaneIndex = SubresourceRange.PlaneIndex; PlaneIndex < LastPlaneIndex; ++PlaneIndex)
+				for (uint32 ArraySlice = SubresourceRange.ArraySlice; ArraySlice < LastArraySlice; ++ArraySlice)
 				{
-					for (uint32 MipIndex = SubresourceRange.MipIndex; MipIndex < LastMip; ++MipIndex)
-					{
-						for (uint32 ArraySlice = SubresourceRange.ArraySlice; ArraySlice < LastArraySlice; ++ArraySlice)
-						{
-							uint32 SubresourceIndex = PlaneIndex + (MipIndex + ArraySlice * NumMips) * NumPlanes;
-							Callback(SubresourceStates[SubresourceIndex], FSubresourceIndex(MipIndex, ArraySlice, PlaneIndex));
-						}
-					}
+					uint32 SubresourceIndex = PlaneIndex + (MipIndex + ArraySlice * NumMips) * NumPlanes;
+					Callback(SubresourceStates[SubresourceIndex], FSubresourceIndex(MipIndex, ArraySlice, PlaneIndex));
 				}
 			}
 		}
 
-		if (bWholeResource && bBeginTransition && SubresourceStates.Num() != 0)
+		if (bWholeResource && bBeginTransition)
 		{
 			// Switch back to whole resource state tracking on begin transitions
 			WholeResourceState = SubresourceStates[0];
@@ -2653,6 +2646,29 @@ namespace RHIValidation
 		}
 	}
 
+	bool FResource::TryCollapseSubresourceStates()
+	{
+		if (SubresourceStates.Num() == 0)
+		{
+			return true;
+		}
+
+		// Per-subresource tracking is only needed while the subresources disagree. Once a set of
+		// sub-range transitions has brought them back in line, return to the whole resource fast path.
+		FSubresourceState const& First = SubresourceStates[0];
+		for (int32 Index = 1; Index < SubresourceStates.Num(); ++Index)
+		{
+			if (!(SubresourceStates[Index] == First))
+			{
+				return false;
+			}
+		}
+
+		WholeResourceState = First;
+		SubresourceStates.Reset();
+		return true;
+	}
+
 #if WITH_RHI_BREADCRUMBS
 	bool IsInRange(FRHIBreadcrumbRange const& Range, FRHIBreadcrumbNode* const Target, ERHIPipeline Pipeline)
 	{
@@ -2833,6 +2849,7 @@ namespace RHIValidation
 					Queue.FenceValue,
 					Data_EndTransition.CreateBacktrace);
 			});
+			Data_EndTransition.Identity.Resource->TryCollapseSubresourceStates();
 			Data_EndTransition.Identity.Resource->ReleaseOpRef();
 			break;
 
@@ -2927,6 +2944,39 @@ namespace RHIValidation
 		return true;
 	}
 
+	static int32 GMaxPooledOpLists = 64;
+	static FAutoConsoleVariableRef CVarMaxPooledOpLists(
+		TEXT("r.RHIValidation.MaxPooledOpLists"),
+		GMaxPooledOpLists,
+		TEXT("Maximum number of replayed validation op lists kept around for reuse by the barrier trackers (default 64).\n")
+		TEXT("0 disables pooling, which makes every command list grow a new op array while it is recorded."),
+		ECVF_RenderThreadSafe);
+
+	static FCriticalSection GOpListPoolCS;
+	static TArray<TArray<FOperation>> GOpListPool;
+
+	TArray<FOperation> FTracker::AllocateOpList()
+	{
+		FScopeLock Lock(&GOpListPoolCS);
+		return GOpListPool.Num() ? GOpListPool.Pop(EAllowShrinking::No) : TArray<FOperation>();
+	}
+
+	void FTracker::ReleaseOpList(TArray<FOperation>&& List)
+	{
+		if (List.Max() == 0)
+		{
+			return;
+		}
+
+		List.Reset();
+
+		FScopeLock Lock(&GOpListPoolCS);
+		if (GOpListPool.Num() < GMaxPooledOpLists)
+		{
+			GOpListPool.Emplace(MoveTemp(List));
+		}
+	}
+
 	void FTracker::AddOp(const RHIValidation::FOperation& Op)
 	{
 		if (GRHICommandList.Bypass() && CurrentList.IsEmpty())
@@ -2937,6 +2987,11 @@ namespace RHIValidation
 			}
 		}
 
+		if (CurrentList.Max() == 0)
+		{
+			CurrentList = AllocateOpList();
+		}
+
 		CurrentList.Add(Op);
 	}
 
@@ -2947,32 +3002,60 @@ namespace RHIValidation
 
 	bool FOpQueueState::Execute()
 	{
-		if (!Ops.Num())
+		if (ReplayListIndex == Ops.Num())
 			return false;
 
 		bool bProgressMade = false;
 		FRHIValidationQueueScope Scope(*this);
 
-		while (Ops.Num())
+		for (; ReplayListIndex < Ops.Num(); ++ReplayListIndex)
 		{
-			for (FOpsList& List = Ops[0]; List.ReplayPos < List.Num(); ++List.ReplayPos)
+			FOpsList& List = Ops[ReplayListIndex];
+
+#if WITH_RHI_BREADCRUMBS
+			if (List.BreadcrumbRange.IsSet())
+			{
+				FOperation::SetBreadcrumbRange(List.BreadcrumbRange.GetValue()).Replay(*this);
+				List.BreadcrumbRange.Reset();
+				bProgressMade = true;
+			}
+#endif
+
+			for (; List.ReplayPos < List.Num(); ++List.ReplayPos)
 			{
 				if (!List[List.ReplayPos].Replay(*this))
 				{
 					// Queue is blocked
-					return bProgressMade;
+					break;
 				}
 
 				bProgressMade = true;
 			}
 
-			Ops.RemoveAt(0);
+			if (List.ReplayPos < List.Num())
+			{
+				break;
+			}
+
+			FTracker::ReleaseOpList(MoveTemp(List));
+		}
+
+		// Drop the fully replayed lists in one go, rather than shifting the queue down after every list.
+		if (ReplayListIndex == Ops.Num())
+		{
+			Ops.Reset();
+			ReplayListIndex = 0;
+		}
+		else if (ReplayListIndex > 0 && ReplayListIndex * 2 >= Ops.Num())
+		{
+			Ops.RemoveAt(0, ReplayListIndex, EAllowShrinking::No);
+			ReplayListIndex = 0;
 		}
 
 		return bProgressMade;
 	}
 
-	void FTracker::SubmitValidationOps(ERHIPipeline Pipeline, TArray<RHIValidation::FOperation>&& Ops)
+	void FTracker::SubmitValidationOps(ERHIPipeline Pipeline, FOpQueueState::FOpsList&& Ops)
 	{
 		GetQueue(Pipeline).Ops.Emplace(MoveTemp(Ops));
 
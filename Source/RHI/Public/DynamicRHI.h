@@ -946,6 +946,24 @@ public:
 	//
 	virtual void RHIProcessDeleteQueue() {}
 
+	//
+	// Called before and after a batch of RHI resources of the same type is destroyed, on the thread destroying them.
+	// Platform RHIs can use this to amortize per-resource work in their destructors across the batch (e.g. take a deferred deletion lock once).
+	// Batches of types that RHICanDeleteResourcesInParallel() allows may be destroyed concurrently on task worker threads.
+	// Called only from RHI resource deletion code. Do not call directly.
+	//
+	virtual void RHIBeginDeleteResources(ERHIResourceType ResourceType, TConstArrayView<FRHIResource*> Resources) {}
+	virtual void RHIEndDeleteResources(ERHIResourceType ResourceType) {}
+
+	//
+	// Returns true if resources of the given type have no thread affinity in this RHI, i.e. they can be destroyed from
+	// any thread, concurrently with each other and with the RHI thread. Only RHI-level objects qualify by default.
+	//
+	virtual bool RHICanDeleteResourcesInParallel(ERHIResourceType ResourceType) const
+	{
+		return ResourceType == RRT_UniformBufferLayout;
+	}
+
 	RHI_API virtual FTextureRHIRef AsyncReallocateTexture2D_RenderThread(class FRHICommandListImmediate& RHICmdList, FRHITexture* Texture2D, int32 NewMipCount, int32 NewSizeX, int32 NewSizeY, FThreadSafeCounter* RequestStatus);
 
 	RHI_API virtual FUpdateTexture3DData RHIBeginUpdateTexture3D(FRHICommandListBase& RHICmdList, FRHITexture* Texture, uint32 MipIndex, const struct FUpdateTextureRegion3D& UpdateRegion);
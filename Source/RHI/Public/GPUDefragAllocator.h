@@ -8,6 +8,7 @@
 #include "Misc/OutputDeviceRedirector.h"
 #include "HAL/IConsoleManager.h"
 #include "Containers/List.h"
+#include "Math/RandomStream.h"
 #include "HAL/LowLevelMemTracker.h"
 #include "ProfilingDebugging/MemoryTrace.h"
 
@@ -21,6 +22,8 @@
 
 #define USE_ALLOCATORFIXEDSIZEFREELIST	0
 
+#define GPU_DEFRAG_TRACE_RECORDING		(!(UE_BUILD_SHIPPING || UE_BUILD_TEST)) //allows recording Allocate/Free/Tick traces for ReplayTrace().
+
 class FAsyncReallocationRequest;
 class FScopedGPUDefragLock;
 
@@ -136,6 +139,58 @@ public:
 		int32 NumLockedChunks;
 	};
 
+	/**
+	* A single event of a recorded allocation trace. See StartTraceRecording() and ReplayTrace().
+	*/
+	struct FAllocationTraceEvent
+	{
+		enum class EType : uint8
+		{
+			Allocate,
+			Free,
+			Tick,
+			PanicTick
+		};
+
+		EType	Type = EType::Tick;
+		/** Identifies an allocation across its Allocate and Free events. Unused for ticks. */
+		uint32	AllocationId = 0;
+		/** Requested size of Allocate events, in bytes. */
+		int64	Size = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FAllocationTraceEvent& Event)
+		{
+			uint8 EventType = uint8(Event.Type);
+			Ar << EventType;
+			Event.Type = EType(EventType);
+			Ar << Event.AllocationId;
+			Ar << Event.Size;
+			return Ar;
+		}
+	};
+
+	/**
+	* Results of ReplayTrace(). Fragmentation is 1 - (largest hole / free memory), sampled after every tick.
+	*/
+	struct FTraceReplayStats
+	{
+		int64	NumBytesRelocated = 0;
+		int32	NumRelocations = 0;
+		int32	NumTicks = 0;
+		int32	NumFailedAllocations = 0;
+		double	AverageFragmentation = 0.0;
+		double	FinalFragmentation = 0.0;
+	};
+
+	class FMemoryChunk;
+
+	/** Intrusive treap links, used to index free chunks by address and by size. */
+	struct FFreeChunkTreeLinks
+	{
+		FMemoryChunk* Left = nullptr;
+		FMemoryChunk* Right = nullptr;
+	};
+
 	/**
 	* Contains information of a single allocation or free block.
 	*/
@@ -253,6 +308,7 @@ public:
 		void	UnlinkFree()
 		{
 			check(bIsAvailable);
+			BestFitAllocator.RemoveFromFreeIndex(this);
 			bIsAvailable = false;
 
 			if (PreviousFreeChunk)
@@ -357,6 +413,11 @@ public:
 		FMemoryChunk*			PreviousFreeChunk;
 		/** Pointer to next free chunk.					*/
 		FMemoryChunk*			NextFreeChunk;
+		/** Links in the free address and free size trees. Only valid while available. */
+		FFreeChunkTreeLinks		FreeAddressLinks;
+		FFreeChunkTreeLinks		FreeSizeLinks;
+		/** Treap priority, assigned whenever the chunk becomes available. */
+		uint32					FreeTreePriority = 0;
 		/** SyncIndex that must be exceeded before accessing the data within this chunk. */
 		uint32					SyncIndex;
 
@@ -661,6 +722,34 @@ public:
 	* @param Filename		[opt] Filename to a previously saved memory layout to use for benchmarking, or nullptr
 	*/
 	void	Benchmark(int32 MinChunkSize, int32 MaxChunkSize, float FreeRatio, float LockRatio, bool bFullDefrag, bool bSaveImages, const TCHAR* Filename);
+
+#if GPU_DEFRAG_TRACE_RECORDING
+	/**
+	* Starts recording all Allocate(), Free() and Tick() calls, discarding any previous recording.
+	* Allocations that already exist are not part of the trace.
+	*/
+	void	StartTraceRecording();
+
+	/**
+	* Stops recording and returns the recorded trace.
+	*
+	* @param OutEvents		[out] Recorded events, in call order
+	*/
+	void	StopTraceRecording(TArray<FAllocationTraceEvent>& OutEvents);
+#endif
+
+	/**
+	* Replays an allocation trace on a CPU-only allocator that never touches the pool memory.
+	* Deterministic for a given trace, pool size, settings and policy.
+	*
+	* @param Events					Trace to replay
+	* @param PoolSize				Size of the simulated pool, in bytes
+	* @param AllocationAlignment	Alignment for all allocations, in bytes
+	* @param Settings				Allocator settings, e.g. the per-tick relocation budget
+	* @param bUseCompactionPlanner	Whether ticks use the compaction planner (true) or the greedy partial defrag (false)
+	* @param OutStats				[out] Replay results
+	*/
+	static void	ReplayTrace(TConstArrayView<FAllocationTraceEvent> Events, int64 PoolSize, int32 AllocationAlignment, const FSettings& Settings, bool bUseCompactionPlanner, FTraceReplayStats& OutStats);
 	
 	static inline bool IsAligned(const volatile void* Ptr, const uint32 Alignment)
 	{
@@ -832,6 +921,15 @@ protected:
 	*/
 	void			PartialDefragmentationFast(FRelocationStats& Stats, double StartTime);
 
+	/**
+	* Picks how many ticks a free chunk that failed to defrag is skipped for.
+	*
+	* @param MinCounter		Smallest delay
+	* @param MaxCounter		Largest delay (exclusive)
+	* @return				Delay in [MinCounter, MaxCounter)
+	*/
+	int32			RandomDefragCounter(int32 MinCounter, int32 MaxCounter);
+
 	/**
 	* Performs a partial defrag doing slow all chunk search to find used chunks to move that are surrounded by other used chunks
 	* That a freechunk walk won't find.
@@ -857,6 +955,51 @@ protected:
 	*/
 	void			FullDefragmentation(FRelocationStats& Stats);
 
+	/** A single relocation planned by PlanCompaction(). */
+	struct FCompactionMove
+	{
+		FMemoryChunk*	Source;
+		/** Base of the free chunk the source gets relocated to, taking earlier moves of the same plan into account. */
+		uint8*			DestinationBase;
+	};
+
+	/**
+	* Plans a set of relocations that empties a window of consecutive chunks into free chunks outside of it, turning the
+	* window into a single free chunk larger than the current largest one. Each planned byte is copied once. Among all
+	* windows that fit the budget, the one with the largest growth of the largest free chunk per byte copied is chosen.
+	*
+	* @param ByteBudget		Maximum number of bytes to relocate
+	* @param MaxMoves		Maximum number of relocations
+	* @param OutMoves		[out] Planned relocations, to be executed in order. Empty if nothing worthwhile fits the budget.
+	* @return				Size of the free chunk created by the plan
+	*/
+	int64			PlanCompaction(int64 ByteBudget, int32 MaxMoves, TArray<FCompactionMove>& OutMoves) const;
+
+	/**
+	* Performs a partial defrag by executing compaction plans until the relocation budget is spent.
+	*
+	* @param Stats			[out] Stats
+	* @param StartTime		Start time, used for limiting the Tick() time
+	*/
+	void			PlannedDefragmentation(FRelocationStats& Stats, double StartTime);
+
+	/**
+	* Keeps the trace recording in sync when an allocation moves to a new base address.
+	*/
+	void			RetargetTracedAllocation(const void* OldBase, const void* NewBase)
+	{
+#if GPU_DEFRAG_TRACE_RECORDING
+		if (bRecordingTrace)
+		{
+			uint32 AllocationId;
+			if (TraceAllocationIds.RemoveAndCopyValue(OldBase, AllocationId))
+			{
+				TraceAllocationIds.Add(NewBase, AllocationId);
+			}
+		}
+#endif
+	}
+
 	/**
 	* Tries to immediately grow a memory chunk by moving the base address, without relocating any memory.
 	*
@@ -947,7 +1090,7 @@ protected:
 		BaseChunk->SetSyncIndex(BaseChunk->SyncIndex, FMath::Min((int64)FirstSize, BaseChunk->SyncSize));
 
 		// Resize base chunk.
-		BaseChunk->Size = FirstSize;
+		SetChunkExtent(BaseChunk, BaseChunk->Base, FirstSize);
 	} //-V773
 
 	/**
@@ -1045,6 +1188,46 @@ protected:
 
 	FMemoryChunk* RelocateAllowed(FMemoryChunk* FreeChunk, FMemoryChunk* UsedChunk);	
 
+	/**
+	* Adds an available chunk to the free address and size trees.
+	*/
+	void			AddToFreeIndex(FMemoryChunk* Chunk);
+
+	/**
+	* Removes an available chunk from the free address and size trees.
+	*/
+	void			RemoveFromFreeIndex(FMemoryChunk* Chunk);
+
+	/**
+	* Changes the base and size of a chunk. Available chunks are re-keyed in the free size tree; the base of an
+	* available chunk may only move over memory that isn't covered by another available chunk.
+	*/
+	void			SetChunkExtent(FMemoryChunk* Chunk, uint8* NewBase, int64 NewSize);
+
+	/**
+	* Returns the smallest available chunk that can hold the allocation right now, lowest address first among equal sizes.
+	*
+	* @param AllocationSize	Aligned allocation size, in bytes
+	* @return				Best fitting free chunk, or nullptr
+	*/
+	FMemoryChunk*	FindBestFit(int64 AllocationSize) const;
+
+	/**
+	* Reference best-fit search walking the whole free list, as Allocate() did before the free chunks were indexed.
+	* Only used by the benchmark to compare against FindBestFit().
+	*/
+	FMemoryChunk*	FindBestFitLinear(int64 AllocationSize) const;
+
+	/**
+	* Returns the available chunk with the highest base address below Base, or the last available chunk if Base is nullptr.
+	*/
+	FMemoryChunk*	FindPreviousFreeChunk(const uint8* Base) const;
+
+	/**
+	* Fragments the pool and compares FindBestFit() against FindBestFitLinear(). Part of Benchmark().
+	*/
+	void			BenchmarkBestFit(int32 MinChunkSize, int32 MaxChunkSize, float FreeRatio);
+
 	FCriticalSection	SynchronizationObject;
 
 	/** Total size of memory pool, in uint8s.						*/
@@ -1057,8 +1240,14 @@ protected:
 	FMemoryChunk*	FirstChunk;
 	/** Last chunk in the linked list of chunks (see FirstChunk).	*/
 	FMemoryChunk*	LastChunk;
-	/** Head of linked list of free chunks.	Unsorted.				*/
+	/** Head of linked list of free chunks. Sorted by memory address.	*/
 	FMemoryChunk*	FirstFreeChunk;
+	/** Root of the treap of free chunks, ordered by base address.	*/
+	FMemoryChunk*	FreeAddressTreeRoot = nullptr;
+	/** Root of the treap of free chunks, ordered by size then base address. */
+	FMemoryChunk*	FreeSizeTreeRoot = nullptr;
+	/** Xorshift state for treap priorities.						*/
+	uint32			FreeTreeSeed = 0x2545F491;
 	/** Cumulative time spent in allocator.							*/
 	double			TimeSpentInAllocator;
 	/** Allocated memory in uint8s.									*/
@@ -1121,6 +1310,23 @@ protected:
 	/** When in benchmark mode, don't call any Platform functions.	*/
 	bool			bBenchmarkMode;
 
+	/** Whether Tick() uses PlannedDefragmentation() instead of the greedy partial defrag. Overrides r.GPUDefrag.CompactionPlanner when set. */
+	TOptional<bool>	UseCompactionPlannerOverride;
+
+	/** Stream used for the defrag retry delays instead of the global FMath random state, if set. Not owned. */
+	FRandomStream*	DefragRandomStream = nullptr;
+
+#if GPU_DEFRAG_TRACE_RECORDING
+	/** Whether Allocate(), Free() and Tick() are being recorded.		*/
+	bool			bRecordingTrace = false;
+	/** Trace id of the next recorded allocation.						*/
+	uint32			NextTraceAllocationId = 0;
+	/** Events recorded since StartTraceRecording().					*/
+	TArray<FAllocationTraceEvent>	TraceEvents;
+	/** Trace ids of the live recorded allocations, by base address.	*/
+	TMap<const void*, uint32>		TraceAllocationIds;
+#endif
+
 	friend FScopedGPUDefragLock;
 };
 
@@ -19,6 +19,12 @@
 
 #if RHI_NEW_GPU_PROFILER
 
+// Fills event stream chunks with a pattern when they are allocated and freed, to catch use-after-free of event data.
+// This touches the whole chunk on every allocation, so it is off by default outside of debug builds.
+#ifndef RHI_GPU_PROFILER_POISON_EVENT_CHUNKS
+	#define RHI_GPU_PROFILER_POISON_EVENT_CHUNKS UE_BUILD_DEBUG
+#endif
+
 namespace UE::RHI::GPUProfiler
 {
 	struct FQueue
@@ -302,6 +308,11 @@ namespace UE::RHI::GPUProfiler
 			: Value(TInPlaceType<T>(), Value)
 		{}
 
+		template <typename T, typename... TArgs>
+		FEvent(TInPlaceType<T>, TArgs&&... Args)
+			: Value(TInPlaceType<T>(), Forward<TArgs>(Args)...)
+		{}
+
 		FEvent(FEvent const&) = delete;
 		FEvent(FEvent&&) = delete;
 	};
@@ -341,16 +352,20 @@ namespace UE::RHI::GPUProfiler
 					Memory = FMemory::Malloc(sizeof(FChunk), alignof(FChunk));
 				}
 
+			#if RHI_GPU_PROFILER_POISON_EVENT_CHUNKS
 				// UE-295331 Investigation : Fill memory with garbage on allocation to catch use-after-free etc.
 				FMemory::Memset(Memory, 0xf7, sizeof(FChunk));
+			#endif
 
 				return Memory;
 			}
 
 			void operator delete(void* Pointer)
 			{
+			#if RHI_GPU_PROFILER_POISON_EVENT_CHUNKS
 				// UE-295331 Investigation : Fill memory with garbage on deallocation to catch use-after-free etc.
 				FMemory::Memset(Pointer, 0xe5, sizeof(FChunk));
+			#endif
 
 				MemoryPool.Push(Pointer);
 			}
@@ -416,7 +431,7 @@ namespace UE::RHI::GPUProfiler
 			}
 
 			FEvent* Event = Current->GetElement(Current->Header.Num++);
-			new (Event) FEvent(TEventType(Forward<TArgs>(Args)...));
+			new (Event) FEvent(TInPlaceType<TEventType>(), Forward<TArgs>(Args)...);
 
 			TEventType& Data = Event->Value.Get<TEventType>();
 
@@ -493,7 +508,11 @@ namespace UE::RHI::GPUProfiler
 				FEvent const* Result = Peek();
 				if (Result)
 				{
-					++Index;
+					// Common case: the next event is in the same chunk.
+					if (++Index < Current->Header.Num)
+					{
+						return Result;
+					}
 
 					while (Current && Index >= Current->Header.Num)
 					{
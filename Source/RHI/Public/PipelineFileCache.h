@@ -84,6 +84,8 @@ struct FPipelineStateStats
 	, CreateCount(0)
 	, TotalBindCount(0)
 	, PSOHash(0)
+	, MaxCompileTimeUs(0)
+	, RuntimeHitchCount(0)
 	{
 	}
 	
@@ -92,6 +94,9 @@ struct FPipelineStateStats
 	}
 
 	RHI_API static void UpdateStats(FPipelineStateStats* Stats);
+
+	/** Records the time it took to create the PSO and whether that creation was a runtime hitch. */
+	RHI_API static void UpdateCompileStats(FPipelineStateStats* Stats, uint64 CompileCycles, bool bRuntimeHitch);
 	
 	friend FArchive& operator<<( FArchive& Ar, FPipelineStateStats& Info );
 
@@ -100,6 +105,8 @@ struct FPipelineStateStats
 	uint64 CreateCount;
 	int64 TotalBindCount;
 	uint32 PSOHash;
+	int32 MaxCompileTimeUs; // Longest creation time observed for this PSO, in microseconds.
+	int32 RuntimeHitchCount; // Number of creations that exceeded r.PSO.RuntimeCreationHitchThreshold (in the worst recorded run once saved).
 };
 
 struct FPipelineCacheFileFormatPSO
@@ -323,7 +330,8 @@ public:
 	{
 		Default = 0, // Whatever order they are already in.
 		FirstToLatestUsed = 1, // Start with the PSOs with the lowest first-frame used and work toward those with the highest.
-		MostToLeastUsed = 2 // Start with the most often used PSOs working toward the least.
+		MostToLeastUsed = 2, // Start with the most often used PSOs working toward the least.
+		CostModel = 3 // Start with the PSOs most likely to hitch early in gameplay (expensive to create, used early and often), finishing with cheap or rarely used ones.
 	};
 
 public:
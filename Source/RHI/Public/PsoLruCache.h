@@ -4,9 +4,16 @@
 
 #include "CoreTypes.h"
 #include "Containers/Set.h"
+#include "Containers/SparseArray.h"
+#include "Math/UnrealMathUtility.h"
 #include "Misc/AssertionMacros.h"
+#include <type_traits>
 
 /* Implements a Least Recently Used (LRU) cache.
+ *
+ * Entries live in a sparse array that is preallocated to the maximum number of elements. Both the recency list and the
+ * lookup hash chains are linked by entry index, so adding, touching and removing entries never allocates and only ever
+ * touches entries within one contiguous allocation.
  *
  * @param KeyType The type of cache entry keys.
  * @param ValueType The type of cache entry values.
@@ -17,14 +24,20 @@ class TPsoLruCache
 	/** An entry in the LRU cache. */
 	struct FCacheEntry
 	{
-		/** The entry's lookup key. */
-		KeyType Key;
-
 		/** The less recent entry in the linked list. */
-		FCacheEntry* LessRecent;
+		int32 LessRecent;
 
 		/** The more recent entry in the linked list. */
-		FCacheEntry* MoreRecent;
+		int32 MoreRecent;
+
+		/** The next entry in the same lookup bucket. */
+		int32 NextInBucket;
+
+		/** Hash of the key, compared before the key itself and used to find the entry's lookup bucket. */
+		uint32 KeyHash;
+
+		/** The entry's lookup key. */
+		KeyType Key;
 
 		/** The entry's value. */
 		ValueType Value;
@@ -33,69 +46,25 @@ class TPsoLruCache
 		 * Create and initialize a new instance.
 		 *
 		 * @param InKey The entry's key.
+		 * @param InKeyHash The hash of the entry's key.
 		 * @param InValue The entry's value.
 		 */
-		FCacheEntry(const KeyType& InKey, const ValueType& InValue)
-			: Key(InKey)
-			, LessRecent(nullptr)
-			, MoreRecent(nullptr)
+		FCacheEntry(const KeyType& InKey, uint32 InKeyHash, const ValueType& InValue)
+			: LessRecent(INDEX_NONE)
+			, MoreRecent(INDEX_NONE)
+			, NextInBucket(INDEX_NONE)
+			, KeyHash(InKeyHash)
+			, Key(InKey)
 			, Value(InValue)
 		{ }
-
-		/** Add this entry before the given one. */
-		inline void LinkBefore(FCacheEntry* Other)
-		{
-			LessRecent = Other;
-
-			if (Other != nullptr)
-			{
-				Other->MoreRecent = this;
-			}
-		}
-
-		/** Remove this entry from the list. */
-		inline void Unlink()
-		{
-			if (LessRecent != nullptr)
-			{
-				LessRecent->MoreRecent = MoreRecent;
-			}
-
-			if (MoreRecent != nullptr)
-			{
-				MoreRecent->LessRecent = LessRecent;
-			}
-
-			LessRecent = nullptr;
-			MoreRecent = nullptr;
-		}
-	};
-
-	/** Lookup set key functions. */
-	struct FKeyFuncs : public BaseKeyFuncs<FCacheEntry*, KeyType>
-	{
-		inline static const KeyType& GetSetKey(const FCacheEntry* Entry)
-		{
-			return Entry->Key;
-		}
-
-		inline static bool Matches(KeyType A, KeyType B)
-		{
-			return A == B;
-		}
-
-		inline static uint32 GetKeyHash(KeyType Key)
-		{
-			return GetTypeHash(Key);
-		}
 	};
 
 public:
 
 	/** Default constructor (empty cache that cannot hold any values). */
 	TPsoLruCache()
-		: LeastRecent(nullptr)
-		, MostRecent(nullptr)
+		: LeastRecent(INDEX_NONE)
+		, MostRecent(INDEX_NONE)
 		, MaxNumElements(0)
 	{ }
 
@@ -105,8 +74,8 @@ public:
 	 * @param InMaxNumElements The maximum number of elements this cache can hold.
 	 */
 	TPsoLruCache(int32 InMaxNumElements)
-		: LeastRecent(nullptr)
-		, MostRecent(nullptr)
+		: LeastRecent(INDEX_NONE)
+		, MostRecent(INDEX_NONE)
 		, MaxNumElements(InMaxNumElements)
 	{
 		Empty(InMaxNumElements);
@@ -135,20 +104,20 @@ public:
 	 */
 	FSetElementId Add(const KeyType& Key, const ValueType& Value)
 	{
-		check(MaxNumElements > 0 && "Cannot add values to zero size FOpenGLLruCache");
-		check(!LookupSet.Contains(Key));
+		check(MaxNumElements > 0 && "Cannot add values to zero size TPsoLruCache");
+		check(!Contains(Key));
 
-		check(LookupSet.Num() < MaxNumElements);
-		// add new entry
-		FCacheEntry* NewEntry = new FCacheEntry(Key, Value);
-		NewEntry->LinkBefore(MostRecent);
-		MostRecent = NewEntry;
+		check(Entries.Num() < MaxNumElements);
+		// add new entry, reusing the most recently freed slot
+		const uint32 KeyHash = GetTypeHash(Key);
+		const int32 NewIndex = Entries.Emplace(Key, KeyHash, Value);
 
-		if (LeastRecent == nullptr)
-		{
-			LeastRecent = NewEntry;
-		}
-		return LookupSet.Add(NewEntry);
+		int32& Bucket = Buckets[KeyHash & (Buckets.Num() - 1)];
+		Entries[NewIndex].NextInBucket = Bucket;
+		Bucket = NewIndex;
+
+		LinkAsMostRecent(NewIndex);
+		return FSetElementId::FromInteger(NewIndex);
 	}
 
 	/**
@@ -160,7 +129,7 @@ public:
 	 */
 	inline bool Contains(const KeyType& Key) const
 	{
-		return LookupSet.Contains(Key);
+		return FindIndex(Key) != INDEX_NONE;
 	}
 
 	/**
@@ -173,9 +142,9 @@ public:
 	template<typename Predicate>
 	inline bool ContainsByPredicate(Predicate Pred) const
 	{
-		for (const FCacheEntry* Entry : LookupSet)
+		for (const FCacheEntry& Entry : Entries)
 		{
-			if (Pred(Entry->Key, Entry->Value))
+			if (Pred(Entry.Key, Entry.Value))
 			{
 				return true;
 			}
@@ -194,16 +163,17 @@ public:
 	{
 		check(InMaxNumElements >= 0);
 
-		for (FCacheEntry* Entry : LookupSet)
+		MaxNumElements = InMaxNumElements;
+		Entries.Empty(MaxNumElements);
+
+		Buckets.Empty();
+		if (MaxNumElements > 0)
 		{
-			delete Entry;
+			Buckets.Init(INDEX_NONE, (int32)FMath::RoundUpToPowerOfTwo((uint32)MaxNumElements));
 		}
 
-		MaxNumElements = InMaxNumElements;
-		LookupSet.Empty(MaxNumElements);
-
-		MostRecent = nullptr;
-		LeastRecent = nullptr;
+		MostRecent = INDEX_NONE;
+		LeastRecent = INDEX_NONE;
 	}
 
 	/**
@@ -218,11 +188,11 @@ public:
 	{
 		TArray<ValueType> Result;
 
-		for (const FCacheEntry* Entry : LookupSet)
+		for (const FCacheEntry& Entry : Entries)
 		{
-			if (Pred(Entry->Key, Entry->Value))
+			if (Pred(Entry.Key, Entry.Value))
 			{
-				Result.Add(Entry->Value);
+				Result.Add(Entry.Value);
 			}
 		}
 
@@ -238,11 +208,11 @@ public:
 	 */
 	inline const ValueType* Find(const KeyType& Key) const
 	{
-		FCacheEntry** EntryPtr = LookupSet.Find(Key);
+		const int32 Index = FindIndex(Key);
 
-		if (EntryPtr != nullptr)
+		if (Index != INDEX_NONE)
 		{
-			return &(*EntryPtr)->Value;
+			return &Entries[Index].Value;
 		}
 
 		return nullptr;
@@ -257,16 +227,16 @@ public:
 	 */
 	const ValueType* FindAndTouch(const KeyType& Key)
 	{
-		FCacheEntry** EntryPtr = LookupSet.Find(Key);
+		const int32 Index = FindIndex(Key);
 
-		if (EntryPtr == nullptr)
+		if (Index == INDEX_NONE)
 		{
 			return nullptr;
 		}
 
-		MarkAsRecent(**EntryPtr);
+		MarkAsRecent(Index);
 
-		return &(*EntryPtr)->Value;
+		return &Entries[Index].Value;
 	}
 
 	/**
@@ -279,11 +249,11 @@ public:
 	template<typename Predicate>
 	const ValueType* FindByPredicate(Predicate Pred) const
 	{
-		for (const FCacheEntry* Entry : LookupSet)
+		for (const FCacheEntry& Entry : Entries)
 		{
-			if (Pred(Entry->Key, Entry->Value))
+			if (Pred(Entry.Key, Entry.Value))
 			{
-				return &Entry->Value;
+				return &Entry.Value;
 			}
 		}
 
@@ -298,9 +268,9 @@ public:
 	 */
 	void GetKeys(TArray<KeyType>& OutKeys) const
 	{
-		for (const FCacheEntry* Entry : LookupSet)
+		for (const FCacheEntry& Entry : Entries)
 		{
-			OutKeys.Add(Entry->Key);
+			OutKeys.Add(Entry.Key);
 		}
 	}
 
@@ -323,7 +293,7 @@ public:
 	 */
 	inline int32 Num() const
 	{
-		return LookupSet.Num();
+		return Entries.Num();
 	}
 
 	/**
@@ -334,22 +304,22 @@ public:
 	 */
 	void Remove(const KeyType& Key)
 	{
-		FCacheEntry** EntryPtr = LookupSet.Find(Key);
+		const int32 Index = FindIndex(Key);
 
-		if (EntryPtr != nullptr)
+		if (Index != INDEX_NONE)
 		{
-			Remove(*EntryPtr);
+			RemoveAt(Index);
 		}
 	}
 
 	bool Remove(const KeyType& Key, ValueType& RemovedValue)
 	{
-		FCacheEntry** EntryPtr = LookupSet.Find(Key);
+		const int32 Index = FindIndex(Key);
 
-		if (EntryPtr != nullptr)
+		if (Index != INDEX_NONE)
 		{
-			RemovedValue = MoveTemp((*EntryPtr)->Value);
-			Remove(*EntryPtr);
+			RemovedValue = MoveTemp(Entries[Index].Value);
+			RemoveAt(Index);
 			return true;
 		}
 		return false;
@@ -367,13 +337,18 @@ public:
 	{
 		int32 NumRemoved = 0;
 
-		for (const FCacheEntry* Entry : LookupSet)
+		for (int32 Index = MostRecent; Index != INDEX_NONE;)
 		{
-			if (Pred(Entry->Key, Entry->Value))
+			const FCacheEntry& Entry = Entries[Index];
+			const int32 LessRecentIndex = Entry.LessRecent;
+
+			if (Pred(Entry.Key, Entry.Value))
 			{
-				Remove(Entry);
+				RemoveAt(Index);
 				++NumRemoved;
 			}
+
+			Index = LessRecentIndex;
 		}
 
 		return NumRemoved;
@@ -386,9 +361,9 @@ public:
 	 */
 	inline ValueType RemoveLeastRecent()
 	{
-		check(LeastRecent);
-		ValueType LeastRecentElement = MoveTemp(LeastRecent->Value);
-		Remove(LeastRecent);
+		check(LeastRecent != INDEX_NONE);
+		ValueType LeastRecentElement = MoveTemp(Entries[LeastRecent].Value);
+		RemoveAt(LeastRecent);
 		return LeastRecentElement;
 	}
 
@@ -399,8 +374,8 @@ public:
 	 */
 	inline const ValueType GetLeastRecent() const
 	{
-		check(LeastRecent);
-		return LeastRecent->Value;
+		check(LeastRecent != INDEX_NONE);
+		return Entries[LeastRecent].Value;
 	}
 
 	/**
@@ -410,15 +385,15 @@ public:
 	*/
 	inline ValueType RemoveMostRecent()
 	{
-		check(MostRecent);
-		ValueType MostRecentElement = MoveTemp(MostRecent->Value);
-		Remove(MostRecent);
+		check(MostRecent != INDEX_NONE);
+		ValueType MostRecentElement = MoveTemp(Entries[MostRecent].Value);
+		RemoveAt(MostRecent);
 		return MostRecentElement;
 	}
 
 	inline void MarkAsRecent(const FSetElementId& LRUNode)
 	{
-		MarkAsRecent(*LookupSet[LRUNode]);
+		MarkAsRecent(LRUNode.AsInteger());
 	}
 
 public:
@@ -431,14 +406,20 @@ public:
 	template<bool Const>
 	class TBaseIterator
 	{
+		using CacheType = std::conditional_t<Const, const TPsoLruCache, TPsoLruCache>;
+		using ItKeyType = std::conditional_t<Const, const KeyType, KeyType>;
+		using ItValueType = std::conditional_t<Const, const ValueType, ValueType>;
+
 	public:
 
 		inline TBaseIterator()
-			: CurrentEntry(nullptr)
+			: Cache(nullptr)
+			, CurrentIndex(INDEX_NONE)
 		{ }
 
-		inline TBaseIterator(const TPsoLruCache& Cache)
-			: CurrentEntry(Cache.MostRecent)
+		inline TBaseIterator(CacheType& InCache)
+			: Cache(&InCache)
+			, CurrentIndex(InCache.MostRecent)
 		{ }
 
 	public:
@@ -451,29 +432,27 @@ public:
 
 		inline friend bool operator==(const TBaseIterator& Lhs, const TBaseIterator& Rhs)
 		{
-			return Lhs.CurrentEntry == Rhs.CurrentEntry;
+			return Lhs.CurrentIndex == Rhs.CurrentIndex;
 		}
 
 		inline friend bool operator!=(const TBaseIterator& Lhs, const TBaseIterator& Rhs)
 		{
-			return Lhs.CurrentEntry != Rhs.CurrentEntry;
+			return Lhs.CurrentIndex != Rhs.CurrentIndex;
 		}
 
-		ValueType& operator->() const
+		ItValueType& operator->() const
 		{
-			check(CurrentEntry != nullptr);
-			return CurrentEntry->Value;
+			return Value();
 		}
 
-		ValueType& operator*() const
+		ItValueType& operator*() const
 		{
-			check(CurrentEntry != nullptr);
-			return CurrentEntry->Value;
+			return Value();
 		}
 
 		inline explicit operator bool() const
 		{
-			return (CurrentEntry != nullptr);
+			return (CurrentIndex != INDEX_NONE);
 		}
 
 		inline bool operator!() const
@@ -483,34 +462,40 @@ public:
 
 	public:
 
-		inline KeyType& Key() const
+		inline ItKeyType& Key() const
 		{
-			check(CurrentEntry != nullptr);
-			return CurrentEntry->Key;
+			check(CurrentIndex != INDEX_NONE);
+			return Cache->Entries[CurrentIndex].Key;
 		}
 
-		inline ValueType& Value() const
+		inline ItValueType& Value() const
 		{
-			check(CurrentEntry != nullptr);
-			return CurrentEntry->Value;
+			check(CurrentIndex != INDEX_NONE);
+			return Cache->Entries[CurrentIndex].Value;
 		}
 
 	protected:
 
-		FCacheEntry* GetCurrentEntry()
+		CacheType* GetCache() const
+		{
+			return Cache;
+		}
+
+		int32 GetCurrentIndex() const
 		{
-			return CurrentEntry;
+			return CurrentIndex;
 		}
 
 		void Increment()
 		{
-			check(CurrentEntry != nullptr);
-			CurrentEntry = CurrentEntry->LessRecent;
+			check(CurrentIndex != INDEX_NONE);
+			CurrentIndex = Cache->Entries[CurrentIndex].LessRecent;
 		}
 
 	private:
 
-		FCacheEntry* CurrentEntry;
+		CacheType* Cache;
+		int32 CurrentIndex;
 	};
 
 
@@ -531,7 +516,7 @@ public:
 		{ }
 	};
 
-	
+
 	/**
 	 * Cache iterator.
 	 */
@@ -542,82 +527,147 @@ public:
 
 		inline TIterator()
 			: TBaseIterator<false>()
-			, Cache(nullptr)
 		{ }
 
 		inline TIterator(TPsoLruCache& InCache)
 			: TBaseIterator<false>(InCache)
-			, Cache(&InCache)
 		{ }
 
 		/** Removes the current element from the cache and increments the iterator. */
 		inline void RemoveCurrentAndIncrement()
 		{
-			check(Cache != nullptr);
+			check(this->GetCache() != nullptr);
 
-			FCacheEntry* MoreRecentEntry = this->GetCurrentEntry();
+			const int32 MoreRecentIndex = this->GetCurrentIndex();
 			this->Increment();
-			Cache->Remove(MoreRecentEntry);
+			this->GetCache()->RemoveAt(MoreRecentIndex);
 		}
-
-	private:
-		
-		TPsoLruCache* Cache;
 	};
 
 protected:
 
 	/**
-	 * Mark the given entry as recently used.
+	 * Find the index of the entry with the specified key.
 	 *
-	 * @param Entry The entry to mark.
+	 * @param Key The key of the entry to find.
+	 * @return Index of the entry, or INDEX_NONE if not found.
 	 */
-	inline void MarkAsRecent(FCacheEntry& Entry)
+	inline int32 FindIndex(const KeyType& Key) const
 	{
-		check(LeastRecent != nullptr);
-		check(MostRecent != nullptr);
+		if (Buckets.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const uint32 KeyHash = GetTypeHash(Key);
 
-		// if entry is least recent and not the only item in the list, make it not least recent
-		if ((&Entry == LeastRecent) && (LeastRecent->MoreRecent != nullptr))
+		for (int32 Index = Buckets[KeyHash & (Buckets.Num() - 1)]; Index != INDEX_NONE;)
 		{
-			LeastRecent = LeastRecent->MoreRecent;
+			const FCacheEntry& Entry = Entries[Index];
+			if (Entry.KeyHash == KeyHash && Entry.Key == Key)
+			{
+				return Index;
+			}
+			Index = Entry.NextInBucket;
 		}
 
-		// relink if not already the most recent item
-		if (&Entry != MostRecent)
+		return INDEX_NONE;
+	}
+
+	/**
+	 * Link the given unlinked entry at the most recent end of the list.
+	 *
+	 * @param Index The index of the entry to link.
+	 */
+	inline void LinkAsMostRecent(int32 Index)
+	{
+		FCacheEntry& Entry = Entries[Index];
+		Entry.LessRecent = MostRecent;
+		Entry.MoreRecent = INDEX_NONE;
+
+		if (MostRecent != INDEX_NONE)
+		{
+			Entries[MostRecent].MoreRecent = Index;
+		}
+		else
 		{
-			Entry.Unlink();
-			Entry.LinkBefore(MostRecent);
-			MostRecent = &Entry;
+			LeastRecent = Index;
 		}
+
+		MostRecent = Index;
 	}
 
 	/**
-	 * Remove the specified entry from the cache.
+	 * Remove the given entry from the list.
 	 *
-	 * @param Entry The entry to remove.
+	 * @param Index The index of the entry to unlink.
 	 */
-	inline void Remove(FCacheEntry* Entry)
+	inline void Unlink(int32 Index)
 	{
-		if (Entry == nullptr)
+		FCacheEntry& Entry = Entries[Index];
+
+		if (Entry.LessRecent != INDEX_NONE)
 		{
-			return;
+			Entries[Entry.LessRecent].MoreRecent = Entry.MoreRecent;
+		}
+		else
+		{
+			LeastRecent = Entry.MoreRecent;
 		}
 
-		LookupSet.Remove(Entry->Key);
+		if (Entry.MoreRecent != INDEX_NONE)
+		{
+			Entries[Entry.MoreRecent].LessRecent = Entry.LessRecent;
+		}
+		else
+		{
+			MostRecent = Entry.LessRecent;
+		}
+
+		Entry.LessRecent = INDEX_NONE;
+		Entry.MoreRecent = INDEX_NONE;
+	}
+
+	/**
+	 * Mark the given entry as recently used.
+	 *
+	 * @param Index The index of the entry to mark.
+	 */
+	inline void MarkAsRecent(int32 Index)
+	{
+		check(LeastRecent != INDEX_NONE);
+		check(MostRecent != INDEX_NONE);
 
-		if (Entry == LeastRecent)
+		// relink if not already the most recent item
+		if (Index != MostRecent)
+		{
+			Unlink(Index);
+			LinkAsMostRecent(Index);
+		}
+	}
+
+	/**
+	 * Remove the specified entry from the cache.
+	 *
+	 * @param Index The index of the entry to remove.
+	 */
+	inline void RemoveAt(int32 Index)
+	{
+		if (Index == INDEX_NONE)
 		{
-			LeastRecent = Entry->MoreRecent;
+			return;
 		}
 
-		if (Entry == MostRecent)
+		int32* Link = &Buckets[Entries[Index].KeyHash & (Buckets.Num() - 1)];
+		while (*Link != Index)
 		{
-			MostRecent = Entry->LessRecent;
+			check(*Link != INDEX_NONE);
+			Link = &Entries[*Link].NextInBucket;
 		}
+		*Link = Entries[Index].NextInBucket;
 
-		Entry->Unlink();
-		delete Entry;
+		Unlink(Index);
+		Entries.RemoveAt(Index);
 	}
 
 private:
@@ -629,14 +679,17 @@ private:
 
 private:
 
-	/** Set of entries for fast lookup. */
-	TSet<FCacheEntry*, FKeyFuncs> LookupSet;
+	/** Entries, preallocated to MaxNumElements. Freed slots are reused by the next Add. */
+	TSparseArray<FCacheEntry> Entries;
+
+	/** Heads of the lookup hash chains, one bucket per element rounded up to a power of two. */
+	TArray<int32> Buckets;
 
-	/** Least recent item in the cache. */
-	FCacheEntry* LeastRecent;
+	/** Index of the least recent item in the cache. */
+	int32 LeastRecent;
 
-	/** Most recent item in the cache. */
-	FCacheEntry* MostRecent;
+	/** Index of the most recent item in the cache. */
+	int32 MostRecent;
 
 	/** Maximum number of elements in the cache. */
 	int32 MaxNumElements;
@@ -233,6 +233,9 @@ private:
 #endif
 
 	friend FRHICommandListImmediate;
+#if RHI_ENABLE_RESOURCE_INFO
+	friend class FRHITrackedResourceRegistry;
+#endif
 };
 
 enum class EClearBinding
@@ -532,6 +532,22 @@ enum class ERHITransientResourceCreateMode
 	Task
 };
 
+/** Describes one transient allocation of an allocation cycle ahead of time. The full list is provided in the order in which the
+ *  resources will be created, which allows the allocator to plan memory placements with knowledge of every lifetime.
+ */
+struct FRHITransientAllocationLifetime
+{
+	static const uint32 kInvalidIndex = TNumericLimits<uint32>::Max();
+
+	// Create info of the resource; exactly one is valid.
+	const FRHITextureCreateInfo* TextureCreateInfo = nullptr;
+	const FRHIBufferCreateInfo* BufferCreateInfo = nullptr;
+
+	// Positions of the allocate and deallocate operations in the allocation cycle. Resources which are not deallocated within the cycle use kInvalidIndex.
+	uint32 AllocateIndex = 0;
+	uint32 DeallocateIndex = kInvalidIndex;
+};
+
 class IRHITransientResourceAllocator
 {
 public:
@@ -543,6 +559,10 @@ public:
 	// Sets the create mode for allocations.
 	virtual void SetCreateMode(ERHITransientResourceCreateMode CreateMode) {};
 
+	// Provides every allocation of the upcoming cycle prior to creation so the allocator may plan placements up front. Resources are still
+	// created through CreateTexture / CreateBuffer in the same order. Returns whether a plan was made.
+	virtual bool PlanAllocations(TConstArrayView<FRHITransientAllocationLifetime> Lifetimes) { return false; }
+
 	// Allocates a new transient resource with memory backed by the transient allocator.
 	virtual FRHITransientTexture* CreateTexture(const FRHITextureCreateInfo& CreateInfo, const TCHAR* DebugName, const FRHITransientAllocationFences& Fences) = 0;
 	virtual FRHITransientBuffer* CreateBuffer(const FRHIBufferCreateInfo& CreateInfo, const TCHAR* DebugName, const FRHITransientAllocationFences& Fences) = 0;
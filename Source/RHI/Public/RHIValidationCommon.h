@@ -12,6 +12,7 @@
 #include "RHIStrings.h"
 #include "RHIAccess.h"
 #include "RHIBreadcrumbs.h"
+#include "Misc/Optional.h"
 #include "Templates/TypeHash.h"
 
 #if ENABLE_RHI_VALIDATION
@@ -198,11 +199,37 @@ namespace RHIValidation
 			// Pointer to the previous create/begin transition backtraces if logging is enabled for this resource.
 			void* CreateTransitionBacktrace = nullptr;
 			void* BeginTransitionBacktrace = nullptr;
+
+			inline bool operator == (FPipelineState const& Other) const
+			{
+				return Previous == Other.Previous
+					&& Current == Other.Current
+					&& Flags == Other.Flags
+					&& bTransitioning == Other.bTransitioning
+					&& bIgnoringAfterState == Other.bIgnoringAfterState
+					&& bUsedWithAllUAVsOverlap == Other.bUsedWithAllUAVsOverlap
+					&& bExplicitAllowUAVOverlap == Other.bExplicitAllowUAVOverlap
+					&& bUsedWithExplicitUAVsOverlap == Other.bUsedWithExplicitUAVsOverlap
+					&& CreateTransitionBacktrace == Other.CreateTransitionBacktrace
+					&& BeginTransitionBacktrace == Other.BeginTransitionBacktrace;
+			}
 		};
 
 		TRHIPipelineArray<uint64> LastTransitionFences{InPlace, 0};
 		TRHIPipelineArray<FPipelineState> States;
 
+		inline bool operator == (FSubresourceState const& Other) const
+		{
+			for (ERHIPipeline Pipeline : MakeFlagsRange(ERHIPipeline::All))
+			{
+				if (LastTransitionFences[Pipeline] != Other.LastTransitionFences[Pipeline] || !(States[Pipeline] == Other.States[Pipeline]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
 		void BeginTransition   (FResource* Resource, FSubresourceIndex const& SubresourceIndex, const FState& CurrentStateFromRHI, const FState& TargetState, EResourceTransitionFlags NewFlags, ERHITransitionCreateFlags CreateFlags, ERHIPipeline Pipeline, const TRHIPipelineArray<uint64>& PipelineMaxAwaitedFenceValues, void* CreateTrace);
 		void EndTransition     (FResource* Resource, FSubresourceIndex const& SubresourceIndex, const FState& CurrentStateFromRHI, const FState& TargetState, EResourceTransitionFlags NewFlags, ERHIPipeline Pipeline, uint64 PipelineFenceValue, void* CreateTrace);
 		void Assert            (FResource* Resource, FSubresourceIndex const& SubresourceIndex, const FState& RequiredState, bool bAllowAllUAVsOverlap);
@@ -343,7 +370,11 @@ namespace RHIValidation
 
 		mutable FThreadSafeCounter NumOpRefs;
 
-		inline void EnumerateSubresources(FSubresourceRange const& SubresourceRange, TFunctionRef<void(FSubresourceState&, FSubresourceIndex const&)> Callback, bool bBeginTransition = false);
+		// Resources are tracked with a single whole-resource state until an operation touches a sub-range, and collapse back once all subresources agree again.
+		template <typename TCallback>
+		inline void EnumerateSubresources(FSubresourceRange const& SubresourceRange, TCallback&& Callback, bool bBeginTransition = false);
+
+		bool TryCollapseSubresourceStates();
 
 	public:
 		~FResource()
@@ -928,13 +959,21 @@ namespace RHIValidation
 		{
 			int32 ReplayPos = 0;
 
+#if WITH_RHI_BREADCRUMBS
+			// Applied before the first op is replayed, instead of being inserted at the front of the list.
+			TOptional<FRHIBreadcrumbRange> BreadcrumbRange;
+#endif
+
 			FOpsList(FOpsList&&) = default;
+			FOpsList& operator = (FOpsList&&) = default;
 			FOpsList(TArray<FOperation>&& Other)
 				: TArray(MoveTemp(Other))
 			{}
 		};
 
+		// Lists waiting to be replayed, oldest first. Lists before ReplayListIndex have been fully replayed and are removed in batches.
 		TArray<FOpsList> Ops;
+		int32 ReplayListIndex = 0;
 
 		FOpQueueState(ERHIPipeline Pipeline)
 			: Pipeline(Pipeline)
@@ -996,6 +1035,10 @@ namespace RHIValidation
 			return MoveTemp(CurrentList);
 		}
 
+		// Op lists are recycled once replayed so that recording does not regrow a fresh array for every command list.
+		static TArray<FOperation> AllocateOpList();
+		static void ReleaseOpList(TArray<FOperation>&& List);
+
 #if WITH_RHI_BREADCRUMBS
 		void BeginBreadcrumbGPU(FRHIBreadcrumbNode* Breadcrumb)
 		{
@@ -1079,7 +1122,7 @@ namespace RHIValidation
 
 		static FOpQueueState& GetQueue(ERHIPipeline Pipeline);
 
-		static void SubmitValidationOps(ERHIPipeline Pipeline, TArray<RHIValidation::FOperation>&& Ops);
+		static void SubmitValidationOps(ERHIPipeline Pipeline, FOpQueueState::FOpsList&& Ops);
 
 	private:
 		const ERHIPipeline Pipeline;
@@ -18,6 +18,7 @@ public:
 	// Implementation of FRHITransientResourceAllocator interface
 	virtual void SetCreateMode(ERHITransientResourceCreateMode InCreateMode) override final;
 	virtual bool SupportsResourceType(ERHITransientResourceType InType) const override final { return RHIAllocator->SupportsResourceType(InType); }
+	virtual bool PlanAllocations(TConstArrayView<FRHITransientAllocationLifetime> Lifetimes) override final { return RHIAllocator->PlanAllocations(Lifetimes); }
 	virtual FRHITransientTexture* CreateTexture(const FRHITextureCreateInfo& InCreateInfo, const TCHAR* InDebugName, const FRHITransientAllocationFences& Fences) override final;
 	virtual FRHITransientBuffer* CreateBuffer(const FRHIBufferCreateInfo& InCreateInfo, const TCHAR* InDebugName, const FRHITransientAllocationFences& Fences) override final;
 	virtual void DeallocateMemory(FRHITransientTexture* InTexture, const FRHITransientAllocationFences& Fences) override final;
@@ -1,14 +1,18 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RHICoreTransientResourceAllocator.h"
+#include "Algo/Sort.h"
 #include "HAL/IConsoleManager.h"
 #include "HAL/LowLevelMemTracker.h"
 #include "HAL/LowLevelMemStats.h"
+#include "Math/RandomStream.h"
+#include "Misc/ScopeLock.h"
 #include "ProfilingDebugging/CountersTrace.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "RHICommandList.h"
 #include "RHICoreNvidiaAftermath.h"
 #include "RHICore.h"
+#include <atomic>
 
 static bool GRHITransientAllocatorParallelResourceCreation = true;
 static FAutoConsoleVariableRef CVarRHITransientAllocatorParallelResourceCreation(
@@ -45,6 +49,13 @@ static FAutoConsoleVariableRef CVarRHITransientAllocatorGarbageCollectLatency(
 	TEXT("Amount of update cycles before memory is reclaimed."),
 	ECVF_ReadOnly);
 
+static float GRHITransientAllocatorPlacementPlanningBudget = 0.5f;
+static FAutoConsoleVariableRef CVarRHITransientAllocatorPlacementPlanningBudget(
+	TEXT("RHI.TransientAllocator.PlacementPlanningBudget"),
+	GRHITransientAllocatorPlacementPlanningBudget,
+	TEXT("Time budget in milliseconds for planning heap placements when all allocation lifetimes are provided up front. 0 disables planning (Default 0.5)."),
+	ECVF_RenderThreadSafe);
+
 TRACE_DECLARE_INT_COUNTER(TransientResourceCreateCount, TEXT("TransientAllocator/ResourceCreateCount"));
 
 TRACE_DECLARE_INT_COUNTER(TransientTextureCreateCount, TEXT("TransientAllocator/TextureCreateCount"));
@@ -65,6 +76,9 @@ TRACE_DECLARE_INT_COUNTER(TransientMemoryRangeCount, TEXT("TransientAllocator/Me
 
 TRACE_DECLARE_MEMORY_COUNTER(TransientMemoryUsed, TEXT("TransientAllocator/MemoryUsed"));
 TRACE_DECLARE_MEMORY_COUNTER(TransientMemoryRequested, TEXT("TransientAllocator/MemoryRequested"));
+TRACE_DECLARE_MEMORY_COUNTER(TransientMemoryPlanned, TEXT("TransientAllocator/MemoryPlanned"));
+TRACE_DECLARE_MEMORY_COUNTER(TransientMemoryUnplanned, TEXT("TransientAllocator/MemoryUnplanned"));
+TRACE_DECLARE_INT_COUNTER(TransientPlanFallbackCount, TEXT("TransientAllocator/PlanFallbackCount"));
 
 DECLARE_STATS_GROUP(TEXT("RHI: Transient Memory"), STATGROUP_RHITransientMemory, STATCAT_Advanced);
 
@@ -73,10 +87,14 @@ DECLARE_MEMORY_STAT(TEXT("Memory Aliased"), STAT_RHITransientMemoryAliased, STAT
 DECLARE_MEMORY_STAT(TEXT("Memory Requested"), STAT_RHITransientMemoryRequested, STATGROUP_RHITransientMemory);
 DECLARE_MEMORY_STAT(TEXT("Buffer Memory Requested"), STAT_RHITransientBufferMemoryRequested, STATGROUP_RHITransientMemory);
 DECLARE_MEMORY_STAT(TEXT("Texture Memory Requested"), STAT_RHITransientTextureMemoryRequested, STATGROUP_RHITransientMemory);
+DECLARE_MEMORY_STAT(TEXT("Memory Planned"), STAT_RHITransientMemoryPlanned, STATGROUP_RHITransientMemory);
+DECLARE_MEMORY_STAT(TEXT("Memory Unplanned"), STAT_RHITransientMemoryUnplanned, STATGROUP_RHITransientMemory);
 
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resources"), STAT_RHITransientResources, STATGROUP_RHITransientMemory);
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Textures"), STAT_RHITransientTextures, STATGROUP_RHITransientMemory);
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffers"), STAT_RHITransientBuffers, STATGROUP_RHITransientMemory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Planned Allocations"), STAT_RHITransientPlannedAllocations, STATGROUP_RHITransientMemory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Plan Fallbacks"), STAT_RHITransientPlanFallbacks, STATGROUP_RHITransientMemory);
 
 DECLARE_LLM_MEMORY_STAT(TEXT("RHI Transient Resources"), STAT_RHITransientResourcesLLM, STATGROUP_LLMFULL);
 
@@ -114,9 +132,195 @@ void FRHITransientMemoryStats::Submit(uint64 UsedSize)
 	SET_DWORD_STAT(STAT_RHITransientBuffers, Buffers.AllocationCount);
 	SET_DWORD_STAT(STAT_RHITransientResources, Textures.AllocationCount + Buffers.AllocationCount);
 
+	if (PlannedAllocationCount > 0 || PlanFallbackCount > 0)
+	{
+		TRACE_COUNTER_SET(TransientMemoryPlanned, PlannedSize);
+		TRACE_COUNTER_SET(TransientMemoryUnplanned, UnplannedSize);
+		TRACE_COUNTER_SET(TransientPlanFallbackCount, PlanFallbackCount);
+
+		CSV_CUSTOM_STAT_GLOBAL(TransientMemoryPlannedMB, static_cast<float>(PlannedSize * ToMB), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT_GLOBAL(TransientMemoryUnplannedMB, static_cast<float>(UnplannedSize * ToMB), ECsvCustomStatOp::Set);
+
+		SET_MEMORY_STAT(STAT_RHITransientMemoryPlanned, PlannedSize);
+		SET_MEMORY_STAT(STAT_RHITransientMemoryUnplanned, UnplannedSize);
+		SET_DWORD_STAT(STAT_RHITransientPlannedAllocations, PlannedAllocationCount);
+		SET_DWORD_STAT(STAT_RHITransientPlanFallbacks, PlanFallbackCount);
+	}
+
 	Reset();
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Transient Placement Planner
+//////////////////////////////////////////////////////////////////////////
+
+void FRHITransientPlacementPlanner::Reset()
+{
+	Offsets.Reset();
+	PlannedSize = 0;
+	UnplannedSize = 0;
+}
+
+bool FRHITransientPlacementPlanner::PlaceItems(TConstArrayView<FItem> Items, TConstArrayView<uint32> Order, double EndTime, TArray<uint64>& OutOffsets, uint64& OutPeakSize)
+{
+	OutOffsets.SetNumUninitialized(Items.Num(), EAllowShrinking::No);
+	OutPeakSize = 0;
+	PlacedItems.Reset();
+
+	for (int32 OrderIndex = 0; OrderIndex < Order.Num(); ++OrderIndex)
+	{
+		if ((OrderIndex & 63) == 63 && FPlatformTime::Seconds() > EndTime)
+		{
+			return false;
+		}
+
+		const uint32 ItemIndex = Order[OrderIndex];
+		const FItem& Item = Items[ItemIndex];
+
+		// Gather the memory ranges of placed items whose lifetimes intersect this one.
+		ConflictRanges.Reset();
+
+		for (uint32 PlacedIndex : PlacedItems)
+		{
+			const FItem& PlacedItem = Items[PlacedIndex];
+
+			if (PlacedItem.Begin < Item.End && Item.Begin < PlacedItem.End)
+			{
+				ConflictRanges.Add({ OutOffsets[PlacedIndex], OutOffsets[PlacedIndex] + PlacedItem.Size });
+			}
+		}
+
+		Algo::SortBy(ConflictRanges, &FPlacedRange::Min);
+
+		// Take the lowest aligned gap which fits the item.
+		uint64 Offset = 0;
+
+		for (const FPlacedRange& Range : ConflictRanges)
+		{
+			if (Offset + Item.Size <= Range.Min)
+			{
+				break;
+			}
+
+			Offset = FMath::Max(Offset, Align(Range.Max, (uint64)Item.Alignment));
+		}
+
+		OutOffsets[ItemIndex] = Offset;
+		OutPeakSize = FMath::Max(OutPeakSize, Offset + Item.Size);
+		PlacedItems.Add(ItemIndex);
+	}
+
+	return true;
+}
+
+bool FRHITransientPlacementPlanner::Plan(TConstArrayView<FItem> Items, double BudgetSeconds)
+{
+	Reset();
+
+	if (Items.IsEmpty())
+	{
+		return false;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+	const int32 NumItems = Items.Num();
+
+	TArray<uint32> Order;
+	Order.SetNumUninitialized(NumItems);
+
+	uint32 LastPosition = 0;
+
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		Order[Index] = Index;
+		LastPosition = FMath::Max(LastPosition, Items[Index].Begin + 1);
+
+		if (Items[Index].End != TNumericLimits<uint32>::Max())
+		{
+			LastPosition = FMath::Max(LastPosition, Items[Index].End);
+		}
+	}
+
+	// First-fit in allocation order approximates the online allocator and is the baseline to improve on.
+	PlaceItems(Items, Order, TNumericLimits<double>::Max(), Offsets, UnplannedSize);
+	PlannedSize = UnplannedSize;
+
+	TArray<uint32> BestOrder = Order;
+
+	const auto TryOrder = [&]
+	{
+		uint64 PeakSize = 0;
+
+		if (!PlaceItems(Items, Order, EndTime, CandidateOffsets, PeakSize))
+		{
+			return false;
+		}
+
+		if (PeakSize < PlannedSize)
+		{
+			PlannedSize = PeakSize;
+			Swap(Offsets, CandidateOffsets);
+			BestOrder = Order;
+		}
+
+		return true;
+	};
+
+	const auto GetDuration = [&](uint32 Index)
+	{
+		return uint64(FMath::Min(Items[Index].End, LastPosition) - Items[Index].Begin);
+	};
+
+	// Largest first; long lived allocations first among equal sizes.
+	Algo::Sort(Order, [&](uint32 A, uint32 B)
+	{
+		if (Items[A].Size != Items[B].Size) { return Items[A].Size > Items[B].Size; }
+		if (GetDuration(A) != GetDuration(B)) { return GetDuration(A) > GetDuration(B); }
+		return A < B;
+	});
+
+	bool bWithinBudget = TryOrder();
+
+	// Largest footprint in the lifetime x memory plane first.
+	if (bWithinBudget)
+	{
+		Algo::Sort(Order, [&](uint32 A, uint32 B)
+		{
+			const uint64 AreaA = Items[A].Size * GetDuration(A);
+			const uint64 AreaB = Items[B].Size * GetDuration(B);
+			if (AreaA != AreaB) { return AreaA > AreaB; }
+			return A < B;
+		});
+
+		bWithinBudget = TryOrder();
+	}
+
+	// Longest lived first, which packs persistent allocations at the bottom of the heap.
+	if (bWithinBudget)
+	{
+		Algo::Sort(Order, [&](uint32 A, uint32 B)
+		{
+			if (GetDuration(A) != GetDuration(B)) { return GetDuration(A) > GetDuration(B); }
+			if (Items[A].Size != Items[B].Size) { return Items[A].Size > Items[B].Size; }
+			return A < B;
+		});
+
+		bWithinBudget = TryOrder();
+	}
+
+	// Spend the remaining budget on random swaps of the best order found so far.
+	FRandomStream RandomStream(NumItems);
+
+	while (bWithinBudget && NumItems > 1 && FPlatformTime::Seconds() < EndTime)
+	{
+		Order = BestOrder;
+		Order.Swap(RandomStream.RandRange(0, NumItems - 1), RandomStream.RandRange(0, NumItems - 1));
+		bWithinBudget = TryOrder();
+	}
+
+	return PlannedSize < UnplannedSize;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Transient Resource Heap Allocator
 //////////////////////////////////////////////////////////////////////////
@@ -258,6 +462,121 @@ FRHITransientHeapAllocation FRHITransientHeapAllocator::Allocate(const FRHITrans
 	return Allocation;
 }
 
+FRHITransientHeapAllocation FRHITransientHeapAllocator::AllocateAt(const FRHITransientAllocationFences& Fences, uint64 Size, uint32 Alignment, uint64 Offset, TArray<FAliasingOverlap>& OutAliasingOverlaps)
+{
+	check(Size > 0);
+
+	if (Alignment < AlignmentMin)
+	{
+		Alignment = AlignmentMin;
+	}
+
+	FRHITransientHeapAllocation Allocation;
+	const uint64 AllocationMax = Offset + Size;
+
+	if (AllocationMax > Capacity || Align(GpuVirtualAddress + Offset, Alignment) != GpuVirtualAddress + Offset)
+	{
+		return Allocation;
+	}
+
+	// Find the free range containing the start of the allocation.
+	FRangeHandle PreviousHandle = HeadHandle;
+	FRangeHandle Handle = GetFirstFreeRangeHandle();
+
+	while (Handle != InvalidRangeHandle && Ranges[Handle].GetEnd() <= Offset)
+	{
+		PreviousHandle = Handle;
+		Handle = Ranges[Handle].NextFreeHandle;
+	}
+
+	if (Handle == InvalidRangeHandle || Ranges[Handle].GetStart() > Offset)
+	{
+		return Allocation;
+	}
+
+	// The allocation must be covered by contiguous free ranges, none of which overlap the allocation on the GPU timeline.
+	TArray<FRangeHandle, TInlineAllocator<16>> RangeCandidates;
+	uint64 NextRangeMin = Ranges[Handle].GetStart();
+
+	while (true)
+	{
+		if (Handle == InvalidRangeHandle)
+		{
+			return Allocation;
+		}
+
+		const FRange& Range = Ranges[Handle];
+
+		if (Range.GetStart() != NextRangeMin || FRHITransientAllocationFences::Contains(Range.Fences, Fences))
+		{
+			return Allocation;
+		}
+
+		RangeCandidates.Emplace(Handle);
+
+		if (AllocationMax <= Range.GetEnd())
+		{
+			break;
+		}
+
+		NextRangeMin = Range.GetEnd();
+		Handle = Range.NextFreeHandle;
+	}
+
+	for (FRangeHandle CandidateHandle : RangeCandidates)
+	{
+		const FRange& Range = Ranges[CandidateHandle];
+
+		if (FRHITransientResource* ResourceToOverlap = Range.Resource)
+		{
+			OutAliasingOverlaps.Emplace(ResourceToOverlap, FRHITransientAllocationFences::GetAcquireFence(Range.Fences, Fences));
+		}
+	}
+
+	const uint64 FrontSize = Offset - Ranges[RangeCandidates[0]].GetStart();
+	const uint64 BackSize  = Ranges[RangeCandidates.Last()].GetEnd() - AllocationMax;
+
+	// Keep the free space in front of and behind the allocation; covered ranges in between are removed.
+	if (RangeCandidates.Num() == 1 && FrontSize > 0 && BackSize > 0)
+	{
+		const FRange SplitRange = Ranges[RangeCandidates[0]];
+		Ranges[RangeCandidates[0]].Size = FrontSize;
+		InsertRange(RangeCandidates[0], SplitRange.Resource, SplitRange.Fences, AllocationMax, BackSize);
+	}
+	else
+	{
+		for (int32 Index = 0; Index < RangeCandidates.Num(); ++Index)
+		{
+			const FRangeHandle CandidateHandle = RangeCandidates[Index];
+			FRange& Range = Ranges[CandidateHandle];
+
+			if (Index == 0 && FrontSize > 0)
+			{
+				Range.Size = FrontSize;
+				PreviousHandle = CandidateHandle;
+			}
+			else if (Index == RangeCandidates.Num() - 1 && BackSize > 0)
+			{
+				Range.Offset = AllocationMax;
+				Range.Size   = BackSize;
+			}
+			else
+			{
+				RemoveRange(PreviousHandle, CandidateHandle);
+			}
+		}
+	}
+
+	AllocationCount++;
+	UsedSize += Size;
+
+	Allocation.Size   = Size;
+	Allocation.Offset = Offset;
+
+	Validate();
+	return Allocation;
+}
+
 void FRHITransientHeapAllocator::Deallocate(FRHITransientResource* Resource, const FRHITransientAllocationFences& Fences)
 {
 	check(Resource);
@@ -362,9 +681,12 @@ FRHITransientTexture* FRHITransientHeap::CreateTexture(
 	uint64 CurrentAllocatorCycle,
 	uint64 TextureSize,
 	uint32 TextureAlignment,
-	FCreateTextureFunction CreateTextureFunction)
+	FCreateTextureFunction CreateTextureFunction,
+	uint64 PlacementOffset)
 {
-	FRHITransientHeapAllocation Allocation = Allocator.Allocate(Fences, TextureSize, TextureAlignment, AliasingOverlaps);
+	FRHITransientHeapAllocation Allocation = PlacementOffset != kAnyOffset
+		? Allocator.AllocateAt(Fences, TextureSize, TextureAlignment, PlacementOffset, AliasingOverlaps)
+		: Allocator.Allocate(Fences, TextureSize, TextureAlignment, AliasingOverlaps);
 	Allocation.Heap = this;
 
 	if (!Allocation.IsValid())
@@ -398,9 +720,12 @@ FRHITransientBuffer* FRHITransientHeap::CreateBuffer(
 	uint64 CurrentAllocatorCycle,
 	uint64 BufferSize,
 	uint32 BufferAlignment,
-	FCreateBufferFunction CreateBufferFunction)
+	FCreateBufferFunction CreateBufferFunction,
+	uint64 PlacementOffset)
 {
-	FRHITransientHeapAllocation Allocation = Allocator.Allocate(Fences, BufferSize, BufferAlignment, AliasingOverlaps);
+	FRHITransientHeapAllocation Allocation = PlacementOffset != kAnyOffset
+		? Allocator.AllocateAt(Fences, BufferSize, BufferAlignment, PlacementOffset, AliasingOverlaps)
+		: Allocator.Allocate(Fences, BufferSize, BufferAlignment, AliasingOverlaps);
 	Allocation.Heap = this;
 
 	if (!Allocation.IsValid())
@@ -648,8 +973,30 @@ FRHITransientTexture* FRHITransientResourceHeapAllocator::CreateTextureInternal(
 
 	FRHITransientTexture* Texture = nullptr;
 
+	FRHITransientHeap* PlannedTextureHeap = nullptr;
+	const uint64 PlacementOffset = GetNextPlacementOffset(TextureSize, PlannedTextureHeap);
+
+	if (PlacementOffset != FRHITransientHeap::kAnyOffset)
+	{
+		Texture = PlannedTextureHeap->CreateTexture(CreateInfo, DebugName, Fences, CurrentCycle, TextureSize, TextureAlignment, CreateTextureFunction, PlacementOffset);
+
+		if (Texture)
+		{
+			PlannedAllocationCount++;
+		}
+		else
+		{
+			PlanFallbackCount++;
+		}
+	}
+
 	for (FRHITransientHeap* Heap : Heaps)
 	{
+		if (Texture)
+		{
+			break;
+		}
+
 		if (!Heap->IsAllocationSupported(TextureSize, TextureHeapFlags))
 		{
 			continue;
@@ -698,8 +1045,30 @@ FRHITransientBuffer* FRHITransientResourceHeapAllocator::CreateBufferInternal(
 	ERHITransientHeapFlags BufferHeapFlag = ERHITransientHeapFlags::AllowBuffers;
 #endif
 
+	FRHITransientHeap* PlannedBufferHeap = nullptr;
+	const uint64 PlacementOffset = GetNextPlacementOffset(BufferSize, PlannedBufferHeap);
+
+	if (PlacementOffset != FRHITransientHeap::kAnyOffset)
+	{
+		Buffer = PlannedBufferHeap->CreateBuffer(CreateInfo, DebugName, Fences, CurrentCycle, BufferSize, BufferAlignment, CreateBufferFunction, PlacementOffset);
+
+		if (Buffer)
+		{
+			PlannedAllocationCount++;
+		}
+		else
+		{
+			PlanFallbackCount++;
+		}
+	}
+
 	for (FRHITransientHeap* Heap : Heaps)
 	{
+		if (Buffer)
+		{
+			break;
+		}
+
 		if (!Heap->IsAllocationSupported(BufferSize, BufferHeapFlag))
 		{
 			continue;
@@ -732,6 +1101,94 @@ FRHITransientBuffer* FRHITransientResourceHeapAllocator::CreateBufferInternal(
 	return Buffer;
 }
 
+bool FRHITransientResourceHeapAllocator::PlanAllocations(TConstArrayView<FRHITransientAllocationLifetime> Lifetimes)
+{
+	Planner.Reset();
+	PlannedSizes.Reset();
+	PlannedHeap = nullptr;
+	PlanCursor = 0;
+
+	// Planned allocations share one heap, which requires heaps that accept every resource type.
+	if (GRHITransientAllocatorPlacementPlanningBudget <= 0.0f || Lifetimes.IsEmpty() || !HeapCache.GetInitializer().bSupportsAllHeapFlags || GNumExplicitGPUsForRendering > 1)
+	{
+		return false;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(RHITransientPlanAllocations);
+
+	const uint32 HeapAlignment = HeapCache.GetInitializer().HeapAlignment;
+
+	TArray<FRHITransientPlacementPlanner::FItem> Items;
+	Items.Reserve(Lifetimes.Num());
+	PlannedSizes.Reserve(Lifetimes.Num());
+
+	for (const FRHITransientAllocationLifetime& Lifetime : Lifetimes)
+	{
+		FRHITransientPlacementPlanner::FItem& Item = Items.Emplace_GetRef();
+
+		if (Lifetime.TextureCreateInfo)
+		{
+			GetPlacementSizeAndAlignment(*Lifetime.TextureCreateInfo, Item.Size, Item.Alignment);
+		}
+		else
+		{
+			check(Lifetime.BufferCreateInfo);
+			GetPlacementSizeAndAlignment(*Lifetime.BufferCreateInfo, Item.Size, Item.Alignment);
+		}
+
+		Item.Alignment = FMath::Max(Item.Alignment, HeapAlignment);
+		Item.Begin = Lifetime.AllocateIndex;
+		Item.End = Lifetime.DeallocateIndex;
+		PlannedSizes.Emplace(Item.Size);
+	}
+
+	if (!Planner.Plan(Items, GRHITransientAllocatorPlacementPlanningBudget / 1000.0))
+	{
+		PlannedSizes.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+uint64 FRHITransientResourceHeapAllocator::GetNextPlacementOffset(uint64 Size, FRHITransientHeap*& OutHeap)
+{
+	if (PlanCursor >= PlannedSizes.Num())
+	{
+		return FRHITransientHeap::kAnyOffset;
+	}
+
+	const int32 PlanIndex = PlanCursor++;
+
+	if (Size > PlannedSizes[PlanIndex])
+	{
+		PlanFallbackCount++;
+		return FRHITransientHeap::kAnyOffset;
+	}
+
+	if (!PlannedHeap)
+	{
+		PlannedHeap = HeapCache.Acquire(Planner.GetPlannedSize(), ERHITransientHeapFlags::AllowAll);
+		Heaps.Emplace(PlannedHeap);
+	}
+
+	OutHeap = PlannedHeap;
+	return Planner.GetOffsets()[PlanIndex];
+}
+
+void FRHITransientResourceHeapAllocator::GetPlacementSizeAndAlignment(const FRHITextureCreateInfo& CreateInfo, uint64& OutSize, uint32& OutAlignment) const
+{
+	const FRHICalcTextureSizeResult SizeResult = RHICalcTexturePlatformSize(CreateInfo);
+	OutSize = SizeResult.Size;
+	OutAlignment = SizeResult.Align;
+}
+
+void FRHITransientResourceHeapAllocator::GetPlacementSizeAndAlignment(const FRHIBufferCreateInfo& CreateInfo, uint64& OutSize, uint32& OutAlignment) const
+{
+	OutSize = CreateInfo.Size;
+	OutAlignment = HeapCache.GetInitializer().HeapAlignment;
+}
+
 void FRHITransientResourceHeapAllocator::DeallocateMemory(FRHITransientTexture* Texture, const FRHITransientAllocationFences& Fences)
 {
 	check(Texture);
@@ -792,6 +1249,21 @@ void FRHITransientResourceHeapAllocator::Flush(FRHICommandListImmediate& RHICmdL
 	TRACE_COUNTER_SET(TransientBufferCacheSize, NumBuffers);
 	TRACE_COUNTER_SET(TransientTextureCacheSize, NumTextures);
 
+	if (!PlannedSizes.IsEmpty())
+	{
+		Stats.PlannedSize = Planner.GetPlannedSize();
+		Stats.UnplannedSize = Planner.GetUnplannedSize();
+		Stats.PlannedAllocationCount = PlannedAllocationCount;
+		Stats.PlanFallbackCount = PlanFallbackCount;
+	}
+
+	Planner.Reset();
+	PlannedSizes.Reset();
+	PlannedHeap = nullptr;
+	PlanCursor = 0;
+	PlannedAllocationCount = 0;
+	PlanFallbackCount = 0;
+
 	if (DeallocationCount > 0)
 	{
 		// This could be done more efficiently, but the number of heaps is small and the goal is to keep the list stable
@@ -830,9 +1302,68 @@ void FRHITransientResourceHeapAllocator::Flush(FRHICommandListImmediate& RHICmdL
 //! Transient Resource Page Allocator
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#if RHICORE_TRANSIENT_ALLOCATOR_DEBUG
+
+namespace UE::RHICore::Private
+{
+	/** Calls made to a page span allocator, recorded with RHI.TransientAllocator.RecordPageSpans for offline replay. */
+	struct FPageSpanAllocatorOp
+	{
+		enum class EType : uint8
+		{
+			Allocate,
+			Deallocate,
+			Flush
+		};
+
+		EType Type = EType::Flush;
+
+		// Number of pages requested by an allocation.
+		uint32 PageCount = 0;
+
+		// Span index returned by an allocation, or passed to a deallocation.
+		uint32 SpanIndex = 0;
+
+		FRHITransientAllocationFences Fences;
+	};
+
+	struct FPageSpanAllocatorSequence
+	{
+		uint32 PageCount = 0;
+		uint32 PageSize = 0;
+		TArray<FPageSpanAllocatorOp> Ops;
+	};
+
+	static std::atomic<bool> GRecordPageSpans{ false };
+	static FCriticalSection GRecordedPageSpansCS;
+	static TMap<const FRHITransientPageSpanAllocator*, FPageSpanAllocatorSequence> GRecordedPageSpans;
+
+	static void RecordPageSpanOp(const FRHITransientPageSpanAllocator& Allocator, FPageSpanAllocatorOp::EType Type, const FRHITransientAllocationFences& Fences = {}, uint32 PageCount = 0, uint32 SpanIndex = 0)
+	{
+		if (!GRecordPageSpans.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		FScopeLock Lock(&GRecordedPageSpansCS);
+		FPageSpanAllocatorSequence& Sequence = GRecordedPageSpans.FindOrAdd(&Allocator);
+		Sequence.PageSize = Allocator.GetPageSize();
+		Sequence.PageCount = uint32(Allocator.GetCapacity() / Allocator.GetPageSize());
+
+		FPageSpanAllocatorOp& Op = Sequence.Ops.AddDefaulted_GetRef();
+		Op.Type = Type;
+		Op.PageCount = PageCount;
+		Op.SpanIndex = SpanIndex;
+		Op.Fences = Fences;
+	}
+}
+
+#endif
+
 void FRHITransientPageSpanAllocator::Init()
 {
-	check(MaxSpanCount == MaxPageCount + 2);
+	check(MaxSpanCount == MaxPageCount + NumFreeLists);
+	check(MaxPageCount <= TNumericLimits<uint16>::Max());
 
 	PageToSpanStart.AddDefaulted(MaxPageCount + 1);
 	PageToSpanEnd.AddDefaulted(MaxPageCount + 1);
@@ -855,53 +1386,68 @@ void FRHITransientPageSpanAllocator::Reset()
 	}
 	UnusedSpanListCount = MaxSpanCount;
 
-	// Allocate the head and tail spans (dummy spans), and a span between them covering the entire range
-	uint32 HeadSpanIndex = AllocSpan();
-	uint32 TailSpanIndex = AllocSpan();
-	check(HeadSpanIndex == FreeSpanListHeadIndex);
-	check(TailSpanIndex == FreeSpanListTailIndex);
+	// Allocate the head spans of the free lists (dummy spans)
+	for (uint32 FreeListIndex = 0; FreeListIndex < NumFreeLists; FreeListIndex++)
+	{
+		uint32 HeadSpanIndex = AllocSpan();
+		check(HeadSpanIndex == FreeListIndex);
+		PageSpans[HeadSpanIndex] = FPageSpan();
+	}
 
-	if (MaxPageCount > 0)
+	for (uint32 FenceClass = 0; FenceClass < NumFenceClasses; FenceClass++)
 	{
-		uint32 FirstFreeNodeIndex = AllocSpan();
+		NonEmptyFreeLists[FenceClass] = 0;
+	}
 
-		// Allocate head and tail nodes (0 and 1)
-		for (uint32 Index = 0; Index < 2; Index++)
-		{
-			PageSpans[Index].Resource = nullptr;
-			PageSpans[Index].Offset = 0;
-			PageSpans[Index].Count = 0;
-			PageSpans[Index].Fences = {};
-			PageSpans[Index].NextSpanIndex = InvalidIndex;
-			PageSpans[Index].PrevSpanIndex = InvalidIndex;
-			PageSpans[Index].bAllocated = false;
-		}
-		PageSpans[HeadSpanIndex].NextSpanIndex = FirstFreeNodeIndex;
-		PageSpans[TailSpanIndex].PrevSpanIndex = FirstFreeNodeIndex;
+	// Initialize the page->span mapping
+	for (uint32 Index = 0; Index < MaxPageCount + 1; Index++)
+	{
+		PageToSpanStart[Index] = InvalidIndex;
+		PageToSpanEnd[Index] = InvalidIndex;
+	}
 
-		// First Node
-		PageSpans[FirstFreeNodeIndex].Resource = nullptr;
+	if (MaxPageCount > 0)
+	{
+		// A single free span covering the entire range
+		uint32 FirstFreeNodeIndex = AllocSpan();
+		PageSpans[FirstFreeNodeIndex] = FPageSpan();
 		PageSpans[FirstFreeNodeIndex].Offset = 0;
 		PageSpans[FirstFreeNodeIndex].Count = MaxPageCount;
-		PageSpans[FirstFreeNodeIndex].Fences = {};
-		PageSpans[FirstFreeNodeIndex].PrevSpanIndex = HeadSpanIndex;
-		PageSpans[FirstFreeNodeIndex].NextSpanIndex = TailSpanIndex;
-		PageSpans[FirstFreeNodeIndex].bAllocated = false;
+		LinkFreeSpan(FirstFreeNodeIndex);
 
-		// Initialize the page->span mapping
-		for (uint32 Index = 0; Index < MaxPageCount + 1; Index++)
-		{
-			PageToSpanStart[Index] = InvalidIndex;
-			PageToSpanEnd[Index] = InvalidIndex;
-		}
 		PageToSpanStart[0] = FirstFreeNodeIndex;
 		PageToSpanEnd[MaxPageCount] = FirstFreeNodeIndex;
 	}
-	else
+}
+
+uint32 FRHITransientPageSpanAllocator::FindContiguousSpan(const FRHITransientAllocationFences& Fences, uint32 PageCount) const
+{
+	const bool bAcquireOnAsyncCompute = GetFenceClass(Fences) == AsyncComputeFenceClass;
+
+	// Walk the size classes that can hold the request from the smallest up, so that large spans stay intact for large requests.
+	// Every span above the first size class fits, so for graphics acquires those lists are only ever looked at once.
+	uint32 SizeClassMask = (NonEmptyFreeLists[GraphicsFenceClass] | NonEmptyFreeLists[AsyncComputeFenceClass]) & (~0u << GetSizeClass(PageCount));
+
+	while (SizeClassMask != 0)
 	{
-		PageSpans[HeadSpanIndex].NextSpanIndex = TailSpanIndex;
-		PageSpans[TailSpanIndex].PrevSpanIndex = HeadSpanIndex;
+		const uint32 SizeClass = FMath::CountTrailingZeros(SizeClassMask);
+		SizeClassMask &= SizeClassMask - 1;
+
+		for (uint32 FenceClass = 0; FenceClass < NumFenceClasses; FenceClass++)
+		{
+			for (uint32 SpanIndex = PageSpans[FenceClass * NumSizeClasses + SizeClass].NextSpanIndex; SpanIndex != InvalidIndex; SpanIndex = PageSpans[SpanIndex].NextSpanIndex)
+			{
+				const FPageSpan& Span = PageSpans[SpanIndex];
+
+				if (Span.Count >= PageCount && IsCompatible(Span, FenceClass, Fences, bAcquireOnAsyncCompute))
+				{
+					return SpanIndex;
+				}
+			}
+		}
 	}
+
+	return InvalidIndex;
 }
 
 bool FRHITransientPageSpanAllocator::Allocate(FRHITransientResource* Resource, const FRHITransientAllocationFences& Fences, uint32 PageCount, uint32& OutNumPagesAllocated, uint32& OutSpanIndex)
@@ -913,54 +1459,76 @@ bool FRHITransientPageSpanAllocator::Allocate(FRHITransientResource* Resource, c
 		return false;
 	}
 
-	// Allocate spans from the free list head
 	uint32 NumPagesToFind = PageCount;
-	uint32 FoundPages = 0;
-	FPageSpan& HeadSpan = PageSpans[FreeSpanListHeadIndex];
-	uint32 FirstSpanIndex = InvalidIndex;
-	uint32 LastSpanIndex = InvalidIndex;
-	uint32 SpanIndex = HeadSpan.NextSpanIndex;
-	while (SpanIndex != FreeSpanListTailIndex && SpanIndex != InvalidIndex && NumPagesToFind > 0)
+	uint32 FirstSpanIndex = FindContiguousSpan(Fences, PageCount);
+
+	if (FirstSpanIndex != InvalidIndex)
 	{
-		FPageSpan& Span = PageSpans[SpanIndex];
-		uint32 NextSpanIndex = Span.NextSpanIndex;
+		// A single span maps with a single page map operation
+		AllocateSpan(Resource, Fences, FirstSpanIndex, PageCount);
+		NumPagesToFind = 0;
+	}
+	else
+	{
+		// No compatible span holds the whole request, so gather spans from the largest size class down to keep the span count low
+		const bool bAcquireOnAsyncCompute = GetFenceClass(Fences) == AsyncComputeFenceClass;
+		TArray<uint32, TInlineAllocator<32>> SpanIndices;
 
-		if (!FRHITransientAllocationFences::Contains(Span.Fences, Fences))
+		for (int32 SizeClass = NumSizeClasses - 1; SizeClass >= 0 && NumPagesToFind > 0; SizeClass--)
 		{
-			if (NumPagesToFind <= Span.Count)
+			for (uint32 FenceClass = 0; FenceClass < NumFenceClasses && NumPagesToFind > 0; FenceClass++)
 			{
-				// Span is too big, so split it
-				if (Span.Count > NumPagesToFind)
+				if (!(NonEmptyFreeLists[FenceClass] & (1u << SizeClass)))
 				{
-					SplitSpan(SpanIndex, NumPagesToFind);
+					continue;
 				}
-				check(NumPagesToFind == Span.Count);
-			}
-			Span.bAllocated = true;
 
-			NextSpanIndex = Span.NextSpanIndex;
-			Unlink(SpanIndex);
-			if (FirstSpanIndex == InvalidIndex)
-			{
-				FirstSpanIndex = LastSpanIndex = SpanIndex;
+				uint32 SpanIndex = PageSpans[FenceClass * NumSizeClasses + SizeClass].NextSpanIndex;
+				while (SpanIndex != InvalidIndex && NumPagesToFind > 0)
+				{
+					const FPageSpan& Span = PageSpans[SpanIndex];
+					const uint32 NextSpanIndex = Span.NextSpanIndex;
+
+					if (IsCompatible(Span, FenceClass, Fences, bAcquireOnAsyncCompute))
+					{
+						const uint32 SpanPageCount = FMath::Min<uint32>(Span.Count, NumPagesToFind);
+						AllocateSpan(Resource, Fences, SpanIndex, SpanPageCount);
+						SpanIndices.Emplace(SpanIndex);
+						NumPagesToFind -= SpanPageCount;
+					}
+
+					SpanIndex = NextSpanIndex;
+				}
 			}
-			else
+		}
+
+		if (!SpanIndices.IsEmpty())
+		{
+			// Chain the spans in page order and coalesce physically adjacent ones, so that they map as a single range
+			Algo::Sort(SpanIndices, [this](uint32 SpanIndexA, uint32 SpanIndexB)
 			{
-				InsertAfter(LastSpanIndex, SpanIndex);
-				LastSpanIndex = SpanIndex;
-			}
+				return PageSpans[SpanIndexA].Offset < PageSpans[SpanIndexB].Offset;
+			});
 
-			// Record the aliasing overlap between the resource we are allocating and the one that was deallocated.
-			if (Span.Resource)
+			FirstSpanIndex = SpanIndices[0];
+			uint32 LastSpanIndex = FirstSpanIndex;
+
+			for (int32 Index = 1; Index < SpanIndices.Num(); Index++)
 			{
-				Resource->AddAliasingOverlap(Span.Resource, FRHITransientAllocationFences::GetAcquireFence(Span.Fences, Fences));
-			}
+				const uint32 SpanIndex = SpanIndices[Index];
+				const FPageSpan& LastSpan = PageSpans[LastSpanIndex];
 
-			check(NumPagesToFind >= Span.Count)
-			NumPagesToFind -= Span.Count;
+				if (LastSpan.Offset + LastSpan.Count == PageSpans[SpanIndex].Offset)
+				{
+					MergeSpans(LastSpanIndex, SpanIndex);
+				}
+				else
+				{
+					InsertAfter(LastSpanIndex, SpanIndex);
+					LastSpanIndex = SpanIndex;
+				}
+			}
 		}
-
-		SpanIndex = NextSpanIndex;
 	}
 
 	const uint32 NumPagesAllocated = PageCount - NumPagesToFind;
@@ -970,12 +1538,30 @@ bool FRHITransientPageSpanAllocator::Allocate(FRHITransientResource* Resource, c
 		AllocationCount++;
 		OutSpanIndex = FirstSpanIndex;
 		OutNumPagesAllocated = NumPagesAllocated;
+
+		IF_RHICORE_TRANSIENT_ALLOCATOR_DEBUG(UE::RHICore::Private::RecordPageSpanOp(*this, UE::RHICore::Private::FPageSpanAllocatorOp::EType::Allocate, Fences, PageCount, FirstSpanIndex));
 	}
 
 	Validate();
 	return NumPagesAllocated != 0;
 }
 
+void FRHITransientPageSpanAllocator::AllocateSpan(FRHITransientResource* Resource, const FRHITransientAllocationFences& Fences, uint32 SpanIndex, uint32 PageCount)
+{
+	UnlinkFreeSpan(SpanIndex);
+	SplitSpan(SpanIndex, PageCount);
+
+	FPageSpan& Span = PageSpans[SpanIndex];
+	check(PageCount == Span.Count);
+	Span.bAllocated = true;
+
+	// Record the aliasing overlap between the resource we are allocating and the one that was deallocated.
+	if (Span.Resource)
+	{
+		Resource->AddAliasingOverlap(Span.Resource, FRHITransientAllocationFences::GetAcquireFence(Span.Fences, Fences));
+	}
+}
+
 void FRHITransientPageSpanAllocator::Deallocate(FRHITransientResource* Resource, const FRHITransientAllocationFences& Fences, uint32 SpanIndex)
 {
 	if (SpanIndex == InvalidIndex)
@@ -983,6 +1569,9 @@ void FRHITransientPageSpanAllocator::Deallocate(FRHITransientResource* Resource,
 		return;
 	}
 	check(AllocationCount > 0);
+
+	IF_RHICORE_TRANSIENT_ALLOCATOR_DEBUG(UE::RHICore::Private::RecordPageSpanOp(*this, UE::RHICore::Private::FPageSpanAllocatorOp::EType::Deallocate, Fences, 0, SpanIndex));
+
 	while (SpanIndex != InvalidIndex)
 	{
 		FPageSpan& FreedSpan = PageSpans[SpanIndex];
@@ -993,7 +1582,7 @@ void FRHITransientPageSpanAllocator::Deallocate(FRHITransientResource* Resource,
 		FreedSpan.Fences = Fences;
 		FreedSpan.bAllocated = false;
 		Unlink(SpanIndex);
-		InsertAfter(FreeSpanListHeadIndex, SpanIndex);
+		LinkFreeSpan(SpanIndex);
 		SpanIndex = NextSpanIndex;
 	}
 	AllocationCount--;
@@ -1005,28 +1594,26 @@ void FRHITransientPageSpanAllocator::SplitSpan(uint32 InSpanIndex, uint32 InPage
 {
 	FPageSpan& Span = PageSpans[InSpanIndex];
 	check(InPageCount <= Span.Count);
+	check(!Span.IsLinked() && !Span.bAllocated);
 	if (InPageCount < Span.Count)
 	{
 		uint32 NewSpanIndex = AllocSpan();
 		FPageSpan& NewSpan = PageSpans[NewSpanIndex];
 		NewSpan.Resource = Span.Resource;
 		NewSpan.Fences = Span.Fences;
-		NewSpan.NextSpanIndex = Span.NextSpanIndex;
-		NewSpan.PrevSpanIndex = InSpanIndex;
+		NewSpan.NextSpanIndex = InvalidIndex;
+		NewSpan.PrevSpanIndex = InvalidIndex;
 		NewSpan.Count = Span.Count - InPageCount;
 		NewSpan.Offset = Span.Offset + InPageCount;
-		NewSpan.bAllocated = Span.bAllocated;
+		NewSpan.bAllocated = false;
 		Span.Count = InPageCount;
-		Span.NextSpanIndex = NewSpanIndex;
-		if (NewSpan.NextSpanIndex != InvalidIndex)
-		{
-			PageSpans[NewSpan.NextSpanIndex].PrevSpanIndex = NewSpanIndex;
-		}
 
 		// Update the PageToSpan mappings
 		PageToSpanEnd[NewSpan.Offset] = InSpanIndex;
 		PageToSpanStart[NewSpan.Offset] = NewSpanIndex;
 		PageToSpanEnd[NewSpan.Offset + NewSpan.Count] = NewSpanIndex;
+
+		LinkFreeSpan(NewSpanIndex);
 	}
 }
 
@@ -1036,8 +1623,7 @@ void FRHITransientPageSpanAllocator::MergeSpans(uint32 SpanIndex0, uint32 SpanIn
 	FPageSpan& Span1 = PageSpans[SpanIndex1];
 	check(Span0.Offset + Span0.Count == Span1.Offset);
 	check(Span0.bAllocated == Span1.bAllocated);
-	check(Span0.NextSpanIndex == SpanIndex1);
-	check(Span1.PrevSpanIndex == SpanIndex0);
+	check(!Span1.IsLinked());
 
 	uint32 SpanIndexToKeep = SpanIndex0;
 	uint32 SpanIndexToRemove = SpanIndex1;
@@ -1049,52 +1635,76 @@ void FRHITransientPageSpanAllocator::MergeSpans(uint32 SpanIndex0, uint32 SpanIn
 	PageToSpanEnd[Span1.Offset + Span1.Count] = SpanIndexToKeep;
 	Span0.Count += Span1.Count;
 
-	Unlink(SpanIndexToRemove);
 	ReleaseSpan(SpanIndexToRemove);
 }
 
 void FRHITransientPageSpanAllocator::Flush()
 {
+	IF_RHICORE_TRANSIENT_ALLOCATOR_DEBUG(UE::RHICore::Private::RecordPageSpanOp(*this, UE::RHICore::Private::FPageSpanAllocatorOp::EType::Flush));
+
 	uint32 PageIndex = 0;
 	while (PageIndex < MaxPageCount)
 	{
-		int32 SpanIndex = PageToSpanStart[PageIndex];
+		uint32 SpanIndex = PageToSpanStart[PageIndex];
 		check(SpanIndex != InvalidIndex);
 		FPageSpan& Span = PageSpans[SpanIndex];
 
 		if (!Span.bAllocated)
 		{
+			// The span no longer aliases anything, so it moves to the graphics fence class along with any free spans merged into it.
+			UnlinkFreeSpan(SpanIndex);
 			Span.Resource = nullptr;
 			Span.Fences = {};
 
 			while (true)
 			{
 				// Can we merge this span with an existing free one to the right?
-				int32 NextSpanIndex = PageToSpanStart[Span.Offset + Span.Count];
+				uint32 NextSpanIndex = PageToSpanStart[Span.Offset + Span.Count];
 
-				if (NextSpanIndex == InvalidIndex)
+				if (NextSpanIndex == InvalidIndex || PageSpans[NextSpanIndex].bAllocated)
 				{
 					break;
 				}
 
-				FPageSpan& NextPageSpan = PageSpans[NextSpanIndex];
-
-				if (NextPageSpan.bAllocated)
-				{
-					PageIndex += NextPageSpan.Count;
-					break;
-				}
-
-				NextPageSpan.Resource = nullptr;
-				Unlink(SpanIndex);
-				InsertBefore(NextSpanIndex, SpanIndex);
+				UnlinkFreeSpan(NextSpanIndex);
 				MergeSpans(SpanIndex, NextSpanIndex);
-				Validate();
 			}
+
+			LinkFreeSpan(SpanIndex);
 		}
 
 		PageIndex += Span.Count;
 	}
+
+	Validate();
+}
+
+void FRHITransientPageSpanAllocator::LinkFreeSpan(uint32 SpanIndex)
+{
+	FPageSpan& Span = PageSpans[SpanIndex];
+	check(!Span.bAllocated && Span.Count > 0);
+
+	const uint32 FenceClass = GetFenceClass(Span.Fences);
+	const uint32 SizeClass = GetSizeClass(Span.Count);
+
+	Span.FreeListIndex = FenceClass * NumSizeClasses + SizeClass;
+	InsertAfter(Span.FreeListIndex, SpanIndex);
+	NonEmptyFreeLists[FenceClass] |= 1u << SizeClass;
+}
+
+void FRHITransientPageSpanAllocator::UnlinkFreeSpan(uint32 SpanIndex)
+{
+	FPageSpan& Span = PageSpans[SpanIndex];
+	const uint32 FreeListIndex = Span.FreeListIndex;
+	check(FreeListIndex < NumFreeLists);
+
+	Unlink(SpanIndex);
+	Span.FreeListIndex = InvalidIndex;
+
+	if (PageSpans[FreeListIndex].NextSpanIndex == InvalidIndex)
+	{
+		NonEmptyFreeLists[FreeListIndex / NumSizeClasses] &= ~(1u << (FreeListIndex % NumSizeClasses));
+	}
 }
 
 // Inserts a span after an existing span. The span to insert must be unlinked
@@ -1117,31 +1727,10 @@ void FRHITransientPageSpanAllocator::InsertAfter(uint32 InsertPosition, uint32 I
 	SpanToInsert.PrevSpanIndex = InsertPosition;
 }
 
-// Inserts a span after an existing span. The span to insert must be unlinked
-void FRHITransientPageSpanAllocator::InsertBefore(uint32 InsertPosition, uint32 InsertSpanIndex)
-{
-	check(InsertPosition != InvalidIndex && InsertPosition != 0); // Can't insert before the head
-	check(InsertSpanIndex != InvalidIndex);
-	FPageSpan& SpanAtPos = PageSpans[InsertPosition];
-	FPageSpan& SpanToInsert = PageSpans[InsertSpanIndex];
-	check(!SpanToInsert.IsLinked());
-
-	// Connect Span0's prev node with the inserted node
-	SpanToInsert.PrevSpanIndex = SpanAtPos.PrevSpanIndex;
-	if (SpanAtPos.PrevSpanIndex != InvalidIndex)
-	{
-		PageSpans[SpanAtPos.PrevSpanIndex].NextSpanIndex = InsertSpanIndex;
-	}
-
-	// Connect the two nodes
-	SpanAtPos.PrevSpanIndex = InsertSpanIndex;
-	SpanToInsert.NextSpanIndex = InsertPosition;
-}
-
 void FRHITransientPageSpanAllocator::Unlink(uint32 SpanIndex)
 {
 	FPageSpan& Span = PageSpans[SpanIndex];
-	check(SpanIndex != FreeSpanListHeadIndex);
+	check(SpanIndex >= NumFreeLists); // Can't unlink a free list head
 	if (Span.PrevSpanIndex != InvalidIndex)
 	{
 		PageSpans[Span.PrevSpanIndex].NextSpanIndex = Span.NextSpanIndex;
@@ -1180,22 +1769,165 @@ void FRHITransientPageSpanAllocator::Validate()
 		check(PageToSpanEnd[Index] == InvalidIndex || PageSpans[PageToSpanEnd[Index]].Offset + PageSpans[PageToSpanEnd[Index]].Count == Index);
 	}
 
-	// Count free pages
+	// Count free pages and check that each span is in the list of its classes
 	uint32 FreeCount = 0;
-	uint32 PrevIndex = FreeSpanListHeadIndex;
-	for (uint32 Index = GetFirstSpanIndex(); PageSpans.IsValidIndex(Index); Index = PageSpans[Index].NextSpanIndex)
+	for (uint32 FreeListIndex = 0; FreeListIndex < NumFreeLists; FreeListIndex++)
 	{
-		FPageSpan& Span = PageSpans[Index];
-		check(Span.PrevSpanIndex == PrevIndex);
-		check(Index == FreeSpanListHeadIndex || Index == FreeSpanListTailIndex || Span.Count != 0);
-		PrevIndex = Index;
-		FreeCount += Span.Count;
+		const uint32 FenceClass = FreeListIndex / NumSizeClasses;
+		const uint32 SizeClass = FreeListIndex % NumSizeClasses;
+		check(((NonEmptyFreeLists[FenceClass] >> SizeClass) & 1) == (PageSpans[FreeListIndex].NextSpanIndex != InvalidIndex ? 1 : 0));
+
+		uint32 PrevIndex = FreeListIndex;
+		for (uint32 Index = PageSpans[FreeListIndex].NextSpanIndex; Index != InvalidIndex; Index = PageSpans[Index].NextSpanIndex)
+		{
+			FPageSpan& Span = PageSpans[Index];
+			check(Span.PrevSpanIndex == PrevIndex);
+			check(Span.Count != 0 && !Span.bAllocated);
+			check(Span.FreeListIndex == FreeListIndex);
+			check(GetFenceClass(Span.Fences) == FenceClass && GetSizeClass(Span.Count) == SizeClass);
+			PrevIndex = Index;
+			FreeCount += Span.Count;
+		}
 	}
 	check(FreeCount <= MaxPageCount);
 	check(FreeCount == FreePageCount);
 #endif
 }
 
+#if RHICORE_TRANSIENT_ALLOCATOR_DEBUG
+
+static FAutoConsoleCommand GRHITransientAllocatorRecordPageSpansCmd(
+	TEXT("RHI.TransientAllocator.RecordPageSpans"),
+	TEXT("Starts (1, default) or stops (0) recording the page span allocations of every transient page pool for RHI.TransientAllocator.ReplayPageSpans.\n")
+	TEXT("Starting a recording discards the previous one."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+{
+	using namespace UE::RHICore::Private;
+
+	const bool bRecord = Args.Num() == 0 || FCString::Atoi(*Args[0]) != 0;
+
+	FScopeLock Lock(&GRecordedPageSpansCS);
+	if (bRecord)
+	{
+		GRecordedPageSpans.Reset();
+	}
+	GRecordPageSpans.store(bRecord, std::memory_order_relaxed);
+
+	UE_LOG(LogRHICore, Display, TEXT("%s recording transient page span allocations."), bRecord ? TEXT("Started") : TEXT("Stopped"));
+}));
+
+static FAutoConsoleCommand GRHITransientAllocatorReplayPageSpansCmd(
+	TEXT("RHI.TransientAllocator.ReplayPageSpans"),
+	TEXT("Stops recording and replays the page span allocations recorded with RHI.TransientAllocator.RecordPageSpans through fresh allocators.\n")
+	TEXT("Reports the replay time and the number of spans (page map ranges) per allocation.\n")
+	TEXT("Usage: RHI.TransientAllocator.ReplayPageSpans [Iterations=10]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+{
+	using namespace UE::RHICore::Private;
+
+	const int32 NumIterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10;
+
+	TArray<FPageSpanAllocatorSequence> Sequences;
+	{
+		FScopeLock Lock(&GRecordedPageSpansCS);
+		GRecordPageSpans.store(false, std::memory_order_relaxed);
+		GRecordedPageSpans.GenerateValueArray(Sequences);
+	}
+
+	if (Sequences.IsEmpty())
+	{
+		UE_LOG(LogRHICore, Display, TEXT("No transient page span allocations recorded, use RHI.TransientAllocator.RecordPageSpans first."));
+		return;
+	}
+
+	uint64 NumOps = 0;
+	uint64 NumAllocations = 0;
+	uint64 NumPartialAllocations = 0;
+	uint64 NumSpans = 0;
+	uint64 NumPages = 0;
+	uint64 TotalCycles = 0;
+	uint64 MinCycles = MAX_uint64;
+
+	TArray<FRHITransientPageSpan, TInlineAllocator<64>> Spans;
+	TMap<uint32, uint32> ReplaySpanIndices;
+
+	// The first pass gathers span statistics, the following ones are timed.
+	for (int32 Iteration = -1; Iteration < NumIterations; Iteration++)
+	{
+		const bool bGatherStats = Iteration < 0;
+		uint64 IterationCycles = 0;
+
+		for (const FPageSpanAllocatorSequence& Sequence : Sequences)
+		{
+			FRHITransientPageSpanAllocator Allocator(Sequence.PageCount, Sequence.PageSize);
+			ReplaySpanIndices.Reset();
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+
+			for (const FPageSpanAllocatorOp& Op : Sequence.Ops)
+			{
+				switch (Op.Type)
+				{
+				case FPageSpanAllocatorOp::EType::Allocate:
+				{
+					uint32 NumPagesAllocated = 0;
+					uint32 SpanIndex = 0;
+
+					// Deallocations pass a null resource, so no aliasing overlaps are recorded against one.
+					if (Allocator.Allocate(nullptr, Op.Fences, Op.PageCount, NumPagesAllocated, SpanIndex))
+					{
+						ReplaySpanIndices.Emplace(Op.SpanIndex, SpanIndex);
+
+						if (bGatherStats)
+						{
+							Spans.Reset();
+							Allocator.GetSpanArray(SpanIndex, Spans);
+							NumAllocations++;
+							NumPartialAllocations += NumPagesAllocated < Op.PageCount ? 1 : 0;
+							NumSpans += Spans.Num();
+							NumPages += NumPagesAllocated;
+						}
+					}
+					break;
+				}
+				case FPageSpanAllocatorOp::EType::Deallocate:
+				{
+					uint32 SpanIndex = 0;
+					if (ReplaySpanIndices.RemoveAndCopyValue(Op.SpanIndex, SpanIndex))
+					{
+						Allocator.Deallocate(nullptr, Op.Fences, SpanIndex);
+					}
+					break;
+				}
+				case FPageSpanAllocatorOp::EType::Flush:
+					Allocator.Flush();
+					break;
+				}
+			}
+
+			IterationCycles += FPlatformTime::Cycles64() - StartCycles;
+
+			if (bGatherStats)
+			{
+				NumOps += Sequence.Ops.Num();
+			}
+		}
+
+		if (!bGatherStats)
+		{
+			TotalCycles += IterationCycles;
+			MinCycles = FMath::Min(MinCycles, IterationCycles);
+		}
+	}
+
+	UE_LOG(LogRHICore, Display, TEXT("Replayed %d transient page pools (%llu ops) %d times:"), Sequences.Num(), NumOps, NumIterations);
+	UE_LOG(LogRHICore, Display, TEXT("  Time:        avg %.3f ms, min %.3f ms"), FPlatformTime::ToMilliseconds64(TotalCycles) / NumIterations, FPlatformTime::ToMilliseconds64(MinCycles));
+	UE_LOG(LogRHICore, Display, TEXT("  Allocations: %llu (%llu partial), %llu pages"), NumAllocations, NumPartialAllocations, NumPages);
+	UE_LOG(LogRHICore, Display, TEXT("  Spans:       %llu, %.2f per allocation"), NumSpans, NumAllocations ? double(NumSpans) / NumAllocations : 0.0);
+}));
+
+#endif // RHICORE_TRANSIENT_ALLOCATOR_DEBUG
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void FRHITransientPagePool::Allocate(FAllocationContext& Context)
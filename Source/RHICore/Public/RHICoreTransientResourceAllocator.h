@@ -96,6 +96,10 @@ public:
 		Textures.Add(Other.Textures);
 		Buffers.Add(Other.Buffers);
 		AliasedSize = FMath::Max(AliasedSize, Other.AliasedSize);
+		PlannedSize = FMath::Max(PlannedSize, Other.PlannedSize);
+		UnplannedSize = FMath::Max(UnplannedSize, Other.UnplannedSize);
+		PlannedAllocationCount += Other.PlannedAllocationCount;
+		PlanFallbackCount += Other.PlanFallbackCount;
 	}
 
 	void AllocateTexture(uint64 Size)
@@ -129,6 +133,10 @@ public:
 		Textures = {};
 		Buffers = {};
 		AliasedSize = AliasedSizeCurrent;
+		PlannedSize = 0;
+		UnplannedSize = 0;
+		PlannedAllocationCount = 0;
+		PlanFallbackCount = 0;
 	}
 
 	RHICORE_API void Submit(uint64 TotalMemoryCapacity);
@@ -143,6 +151,63 @@ public:
 
 	// Current aliased size as items are being allocated / deallocated.
 	uint64 AliasedSize = 0;
+
+	// Peak memory of the placement plan for the cycle, and the peak of placing the same lifetimes first-fit in allocation order.
+	uint64 PlannedSize = 0;
+	uint64 UnplannedSize = 0;
+
+	// Number of allocations placed at their planned offset, and the number which fell back to first-fit placement.
+	uint32 PlannedAllocationCount = 0;
+	uint32 PlanFallbackCount = 0;
+};
+
+/** Plans heap offsets for a full set of transient allocations whose lifetimes are known up front. Placement is a two dimensional
+ *  packing problem (lifetime x memory) solved heuristically: several placement orders are tried within a time budget, each placing
+ *  allocations at the lowest aligned offset not overlapping a placed allocation with an intersecting lifetime. The lowest peak wins.
+ */
+class FRHITransientPlacementPlanner
+{
+public:
+	struct FItem
+	{
+		// Size and alignment of the allocation in bytes.
+		uint64 Size = 0;
+		uint32 Alignment = 1;
+
+		// Positions of the allocate and deallocate operations. Items whose intervals intersect cannot share memory.
+		uint32 Begin = 0;
+		uint32 End = 0;
+	};
+
+	// Builds a plan for the items. Returns false if the time budget ran out or no plan improved on first-fit placement in item order.
+	RHICORE_API bool Plan(TConstArrayView<FItem> Items, double BudgetSeconds);
+
+	RHICORE_API void Reset();
+
+	// Returns the planned offset of each item, in item order.
+	TConstArrayView<uint64> GetOffsets() const { return Offsets; }
+
+	// Returns the peak memory of the plan.
+	uint64 GetPlannedSize() const { return PlannedSize; }
+
+	// Returns the peak memory of first-fit placement in item order, which approximates the online allocator.
+	uint64 GetUnplannedSize() const { return UnplannedSize; }
+
+private:
+	bool PlaceItems(TConstArrayView<FItem> Items, TConstArrayView<uint32> Order, double EndTime, TArray<uint64>& OutOffsets, uint64& OutPeakSize);
+
+	struct FPlacedRange
+	{
+		uint64 Min;
+		uint64 Max;
+	};
+
+	TArray<uint64> Offsets;
+	TArray<uint64> CandidateOffsets;
+	TArray<uint32> PlacedItems;
+	TArray<FPlacedRange> ConflictRanges;
+	uint64 PlannedSize = 0;
+	uint64 UnplannedSize = 0;
 };
 
 /** An RHI transient resource cache designed to optimize fetches for resources placed into a heap with an offset.
@@ -332,6 +397,9 @@ public:
 
 	RHICORE_API FRHITransientHeapAllocation Allocate(const FRHITransientAllocationFences& Fences, uint64 Size, uint32 Alignment, TArray<FAliasingOverlap>& OutAliasingOverlaps);
 
+	// Allocates at a specific offset (e.g. from a placement plan). Returns an invalid allocation if the range is not free for the given fences.
+	RHICORE_API FRHITransientHeapAllocation AllocateAt(const FRHITransientAllocationFences& Fences, uint64 Size, uint32 Alignment, uint64 Offset, TArray<FAliasingOverlap>& OutAliasingOverlaps);
+
 	RHICORE_API void Deallocate(FRHITransientResource* Resource, const FRHITransientAllocationFences& Fences);
 
 	RHICORE_API void Flush();
@@ -505,6 +573,9 @@ public:
 	using FCreateTextureFunction = TFunction<FRHITransientTexture* (const FResourceInitializer&)>;
 	using FCreateBufferFunction = TFunction<FRHITransientBuffer* (const FResourceInitializer&)>;
 
+	// Placement offset which lets the heap allocator pick the offset.
+	static const uint64 kAnyOffset = ~0ull;
+
 	FRHITransientHeap(const FInitializer& InInitializer)
 		: Initializer(InInitializer)
 		, Allocator(InInitializer.Size, InInitializer.Alignment)
@@ -524,7 +595,8 @@ public:
 		uint64 CurrentAllocatorCycle,
 		uint64 TextureSize,
 		uint32 TextureAlignment,
-		FCreateTextureFunction CreateTextureFunction);
+		FCreateTextureFunction CreateTextureFunction,
+		uint64 PlacementOffset = kAnyOffset);
 
 	RHICORE_API void DeallocateMemory(FRHITransientTexture* Texture, const FRHITransientAllocationFences& Fences);
 
@@ -535,7 +607,8 @@ public:
 		uint64 CurrentAllocatorCycle,
 		uint64 BufferSize,
 		uint32 BufferAlignment,
-		FCreateBufferFunction CreateBufferFunction);
+		FCreateBufferFunction CreateBufferFunction,
+		uint64 PlacementOffset = kAnyOffset);
 
 	RHICORE_API void DeallocateMemory(FRHITransientBuffer* Buffer, const FRHITransientAllocationFences& Fences);
 
@@ -685,6 +758,9 @@ public:
 	// Sets the create mode for allocations.
 	RHICORE_API void SetCreateMode(ERHITransientResourceCreateMode InCreateMode) override;
 
+	// Plans heap placements for the upcoming cycle. Planned allocations are placed on a dedicated heap sized to the plan.
+	RHICORE_API bool PlanAllocations(TConstArrayView<FRHITransientAllocationLifetime> Lifetimes) override;
+
 	// Deallocates a texture from its parent heap. Provide the current platform fence value used to update the heap.
 	RHICORE_API void DeallocateMemory(FRHITransientTexture* Texture, const FRHITransientAllocationFences& Fences) override;
 
@@ -742,12 +818,29 @@ protected:
 		uint32 BufferAlignment,
 		FRHITransientHeap::FCreateBufferFunction CreateBufferFunction);
 
+	/** Returns the size and alignment used to plan the placement of a resource. These should match what the platform passes to
+	 *  CreateTextureInternal / CreateBufferInternal; allocations larger than planned fall back to first-fit placement.
+	 */
+	RHICORE_API virtual void GetPlacementSizeAndAlignment(const FRHITextureCreateInfo& CreateInfo, uint64& OutSize, uint32& OutAlignment) const;
+	RHICORE_API virtual void GetPlacementSizeAndAlignment(const FRHIBufferCreateInfo& CreateInfo, uint64& OutSize, uint32& OutAlignment) const;
+
 private:
+	// Returns the planned offset for the next created resource, acquiring the planned heap on first use, or kAnyOffset if no plan applies.
+	uint64 GetNextPlacementOffset(uint64 Size, FRHITransientHeap*& OutHeap);
+
 	TArray<FRHITransientHeap*> Heaps;
 	uint64 CurrentCycle = 0;
 	uint32 DeallocationCount = 0;
 	ERHITransientResourceCreateMode CreateMode = ERHITransientResourceCreateMode::Inline;
 
+	// Placement plan for the current cycle, consumed in creation order.
+	FRHITransientPlacementPlanner Planner;
+	TArray<uint64> PlannedSizes;
+	FRHITransientHeap* PlannedHeap = nullptr;
+	int32 PlanCursor = 0;
+	uint32 PlannedAllocationCount = 0;
+	uint32 PlanFallbackCount = 0;
+
 	IF_RHICORE_TRANSIENT_ALLOCATOR_DEBUG(TSet<FRHITransientResource*> ActiveResources);
 };
 
@@ -758,12 +851,16 @@ private:
 class FRHITransientPagePoolCache;
 class FRHITransientResourcePageAllocator;
 
-/** Allocates page spans for a resource. */
+/**
+ * Allocates page spans for a resource. Free spans are kept in segregated lists by fence class and power of two size class,
+ * so an allocation first looks for a single compatible span that holds all of its pages and only falls back to gathering
+ * smaller spans when there is none.
+ */
 class FRHITransientPageSpanAllocator
 {
 public:
 	FRHITransientPageSpanAllocator(uint32 InPageCount, uint32 InPageSize)
-		: MaxSpanCount(InPageCount + 2)
+		: MaxSpanCount(InPageCount + NumFreeLists)
 		, MaxPageCount(InPageCount)
 		, PageSize(InPageSize)
 	{
@@ -811,8 +908,17 @@ public:
 
 private:
 	static const uint32 InvalidIndex = TNumericLimits<uint32>::Max();
-	static const uint32 FreeSpanListHeadIndex = 0;
-	static const uint32 FreeSpanListTailIndex = 1;
+
+	// Spans discarded on the graphics pipe only (or never used) can't overlap a graphics acquire, so they are taken without fence checks.
+	static const uint32 GraphicsFenceClass = 0;
+	static const uint32 AsyncComputeFenceClass = 1;
+	static const uint32 NumFenceClasses = 2;
+
+	// Size class N holds free spans of [2^N, 2^(N+1)) pages. FRHITransientPageSpan::Count is 16 bits.
+	static const uint32 NumSizeClasses = 16;
+
+	// Each free list has a dummy head span at the start of PageSpans.
+	static const uint32 NumFreeLists = NumFenceClasses * NumSizeClasses;
 
 	struct FPageSpan : FRHITransientPageSpan
 	{
@@ -821,23 +927,48 @@ private:
 		FRHITransientResource* Resource = nullptr;
 		FRHITransientAllocationFences Fences;
 		uint32 NextSpanIndex = InvalidIndex;
-		uint32 PrevSpanIndex = 0;
+		uint32 PrevSpanIndex = InvalidIndex;
+		uint32 FreeListIndex = InvalidIndex;
 		bool bAllocated = false;
 	};
 
+	static uint32 GetFenceClass(const FRHITransientAllocationFences& Fences)
+	{
+		return EnumHasAnyFlags(Fences.GetPipelines(), ERHIPipeline::AsyncCompute) ? AsyncComputeFenceClass : GraphicsFenceClass;
+	}
+
+	static uint32 GetSizeClass(uint32 PageCount)
+	{
+		return FMath::FloorLog2(PageCount);
+	}
+
+	static bool IsCompatible(const FPageSpan& Span, uint32 FenceClass, const FRHITransientAllocationFences& Fences, bool bAcquireOnAsyncCompute)
+	{
+		return (FenceClass == GraphicsFenceClass && !bAcquireOnAsyncCompute) || !FRHITransientAllocationFences::Contains(Span.Fences, Fences);
+	}
+
 	RHICORE_API void Init();
 
-	// Splits a span into two, so that the original span has PageCount pages and the new span contains the remaining ones
+	// Returns the smallest free span compatible with the fences that holds PageCount pages, or InvalidIndex
+	RHICORE_API uint32 FindContiguousSpan(const FRHITransientAllocationFences& Fences, uint32 PageCount) const;
+
+	// Removes a free span from its list, splits it to PageCount pages and marks it allocated
+	RHICORE_API void AllocateSpan(FRHITransientResource* Resource, const FRHITransientAllocationFences& Fences, uint32 SpanIndex, uint32 PageCount);
+
+	// Splits an unlinked free span into two, so that the original span has PageCount pages and a new free span contains the remaining ones
 	RHICORE_API void SplitSpan(uint32 SpanIndex, uint32 PageCount);
 
-	// Merges two spans. They must be adjacent and in the same list
+	// Merges two spans. They must be physically adjacent, in the same state, and the second one must be unlinked
 	RHICORE_API void MergeSpans(uint32 SpanIndex0, uint32 SpanIndex1);
 
-	// Inserts a span after an existing span. The span to insert must be unlinked
-	RHICORE_API void InsertAfter(uint32 InsertPosition, uint32 InsertSpanIndex);
+	// Links a free span into the list for its fence and size class
+	RHICORE_API void LinkFreeSpan(uint32 SpanIndex);
+
+	// Removes a free span from its list
+	RHICORE_API void UnlinkFreeSpan(uint32 SpanIndex);
 
 	// Inserts a span after an existing span. The span to insert must be unlinked
-	RHICORE_API void InsertBefore(uint32 InsertPosition, uint32 InsertSpanIndex);
+	RHICORE_API void InsertAfter(uint32 InsertPosition, uint32 InsertSpanIndex);
 
 	// Removes a span from its list, reconnecting neighbouring list elements
 	RHICORE_API void Unlink(uint32 SpanIndex);
@@ -862,16 +993,14 @@ private:
 
 	RHICORE_API void Validate();
 
-	uint32 GetFirstSpanIndex() const
-	{
-		return PageSpans[FreeSpanListHeadIndex].NextSpanIndex;
-	}
-
 	TArray<int32> PageToSpanStart;  // [PAGE_COUNT + 1]
 	TArray<int32> PageToSpanEnd;    // [PAGE_COUNT + 1]
 	TArray<FPageSpan> PageSpans;    // [MAX_SPAN_COUNT]
 	TArray<int32> UnusedSpanList;   // [MAX_SPAN_COUNT]
 
+	// Bit N is set when the free list for size class N of the fence class is not empty.
+	uint32 NonEmptyFreeLists[NumFenceClasses];
+
 	uint32 FreePageCount;
 	uint32 UnusedSpanListCount;
 
@@ -625,6 +625,48 @@ void FGlobalShaderMap::BeginCreateAllShaders()
 	}
 }
 
+#if !UE_BUILD_SHIPPING
+void FGlobalShaderMap::BenchmarkShaderLookup(int32 NumIterations, FOutputDevice& Out) const
+{
+	int32 NumShaders = 0;
+	double HashChainSeconds = 0.0;
+	double LookupIndexSeconds = 0.0;
+	for (const auto& It : SectionMap)
+	{
+		const FShaderMapContent* Content = It.Value->GetContent();
+		if (!Content)
+		{
+			continue;
+		}
+
+		double SectionHashChainSeconds = 0.0;
+		double SectionLookupIndexSeconds = 0.0;
+		Content->BenchmarkShaderLookup(NumIterations, SectionHashChainSeconds, SectionLookupIndexSeconds);
+		NumShaders += Content->GetNumShaders();
+		HashChainSeconds += SectionHashChainSeconds;
+		LookupIndexSeconds += SectionLookupIndexSeconds;
+	}
+
+	const double NumLookups = FMath::Max(double(NumShaders) * NumIterations, 1.0);
+	Out.Logf(TEXT("Shader lookup: %d sections, %d shaders, %d iterations"), SectionMap.Num(), NumShaders, NumIterations);
+	Out.Logf(TEXT("  Hash chain:   %.3f ms (%.1f ns/lookup)"), HashChainSeconds * 1000.0, HashChainSeconds * 1.0e9 / NumLookups);
+	Out.Logf(TEXT("  Lookup index: %.3f ms (%.1f ns/lookup)"), LookupIndexSeconds * 1000.0, LookupIndexSeconds * 1.0e9 / NumLookups);
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice GBenchmarkGlobalShaderLookupCmd(
+	TEXT("r.ShaderMap.BenchmarkLookup"),
+	TEXT("Times shader lookups in the global shader map through the hash chain and the finalized lookup index. Optional arg: number of iterations (default 100)."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Params, FOutputDevice& Out)
+		{
+			const int32 NumIterations = Params.Num() > 0 ? FMath::Max(FCString::Atoi(*Params[0]), 1) : 100;
+			if (const FGlobalShaderMap* GlobalShaderMap = GGlobalShaderMap[GMaxRHIShaderPlatform])
+			{
+				GlobalShaderMap->BenchmarkShaderLookup(NumIterations, Out);
+			}
+		}));
+#endif // !UE_BUILD_SHIPPING
+
 #if WITH_EDITOR
 void FGlobalShaderMap::GetOutdatedTypes(TArray<const FShaderType*>& OutdatedShaderTypes, TArray<const FShaderPipelineType*>& OutdatedShaderPipelineTypes, TArray<const FVertexFactoryType*>& OutdatedFactoryTypes) const
 {
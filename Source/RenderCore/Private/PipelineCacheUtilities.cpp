@@ -2,7 +2,13 @@
 #include "PipelineCacheUtilities.h"
 
 #if UE_WITH_PIPELINE_CACHE_UTILITIES
+#include "Algo/Count.h"
+#include "Async/ParallelFor.h"
 #include "Async/TaskGraphInterfaces.h"
+#include "Containers/IndirectArray.h"
+#include "Containers/StringConv.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/Compression.h"
 #include "Misc/SecureHash.h"
 #include "Serialization/NameAsStringIndexProxyArchive.h"
@@ -14,7 +20,11 @@
 #include "Serialization/JsonSerializer.h"
 #include "Interfaces/ITargetPlatform.h"
 #include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopedTimers.h"
 #include "ShaderCodeLibrary.h"
+#include "String/ParseLines.h"
+#include "Tasks/Task.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogPipelineCacheUtilities, Log, All);
 
@@ -388,6 +398,330 @@ bool UE::PipelineCacheUtilities::LoadStableKeysFile(const FStringView& Filename,
 	return true;
 }
 
+namespace UE
+{
+namespace PipelineCacheUtilities
+{
+namespace Private
+{
+	/** Text stable keys are parsed in line aligned chunks of about this many characters. Large enough to amortize the per-chunk name cache. */
+	static constexpr int32 StableKeysTextChunkSize = 1024 * 1024;
+
+	/** Text stable keys files are read in blocks of this many bytes. */
+	static constexpr int64 StableKeysTextBlockSize = 16 * 1024 * 1024;
+
+	/** Keys parsed from one chunk, in text order. */
+	using FStableKeysChunk = TArray<FStableShaderKeyAndValue>;
+
+	static bool IsStableKeyLine(const FStringView& Line)
+	{
+		// 11 fields for old files without the pipeline hash, 12 otherwise. Names are sanitized of ',' when written.
+		int32 NumDelimiters = 0;
+		for (TCHAR Char : Line)
+		{
+			NumDelimiters += Char == TEXT(',');
+		}
+		return (NumDelimiters == 10 || NumDelimiters == 11) && !Line.StartsWith(TEXTVIEW("ClassNameAndObjectPath,"));
+	}
+
+	static void ParseStableKeysChunk(const FStringView& Chunk, FStableKeysChunk& OutKeys)
+	{
+		OutKeys.Reserve(Algo::Count(Chunk, TEXT('\n')) + 1);
+
+		FStableShaderKeyNameCache NameCache;
+		UE::String::ParseLines(Chunk, [&OutKeys, &NameCache](FStringView Line)
+		{
+			Line = Line.TrimStartAndEnd();
+			if (IsStableKeyLine(Line))
+			{
+				OutKeys.Emplace_GetRef().ParseFromString(Line, NameCache);
+			}
+		});
+	}
+
+	/** Splits Text into views of whole lines, each at least ChunkSize characters long except for the last one. */
+	static void SplitIntoLineChunks(FStringView Text, int32 ChunkSize, TArray<FStringView>& OutChunks)
+	{
+		while (!Text.IsEmpty())
+		{
+			int32 ChunkLen = FMath::Min(ChunkSize, Text.Len());
+			while (ChunkLen < Text.Len() && Text[ChunkLen - 1] != TEXT('\n'))
+			{
+				++ChunkLen;
+			}
+
+			OutChunks.Add(Text.Left(ChunkLen));
+			Text.RightChopInline(ChunkLen);
+		}
+	}
+
+	template<typename ChunkArrayType>
+	static void AppendStableKeysChunks(ChunkArrayType& Chunks, TArray<FStableShaderKeyAndValue>& InOutArray)
+	{
+		int32 NumKeys = InOutArray.Num();
+		for (const FStableKeysChunk& Chunk : Chunks)
+		{
+			NumKeys += Chunk.Num();
+		}
+		InOutArray.Reserve(NumKeys);
+
+		for (FStableKeysChunk& Chunk : Chunks)
+		{
+			InOutArray.Append(MoveTemp(Chunk));
+		}
+	}
+}
+}
+}
+
+void UE::PipelineCacheUtilities::ParseStableKeysText(const FStringView& Text, TArray<FStableShaderKeyAndValue>& InOutArray)
+{
+	using namespace UE::PipelineCacheUtilities::Private;
+
+	TArray<FStringView> ChunkTexts;
+	SplitIntoLineChunks(Text, StableKeysTextChunkSize, ChunkTexts);
+
+	TArray<FStableKeysChunk> Chunks;
+	Chunks.SetNum(ChunkTexts.Num());
+
+	ParallelFor(TEXT("ParseStableKeysText"), ChunkTexts.Num(), 1, [&ChunkTexts, &Chunks](int32 ChunkIndex)
+	{
+		ParseStableKeysChunk(ChunkTexts[ChunkIndex], Chunks[ChunkIndex]);
+	});
+
+	AppendStableKeysChunks(Chunks, InOutArray);
+}
+
+bool UE::PipelineCacheUtilities::LoadStableKeysTextFile(const FStringView& Filename, TArray<FStableShaderKeyAndValue>& InOutArray)
+{
+	using namespace UE::PipelineCacheUtilities::Private;
+
+	const FString FilenameStr = FString::ConstructFromPtrSize(Filename.GetData(), Filename.Len());
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileReader(*FilenameStr));
+	if (!Archive)
+	{
+		return false;
+	}
+
+	const int64 FileSize = Archive->TotalSize();
+	int64 Offset = 0;
+
+	// Only UTF-8 and ANSI are streamed. UTF-16 files (written with ForceUnicode) are rare enough to just load whole.
+	uint8 Bom[3] = {};
+	Archive->Serialize(Bom, FMath::Min<int64>(FileSize, UE_ARRAY_COUNT(Bom)));
+	if (FileSize >= 2 && ((Bom[0] == 0xFF && Bom[1] == 0xFE) || (Bom[0] == 0xFE && Bom[1] == 0xFF)))
+	{
+		Archive.Reset();
+
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *FilenameStr))
+		{
+			return false;
+		}
+
+		ParseStableKeysText(Text, InOutArray);
+		return true;
+	}
+	else if (FileSize >= 3 && Bom[0] == 0xEF && Bom[1] == 0xBB && Bom[2] == 0xBF)
+	{
+		Offset = 3;
+	}
+	Archive->Seek(Offset);
+
+	TArray<uint8> Block;
+	Block.SetNumUninitialized((int32)FMath::Min(FileSize - Offset, StableKeysTextBlockSize));
+	int32 NumCarriedBytes = 0;
+
+	// Tasks share ownership of the converted text of their block so that blocks are freed as soon as they are parsed.
+	TIndirectArray<FStableKeysChunk> Chunks;
+	TArray<UE::Tasks::FTask> Tasks;
+
+	while (Offset < FileSize)
+	{
+		const int32 NumBytesToRead = (int32)FMath::Min<int64>(Block.Num() - NumCarriedBytes, FileSize - Offset);
+		if (NumBytesToRead <= 0)
+		{
+			// A single line longer than the block; grow so that it can be completed.
+			Block.SetNumUninitialized(Block.Num() * 2);
+			continue;
+		}
+
+		Archive->Serialize(Block.GetData() + NumCarriedBytes, NumBytesToRead);
+		Offset += NumBytesToRead;
+
+		const int32 NumBytes = NumCarriedBytes + NumBytesToRead;
+		int32 NumLineBytes = NumBytes;
+		if (Offset < FileSize)
+		{
+			while (NumLineBytes > 0 && Block[NumLineBytes - 1] != '\n')
+			{
+				--NumLineBytes;
+			}
+		}
+
+		if (NumLineBytes > 0)
+		{
+			FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Block.GetData()), NumLineBytes);
+			TSharedRef<FString> BlockText = MakeShared<FString>(FString::ConstructFromPtrSize(Converted.Get(), Converted.Length()));
+
+			TArray<FStringView> ChunkTexts;
+			SplitIntoLineChunks(*BlockText, StableKeysTextChunkSize, ChunkTexts);
+
+			for (const FStringView& ChunkText : ChunkTexts)
+			{
+				FStableKeysChunk* Chunk = new FStableKeysChunk();
+				Chunks.Add(Chunk);
+
+				Tasks.Emplace(UE::Tasks::Launch(UE_SOURCE_LOCATION, [BlockText, ChunkText, Chunk]
+				{
+					ParseStableKeysChunk(ChunkText, *Chunk);
+				}));
+			}
+		}
+
+		// Move the incomplete last line to the front of the block, it is completed by the next read.
+		NumCarriedBytes = NumBytes - NumLineBytes;
+		if (NumCarriedBytes > 0)
+		{
+			FMemory::Memmove(Block.GetData(), Block.GetData() + NumLineBytes, NumCarriedBytes);
+		}
+	}
+
+	const bool bSuccess = !Archive->IsError();
+	Archive.Reset();
+
+	UE::Tasks::Wait(Tasks);
+	AppendStableKeysChunks(Chunks, InOutArray);
+
+	return bSuccess;
+}
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+static void BenchmarkStableKeysTextParsing(const TArray<FString>& Args)
+{
+	const int32 NumKeys = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000000;
+
+	auto MakeNamePool = [](const TCHAR* Prefix, int32 Num)
+	{
+		TArray<FName> Names;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Names.Emplace(*FString::Printf(TEXT("%s%d"), Prefix, Index));
+		}
+		return Names;
+	};
+
+	// Mimic the distribution of real key files: a few hundred distinct shader types and vertex factories, many distinct assets.
+	const TArray<FName> ShaderTypes = MakeNamePool(TEXT("FBenchmarkShaderType"), 300);
+	const TArray<FName> VFTypes = MakeNamePool(TEXT("FBenchmarkVertexFactory"), 24);
+	const TArray<FName> Permutations = MakeNamePool(TEXT(""), 64);
+	const TArray<FName> Frequencies = { FName(TEXT("SF_Vertex")), FName(TEXT("SF_Pixel")), FName(TEXT("SF_Compute")) };
+	const FName MaterialClass(TEXT("Material"));
+
+	FString Text;
+	Text.Reserve(NumKeys * 256);
+	Text += FStableShaderKeyAndValue::HeaderLine();
+	Text += LINE_TERMINATOR;
+
+	{
+		FStableShaderKeyAndValue Key;
+		Key.ShaderClass = FName(TEXT("FMeshMaterialShader"));
+		Key.MaterialDomain = FName(TEXT("Surface"));
+		Key.FeatureLevel = FName(TEXT("SM6"));
+		Key.QualityLevel = FName(TEXT("High"));
+		Key.TargetPlatform = FName(TEXT("PCD3D_SM6"));
+
+		FString Line;
+		for (int32 Index = 0; Index < NumKeys; ++Index)
+		{
+			const int32 AssetIndex = Index / 16;
+			Key.ClassNameAndObjectPath.ObjectClassAndPath.Reset();
+			Key.ClassNameAndObjectPath.ObjectClassAndPath.Add(MaterialClass);
+			Key.ClassNameAndObjectPath.ObjectClassAndPath.Emplace(*FString::Printf(TEXT("/Game/Benchmark/Group%d/M_Benchmark_%d"), AssetIndex % 97, AssetIndex));
+			Key.ClassNameAndObjectPath.ObjectClassAndPath.Emplace(*FString::Printf(TEXT("M_Benchmark_%d"), AssetIndex));
+			Key.ShaderType = ShaderTypes[Index % ShaderTypes.Num()];
+			Key.TargetFrequency = Frequencies[Index % Frequencies.Num()];
+			Key.VFType = VFTypes[(Index / 3) % VFTypes.Num()];
+			Key.PermutationId = Permutations[(Index / 7) % Permutations.Num()];
+			FSHA1::HashBuffer(&Index, sizeof(Index), Key.OutputHash.Hash);
+
+			Key.ToString(Line);
+			Text += Line;
+			Text += LINE_TERMINATOR;
+		}
+	}
+
+	UE_LOG(LogPipelineCacheUtilities, Display, TEXT("Parsing %d generated stable keys (%.1f MB of text):"), NumKeys, Text.Len() * sizeof(TCHAR) / (1024.0 * 1024.0));
+
+	// What tools did before: one FString per line, then a FName lookup for every field.
+	TArray<FStableShaderKeyAndValue> PerLineKeys;
+	double PerLineSeconds = 0.0;
+	{
+		FScopedDurationTimer Timer(PerLineSeconds);
+
+		TArray<FString> Lines;
+		Text.ParseIntoArrayLines(Lines);
+		PerLineKeys.Reserve(Lines.Num());
+		for (const FString& Line : Lines)
+		{
+			if (!Line.StartsWith(TEXT("ClassNameAndObjectPath,")))
+			{
+				PerLineKeys.Emplace_GetRef().ParseFromString(Line);
+			}
+		}
+	}
+
+	TArray<FStableShaderKeyAndValue> ChunkedKeys;
+	double ChunkedSeconds = 0.0;
+	{
+		FScopedDurationTimer Timer(ChunkedSeconds);
+		UE::PipelineCacheUtilities::ParseStableKeysText(Text, ChunkedKeys);
+	}
+
+	const FString Filename = FPaths::ProfilingDir() / TEXT("StableKeysBenchmark.scl.csv");
+	TArray<FStableShaderKeyAndValue> StreamedKeys;
+	double StreamedSeconds = 0.0;
+	if (FFileHelper::SaveStringToFile(Text, *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		Text.Empty();
+
+		FScopedDurationTimer Timer(StreamedSeconds);
+		UE::PipelineCacheUtilities::LoadStableKeysTextFile(Filename, StreamedKeys);
+	}
+	IFileManager::Get().Delete(*Filename);
+
+	auto Matches = [&PerLineKeys](const TArray<FStableShaderKeyAndValue>& Keys)
+	{
+		if (Keys.Num() != PerLineKeys.Num())
+		{
+			return false;
+		}
+		for (int32 Index = 0; Index < Keys.Num(); ++Index)
+		{
+			if (!(Keys[Index] == PerLineKeys[Index]) || Keys[Index].OutputHash != PerLineKeys[Index].OutputHash)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	UE_LOG(LogPipelineCacheUtilities, Display, TEXT("  Per line:         %8.3f s"), PerLineSeconds);
+	UE_LOG(LogPipelineCacheUtilities, Display, TEXT("  Chunked parallel: %8.3f s (%.2fx)%s"), ChunkedSeconds, PerLineSeconds / FMath::Max(ChunkedSeconds, UE_DOUBLE_SMALL_NUMBER),
+		Matches(ChunkedKeys) ? TEXT("") : TEXT(" MISMATCH"));
+	UE_LOG(LogPipelineCacheUtilities, Display, TEXT("  Streamed file:    %8.3f s (%.2fx)%s"), StreamedSeconds, PerLineSeconds / FMath::Max(StreamedSeconds, UE_DOUBLE_SMALL_NUMBER),
+		Matches(StreamedKeys) ? TEXT("") : TEXT(" MISMATCH"));
+}
+
+static FAutoConsoleCommand GBenchmarkStableKeysTextParsingCmd(
+	TEXT("r.ShaderLibrary.BenchmarkStableKeysTextParsing"),
+	TEXT("Generates a text stable shader keys file and compares per line parsing with the chunked parallel parser and the streaming file loader.\n")
+	TEXT("Usage: r.ShaderLibrary.BenchmarkStableKeysTextParsing [NumKeys=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkStableKeysTextParsing));
+
+#endif // !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
 #if WITH_EDITOR
 
 bool UE::PipelineCacheUtilities::SaveStableKeysFile(const FStringView& Filename, const FStableShaderSet& Values)
@@ -9,6 +9,9 @@
 #include "VisualizeTexture.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeRWLock.h"
 
 struct FParallelPassSet : public FRHICommandListImmediate::FQueuedCommandList
 {
@@ -436,6 +439,23 @@ void FRDGBuilder::TickPoolElements()
 	SET_DWORD_STAT(STAT_RDG_TransitionBatchCount, GRDGStatTransitionBatchCount);
 	SET_MEMORY_STAT(STAT_RDG_MemoryWatermark, int64(GRDGStatMemoryWatermark));
 
+	if (GRDGCompileCache > 0)
+	{
+		const float CompileCacheHitRate = (float)GRDGStatCompileCacheHitCount / FMath::Max((float)(GRDGStatCompileCacheHitCount + GRDGStatCompileCacheMissCount), 1.0f);
+
+		CSV_CUSTOM_STAT(RDGCount, CompileCacheHits, GRDGStatCompileCacheHitCount, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(RDGCount, CompileCacheTimeSaved, GRDGStatCompileCacheTimeSaved, ECsvCustomStatOp::Set);
+
+		TRACE_COUNTER_SET(COUNTER_RDG_CompileCacheHitCount, GRDGStatCompileCacheHitCount);
+		TRACE_COUNTER_SET(COUNTER_RDG_CompileCacheMissCount, GRDGStatCompileCacheMissCount);
+		TRACE_COUNTER_SET(COUNTER_RDG_CompileCacheTimeSaved, GRDGStatCompileCacheTimeSaved);
+
+		SET_DWORD_STAT(STAT_RDG_CompileCacheHitCount, GRDGStatCompileCacheHitCount);
+		SET_DWORD_STAT(STAT_RDG_CompileCacheMissCount, GRDGStatCompileCacheMissCount);
+		SET_FLOAT_STAT(STAT_RDG_CompileCacheHitRate, CompileCacheHitRate);
+		SET_FLOAT_STAT(STAT_RDG_CompileCacheTimeSaved, GRDGStatCompileCacheTimeSaved);
+	}
+
 	GRDGStatPassCount = 0;
 	GRDGStatPassCullCount = 0;
 	GRDGStatRenderPassMergeCount = 0;
@@ -451,6 +471,9 @@ void FRDGBuilder::TickPoolElements()
 	GRDGStatAliasingCount = 0;
 	GRDGStatTransitionBatchCount = 0;
 	GRDGStatMemoryWatermark = 0;
+	GRDGStatCompileCacheHitCount = 0;
+	GRDGStatCompileCacheMissCount = 0;
+	GRDGStatCompileCacheTimeSaved = 0.0f;
 #endif
 }
 
@@ -588,6 +611,7 @@ FRDGBuilder::FRDGBuilder(FRHICommandListImmediate& InRHICmdList, FRDGEventName I
 
 	bSupportsAsyncCompute = IsAsyncComputeSupported(ShaderPlatform);
 	bSupportsRenderPassMerge = IsRenderPassMergeEnabled(ShaderPlatform);
+	bCompileCacheEnabled = GRDGCompileCache > 0 && !::IsImmediateMode();
 
 	const bool bParallelExecuteFlag = EnumHasAnyFlags(InFlags, ERDGBuilderFlags::ParallelExecute);
 	const bool bParallelExecuteAllowedAwait = ::IsParallelExecuteEnabled(ShaderPlatform);
@@ -1313,6 +1337,138 @@ void FRDGBuilder::FlushCullStack()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/** Results of CompilePassBarriers / CollectPassBarriers recorded by a graph, replayed by later graphs with the same compile cache key.
+ *  Resources are referenced by registry handle; the RHI resources are only bound when the replaying graph creates its transitions.
+ */
+struct FRDGCompileCacheEntry
+{
+	uint64 Key = 0;
+
+	/** Registry sizes of the recording graph. Handles in the entry are only meaningful for a graph with the same sizes. */
+	int32 NumPasses = 0;
+	int32 NumTextures = 0;
+	int32 NumBuffers = 0;
+
+	bool MatchesRegistrySizes(int32 InNumPasses, int32 InNumTextures, int32 InNumBuffers) const
+	{
+		return NumPasses == InNumPasses && NumTextures == InNumTextures && NumBuffers == InNumBuffers;
+	}
+
+	struct FTransition
+	{
+		FRDGSubresourceState StateBefore;
+		FRDGSubresourceState StateAfter;
+		FRDGTransitionInfo Info;
+	};
+
+	/** Every transition added while collecting pass barriers, in the order it was added. */
+	TArray<FTransition> Transitions;
+
+	/** Unique subresource states referenced by the resource end states below. */
+	TArray<FRDGSubresourceState> EndStates;
+
+	/** State / FirstState of each texture touched by the collected passes. Subresources index into [FirstEndState, FirstEndState + NumEndStates)
+	 *  so that subresources sharing a state object still share one after replay. The first half of the indices is State, the second FirstState.
+	 */
+	struct FTextureEndState
+	{
+		FRDGTextureHandle Texture;
+		int32 FirstEndState = 0;
+		int32 NumEndStates = 0;
+		int32 FirstEndStateIndex = 0;
+	};
+
+	TArray<FTextureEndState> TextureEndStates;
+	TArray<int32> TextureEndStateIndices;
+
+	struct FBufferEndState
+	{
+		FRDGBufferHandle Buffer;
+		int32 State = INDEX_NONE;
+		int32 FirstState = INDEX_NONE;
+	};
+
+	TArray<FBufferEndState> BufferEndStates;
+
+	/** Time spent by the recording graph compiling and collecting pass barriers. */
+	double RecordSeconds = 0.0;
+};
+
+/** Fixed-capacity map of recorded entries. Entries are only added once fully recorded and are immutable afterwards; when full, the
+ *  oldest entry is replaced.
+ */
+class FRDGCompileCache
+{
+public:
+	static FRDGCompileCache& Get()
+	{
+		static FRDGCompileCache Instance;
+		return Instance;
+	}
+
+	TSharedPtr<const FRDGCompileCacheEntry, ESPMode::ThreadSafe> Find(uint64 Key) const
+	{
+		FReadScopeLock Lock(RWLock);
+		const int32* SlotIndex = SlotIndexByKey.Find(Key);
+		return SlotIndex ? Slots[*SlotIndex] : nullptr;
+	}
+
+	void Add(TSharedPtr<const FRDGCompileCacheEntry, ESPMode::ThreadSafe> Entry)
+	{
+		const uint64 Key = Entry->Key;
+		const int32 MaxEntries = FMath::Max(GRDGCompileCacheMaxEntries, 1);
+
+		FWriteScopeLock Lock(RWLock);
+
+		if (const int32* SlotIndex = SlotIndexByKey.Find(Key))
+		{
+			Slots[*SlotIndex] = MoveTemp(Entry);
+			return;
+		}
+
+		// The capacity was lowered; start over rather than compacting.
+		if (Slots.Num() > MaxEntries)
+		{
+			Slots.Reset();
+			SlotIndexByKey.Reset();
+			NextSlotIndex = 0;
+		}
+
+		if (Slots.Num() < MaxEntries)
+		{
+			SlotIndexByKey.Emplace(Key, Slots.Num());
+			Slots.Emplace(MoveTemp(Entry));
+			return;
+		}
+
+		NextSlotIndex %= Slots.Num();
+		SlotIndexByKey.Remove(Slots[NextSlotIndex]->Key);
+		SlotIndexByKey.Emplace(Key, NextSlotIndex);
+		Slots[NextSlotIndex] = MoveTemp(Entry);
+		NextSlotIndex++;
+	}
+
+private:
+	mutable FRWLock RWLock;
+	TArray<TSharedPtr<const FRDGCompileCacheEntry, ESPMode::ThreadSafe>> Slots;
+	TMap<uint64, int32> SlotIndexByKey;
+	int32 NextSlotIndex = 0;
+};
+
+uint64 FRDGBuilder::ComputeCompileCacheKey() const
+{
+	// Each pass hashed its resource accesses during setup, so the key is a single walk over the passes once culling is resolved.
+	uint64 Key = Passes.Num();
+
+	for (FRDGPassHandle PassHandle = GetProloguePassHandle() + 1; PassHandle < GetEpiloguePassHandle(); ++PassHandle)
+	{
+		const FRDGPass* Pass = Passes[PassHandle];
+		Key = CityHash128to64({ Key, Pass->bCulled ? 0 : Pass->SetupHash });
+	}
+
+	return Key;
+}
+
 void FRDGBuilder::Compile()
 {
 	SCOPE_CYCLE_COUNTER(STAT_RDG_CompileTime);
@@ -1412,6 +1568,30 @@ void FRDGBuilder::Compile()
 		}
 	}
 
+	// Culling is resolved at this point, so the passes that take part in barrier compilation are known. Graphs whose setup key
+	// matches one recorded by an earlier graph replay its transitions instead of compiling and collecting barriers.
+	if (bCompileCacheEnabled)
+	{
+		const uint64 Key = ComputeCompileCacheKey();
+
+		TSharedPtr<const FRDGCompileCacheEntry, ESPMode::ThreadSafe> Entry = FRDGCompileCache::Get().Find(Key);
+
+		// A key collision between graphs with different resource counts would replay out-of-range handles; treat it as a miss
+		// and let the recorded entry replace the stale one.
+		if (Entry && Entry->MatchesRegistrySizes(Passes.Num(), Textures.Num(), Buffers.Num()))
+		{
+			CompileCacheReplayEntry = MoveTemp(Entry);
+		}
+		else
+		{
+			CompileCacheRecordEntry = MakeShared<FRDGCompileCacheEntry, ESPMode::ThreadSafe>();
+			CompileCacheRecordEntry->Key = Key;
+			CompileCacheRecordEntry->NumPasses = Passes.Num();
+			CompileCacheRecordEntry->NumTextures = Textures.Num();
+			CompileCacheRecordEntry->NumBuffers = Buffers.Num();
+		}
+	}
+
 	// Traverses passes on the graphics pipe and merges raster passes with the same render targets into a single RHI render pass.
 	if (bSupportsRenderPassMerge && RasterPassCount > 0)
 	{
@@ -1792,6 +1972,8 @@ void FRDGBuilder::Execute()
 
 	FCollectResourceContext CollectResourceContext;
 
+	IF_RDG_ENABLE_TRACE(Trace.OutputGraphCompileBegin());
+
 	bCompiling = true;
 
 	if (!IsImmediateMode())
@@ -1888,12 +2070,53 @@ void FRDGBuilder::Execute()
 
 		}, BufferNumElementsCallbacksTask, TaskPriority, !UploadedBuffers.IsEmpty());
 
+#if RDG_ENABLE_TRACE
+		if (FRDGTrace::IsGraphCaptureRequested())
+		{
+			// Buffer descs are only final once the NumElements callbacks have run.
+			BufferNumElementsCallbacksTask.Wait();
+			Trace.CaptureGraph(*this);
+		}
+#endif
+
 		Compile();
 
 		CollectPassBarriersTask = AddSetupTask([this]
 		{
-			CompilePassBarriers();
-			CollectPassBarriers();
+			const double StartTime = bCompileCacheEnabled ? FPlatformTime::Seconds() : 0.0;
+
+			if (CompileCacheReplayEntry)
+			{
+				ReplayPassBarriers(*CompileCacheReplayEntry);
+
+			#if RDG_STATS
+				GRDGStatCompileCacheHitCount++;
+				GRDGStatCompileCacheTimeSaved += (float)((CompileCacheReplayEntry->RecordSeconds - (FPlatformTime::Seconds() - StartTime)) * 1000.0);
+			#endif
+
+				CompileCacheReplayEntry.Reset();
+			}
+			// Transitions are recorded in the order the serial path adds them, so recording always takes the serial path.
+			else if (GRDGParallelCollectBarriers > 0 && bParallelCompileEnabled && !CompileCacheRecordEntry)
+			{
+				CompileAndCollectPassBarriersParallel();
+			}
+			else
+			{
+				CompilePassBarriers();
+				CollectPassBarriers();
+
+				if (CompileCacheRecordEntry)
+				{
+					CompileCacheRecordEntry->RecordSeconds = FPlatformTime::Seconds() - StartTime;
+					RecordPassBarrierEndStates(*CompileCacheRecordEntry);
+					FRDGCompileCache::Get().Add(MoveTemp(CompileCacheRecordEntry));
+
+				#if RDG_STATS
+					GRDGStatCompileCacheMissCount++;
+				#endif
+				}
+			}
 
 		}, TaskPriority, bParallelCompileResources);
 
@@ -2371,6 +2594,46 @@ void FRDGBuilder::SetupPassDependencies(FRDGPass* Pass)
 	}
 }
 
+/** Whether the subresources of a texture may share a single state when accessed as a whole. Fused depth / stencil copy transitions
+ *  patch the depth and stencil states independently, so those textures always track each subresource separately.
+ */
+static bool SupportsUniformSubresourceState(const FRDGTexture* Texture)
+{
+	return GRHISupportsSeparateDepthStencilCopyAccess || Texture->Desc.Format != PF_DepthStencil;
+}
+
+static bool IsUniformSubresourceState(const FRDGTexture* Texture, const FRDGTextureSubresourceState& State)
+{
+	if (!SupportsUniformSubresourceState(Texture))
+	{
+		return false;
+	}
+
+	for (int32 Index = 1; Index < State.Num(); ++Index)
+	{
+		if (State[Index] != State[0])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FRDGBuilder::SplitUniformPassState(FRDGPass::FTextureState& PassState)
+{
+	check(PassState.bUniform);
+	PassState.bUniform = false;
+
+	if (FRDGSubresourceState* SharedState = PassState.State[0])
+	{
+		for (int32 Index = 1; Index < PassState.State.Num(); ++Index)
+		{
+			PassState.State[Index] = AllocSubresource(*SharedState);
+		}
+	}
+}
+
 void FRDGBuilder::SetupPassResources(FRDGPass* Pass)
 {
 	const FRDGParameterStruct PassParameters = Pass->GetParameters();
@@ -2380,6 +2643,26 @@ void FRDGBuilder::SetupPassResources(FRDGPass* Pass)
 
 	bool bRenderPassOnlyWrites = true;
 
+	// Hashes every input of CompilePassBarriers / CollectPassBarriers for the compile cache. Resources are identified by registry
+	// handle, so graphs built the same way on different frames produce the same hash.
+	uint64 SetupHash = 0;
+
+	const auto HashSetupValue = [&](const auto& Value)
+	{
+		static_assert(sizeof(Value) <= sizeof(uint64), "Setup hash values are folded in 64 bits at a time.");
+
+		if (bCompileCacheEnabled)
+		{
+			uint64 Bits = 0;
+			FMemory::Memcpy(&Bits, &Value, sizeof(Value));
+			SetupHash = CityHash128to64({ SetupHash, Bits });
+		}
+	};
+
+	HashSetupValue(PassFlags);
+	HashSetupValue(PassPipeline);
+	HashSetupValue(uint8(Pass->bExternalAccessPass));
+
 	const auto TryAddView = [&](FRDGViewRef View)
 	{
 		if (View && View->LastPass != PassHandle)
@@ -2409,12 +2692,24 @@ void FRDGBuilder::SetupPassResources(FRDGPass* Pass)
 
 		FRDGPass::FTextureState* PassState;
 
+		// Accesses covering the whole texture share a single subresource state until the pass accesses a subset of it.
+		const bool bWholeResource = Range.IsWholeResource(Texture->Layout) && SupportsUniformSubresourceState(Texture);
+
+		HashSetupValue(Texture->Handle.GetIndexUnchecked());
+		HashSetupValue(Texture->Layout);
+		HashSetupValue(uint8(SupportsUniformSubresourceState(Texture)));
+		HashSetupValue(Access);
+		HashSetupValue(Range);
+		HashSetupValue(TransitionFlags);
+		HashSetupValue(NoUAVBarrierHandle.GetIndexUnchecked());
+
 		if (Texture->LastPasses[PassPipeline] != PassHandle)
 		{
 			Texture->LastPasses[PassPipeline] = PassHandle;
 			Texture->PassStateIndex = Pass->TextureStates.Num();
 
 			PassState = &Pass->TextureStates.Emplace_GetRef(Texture);
+			PassState->bUniform = bWholeResource;
 		}
 		else
 		{
@@ -2423,20 +2718,42 @@ void FRDGBuilder::SetupPassResources(FRDGPass* Pass)
 
 		PassState->ReferenceCount++;
 
-		EnumerateSubresourceRange(PassState->State, Texture->Layout, Range, [&](FRDGSubresourceState*& State)
+		const auto AddSubresourceAccess = [&](FRDGSubresourceState* State)
 		{
-			if (!State)
-			{
-				State = AllocSubresource();
-			}
-
 			IF_RDG_ENABLE_DEBUG(UserValidation.ValidateAddSubresourceAccess(Texture, *State, Access));
 
 			State->Access = MakeValidAccess(State->Access, Access);
 			State->Flags |= TransitionFlags;
 			State->NoUAVBarrierFilter.AddHandle(NoUAVBarrierHandle);
 			State->SetPass(PassPipeline, PassHandle);
-		});
+		};
+
+		if (PassState->bUniform && bWholeResource)
+		{
+			if (!PassState->State[0])
+			{
+				InitTextureSubresources(PassState->State, Texture->Layout, AllocSubresource());
+			}
+
+			AddSubresourceAccess(PassState->State[0]);
+		}
+		else
+		{
+			if (PassState->bUniform)
+			{
+				SplitUniformPassState(*PassState);
+			}
+
+			EnumerateSubresourceRange(PassState->State, Texture->Layout, Range, [&](FRDGSubresourceState*& State)
+			{
+				if (!State)
+				{
+					State = AllocSubresource();
+				}
+
+				AddSubresourceAccess(State);
+			});
+		}
 
 		if (IsWritableAccess(Access))
 		{
@@ -2484,6 +2801,11 @@ void FRDGBuilder::SetupPassResources(FRDGPass* Pass)
 
 		IF_RDG_ENABLE_DEBUG(UserValidation.ValidateAddSubresourceAccess(Buffer, PassState->State, Access));
 
+		HashSetupValue(Buffer->Handle.GetIndexUnchecked());
+		HashSetupValue(PassState->State.ReservedCommitHandle.GetIndexUnchecked());
+		HashSetupValue(Access);
+		HashSetupValue(NoUAVBarrierHandle.GetIndexUnchecked());
+
 		PassState->ReferenceCount++;
 		PassState->State.Access = MakeValidAccess(PassState->State.Access, Access);
 		PassState->State.NoUAVBarrierFilter.AddHandle(NoUAVBarrierHandle);
@@ -2502,6 +2824,11 @@ void FRDGBuilder::SetupPassResources(FRDGPass* Pass)
 
 	Pass->bEmptyParameters = !Pass->TextureStates.Num() && !Pass->BufferStates.Num();
 	Pass->bRenderPassOnlyWrites = bRenderPassOnlyWrites;
+
+	if (bCompileCacheEnabled)
+	{
+		Pass->SetupHash = SetupHash;
+	}
 	Pass->bHasExternalOutputs = PassParameters.HasExternalOutputs();
 
 	Pass->UniformBuffers.Reserve(PassParameters.GetUniformBufferParameterCount());
@@ -3185,6 +3512,66 @@ void FRDGBuilder::AllocatePooledBuffers(FRHICommandListBase& InRHICmdList, TCons
 	}
 }
 
+void FRDGBuilder::PlanTransientResources(TConstArrayView<FCollectResourceOp> Ops)
+{
+	SCOPED_NAMED_EVENT_TEXT("FRDGBuilder::PlanTransientResources", FColor::Magenta);
+
+	// Every transient lifetime of the graph is known at this point. Describe them in creation order, using the op index as the position
+	// on the allocation timeline, so the allocator can plan placements for the whole graph before any resource is created.
+	int32 NumBufferAllocations = 0;
+
+	for (FCollectResourceOp Op : Ops)
+	{
+		if (Op.GetOp() == FCollectResourceOp::EOp::Allocate && Op.GetResourceType() == ERDGViewableResourceType::Buffer)
+		{
+			NumBufferAllocations++;
+		}
+	}
+
+	// Buffer create infos are translated from the RDG descriptors, so they need stable storage for the duration of the call.
+	TArray<FRHIBufferCreateInfo, FRDGArrayAllocator> BufferCreateInfos;
+	BufferCreateInfos.Reserve(NumBufferAllocations);
+
+	TArray<FRHITransientAllocationLifetime, FRDGArrayAllocator> Lifetimes;
+	Lifetimes.Reserve(Ops.Num() / 2);
+
+	TArray<int32, FRDGArrayAllocator> TextureLifetimeIndices;
+	TArray<int32, FRDGArrayAllocator> BufferLifetimeIndices;
+	TextureLifetimeIndices.Init(INDEX_NONE, Textures.Num());
+	BufferLifetimeIndices.Init(INDEX_NONE, Buffers.Num());
+
+	for (int32 OpIndex = 0; OpIndex < Ops.Num(); ++OpIndex)
+	{
+		const FCollectResourceOp Op = Ops[OpIndex];
+		const bool bBuffer = Op.GetResourceType() == ERDGViewableResourceType::Buffer;
+		int32& LifetimeIndex = bBuffer ? BufferLifetimeIndices[Op.ResourceIndex] : TextureLifetimeIndices[Op.ResourceIndex];
+
+		if (Op.GetOp() == FCollectResourceOp::EOp::Allocate)
+		{
+			LifetimeIndex = Lifetimes.Num();
+
+			FRHITransientAllocationLifetime& Lifetime = Lifetimes.Emplace_GetRef();
+			Lifetime.AllocateIndex = OpIndex;
+
+			if (bBuffer)
+			{
+				Lifetime.BufferCreateInfo = &BufferCreateInfos.Emplace_GetRef(Translate(Buffers[Op.GetBufferHandle()]->Desc));
+			}
+			else
+			{
+				Lifetime.TextureCreateInfo = &Textures[Op.GetTextureHandle()]->Desc;
+			}
+		}
+		// Deallocations of resources allocated by earlier graphs (e.g. transient render targets) don't affect the plan.
+		else if (LifetimeIndex != INDEX_NONE)
+		{
+			Lifetimes[LifetimeIndex].DeallocateIndex = OpIndex;
+		}
+	}
+
+	TransientResourceAllocator->PlanAllocations(Lifetimes);
+}
+
 void FRDGBuilder::AllocateTransientResources(TConstArrayView<FCollectResourceOp> Ops)
 {
 	if (!TransientResourceAllocator)
@@ -3195,6 +3582,11 @@ void FRDGBuilder::AllocateTransientResources(TConstArrayView<FCollectResourceOp>
 	SCOPED_NAMED_EVENT_TEXT("FRDGBuilder::AllocateTransientResources", FColor::Magenta);
 	TransientResourceAllocator->SetCreateMode(bParallelCompileEnabled ? ERHITransientResourceCreateMode::Task : ERHITransientResourceCreateMode::Inline);
 
+	if (GRDGTransientPlacementPlanning)
+	{
+		PlanTransientResources(Ops);
+	}
+
 	TArray<TPair<FRDGViewableResource*, FRHITransientResource*>, FRDGArrayAllocator> AllocatedResources;
 	AllocatedResources.Reserve(Ops.Num() / 2);
 
@@ -3747,101 +4139,212 @@ void FRDGBuilder::CollectDeallocateBuffer(FCollectResourceContext& Context, ERHI
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-void FRDGBuilder::CompilePassBarriers()
+static void MergeSubresourceState(FRDGPassHandle PassHandle, ERHIPipeline PassPipeline, bool bBeginMergeState, FRDGSubresourceState*& PassMergeState, FRDGSubresourceState*& ResourceMergeState, FRDGSubresourceState* PassState)
 {
-	// Walk the culled graph and compile barriers for each subresource. Certain transitions are redundant; read-to-read, for example.
-	// We can avoid them by traversing and merging compatible states together. The merging states removes a transition, but the merging
-	// heuristic is conservative and choosing not to merge doesn't necessarily mean a transition is performed. They are two distinct steps.
-	// Merged states track the first and last pass used for all pipelines.
-
-	SCOPED_NAMED_EVENT(CompileBarriers, FColor::Emerald);
-	FRDGAllocatorScope AllocatorScope(Allocators.Transition);
-
-	for (FRDGPassHandle PassHandle = GetProloguePassHandle() + 1; PassHandle < GetEpiloguePassHandle(); ++PassHandle)
+	if (bBeginMergeState)
 	{
-		FRDGPass* Pass = Passes[PassHandle];
+		// Use the new pass state as the merge state for future passes.
+		ResourceMergeState = PassState;
+	}
+	else
+	{
+		// Merge the pass state into the merged state.
+		ResourceMergeState->Access |= PassState->Access;
 
-		if (Pass->bCulled)
+		// If multiple reserved commits were requested, take the latest.
+		if (PassState->ReservedCommitHandle.IsValid())
 		{
-			continue;
+			ResourceMergeState->ReservedCommitHandle = PassState->ReservedCommitHandle;
 		}
 
-		if (!Pass->NumTransitionsToReserve)
+		FRDGPassHandle& FirstPassHandle = ResourceMergeState->FirstPass[PassPipeline];
+
+		if (FirstPassHandle.IsNull())
 		{
-			Pass->NumTransitionsToReserve = Pass->TextureStates.Num() + Pass->BufferStates.Num();
+			FirstPassHandle = PassHandle;
 		}
 
-		const ERHIPipeline PassPipeline = Pass->Pipeline;
+		ResourceMergeState->LastPass[PassPipeline] = PassHandle;
+	}
 
-		const auto MergeSubresourceStates = [&](ERDGViewableResourceType ResourceType, FRDGSubresourceState*& PassMergeState, FRDGSubresourceState*& ResourceMergeState, FRDGSubresourceState* PassState)
-		{
-			if (!ResourceMergeState || !FRDGSubresourceState::IsMergeAllowed(ResourceType, *ResourceMergeState, *PassState))
-			{
-				// Use the new pass state as the merge state for future passes.
-				ResourceMergeState = PassState;
-			}
-			else
-			{
-				// Merge the pass state into the merged state.
-				ResourceMergeState->Access |= PassState->Access;
+	PassMergeState = ResourceMergeState;
+}
 
-				// If multiple reserved commits were requested, take the latest.
-				if (PassState->ReservedCommitHandle.IsValid())
-				{
-					ResourceMergeState->ReservedCommitHandle = PassState->ReservedCommitHandle;
-				}
+void FRDGBuilder::SplitUniformMergeState(FRDGTexture* Texture, FRDGPassHandle PassHandle)
+{
+	check(Texture->bUniformMergeState);
+	Texture->bUniformMergeState = false;
 
-				FRDGPassHandle& FirstPassHandle = ResourceMergeState->FirstPass[PassPipeline];
+	FRDGSubresourceState* SharedMergeState = Texture->MergeState[0];
 
-				if (FirstPassHandle.IsNull())
-				{
-					FirstPassHandle = PassHandle;
-				}
+	if (!SharedMergeState)
+	{
+		return;
+	}
 
-				ResourceMergeState->LastPass[PassPipeline] = PassHandle;
-			}
+	// Give each subresource its own copy of the shared merge state, then re-point the pass states merged into it since the run began.
+	// Subresource 0 gets a copy as well: the shared state is the pass state of the pass that began the run, which must not be mutated
+	// by merges into a single subresource.
+	for (int32 Index = 0; Index < Texture->MergeState.Num(); ++Index)
+	{
+		Texture->MergeState[Index] = AllocSubresource(*SharedMergeState);
+	}
 
-			PassMergeState = ResourceMergeState;
-		};
+	for (FRDGPassHandle RunPassHandle = Texture->UniformMergePass; RunPassHandle < PassHandle; ++RunPassHandle)
+	{
+		FRDGPass* RunPass = Passes[RunPassHandle];
 
-		for (auto& PassState : Pass->TextureStates)
+		if (RunPass->bCulled)
 		{
-			FRDGTexture* Texture = PassState.Texture;
-
-		#if RDG_STATS
-			GRDGStatTextureReferenceCount += PassState.ReferenceCount;
-		#endif
+			continue;
+		}
 
-			for (int32 Index = 0; Index < PassState.State.Num(); ++Index)
+		for (auto& RunPassState : RunPass->TextureStates)
+		{
+			if (RunPassState.Texture == Texture && RunPassState.MergeState[0] == SharedMergeState)
 			{
-				if (!PassState.State[Index])
+				for (int32 Index = 0; Index < RunPassState.MergeState.Num(); ++Index)
 				{
-					continue;
+					RunPassState.MergeState[Index] = Texture->MergeState[Index];
 				}
-
-				MergeSubresourceStates(ERDGViewableResourceType::Texture, PassState.MergeState[Index], Texture->MergeState[Index], PassState.State[Index]);
+				break;
 			}
 		}
-
-		for (auto& PassState : Pass->BufferStates)
-		{
-			FRDGBuffer* Buffer = PassState.Buffer;
-
-		#if RDG_STATS
-			GRDGStatBufferReferenceCount += PassState.ReferenceCount;
-		#endif
-
-			MergeSubresourceStates(ERDGViewableResourceType::Buffer, PassState.MergeState, Buffer->MergeState, &PassState.State);
-		}
 	}
 }
 
-void FRDGBuilder::CollectPassBarriers()
+template <typename GetBeginMergeStateLambdaType>
+void FRDGBuilder::MergeTextureState(FRDGPassHandle PassHandle, ERHIPipeline PassPipeline, FRDGPass::FTextureState& PassState, GetBeginMergeStateLambdaType&& GetBeginMergeState)
 {
-	SCOPED_NAMED_EVENT_TEXT("FRDGBuilder::CollectBarriers", FColor::Magenta);
-	SCOPE_CYCLE_COUNTER(STAT_RDG_CollectBarriersTime);
-	CSV_SCOPED_TIMING_STAT_EXCLUSIVE_CONDITIONAL(RDG_CollectBarriers, GRDGVerboseCSVStats != 0);
-	FRDGAllocatorScope AllocatorScope(Allocators.Transition);
+	FRDGTexture* Texture = PassState.Texture;
+	const int32 SubresourceCount = PassState.State.Num();
+
+	if (PassState.bUniform && Texture->bUniformMergeState)
+	{
+		// All subresources share both the pass state and the merge state, so one merge decision applies to all of them.
+		const bool bBeginMergeState = GetBeginMergeState(Texture->MergeState[0], PassState.State[0]);
+		MergeSubresourceState(PassHandle, PassPipeline, bBeginMergeState, PassState.MergeState[0], Texture->MergeState[0], PassState.State[0]);
+
+		for (int32 Index = 1; Index < SubresourceCount; ++Index)
+		{
+			PassState.MergeState[Index] = Texture->MergeState[Index] = PassState.MergeState[0];
+		}
+
+		if (bBeginMergeState)
+		{
+			Texture->UniformMergePass = PassHandle;
+		}
+		return;
+	}
+
+	if (PassState.bUniform)
+	{
+		// The merge state was split by an earlier subresource access. If every subresource begins a new merge state on this pass,
+		// the shared pass state becomes the merge state for all of them and the texture collapses back to a single entry.
+		TBitArray<> BeginMergeStates(false, SubresourceCount);
+		bool bBeginAllMergeStates = true;
+
+		for (int32 Index = 0; Index < SubresourceCount; ++Index)
+		{
+			const bool bBeginMergeState = GetBeginMergeState(Texture->MergeState[Index], PassState.State[Index]);
+			BeginMergeStates[Index] = bBeginMergeState;
+			bBeginAllMergeStates &= bBeginMergeState;
+		}
+
+		if (bBeginAllMergeStates)
+		{
+			for (int32 Index = 0; Index < SubresourceCount; ++Index)
+			{
+				PassState.MergeState[Index] = Texture->MergeState[Index] = PassState.State[0];
+			}
+
+			Texture->bUniformMergeState = true;
+			Texture->UniformMergePass = PassHandle;
+			return;
+		}
+
+		SplitUniformPassState(PassState);
+
+		for (int32 Index = 0; Index < SubresourceCount; ++Index)
+		{
+			MergeSubresourceState(PassHandle, PassPipeline, BeginMergeStates[Index], PassState.MergeState[Index], Texture->MergeState[Index], PassState.State[Index]);
+		}
+		return;
+	}
+
+	if (Texture->bUniformMergeState)
+	{
+		SplitUniformMergeState(Texture, PassHandle);
+	}
+
+	for (int32 Index = 0; Index < SubresourceCount; ++Index)
+	{
+		if (FRDGSubresourceState* State = PassState.State[Index])
+		{
+			const bool bBeginMergeState = GetBeginMergeState(Texture->MergeState[Index], State);
+			MergeSubresourceState(PassHandle, PassPipeline, bBeginMergeState, PassState.MergeState[Index], Texture->MergeState[Index], State);
+		}
+	}
+}
+
+void FRDGBuilder::CompilePassBarriers()
+{
+	// Walk the culled graph and compile barriers for each subresource. Certain transitions are redundant; read-to-read, for example.
+	// We can avoid them by traversing and merging compatible states together. The merging states removes a transition, but the merging
+	// heuristic is conservative and choosing not to merge doesn't necessarily mean a transition is performed. They are two distinct steps.
+	// Merged states track the first and last pass used for all pipelines.
+
+	SCOPED_NAMED_EVENT(CompileBarriers, FColor::Emerald);
+	FRDGAllocatorScope AllocatorScope(Allocators.Transition);
+
+	for (FRDGPassHandle PassHandle = GetProloguePassHandle() + 1; PassHandle < GetEpiloguePassHandle(); ++PassHandle)
+	{
+		FRDGPass* Pass = Passes[PassHandle];
+
+		if (Pass->bCulled)
+		{
+			continue;
+		}
+
+		if (!Pass->NumTransitionsToReserve)
+		{
+			Pass->NumTransitionsToReserve = Pass->TextureStates.Num() + Pass->BufferStates.Num();
+		}
+
+		const ERHIPipeline PassPipeline = Pass->Pipeline;
+
+		for (auto& PassState : Pass->TextureStates)
+		{
+		#if RDG_STATS
+			GRDGStatTextureReferenceCount += PassState.ReferenceCount;
+		#endif
+
+			MergeTextureState(PassHandle, PassPipeline, PassState, [](FRDGSubresourceState* ResourceMergeState, FRDGSubresourceState* PassSubresourceState)
+			{
+				return !ResourceMergeState || !FRDGSubresourceState::IsMergeAllowed(ERDGViewableResourceType::Texture, *ResourceMergeState, *PassSubresourceState);
+			});
+		}
+
+		for (auto& PassState : Pass->BufferStates)
+		{
+			FRDGBuffer* Buffer = PassState.Buffer;
+
+		#if RDG_STATS
+			GRDGStatBufferReferenceCount += PassState.ReferenceCount;
+		#endif
+
+			const bool bBeginMergeState = !Buffer->MergeState || !FRDGSubresourceState::IsMergeAllowed(ERDGViewableResourceType::Buffer, *Buffer->MergeState, PassState.State);
+			MergeSubresourceState(PassHandle, PassPipeline, bBeginMergeState, PassState.MergeState, Buffer->MergeState, &PassState.State);
+		}
+	}
+}
+
+void FRDGBuilder::CollectPassBarriers()
+{
+	SCOPED_NAMED_EVENT_TEXT("FRDGBuilder::CollectBarriers", FColor::Magenta);
+	SCOPE_CYCLE_COUNTER(STAT_RDG_CollectBarriersTime);
+	CSV_SCOPED_TIMING_STAT_EXCLUSIVE_CONDITIONAL(RDG_CollectBarriers, GRDGVerboseCSVStats != 0);
+	FRDGAllocatorScope AllocatorScope(Allocators.Transition);
 
 	for (FRDGPassHandle PassHandle = GetProloguePassHandle() + 1; PassHandle < GetEpiloguePassHandle(); ++PassHandle)
 	{
@@ -3858,6 +4361,17 @@ void FRDGBuilder::CollectPassBarriers(FRDGPassHandle PassHandle)
 		return;
 	}
 
+	FRDGCompileCacheEntry* RecordEntry = CompileCacheRecordEntry.Get();
+
+	const auto AddPassTransition = [this, RecordEntry](FRDGViewableResource* Resource, const FRDGSubresourceState& StateBefore, const FRDGSubresourceState& StateAfter, const FRDGTransitionInfo& Info)
+	{
+		if (RecordEntry)
+		{
+			RecordEntry->Transitions.Add({ StateBefore, StateAfter, Info });
+		}
+
+		AddTransition(Resource, StateBefore, StateAfter, Info);
+	};
 
 	for (auto& PassState : Pass->TextureStates)
 	{
@@ -3871,7 +4385,7 @@ void FRDGBuilder::CollectPassBarriers(FRDGPassHandle PassHandle)
 				return IsImmediateMode();
 			}
 			return true;
-		});
+		}, AddPassTransition);
 
 		IF_RDG_ENABLE_TRACE(Trace.AddTexturePassDependency(Texture, Pass));
 	}
@@ -3888,12 +4402,504 @@ void FRDGBuilder::CollectPassBarriers(FRDGPassHandle PassHandle)
 				return IsImmediateMode();
 			}
 			return true;
-		});
+		}, AddPassTransition);
 
 		IF_RDG_ENABLE_TRACE(Trace.AddBufferPassDependency(Buffer, Pass));
 	}
 }
 
+void FRDGBuilder::RecordPassBarrierEndStates(FRDGCompileCacheEntry& Entry)
+{
+	SCOPED_NAMED_EVENT(RecordPassBarrierEndStates, FColor::Magenta);
+
+	// Replay has to leave State / FirstState exactly as collection did, including which subresources share a state object, since the
+	// first / last transitions and the uniform transition path compare them by pointer.
+	TMap<const FRDGSubresourceState*, int32, TInlineSetAllocator<16>> EndStateIndices;
+
+	const auto AddEndState = [&](const FRDGSubresourceState* State)
+	{
+		if (!State)
+		{
+			return (int32)INDEX_NONE;
+		}
+
+		if (const int32* FoundIndex = EndStateIndices.Find(State))
+		{
+			return *FoundIndex;
+		}
+
+		const int32 Index = EndStateIndices.Num();
+		EndStateIndices.Emplace(State, Index);
+		Entry.EndStates.Emplace(*State);
+		return Index;
+	};
+
+	Textures.Enumerate([&](FRDGTexture* Texture)
+	{
+		const int32 SubresourceCount = Texture->FirstState.Num();
+		int32 Index = 0;
+
+		for (; Index < SubresourceCount && !Texture->FirstState[Index]; ++Index) {}
+
+		if (Index == SubresourceCount)
+		{
+			return;
+		}
+
+		EndStateIndices.Reset();
+
+		FRDGCompileCacheEntry::FTextureEndState& TextureEndState = Entry.TextureEndStates.Emplace_GetRef();
+		TextureEndState.Texture = Texture->Handle;
+		TextureEndState.FirstEndState = Entry.EndStates.Num();
+		TextureEndState.FirstEndStateIndex = Entry.TextureEndStateIndices.Num();
+
+		for (const FRDGSubresourceState* State : Texture->State)
+		{
+			Entry.TextureEndStateIndices.Emplace(AddEndState(State));
+		}
+
+		for (const FRDGSubresourceState* State : Texture->FirstState)
+		{
+			Entry.TextureEndStateIndices.Emplace(AddEndState(State));
+		}
+
+		TextureEndState.NumEndStates = Entry.EndStates.Num() - TextureEndState.FirstEndState;
+	});
+
+	Buffers.Enumerate([&](FRDGBuffer* Buffer)
+	{
+		if (!Buffer->FirstState)
+		{
+			return;
+		}
+
+		FRDGCompileCacheEntry::FBufferEndState& BufferEndState = Entry.BufferEndStates.Emplace_GetRef();
+		BufferEndState.Buffer = Buffer->Handle;
+		BufferEndState.FirstState = Entry.EndStates.Emplace(*Buffer->FirstState);
+		BufferEndState.State = Buffer->State == Buffer->FirstState ? BufferEndState.FirstState : Entry.EndStates.Emplace(*Buffer->State);
+	});
+}
+
+void FRDGBuilder::ReplayPassBarriers(const FRDGCompileCacheEntry& Entry)
+{
+	SCOPED_NAMED_EVENT_TEXT("FRDGBuilder::ReplayPassBarriers", FColor::Magenta);
+	SCOPE_CYCLE_COUNTER(STAT_RDG_CollectBarriersTime);
+	CSV_SCOPED_TIMING_STAT_EXCLUSIVE_CONDITIONAL(RDG_CollectBarriers, GRDGVerboseCSVStats != 0);
+	FRDGAllocatorScope AllocatorScope(Allocators.Transition);
+	check(Entry.MatchesRegistrySizes(Passes.Num(), Textures.Num(), Buffers.Num()));
+
+	// Merge states are not consumed past collection, so only the per-pass bookkeeping of CompilePassBarriers / CollectPassBarriers is redone.
+	for (FRDGPassHandle PassHandle = GetProloguePassHandle() + 1; PassHandle < GetEpiloguePassHandle(); ++PassHandle)
+	{
+		FRDGPass* Pass = Passes[PassHandle];
+
+		if (Pass->bCulled)
+		{
+			continue;
+		}
+
+		if (!Pass->NumTransitionsToReserve)
+		{
+			Pass->NumTransitionsToReserve = Pass->TextureStates.Num() + Pass->BufferStates.Num();
+		}
+
+	#if RDG_STATS
+		for (const auto& PassState : Pass->TextureStates)
+		{
+			GRDGStatTextureReferenceCount += PassState.ReferenceCount;
+		}
+
+		for (const auto& PassState : Pass->BufferStates)
+		{
+			GRDGStatBufferReferenceCount += PassState.ReferenceCount;
+		}
+	#endif
+
+	#if RDG_ENABLE_TRACE
+		if (!Pass->bEmptyParameters)
+		{
+			for (const auto& PassState : Pass->TextureStates)
+			{
+				Trace.AddTexturePassDependency(PassState.Texture, Pass);
+			}
+
+			for (const auto& PassState : Pass->BufferStates)
+			{
+				Trace.AddBufferPassDependency(PassState.Buffer, Pass);
+			}
+		}
+	#endif
+	}
+
+	for (const FRDGCompileCacheEntry::FTransition& Transition : Entry.Transitions)
+	{
+		FRDGTransitionInfo Info = Transition.Info;
+		FRDGViewableResource* Resource;
+
+		if ((ERDGViewableResourceType)Info.ResourceType == ERDGViewableResourceType::Texture)
+		{
+			Resource = Textures[FRDGTextureHandle(Info.ResourceHandle)];
+		}
+		else
+		{
+			Resource = Buffers[FRDGBufferHandle(Info.ResourceHandle)];
+
+			// Commit handles are part of the key, but the commit sizes belong to this graph.
+			Info.Buffer.CommitSize = GetReservedCommitSize(Transition.StateAfter.ReservedCommitHandle);
+		}
+
+		AddTransition(Resource, Transition.StateBefore, Transition.StateAfter, Info);
+	}
+
+	TArray<FRDGSubresourceState*, TInlineAllocator<16, FRDGArrayAllocator>> EndStates;
+
+	for (const FRDGCompileCacheEntry::FTextureEndState& TextureEndState : Entry.TextureEndStates)
+	{
+		FRDGTexture* Texture = Textures[TextureEndState.Texture];
+		const int32 SubresourceCount = Texture->State.Num();
+		check(TextureEndState.FirstEndStateIndex + SubresourceCount * 2 <= Entry.TextureEndStateIndices.Num());
+
+		EndStates.Reset();
+
+		for (int32 Index = 0; Index < TextureEndState.NumEndStates; ++Index)
+		{
+			EndStates.Emplace(AllocSubresource(Entry.EndStates[TextureEndState.FirstEndState + Index]));
+		}
+
+		const int32* StateIndices = &Entry.TextureEndStateIndices[TextureEndState.FirstEndStateIndex];
+		const int32* FirstStateIndices = StateIndices + SubresourceCount;
+
+		for (int32 Index = 0; Index < SubresourceCount; ++Index)
+		{
+			Texture->State[Index] = StateIndices[Index] != INDEX_NONE ? EndStates[StateIndices[Index]] : nullptr;
+			Texture->FirstState[Index] = FirstStateIndices[Index] != INDEX_NONE ? EndStates[FirstStateIndices[Index]] : nullptr;
+		}
+	}
+
+	for (const FRDGCompileCacheEntry::FBufferEndState& BufferEndState : Entry.BufferEndStates)
+	{
+		FRDGBuffer* Buffer = Buffers[BufferEndState.Buffer];
+		Buffer->FirstState = AllocSubresource(Entry.EndStates[BufferEndState.FirstState]);
+		Buffer->State = BufferEndState.State == BufferEndState.FirstState ? Buffer->FirstState : AllocSubresource(Entry.EndStates[BufferEndState.State]);
+	}
+}
+
+void FRDGBuilder::CompileAndCollectPassBarriersParallel()
+{
+	SCOPED_NAMED_EVENT_TEXT("FRDGBuilder::CompileAndCollectBarriersParallel", FColor::Magenta);
+	SCOPE_CYCLE_COUNTER(STAT_RDG_CollectBarriersTime);
+	CSV_SCOPED_TIMING_STAT_EXCLUSIVE_CONDITIONAL(RDG_CollectBarriers, GRDGVerboseCSVStats != 0);
+	FRDGAllocatorScope AllocatorScope(Allocators.Transition);
+
+	// The merge and transition chains of a resource only depend on the passes that reference it. The pass -> resource lists are
+	// inverted into per-resource access sequences (in pass order), which are then compiled and collected for disjoint sets of
+	// resources in parallel. Transitions are recorded with a key of {pass, pass state, subresource} and replayed in key order,
+	// which is exactly the order in which the serial CompilePassBarriers / CollectPassBarriers path calls AddTransition.
+
+	struct FResourceAccess
+	{
+		FRDGPassHandle PassHandle;
+		uint32 PassStateIndex;
+	};
+
+	struct FRecordedTransition
+	{
+		uint64 Key;
+		FRDGViewableResource* Resource;
+		FRDGSubresourceState StateBefore;
+		FRDGSubresourceState StateAfter;
+		FRDGTransitionInfo Info;
+	};
+
+	struct FTaskContext
+	{
+		TArray<FRecordedTransition> Transitions;
+		TArray<FRDGTexture*> SerialTextures;
+		TArray<FRDGTexture*> SerialMergeTextures;
+	};
+
+	const auto MakeTransitionKey = [](FResourceAccess Access, uint32 TransitionIndex)
+	{
+		checkSlow(Access.PassHandle.GetIndex() < (1u << 24) && Access.PassStateIndex < (1u << 20) && TransitionIndex < (1u << 20));
+		return (uint64(Access.PassHandle.GetIndex()) << 40) | (uint64(Access.PassStateIndex) << 20) | uint64(TransitionIndex);
+	};
+
+	const FRDGPassHandle ProloguePassHandle = GetProloguePassHandle();
+	const FRDGPassHandle EpiloguePassHandle = GetEpiloguePassHandle();
+	const int32 NumTextures = Textures.Num();
+	const int32 NumBuffers = Buffers.Num();
+
+	TArray<uint32, FRDGArrayAllocator> AccessOffsets;
+	AccessOffsets.SetNumZeroed(NumTextures + NumBuffers + 1);
+
+	for (FRDGPassHandle PassHandle = ProloguePassHandle + 1; PassHandle < EpiloguePassHandle; ++PassHandle)
+	{
+		FRDGPass* Pass = Passes[PassHandle];
+
+		if (Pass->bCulled)
+		{
+			continue;
+		}
+
+		if (!Pass->NumTransitionsToReserve)
+		{
+			Pass->NumTransitionsToReserve = Pass->TextureStates.Num() + Pass->BufferStates.Num();
+		}
+
+		for (const auto& PassState : Pass->TextureStates)
+		{
+		#if RDG_STATS
+			GRDGStatTextureReferenceCount += PassState.ReferenceCount;
+		#endif
+
+			AccessOffsets[PassState.Texture->Handle.GetIndex() + 1]++;
+		}
+
+		for (const auto& PassState : Pass->BufferStates)
+		{
+		#if RDG_STATS
+			GRDGStatBufferReferenceCount += PassState.ReferenceCount;
+		#endif
+
+			AccessOffsets[NumTextures + PassState.Buffer->Handle.GetIndex() + 1]++;
+		}
+	}
+
+	for (int32 Index = 1; Index < AccessOffsets.Num(); ++Index)
+	{
+		AccessOffsets[Index] += AccessOffsets[Index - 1];
+	}
+
+	TArray<FResourceAccess, FRDGArrayAllocator> Accesses;
+	Accesses.SetNumUninitialized(AccessOffsets.Last());
+
+	{
+		TArray<uint32, FRDGArrayAllocator> AccessCursors(AccessOffsets.GetData(), NumTextures + NumBuffers);
+
+		for (FRDGPassHandle PassHandle = ProloguePassHandle + 1; PassHandle < EpiloguePassHandle; ++PassHandle)
+		{
+			const FRDGPass* Pass = Passes[PassHandle];
+
+			if (Pass->bCulled)
+			{
+				continue;
+			}
+
+			for (int32 PassStateIndex = 0; PassStateIndex < Pass->TextureStates.Num(); ++PassStateIndex)
+			{
+				Accesses[AccessCursors[Pass->TextureStates[PassStateIndex].Texture->Handle.GetIndex()]++] = { PassHandle, (uint32)PassStateIndex };
+			}
+
+			for (int32 PassStateIndex = 0; PassStateIndex < Pass->BufferStates.Num(); ++PassStateIndex)
+			{
+				Accesses[AccessCursors[NumTextures + Pass->BufferStates[PassStateIndex].Buffer->Handle.GetIndex()]++] = { PassHandle, (uint32)(Pass->TextureStates.Num() + PassStateIndex) };
+			}
+		}
+	}
+
+	// Certain RHIs fuse depth / stencil copy transitions, which allocates new subresource states from the transition allocator. Those
+	// textures are merged in parallel but their transitions are collected on this thread.
+	const auto RequiresSerialCollect = [](const FRDGTexture* Texture)
+	{
+		return !GRHISupportsSeparateDepthStencilCopyAccess && Texture->Desc.Format == PF_DepthStencil;
+	};
+
+	// Textures accessed both as a whole and per subresource split their shared states, which also allocates. Those are merged and
+	// collected entirely on this thread.
+	const auto RequiresSerialMerge = [&](TConstArrayView<FResourceAccess> TextureAccesses)
+	{
+		const bool bFirstUniform = Passes[TextureAccesses[0].PassHandle]->TextureStates[TextureAccesses[0].PassStateIndex].bUniform;
+
+		for (const FResourceAccess& Access : TextureAccesses)
+		{
+			if (Passes[Access.PassHandle]->TextureStates[Access.PassStateIndex].bUniform != bFirstUniform)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	const auto MergeTexture = [&](FRDGTexture* Texture, TConstArrayView<FResourceAccess> TextureAccesses)
+	{
+		for (const FResourceAccess& Access : TextureAccesses)
+		{
+			FRDGPass* Pass = Passes[Access.PassHandle];
+
+			MergeTextureState(Access.PassHandle, Pass->Pipeline, Pass->TextureStates[Access.PassStateIndex], [](FRDGSubresourceState* ResourceMergeState, FRDGSubresourceState* PassSubresourceState)
+			{
+				return !ResourceMergeState || !FRDGSubresourceState::IsMergeAllowed(ERDGViewableResourceType::Texture, *ResourceMergeState, *PassSubresourceState);
+			});
+		}
+	};
+
+	const auto CollectTexture = [&](FTaskContext& Context, FRDGTexture* Texture, TConstArrayView<FResourceAccess> TextureAccesses)
+	{
+		for (const FResourceAccess& Access : TextureAccesses)
+		{
+			FRDGPass* Pass = Passes[Access.PassHandle];
+
+			// Matches CollectPassBarriers, which merges states for passes with empty parameters but doesn't collect their transitions.
+			if (Pass->bEmptyParameters)
+			{
+				continue;
+			}
+
+			FRDGPass::FTextureState& PassState = Pass->TextureStates[Access.PassStateIndex];
+			uint32 TransitionIndex = 0;
+
+			AddTextureTransition(Texture, Texture->State, PassState.MergeState, [Texture] (FRDGSubresourceState* StateAfter, int32 SubresourceIndex)
+			{
+				if (!Texture->FirstState[SubresourceIndex])
+				{
+					Texture->FirstState[SubresourceIndex] = StateAfter;
+					return IsImmediateMode();
+				}
+				return true;
+			},
+			[&](FRDGViewableResource* Resource, const FRDGSubresourceState& StateBefore, const FRDGSubresourceState& StateAfter, const FRDGTransitionInfo& Info)
+			{
+				Context.Transitions.Add({ MakeTransitionKey(Access, TransitionIndex++), Resource, StateBefore, StateAfter, Info });
+			});
+		}
+	};
+
+	TArray<FTaskContext, TInlineAllocator<1, FRDGArrayAllocator>> TaskContexts;
+	ParallelForWithTaskContext(TEXT("FRDGBuilder::CompileAndCollectPassBarriers"), TaskContexts, NumTextures + NumBuffers, 64, [&](FTaskContext& Context, int32 ResourceIndex)
+	{
+		const TConstArrayView<FResourceAccess> ResourceAccesses(Accesses.GetData() + AccessOffsets[ResourceIndex], AccessOffsets[ResourceIndex + 1] - AccessOffsets[ResourceIndex]);
+
+		if (ResourceAccesses.IsEmpty())
+		{
+			return;
+		}
+
+		if (ResourceIndex < NumTextures)
+		{
+			FRDGTexture* Texture = Textures[FRDGTextureHandle(ResourceIndex)];
+
+			if (RequiresSerialMerge(ResourceAccesses))
+			{
+				Context.SerialMergeTextures.Add(Texture);
+				return;
+			}
+
+			MergeTexture(Texture, ResourceAccesses);
+
+			if (RequiresSerialCollect(Texture))
+			{
+				Context.SerialTextures.Add(Texture);
+			}
+			else
+			{
+				CollectTexture(Context, Texture, ResourceAccesses);
+			}
+		}
+		else
+		{
+			FRDGBuffer* Buffer = Buffers[FRDGBufferHandle(ResourceIndex - NumTextures)];
+
+			for (const FResourceAccess& Access : ResourceAccesses)
+			{
+				FRDGPass* Pass = Passes[Access.PassHandle];
+				FRDGPass::FBufferState& PassState = Pass->BufferStates[Access.PassStateIndex - Pass->TextureStates.Num()];
+
+				const bool bBeginMergeState = !Buffer->MergeState || !FRDGSubresourceState::IsMergeAllowed(ERDGViewableResourceType::Buffer, *Buffer->MergeState, PassState.State);
+				MergeSubresourceState(Access.PassHandle, Pass->Pipeline, bBeginMergeState, PassState.MergeState, Buffer->MergeState, &PassState.State);
+			}
+
+			for (const FResourceAccess& Access : ResourceAccesses)
+			{
+				FRDGPass* Pass = Passes[Access.PassHandle];
+
+				if (Pass->bEmptyParameters)
+				{
+					continue;
+				}
+
+				FRDGPass::FBufferState& PassState = Pass->BufferStates[Access.PassStateIndex - Pass->TextureStates.Num()];
+
+				AddBufferTransition(Buffer, Buffer->State, PassState.MergeState, [Buffer] (FRDGSubresourceState* StateAfter)
+				{
+					if (!Buffer->FirstState)
+					{
+						Buffer->FirstState = StateAfter;
+						return IsImmediateMode();
+					}
+					return true;
+				},
+				[&](FRDGViewableResource* Resource, const FRDGSubresourceState& StateBefore, const FRDGSubresourceState& StateAfter, const FRDGTransitionInfo& Info)
+				{
+					Context.Transitions.Add({ MakeTransitionKey(Access, 0), Resource, StateBefore, StateAfter, Info });
+				});
+			}
+		}
+
+	}, bParallelCompileEnabled ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	int32 NumTransitions = 0;
+
+	for (FTaskContext& Context : TaskContexts)
+	{
+		const auto GetTextureAccesses = [&](const FRDGTexture* Texture)
+		{
+			const uint32 HandleIndex = Texture->Handle.GetIndex();
+			return TConstArrayView<FResourceAccess>(Accesses.GetData() + AccessOffsets[HandleIndex], AccessOffsets[HandleIndex + 1] - AccessOffsets[HandleIndex]);
+		};
+
+		for (FRDGTexture* Texture : Context.SerialMergeTextures)
+		{
+			MergeTexture(Texture, GetTextureAccesses(Texture));
+			CollectTexture(Context, Texture, GetTextureAccesses(Texture));
+		}
+
+		for (FRDGTexture* Texture : Context.SerialTextures)
+		{
+			CollectTexture(Context, Texture, GetTextureAccesses(Texture));
+		}
+
+		NumTransitions += Context.Transitions.Num();
+	}
+
+	// Stitch the per-task transitions back together in serial order.
+	TArray<FRecordedTransition, FRDGArrayAllocator> Transitions;
+	Transitions.Reserve(NumTransitions);
+
+	for (FTaskContext& Context : TaskContexts)
+	{
+		Transitions.Append(Context.Transitions);
+	}
+
+	Algo::SortBy(Transitions, &FRecordedTransition::Key);
+
+	for (const FRecordedTransition& Transition : Transitions)
+	{
+		AddTransition(Transition.Resource, Transition.StateBefore, Transition.StateAfter, Transition.Info);
+	}
+
+#if RDG_ENABLE_TRACE
+	for (FRDGPassHandle PassHandle = ProloguePassHandle + 1; PassHandle < EpiloguePassHandle; ++PassHandle)
+	{
+		FRDGPass* Pass = Passes[PassHandle];
+
+		if (Pass->bCulled || Pass->bEmptyParameters)
+		{
+			continue;
+		}
+
+		for (auto& PassState : Pass->TextureStates)
+		{
+			Trace.AddTexturePassDependency(PassState.Texture, Pass);
+		}
+
+		for (auto& PassState : Pass->BufferStates)
+		{
+			Trace.AddBufferPassDependency(PassState.Buffer, Pass);
+		}
+	}
+#endif
+}
+
 void FRDGBuilder::CreatePassBarriers()
 {
 	struct FTaskContext
@@ -3916,9 +4922,9 @@ void FRDGBuilder::CreatePassBarriers()
 			{
 				InfoRHI.Resource   = Textures[FRDGTextureHandle(InfoRDG.ResourceHandle)]->ResourceRHI;
 				InfoRHI.Type       = FRHITransitionInfo::EType::Texture;
-				InfoRHI.ArraySlice = InfoRDG.Texture.ArraySlice;
-				InfoRHI.MipIndex   = InfoRDG.Texture.MipIndex;
-				InfoRHI.PlaneSlice = InfoRDG.Texture.PlaneSlice;
+				InfoRHI.ArraySlice = InfoRDG.Texture.ArraySlice != FRDGTransitionInfo::AllArraySlices ? InfoRDG.Texture.ArraySlice : FRHITransitionInfo::kAllSubresources;
+				InfoRHI.MipIndex   = InfoRDG.Texture.MipIndex   != FRDGTransitionInfo::AllMips        ? InfoRDG.Texture.MipIndex   : FRHITransitionInfo::kAllSubresources;
+				InfoRHI.PlaneSlice = InfoRDG.Texture.PlaneSlice != FRDGTransitionInfo::AllPlaneSlices ? InfoRDG.Texture.PlaneSlice : FRHITransitionInfo::kAllSubresources;
 			}
 			else
 			{
@@ -4261,8 +5267,8 @@ void FRDGBuilder::AddCulledReservedCommitTransition(FRDGBufferRef Buffer)
 	AddBufferTransition(Buffer, StateBefore, StateAfter);
 }
 
-template <typename FilterSubresourceLambdaType>
-void FRDGBuilder::AddTextureTransition(FRDGTexture* Texture, FRDGTextureSubresourceState& StateBefore, FRDGTextureSubresourceState& StateAfter, FilterSubresourceLambdaType&& FilterSubresourceLambda)
+template <typename FilterSubresourceLambdaType, typename AddTransitionLambdaType>
+void FRDGBuilder::AddTextureTransition(FRDGTexture* Texture, FRDGTextureSubresourceState& StateBefore, FRDGTextureSubresourceState& StateAfter, FilterSubresourceLambdaType&& FilterSubresourceLambda, AddTransitionLambdaType&& AddTransitionLambda)
 {
 	const FRDGTextureSubresourceLayout Layout = Texture->Layout;
 	const uint32 SubresourceCount = Texture->SubresourceCount;
@@ -4338,6 +5344,57 @@ void FRDGBuilder::AddTextureTransition(FRDGTexture* Texture, FRDGTextureSubresou
 		}
 	}
 
+	// The filter may track per-subresource state (e.g. first states), so it is evaluated exactly once per subresource. When every
+	// subresource shares the same before / after states, the results are gathered up front so a single transition can be emitted.
+	TBitArray<> FilterResults;
+
+	if (SubresourceCount > 1 && StateAfter[0] && IsUniformSubresourceState(Texture, StateBefore) && IsUniformSubresourceState(Texture, StateAfter))
+	{
+		FRDGSubresourceState* SubresourceStateBefore = StateBefore[0];
+		FRDGSubresourceState* SubresourceStateAfter = StateAfter[0];
+
+		FilterResults.Init(false, SubresourceCount);
+		uint32 NumFiltered = 0;
+
+		for (uint32 SubresourceIndex = 0; SubresourceIndex < SubresourceCount; ++SubresourceIndex)
+		{
+			const bool bFilterResult = FilterSubresourceLambda(SubresourceStateAfter, SubresourceIndex);
+			FilterResults[SubresourceIndex] = bFilterResult;
+			NumFiltered += bFilterResult ? 1 : 0;
+		}
+
+		if (NumFiltered == 0 || NumFiltered == SubresourceCount)
+		{
+			if (NumFiltered)
+			{
+				check(SubresourceStateAfter->Access != ERHIAccess::Unknown);
+
+				if (SubresourceStateBefore && FRDGSubresourceState::IsTransitionRequired(*SubresourceStateBefore, *SubresourceStateAfter))
+				{
+					FRDGTransitionInfo Info;
+					Info.AccessBefore            = (uint64)SubresourceStateBefore->Access;
+					Info.AccessAfter             = (uint64)SubresourceStateAfter->Access;
+					Info.ResourceHandle          = (uint64)Texture->Handle.GetIndex();
+					Info.ResourceType            = (uint64)ERDGViewableResourceType::Texture;
+					Info.ResourceTransitionFlags = (uint64)SubresourceStateAfter->Flags;
+					Info.Texture.ArraySlice      = FRDGTransitionInfo::AllArraySlices;
+					Info.Texture.MipIndex        = FRDGTransitionInfo::AllMips;
+					Info.Texture.PlaneSlice      = FRDGTransitionInfo::AllPlaneSlices;
+
+					AddTransitionLambda(Texture, *SubresourceStateBefore, *SubresourceStateAfter, Info);
+				}
+			}
+
+			for (uint32 SubresourceIndex = 0; SubresourceIndex < SubresourceCount; ++SubresourceIndex)
+			{
+				StateBefore[SubresourceIndex] = SubresourceStateAfter;
+			}
+			return;
+		}
+
+		// The filter disagreed between subresources; fall back to per-subresource transitions using the gathered results.
+	}
+
 	for (uint32 SubresourceIndex = 0; SubresourceIndex < SubresourceCount; ++SubresourceIndex)
 	{
 		FRDGSubresourceState*& SubresourceStateBefore = StateBefore[SubresourceIndex];
@@ -4348,7 +5405,7 @@ void FRDGBuilder::AddTextureTransition(FRDGTexture* Texture, FRDGTextureSubresou
 			continue;
 		}
 
-		if (FilterSubresourceLambda(SubresourceStateAfter, SubresourceIndex))
+		if (FilterResults.Num() ? (bool)FilterResults[SubresourceIndex] : FilterSubresourceLambda(SubresourceStateAfter, SubresourceIndex))
 		{
 			check(SubresourceStateAfter->Access != ERHIAccess::Unknown);
 
@@ -4368,7 +5425,7 @@ void FRDGBuilder::AddTextureTransition(FRDGTexture* Texture, FRDGTextureSubresou
 				Info.Texture.MipIndex        = Subresource.MipIndex;
 				Info.Texture.PlaneSlice      = Subresource.PlaneSlice;
 
-				AddTransition(Texture, *SubresourceStateBefore, *SubresourceStateAfter, Info);
+				AddTransitionLambda(Texture, *SubresourceStateBefore, *SubresourceStateAfter, Info);
 			}
 		}
 
@@ -4376,8 +5433,8 @@ void FRDGBuilder::AddTextureTransition(FRDGTexture* Texture, FRDGTextureSubresou
 	}
 }
 
-template <typename FilterSubresourceLambdaType>
-void FRDGBuilder::AddBufferTransition(FRDGBufferRef Buffer, FRDGSubresourceState*& StateBefore, FRDGSubresourceState* StateAfter, FilterSubresourceLambdaType&& FilterSubresourceLambda)
+template <typename FilterSubresourceLambdaType, typename AddTransitionLambdaType>
+void FRDGBuilder::AddBufferTransition(FRDGBufferRef Buffer, FRDGSubresourceState*& StateBefore, FRDGSubresourceState* StateAfter, FilterSubresourceLambdaType&& FilterSubresourceLambda, AddTransitionLambdaType&& AddTransitionLambda)
 {
 	check(StateAfter);
 	check(StateAfter->Access != ERHIAccess::Unknown);
@@ -4396,7 +5453,7 @@ void FRDGBuilder::AddBufferTransition(FRDGBufferRef Buffer, FRDGSubresourceState
 			Info.ResourceTransitionFlags = (uint64)StateAfter->Flags;
 			Info.Buffer.CommitSize       = GetReservedCommitSize(StateAfter->ReservedCommitHandle);
 
-			AddTransition(Buffer, *StateBefore, *StateAfter, Info);
+			AddTransitionLambda(Buffer, *StateBefore, *StateAfter, Info);
 		}
 	}
 
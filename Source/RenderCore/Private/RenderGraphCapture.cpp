@@ -0,0 +1,457 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RenderGraphCapture.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphPrivate.h"
+#include "RenderGraphTrace.h"
+#include "RenderingThread.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "ShaderParameterStruct.h"
+
+#if RDG_ENABLE_TRACE
+
+static FArchive& operator<<(FArchive& Ar, FRDGGraphCapture::FAccess& Access)
+{
+	uint32 AccessBits = uint32(Access.Access);
+	Ar << Access.Index;
+	Ar << AccessBits;
+	Access.Access = ERHIAccess(AccessBits);
+	return Ar;
+}
+
+static FArchive& operator<<(FArchive& Ar, FRDGGraphCapture::FTexture& Texture)
+{
+	FRDGTextureDesc& Desc = Texture.Desc;
+
+	uint64 CreateFlags = uint64(Desc.Flags);
+	uint8 Dimension = uint8(Desc.Dimension);
+	uint8 Format = uint8(Desc.Format);
+	uint8 UAVFormat = uint8(Desc.UAVFormat);
+	uint8 Flags = uint8(Texture.Flags);
+
+	Ar << Texture.Name;
+	Ar << CreateFlags;
+	Ar << Dimension;
+	Ar << Format;
+	Ar << UAVFormat;
+	Ar << Desc.ExtData;
+	Ar << Desc.Extent;
+	Ar << Desc.Depth;
+	Ar << Desc.ArraySize;
+	Ar << Desc.NumMips;
+	Ar << Desc.NumSamples;
+	Ar << Desc.FastVRAMPercentage;
+	Ar << Flags;
+	Ar << Texture.bExternal;
+	Ar << Texture.bExtracted;
+
+	// The clear value is plain data; it only matters for fast clear compatibility of the pooled allocation.
+	Ar.Serialize(&Desc.ClearValue, sizeof(Desc.ClearValue));
+
+	Desc.Flags = ETextureCreateFlags(CreateFlags);
+	Desc.Dimension = ETextureDimension(Dimension);
+	Desc.Format = EPixelFormat(Format);
+	Desc.UAVFormat = EPixelFormat(UAVFormat);
+	Texture.Flags = ERDGTextureFlags(Flags);
+	return Ar;
+}
+
+static FArchive& operator<<(FArchive& Ar, FRDGGraphCapture::FBuffer& Buffer)
+{
+	uint32 Usage = uint32(Buffer.Desc.Usage);
+	uint8 Flags = uint8(Buffer.Flags);
+
+	Ar << Buffer.Name;
+	Ar << Buffer.Desc.BytesPerElement;
+	Ar << Buffer.Desc.NumElements;
+	Ar << Usage;
+	Ar << Flags;
+	Ar << Buffer.bExternal;
+	Ar << Buffer.bExtracted;
+
+	Buffer.Desc.Usage = EBufferUsageFlags(Usage);
+	Buffer.Flags = ERDGBufferFlags(Flags);
+	return Ar;
+}
+
+static FArchive& operator<<(FArchive& Ar, FRDGGraphCapture::FPass& Pass)
+{
+	uint16 Flags = uint16(Pass.Flags);
+	uint8 Pipeline = uint8(Pass.Pipeline);
+
+	Ar << Pass.Name;
+	Ar << Flags;
+	Ar << Pipeline;
+	Ar << Pass.Textures;
+	Ar << Pass.Buffers;
+
+	Pass.Flags = ERDGPassFlags(Flags);
+	Pass.Pipeline = ERHIPipeline(Pipeline);
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FRDGGraphCapture& Capture)
+{
+	uint32 Magic = FRDGGraphCapture::Magic;
+	uint32 Version = FRDGGraphCapture::Version;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != FRDGGraphCapture::Magic || Version != FRDGGraphCapture::Version)
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Capture.GraphName;
+	Ar << Capture.Textures;
+	Ar << Capture.Buffers;
+	Ar << Capture.Passes;
+	return Ar;
+}
+
+bool FRDGGraphCapture::SaveToFile(const FString& Filename) const
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	*Ar << const_cast<FRDGGraphCapture&>(*this);
+	return Ar->Close();
+}
+
+bool FRDGGraphCapture::LoadFromFile(const FString& Filename)
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	*Ar << *this;
+	if (Ar->IsError() || !Ar->Close())
+	{
+		return false;
+	}
+
+	// Replay indexes the resource arrays directly, so a damaged file must not get that far.
+	for (const FPass& Pass : Passes)
+	{
+		for (const FAccess& Access : Pass.Textures)
+		{
+			if (!Textures.IsValidIndex(Access.Index))
+			{
+				UE_LOG(LogRDG, Warning, TEXT("Graph capture %s: pass '%s' references texture %d, but the capture only has %d textures."), *Filename, *Pass.Name, Access.Index, Textures.Num());
+				return false;
+			}
+		}
+
+		for (const FAccess& Access : Pass.Buffers)
+		{
+			if (!Buffers.IsValidIndex(Access.Index))
+			{
+				UE_LOG(LogRDG, Warning, TEXT("Graph capture %s: pass '%s' references buffer %d, but the capture only has %d buffers."), *Filename, *Pass.Name, Access.Index, Buffers.Num());
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static FCriticalSection GRDGCaptureCS;
+static FString GRDGCaptureFilename;
+static FString GRDGCaptureGraphFilter;
+static std::atomic<bool> GRDGCaptureRequested{ false };
+
+bool FRDGTrace::IsGraphCaptureRequested()
+{
+	return GRDGCaptureRequested.load(std::memory_order_relaxed);
+}
+
+void FRDGTrace::CaptureGraph(const FRDGBuilder& GraphBuilder)
+{
+	const TCHAR* GraphName = GraphBuilder.BuilderName.GetTCHAR();
+
+	FString Filename;
+	{
+		FScopeLock Lock(&GRDGCaptureCS);
+
+		if (!GRDGCaptureRequested.load(std::memory_order_relaxed)
+			|| (!GRDGCaptureGraphFilter.IsEmpty() && !FCString::Stristr(GraphName, *GRDGCaptureGraphFilter)))
+		{
+			return;
+		}
+
+		Filename = MoveTemp(GRDGCaptureFilename);
+		GRDGCaptureRequested.store(false, std::memory_order_relaxed);
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRDGTrace::CaptureGraph);
+
+	FRDGGraphCapture Capture;
+	Capture.GraphName = GraphName;
+
+	const auto& Passes = GraphBuilder.Passes;
+	const auto& Textures = GraphBuilder.Textures;
+	const auto& Buffers = GraphBuilder.Buffers;
+
+	Capture.Textures.Reserve(Textures.Num());
+	for (FRDGTextureHandle Handle = Textures.Begin(); Handle != Textures.End(); ++Handle)
+	{
+		const FRDGTexture* Texture = Textures[Handle];
+
+		FRDGGraphCapture::FTexture& Entry = Capture.Textures.Emplace_GetRef();
+		Entry.Name = Texture->Name;
+		Entry.Desc = Texture->Desc;
+		Entry.Flags = Texture->Flags;
+		Entry.bExternal = Texture->bExternal != 0;
+		Entry.bExtracted = Texture->bExtracted != 0;
+	}
+
+	Capture.Buffers.Reserve(Buffers.Num());
+	for (FRDGBufferHandle Handle = Buffers.Begin(); Handle != Buffers.End(); ++Handle)
+	{
+		const FRDGBuffer* Buffer = Buffers[Handle];
+
+		FRDGGraphCapture::FBuffer& Entry = Capture.Buffers.Emplace_GetRef();
+		Entry.Name = Buffer->Name;
+		Entry.Desc = Buffer->Desc;
+		Entry.Desc.Metadata = nullptr;
+		Entry.Flags = Buffer->Flags;
+		Entry.bExternal = Buffer->bExternal != 0;
+		Entry.bExtracted = Buffer->bExtracted != 0;
+	}
+
+	// The prologue and epilogue are sentinel passes that the replayed builder creates itself.
+	for (FRDGPassHandle Handle = GraphBuilder.GetProloguePassHandle() + 1; Handle < GraphBuilder.GetEpiloguePassHandle(); ++Handle)
+	{
+		const FRDGPass* Pass = Passes[Handle];
+
+		FRDGGraphCapture::FPass& Entry = Capture.Passes.Emplace_GetRef();
+		Entry.Name = Pass->GetEventName().GetTCHAR();
+		Entry.Flags = Pass->GetFlags();
+		Entry.Pipeline = Pass->GetPipeline();
+
+		Entry.Textures.Reserve(Pass->TextureStates.Num());
+		for (const FRDGPass::FTextureState& PassState : Pass->TextureStates)
+		{
+			// Replay declares whole-texture accesses, so take the access of the first subresource the pass touched.
+			ERHIAccess Access = ERHIAccess::Unknown;
+			for (const FRDGSubresourceState* State : PassState.State)
+			{
+				if (State && State->Access != ERHIAccess::Unknown)
+				{
+					Access = State->Access;
+					break;
+				}
+			}
+
+			if (Access != ERHIAccess::Unknown)
+			{
+				Entry.Textures.Add({ (int32)PassState.Texture->Handle.GetIndex(), Access });
+			}
+		}
+
+		Entry.Buffers.Reserve(Pass->BufferStates.Num());
+		for (const FRDGPass::FBufferState& PassState : Pass->BufferStates)
+		{
+			if (PassState.State.Access != ERHIAccess::Unknown)
+			{
+				Entry.Buffers.Add({ (int32)PassState.Buffer->Handle.GetIndex(), PassState.State.Access });
+			}
+		}
+	}
+
+	if (Capture.SaveToFile(Filename))
+	{
+		UE_LOG(LogRDG, Display, TEXT("Captured graph '%s' (%d passes, %d textures, %d buffers) to %s."), GraphName, Capture.Passes.Num(), Capture.Textures.Num(), Capture.Buffers.Num(), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogRDG, Warning, TEXT("Failed to write graph capture to %s."), *Filename);
+	}
+}
+
+BEGIN_SHADER_PARAMETER_STRUCT(FRDGReplayPassParameters, )
+	RDG_TEXTURE_ACCESS_ARRAY(Textures)
+	RDG_BUFFER_ACCESS_ARRAY(Buffers)
+	RENDER_TARGET_BINDING_SLOTS()
+END_SHADER_PARAMETER_STRUCT()
+
+void FRDGTrace::ReplayGraph(FRHICommandListImmediate& RHICmdList, const FRDGGraphCapture& Capture, FRDGPhaseTimings& OutTimings)
+{
+	FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("RDGReplay(%s)", *Capture.GraphName));
+	GraphBuilder.Trace.PhaseTimings = &OutTimings;
+
+	// External and extracted resources are the roots that keep passes alive through culling. The replayed graph owns
+	// all of its resources, so both kinds are recreated as graph resources and queued for extraction instead.
+	TArray<TRefCountPtr<IPooledRenderTarget>> ExtractedTextures;
+	TArray<TRefCountPtr<FRDGPooledBuffer>> ExtractedBuffers;
+	ExtractedTextures.SetNum(Capture.Textures.Num());
+	ExtractedBuffers.SetNum(Capture.Buffers.Num());
+
+	TArray<FRDGTextureRef> Textures;
+	Textures.Reserve(Capture.Textures.Num());
+	for (const FRDGGraphCapture::FTexture& Texture : Capture.Textures)
+	{
+		Textures.Add(GraphBuilder.CreateTexture(Texture.Desc, *Texture.Name, Texture.Flags & ~ERDGTextureFlags::SkipTracking));
+	}
+
+	TArray<FRDGBufferRef> Buffers;
+	Buffers.Reserve(Capture.Buffers.Num());
+	for (const FRDGGraphCapture::FBuffer& Buffer : Capture.Buffers)
+	{
+		Buffers.Add(GraphBuilder.CreateBuffer(Buffer.Desc, *Buffer.Name, Buffer.Flags & ~ERDGBufferFlags::SkipTracking));
+	}
+
+	for (const FRDGGraphCapture::FPass& Pass : Capture.Passes)
+	{
+		FRDGReplayPassParameters* PassParameters = GraphBuilder.AllocParameters<FRDGReplayPassParameters>();
+		ERDGPassFlags PassFlags = Pass.Flags;
+		int32 NumRenderTargets = 0;
+		bool bHasDepthStencil = false;
+
+		for (const FRDGGraphCapture::FAccess& Access : Pass.Textures)
+		{
+			FRDGTextureRef Texture = Textures[Access.Index];
+
+			// Render targets of raster passes are declared through the binding slots, everything else through the access array.
+			if (EnumHasAnyFlags(PassFlags, ERDGPassFlags::Raster))
+			{
+				if (EnumHasAnyFlags(Access.Access, ERHIAccess::RTV) && NumRenderTargets < MaxSimultaneousRenderTargets)
+				{
+					PassParameters->RenderTargets[NumRenderTargets++] = FRenderTargetBinding(Texture, ERenderTargetLoadAction::ELoad);
+					continue;
+				}
+
+				if (EnumHasAnyFlags(Access.Access, ERHIAccess::DSVRead | ERHIAccess::DSVWrite) && !bHasDepthStencil)
+				{
+					const FExclusiveDepthStencil DepthStencilAccess = EnumHasAnyFlags(Access.Access, ERHIAccess::DSVWrite)
+						? FExclusiveDepthStencil::DepthWrite_StencilWrite
+						: FExclusiveDepthStencil::DepthRead_StencilRead;
+
+					PassParameters->RenderTargets.DepthStencil = FDepthStencilBinding(Texture, ERenderTargetLoadAction::ELoad, ERenderTargetLoadAction::ELoad, DepthStencilAccess);
+					bHasDepthStencil = true;
+					continue;
+				}
+			}
+
+			PassParameters->Textures.Emplace(Texture, Access.Access);
+		}
+
+		for (const FRDGGraphCapture::FAccess& Access : Pass.Buffers)
+		{
+			PassParameters->Buffers.Emplace(Buffers[Access.Index], Access.Access);
+		}
+
+		// A raster pass without render target bindings (e.g. a UAV-only raster pass) is replayed on the compute path.
+		if (EnumHasAnyFlags(PassFlags, ERDGPassFlags::Raster) && !NumRenderTargets && !bHasDepthStencil)
+		{
+			EnumRemoveFlags(PassFlags, ERDGPassFlags::Raster | ERDGPassFlags::SkipRenderPass);
+			EnumAddFlags(PassFlags, ERDGPassFlags::Compute);
+		}
+
+		if (!EnumHasAnyFlags(PassFlags, ERDGPassFlags::Raster | ERDGPassFlags::Compute | ERDGPassFlags::AsyncCompute | ERDGPassFlags::Copy))
+		{
+			EnumAddFlags(PassFlags, ERDGPassFlags::Compute);
+		}
+
+		if (EnumHasAnyFlags(PassFlags, ERDGPassFlags::AsyncCompute))
+		{
+			GraphBuilder.AddPass(RDG_EVENT_NAME("%s", *Pass.Name), PassParameters, PassFlags, [](FRHIComputeCommandList&) {});
+		}
+		else
+		{
+			GraphBuilder.AddPass(RDG_EVENT_NAME("%s", *Pass.Name), PassParameters, PassFlags, [](FRHICommandList&) {});
+		}
+	}
+
+	for (int32 Index = 0; Index < Capture.Textures.Num(); ++Index)
+	{
+		if (Capture.Textures[Index].bExternal || Capture.Textures[Index].bExtracted)
+		{
+			GraphBuilder.QueueTextureExtraction(Textures[Index], &ExtractedTextures[Index]);
+		}
+	}
+
+	for (int32 Index = 0; Index < Capture.Buffers.Num(); ++Index)
+	{
+		if (Capture.Buffers[Index].bExternal || Capture.Buffers[Index].bExtracted)
+		{
+			GraphBuilder.QueueBufferExtraction(Buffers[Index], &ExtractedBuffers[Index]);
+		}
+	}
+
+	GraphBuilder.Execute();
+}
+
+static FAutoConsoleCommand GRDGCaptureGraphCmd(
+	TEXT("r.RDG.CaptureGraph"),
+	TEXT("Writes the structure of the next executed render graph (resources, passes and declared accesses) to a file for r.RDG.ReplayGraph.\n")
+	TEXT("Usage: r.RDG.CaptureGraph [GraphNameFilter] [Filename]. The filter matches a substring of the builder name; the file defaults to Saved/Profiling/RDGCapture.rdgc."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+{
+	FScopeLock Lock(&GRDGCaptureCS);
+	GRDGCaptureGraphFilter = Args.Num() > 0 ? Args[0] : FString();
+	GRDGCaptureFilename = Args.Num() > 1 ? Args[1] : FPaths::ProfilingDir() / TEXT("RDGCapture.rdgc");
+	GRDGCaptureRequested.store(true, std::memory_order_relaxed);
+}));
+
+static FAutoConsoleCommand GRDGReplayGraphCmd(
+	TEXT("r.RDG.ReplayGraph"),
+	TEXT("Rebuilds a graph captured with r.RDG.CaptureGraph with empty passes and reports the Compile and Execute phase timings.\n")
+	TEXT("Run with -nullrhi to measure graph compilation and barrier building without GPU work.\n")
+	TEXT("Usage: r.RDG.ReplayGraph [Filename] [Iterations=20]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+{
+	const FString Filename = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("RDGCapture.rdgc");
+	const int32 NumIterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 20;
+
+	TSharedRef<FRDGGraphCapture> Capture = MakeShared<FRDGGraphCapture>();
+	if (!Capture->LoadFromFile(Filename))
+	{
+		UE_LOG(LogRDG, Warning, TEXT("Failed to load graph capture %s."), *Filename);
+		return;
+	}
+
+	ENQUEUE_RENDER_COMMAND(RDGReplayGraph)([Capture, NumIterations](FRHICommandListImmediate& RHICmdList)
+	{
+		if (IsImmediateMode())
+		{
+			UE_LOG(LogRDG, Warning, TEXT("r.RDG.ReplayGraph is not supported in immediate mode."));
+			return;
+		}
+
+		FRDGPhaseTimings Total;
+		FRDGPhaseTimings Min{ MAX_uint64, MAX_uint64 };
+		uint64 TotalSetupCycles = 0;
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			FRDGPhaseTimings Timings;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			FRDGTrace::ReplayGraph(RHICmdList, *Capture, Timings);
+			const uint64 TotalCycles = FPlatformTime::Cycles64() - StartCycles;
+
+			TotalSetupCycles += TotalCycles - Timings.CompileCycles - Timings.ExecuteCycles;
+			Total.CompileCycles += Timings.CompileCycles;
+			Total.ExecuteCycles += Timings.ExecuteCycles;
+			Min.CompileCycles = FMath::Min(Min.CompileCycles, Timings.CompileCycles);
+			Min.ExecuteCycles = FMath::Min(Min.ExecuteCycles, Timings.ExecuteCycles);
+		}
+
+		const double Scale = 1000.0 / NumIterations;
+		UE_LOG(LogRDG, Display, TEXT("Replayed graph '%s' (%d passes, %d textures, %d buffers) %d times on %s:"),
+			*Capture->GraphName, Capture->Passes.Num(), Capture->Textures.Num(), Capture->Buffers.Num(), NumIterations, GDynamicRHI ? GDynamicRHI->GetName() : TEXT("<none>"));
+		UE_LOG(LogRDG, Display, TEXT("  Setup:   avg %8.3f ms"), FPlatformTime::ToSeconds64(TotalSetupCycles) * Scale);
+		UE_LOG(LogRDG, Display, TEXT("  Compile: avg %8.3f ms, min %8.3f ms"), FPlatformTime::ToSeconds64(Total.CompileCycles) * Scale, FPlatformTime::ToSeconds64(Min.CompileCycles) * 1000.0);
+		UE_LOG(LogRDG, Display, TEXT("  Execute: avg %8.3f ms, min %8.3f ms"), FPlatformTime::ToSeconds64(Total.ExecuteCycles) * Scale, FPlatformTime::ToSeconds64(Min.ExecuteCycles) * 1000.0);
+	});
+}));
+
+#endif // RDG_ENABLE_TRACE
@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	RenderGraphCapture.h: Serialized capture of a render graph for offline replay.
+=============================================================================*/
+
+#pragma once
+
+#include "RenderGraphDefinitions.h"
+#include "RenderGraphResources.h"
+
+#if RDG_ENABLE_TRACE
+
+/**
+ * The structure of a render graph as it was just before compilation. It contains the resources, the passes and the
+ * access each pass declared on each resource. This is enough to rebuild the graph with empty pass lambdas and measure
+ * compilation, culling and barrier building on real production graphs. Recorded with r.RDG.CaptureGraph and replayed
+ * with r.RDG.ReplayGraph.
+ */
+struct FRDGGraphCapture
+{
+	static constexpr uint32 Magic = 0x43474452; // 'RDGC'
+	static constexpr uint32 Version = 1;
+
+	struct FTexture
+	{
+		FString Name;
+		FRDGTextureDesc Desc;
+		ERDGTextureFlags Flags = ERDGTextureFlags::None;
+		bool bExternal = false;
+		bool bExtracted = false;
+	};
+
+	struct FBuffer
+	{
+		FString Name;
+		FRDGBufferDesc Desc;
+		ERDGBufferFlags Flags = ERDGBufferFlags::None;
+		bool bExternal = false;
+		bool bExtracted = false;
+	};
+
+	struct FAccess
+	{
+		/** Index into Textures or Buffers. */
+		int32 Index = INDEX_NONE;
+		ERHIAccess Access = ERHIAccess::Unknown;
+	};
+
+	struct FPass
+	{
+		FString Name;
+		ERDGPassFlags Flags = ERDGPassFlags::None;
+		ERHIPipeline Pipeline = ERHIPipeline::Graphics;
+		TArray<FAccess> Textures;
+		TArray<FAccess> Buffers;
+	};
+
+	FString GraphName;
+	TArray<FTexture> Textures;
+	TArray<FBuffer> Buffers;
+	TArray<FPass> Passes;
+
+	bool SaveToFile(const FString& Filename) const;
+	bool LoadFromFile(const FString& Filename);
+
+	friend FArchive& operator<<(FArchive& Ar, FRDGGraphCapture& Capture);
+};
+
+#endif
@@ -246,6 +246,23 @@ FAutoConsoleVariableRef CVarRDGMergeRenderPasses(
 	TEXT(" 1:on(default);\n"),
 	ECVF_RenderThreadSafe);
 
+int32 GRDGCompileCache = 0;
+FAutoConsoleVariableRef CVarRDGCompileCache(
+	TEXT("r.RDG.CompileCache"),
+	GRDGCompileCache,
+	TEXT("Passes hash their resource accesses during setup. After pass culling, a graph whose hashes match a previous graph replays\n")
+	TEXT("the transitions and final resource states that graph collected instead of compiling and collecting pass barriers.\n")
+	TEXT(" 0:off (default);\n")
+	TEXT(" 1:on;\n"),
+	ECVF_RenderThreadSafe);
+
+int32 GRDGCompileCacheMaxEntries = 8;
+FAutoConsoleVariableRef CVarRDGCompileCacheMaxEntries(
+	TEXT("r.RDG.CompileCache.MaxEntries"),
+	GRDGCompileCacheMaxEntries,
+	TEXT("Maximum number of graphs kept by the compile cache. When full, the oldest entry is replaced."),
+	ECVF_RenderThreadSafe);
+
 int32 GRDGTransientAllocator = 1;
 FAutoConsoleVariableRef CVarRDGUseTransientAllocator(
 	TEXT("r.RDG.TransientAllocator"), GRDGTransientAllocator,
@@ -255,6 +272,13 @@ FAutoConsoleVariableRef CVarRDGUseTransientAllocator(
 	TEXT(" 2: enables the transient allocator for resources with FastVRAM flag only"),
 	ECVF_RenderThreadSafe);
 
+int32 GRDGTransientPlacementPlanning = 0;
+FAutoConsoleVariableRef CVarRDGTransientPlacementPlanning(
+	TEXT("r.RDG.TransientAllocator.PlacementPlanning"), GRDGTransientPlacementPlanning,
+	TEXT("RDG will provide the lifetimes of all transient resources in the graph to the transient allocator before creating them, allowing")
+	TEXT(" the allocator to plan placements instead of placing greedily in allocation order. See RHI.TransientAllocator.PlacementPlanningBudget."),
+	ECVF_RenderThreadSafe);
+
 int32 GRDGTransientExtractedResources = 1;
 FAutoConsoleVariableRef CVarRDGTransientExtractedResource(
 	TEXT("r.RDG.TransientExtractedResources"), GRDGTransientExtractedResources,
@@ -310,6 +334,15 @@ FAutoConsoleVariableRef CVarRDGParallelCompile(
 	TEXT(" 1: compile tasks are launched (default);"),
 	ECVF_RenderThreadSafe);
 
+int32 GRDGParallelCollectBarriers = 0;
+FAutoConsoleVariableRef CVarRDGParallelCollectBarriers(
+	TEXT("r.RDG.ParallelCollectBarriers"), GRDGParallelCollectBarriers,
+	TEXT("RDG will merge subresource states and collect transitions for disjoint sets of resources on parallel tasks. The\n")
+	TEXT("transitions are stitched back in pass order, so the barrier batches match the serial path. Requires r.RDG.ParallelCompile.")
+	TEXT(" 0: barriers are compiled and collected serially by pass (default);")
+	TEXT(" 1: barriers are compiled and collected in parallel by resource;"),
+	ECVF_RenderThreadSafe);
+
 int32 GRDGAsyncSetupQueue = 1;
 FAutoConsoleVariableRef CVarRDGAsyncSetupQueue(
 	TEXT("r.RDG.AsyncSetupQueue"), GRDGAsyncSetupQueue,
@@ -420,6 +453,12 @@ FAutoConsoleVariableRef CVarRDGIndirectArgBufferTransientAllocated(
 	TEXT("Whether indirect argument buffers should use transient resource allocator. Default: 0"),
 	ECVF_RenderThreadSafe);
 
+int32 GRDGAllocatorPageCacheSize = 16;
+FAutoConsoleVariableRef CVarRDGAllocatorPageCacheSize(
+	TEXT("r.RDG.Allocator.PageCacheSize"), GRDGAllocatorPageCacheSize,
+	TEXT("Size in MB of the cache of RDG allocator pages kept across frames instead of being freed when a graph is destroyed. 0 disables the cache. Default: 16"),
+	ECVF_RenderThreadSafe);
+
 #if CSV_PROFILER_STATS
 int32 GRDGVerboseCSVStats = 0;
 FAutoConsoleVariableRef CVarRDGVerboseCSVStats(
@@ -448,6 +487,9 @@ int32 GRDGStatTransitionCount = 0;
 int32 GRDGStatAliasingCount = 0;
 int32 GRDGStatTransitionBatchCount = 0;
 int32 GRDGStatMemoryWatermark = 0;
+int32 GRDGStatCompileCacheHitCount = 0;
+int32 GRDGStatCompileCacheMissCount = 0;
+float GRDGStatCompileCacheTimeSaved = 0.0f;
 #endif
 
 CSV_DEFINE_CATEGORY(RDGCount, true);
@@ -470,6 +512,9 @@ TRACE_DECLARE_INT_COUNTER(COUNTER_RDG_TransitionCount, TEXT("RDG/TransitionCount
 TRACE_DECLARE_INT_COUNTER(COUNTER_RDG_AliasingCount, TEXT("RDG/AliasingCount"));
 TRACE_DECLARE_INT_COUNTER(COUNTER_RDG_TransitionBatchCount, TEXT("RDG/TransitionBatchCount"));
 TRACE_DECLARE_MEMORY_COUNTER(COUNTER_RDG_MemoryWatermark, TEXT("RDG/MemoryWatermark"));
+TRACE_DECLARE_INT_COUNTER(COUNTER_RDG_CompileCacheHitCount, TEXT("RDG/CompileCacheHitCount"));
+TRACE_DECLARE_INT_COUNTER(COUNTER_RDG_CompileCacheMissCount, TEXT("RDG/CompileCacheMissCount"));
+TRACE_DECLARE_FLOAT_COUNTER(COUNTER_RDG_CompileCacheTimeSaved, TEXT("RDG/CompileCacheTimeSaved"));
 
 DEFINE_STAT(STAT_RDG_PassCount);
 DEFINE_STAT(STAT_RDG_PassWithParameterCount);
@@ -488,6 +533,10 @@ DEFINE_STAT(STAT_RDG_TransientBufferCount);
 DEFINE_STAT(STAT_RDG_TransitionCount);
 DEFINE_STAT(STAT_RDG_AliasingCount);
 DEFINE_STAT(STAT_RDG_TransitionBatchCount);
+DEFINE_STAT(STAT_RDG_CompileCacheHitCount);
+DEFINE_STAT(STAT_RDG_CompileCacheMissCount);
+DEFINE_STAT(STAT_RDG_CompileCacheHitRate);
+DEFINE_STAT(STAT_RDG_CompileCacheTimeSaved);
 DEFINE_STAT(STAT_RDG_SetupTime);
 DEFINE_STAT(STAT_RDG_CompileTime);
 DEFINE_STAT(STAT_RDG_ExecuteTime);
@@ -86,16 +86,21 @@ const int32 GRDGOverlapUAVs = 1;
 extern int32 GRDGAsyncCompute;
 extern int32 GRDGCullPasses;
 extern int32 GRDGMergeRenderPasses;
+extern int32 GRDGCompileCache;
+extern int32 GRDGCompileCacheMaxEntries;
 extern int32 GRDGTransientAllocator;
+extern int32 GRDGTransientPlacementPlanning;
 extern int32 GRDGAsyncComputeTransientAliasing;
 extern int32 GRDGTransientExtractedResources;
 extern int32 GRDGTransientIndirectArgBuffers;
+extern int32 GRDGAllocatorPageCacheSize;
 
 #if RDG_ENABLE_PARALLEL_TASKS
 
 extern int32 GRDGParallelDestruction;
 extern int32 GRDGParallelSetup;
 extern int32 GRDGParallelCompile;
+extern int32 GRDGParallelCollectBarriers;
 extern int32 GRDGParallelSetupTaskPriorityBias;
 extern int32 GRDGParallelExecute;
 extern int32 GRDGParallelExecutePassMin;
@@ -108,6 +113,7 @@ extern int32 GRDGAsyncSetupQueue;
 const int32 GRDGParallelDestruction = 0;
 const int32 GRDGParallelSetup = 0;
 const int32 GRDGParallelCompile = 0;
+const int32 GRDGParallelCollectBarriers = 0;
 const int32 GRDGParallelExecute = 0;
 const int32 GRDGParallelExecutePassMin = 0;
 const int32 GRDGParallelExecutePassMax = 0;
@@ -142,6 +148,9 @@ extern int32 GRDGStatTransitionCount;
 extern int32 GRDGStatAliasingCount;
 extern int32 GRDGStatTransitionBatchCount;
 extern int32 GRDGStatMemoryWatermark;
+extern int32 GRDGStatCompileCacheHitCount;
+extern int32 GRDGStatCompileCacheMissCount;
+extern float GRDGStatCompileCacheTimeSaved;
 #endif
 
 TRACE_DECLARE_INT_COUNTER_EXTERN(COUNTER_RDG_PassCount);
@@ -162,6 +171,9 @@ TRACE_DECLARE_INT_COUNTER_EXTERN(COUNTER_RDG_TransitionCount);
 TRACE_DECLARE_INT_COUNTER_EXTERN(COUNTER_RDG_AliasingCount);
 TRACE_DECLARE_INT_COUNTER_EXTERN(COUNTER_RDG_TransitionBatchCount);
 TRACE_DECLARE_MEMORY_COUNTER_EXTERN(COUNTER_RDG_MemoryWatermark);
+TRACE_DECLARE_INT_COUNTER_EXTERN(COUNTER_RDG_CompileCacheHitCount);
+TRACE_DECLARE_INT_COUNTER_EXTERN(COUNTER_RDG_CompileCacheMissCount);
+TRACE_DECLARE_FLOAT_COUNTER_EXTERN(COUNTER_RDG_CompileCacheTimeSaved);
 
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Passes"), STAT_RDG_PassCount, STATGROUP_RDG, RENDERCORE_API);
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Passes With Parameters"), STAT_RDG_PassWithParameterCount, STATGROUP_RDG, RENDERCORE_API);
@@ -180,6 +192,10 @@ DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transient Buffers"), STAT_RDG_TransientB
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resource Transitions"), STAT_RDG_TransitionCount, STATGROUP_RDG, RENDERCORE_API);
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resource Acquires and Discards"), STAT_RDG_AliasingCount, STATGROUP_RDG, RENDERCORE_API);
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resource Transition Batches"), STAT_RDG_TransitionBatchCount, STATGROUP_RDG, RENDERCORE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Compile Cache Hits"), STAT_RDG_CompileCacheHitCount, STATGROUP_RDG, RENDERCORE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Compile Cache Misses"), STAT_RDG_CompileCacheMissCount, STATGROUP_RDG, RENDERCORE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Compile Cache Hit Rate"), STAT_RDG_CompileCacheHitRate, STATGROUP_RDG, RENDERCORE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Compile Cache Time Saved (ms)"), STAT_RDG_CompileCacheTimeSaved, STATGROUP_RDG, RENDERCORE_API);
 
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Setup"), STAT_RDG_SetupTime, STATGROUP_RDG, RENDERCORE_API);
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Compile"), STAT_RDG_CompileTime, STATGROUP_RDG, RENDERCORE_API);
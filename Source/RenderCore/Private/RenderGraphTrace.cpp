@@ -124,9 +124,19 @@ bool FRDGTrace::IsEnabled() const
 	return bEnabled;
 }
 
+void FRDGTrace::OutputGraphCompileBegin()
+{
+	if (!IsEnabled() && !PhaseTimings)
+	{
+		return;
+	}
+
+	CompileStartCycles = FPlatformTime::Cycles64();
+}
+
 void FRDGTrace::OutputGraphBegin()
 {
-	if (!IsEnabled())
+	if (!IsEnabled() && !PhaseTimings)
 	{
 		return;
 	}
@@ -136,6 +146,12 @@ void FRDGTrace::OutputGraphBegin()
 
 void FRDGTrace::OutputGraphEnd(const FRDGBuilder& GraphBuilder)
 {
+	if (PhaseTimings)
+	{
+		PhaseTimings->CompileCycles = GraphStartCycles - CompileStartCycles;
+		PhaseTimings->ExecuteCycles = FPlatformTime::Cycles64() - GraphStartCycles;
+	}
+
 	if (!IsEnabled())
 	{
 		return;
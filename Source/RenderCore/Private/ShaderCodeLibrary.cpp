@@ -40,6 +40,7 @@ ShaderCodeLibrary.cpp: Bound shader state cache implementation.
 #include "ShaderPipelineCache.h"
 #include "DataDrivenShaderPlatformInfo.h"
 #include "String/ParseTokens.h"
+#include "Tasks/Task.h"
 #include "IO/IoChunkId.h"
 #include "IO/IoDispatcher.h"
 #include "IO/IoDispatcherInternal.h"
@@ -120,6 +121,152 @@ static FString GetShaderCodeLibraryDebugInfoPath()
 	return BaseDebugInfoPath / TEXT("Shaders");
 }
 
+static int32 GShaderUsageRecord = 0;
+static FAutoConsoleVariableRef CVarShaderUsageRecord(
+	TEXT("r.ShaderCodeLibrary.ShaderUsage.Record"),
+	GShaderUsageRecord,
+	TEXT("If > 0, every RHI shader created from the shader library is recorded (by shader map hash and shader index) into the shader usage profile.\n")
+	TEXT("The profile can be written with r.ShaderCodeLibrary.ShaderUsage.Save and is saved as 'Session' on shutdown. Prefetching is disabled while recording."),
+	ECVF_Default
+);
+
+static int32 GShaderUsagePrefetch = 1;
+static FAutoConsoleVariableRef CVarShaderUsagePrefetch(
+	TEXT("r.ShaderCodeLibrary.ShaderUsage.Prefetch"),
+	GShaderUsagePrefetch,
+	TEXT("If > 0, shader map resources created while a shader usage profile is loaded create the recorded RHI shaders on a background task,\n")
+	TEXT("instead of on first use on the rendering thread. Requires multithreaded shader creation support in the RHI."),
+	ECVF_Default
+);
+
+static int32 GShaderUsagePrefetchBudgetMB = 64;
+static FAutoConsoleVariableRef CVarShaderUsagePrefetchBudgetMB(
+	TEXT("r.ShaderCodeLibrary.ShaderUsage.PrefetchBudgetMB"),
+	GShaderUsagePrefetchBudgetMB,
+	TEXT("Maximum amount of shader code (in MB) that can be held by shaders created ahead of use from the shader usage profile."),
+	ECVF_Default
+);
+
+/** Bytes of shader code currently held by prefetched shaders, checked against r.ShaderCodeLibrary.ShaderUsage.PrefetchBudgetMB. */
+static std::atomic<int64> GShaderUsagePrefetchedBytes(0);
+
+/**
+ * Records which shaders of each shader map had their RHI shader created. Shader maps are keyed by their hash rather than their
+ * library index, so a profile recorded in one run is still valid in the next run of the same cooked build.
+ */
+class FShaderUsageProfile
+{
+public:
+	static FShaderUsageProfile& Get()
+	{
+		static FShaderUsageProfile Profile;
+		return Profile;
+	}
+
+	void RecordShader(const FSHAHash& ShaderMapHash, int32 NumShaders, int32 ShaderIndex)
+	{
+		FRWScopeLock Locker(Lock, SLT_Write);
+		TBitArray<>& ShaderBits = ShaderMaps.FindOrAdd(ShaderMapHash);
+		if (ShaderBits.Num() != NumShaders)
+		{
+			ShaderBits.Init(false, NumShaders);
+		}
+		ShaderBits[ShaderIndex] = true;
+	}
+
+	bool GetShaderIndices(const FSHAHash& ShaderMapHash, int32 NumShaders, TArray<int32>& OutShaderIndices) const
+	{
+		FRWScopeLock Locker(Lock, SLT_ReadOnly);
+		const TBitArray<>* ShaderBits = ShaderMaps.Find(ShaderMapHash);
+		if (!ShaderBits || ShaderBits->Num() != NumShaders)
+		{
+			return false;
+		}
+
+		for (TConstSetBitIterator<> It(*ShaderBits); It; ++It)
+		{
+			OutShaderIndices.Add(It.GetIndex());
+		}
+		return OutShaderIndices.Num() > 0;
+	}
+
+	bool IsEmpty() const
+	{
+		FRWScopeLock Locker(Lock, SLT_ReadOnly);
+		return ShaderMaps.Num() == 0;
+	}
+
+	void Reset()
+	{
+		FRWScopeLock Locker(Lock, SLT_Write);
+		ShaderMaps.Empty();
+	}
+
+	bool Save(const FString& Filename) const
+	{
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+		if (!Ar)
+		{
+			UE_LOG(LogShaderLibrary, Warning, TEXT("Unable to write shader usage profile %s"), *Filename);
+			return false;
+		}
+
+		FRWScopeLock Locker(Lock, SLT_ReadOnly);
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		*Ar << Magic;
+		*Ar << Version;
+		*Ar << const_cast<TMap<FSHAHash, TBitArray<>>&>(ShaderMaps);
+
+		UE_LOG(LogShaderLibrary, Display, TEXT("Saved shader usage profile %s (%d shader maps)"), *Filename, ShaderMaps.Num());
+		return Ar->Close();
+	}
+
+	bool Load(const FString& Filename)
+	{
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename));
+		if (!Ar)
+		{
+			return false;
+		}
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		*Ar << Magic;
+		*Ar << Version;
+		if (Magic != FileMagic || Version != FileVersion)
+		{
+			UE_LOG(LogShaderLibrary, Warning, TEXT("Ignoring shader usage profile %s: unexpected format (magic %x, version %u)"), *Filename, Magic, Version);
+			return false;
+		}
+
+		TMap<FSHAHash, TBitArray<>> LoadedShaderMaps;
+		*Ar << LoadedShaderMaps;
+		if (Ar->IsError())
+		{
+			UE_LOG(LogShaderLibrary, Warning, TEXT("Ignoring shader usage profile %s: failed to read"), *Filename);
+			return false;
+		}
+
+		FRWScopeLock Locker(Lock, SLT_Write);
+		ShaderMaps = MoveTemp(LoadedShaderMaps);
+		UE_LOG(LogShaderLibrary, Display, TEXT("Loaded shader usage profile %s (%d shader maps)"), *Filename, ShaderMaps.Num());
+		return true;
+	}
+
+private:
+	static constexpr uint32 FileMagic = 0x53555046; // 'SUPF'
+	static constexpr uint32 FileVersion = 1;
+
+	mutable FRWLock Lock;
+	TMap<FSHAHash, TBitArray<>> ShaderMaps;
+};
+
+static FString GetShaderUsageProfileFilename(const FString& BaseDir, const FString& ProfileName, EShaderPlatform Platform)
+{
+	return BaseDir / TEXT("ShaderUsage") / FString::Printf(TEXT("%s-%s.ushaderusage"), *ProfileName, *LegacyShaderPlatformToShaderFormat(Platform).ToString());
+}
+
 class FShaderLibraryInstance;
 namespace UE
 {
@@ -329,9 +476,20 @@ public:
 	virtual uint32 GetShaderSizeBytes(int32 ShaderIndex) const override;
 	virtual FSHAHash GetShaderMapHash() const override;
 
+	/** Creates the shaders recorded in the shader usage profile for this shader map on a background task. */
+	void BeginPrefetchRecordedShaders();
+
 	class FShaderLibraryInstance* LibraryInstance;
 	int32 ShaderMapIndex;
 	bool bEntireShaderMapPreloaded;
+
+private:
+	/** Cancels and waits for the prefetch task, and returns its shader code to the prefetch budget. */
+	void FinishPrefetchRecordedShaders();
+
+	UE::Tasks::FTask PrefetchTask;
+	std::atomic<bool> bCancelPrefetch;
+	int64 PrefetchedBytes;
 };
 
 static FArchive* CreateShaderFileReader(const TCHAR* Filename)
@@ -529,7 +687,29 @@ void FCompactFullName::AppendString(FAnsiStringBuilderBase& Out) const
 	}
 }
 
-void FCompactFullName::ParseFromString(const FStringView& InSrc)
+bool FStableShaderKeyNameCache::FKeyFuncs::Matches(const FStringView& A, const FStringView& B)
+{
+	// FName comparison is case insensitive but display strings are not, so keep the first spelling of each name
+	return A.Equals(B, ESearchCase::CaseSensitive);
+}
+
+uint32 FStableShaderKeyNameCache::FKeyFuncs::GetKeyHash(const FStringView& Key)
+{
+	return CityHash32(reinterpret_cast<const char*>(Key.GetData()), Key.Len() * sizeof(TCHAR));
+}
+
+FName FStableShaderKeyNameCache::FindOrAdd(const FStringView& Src)
+{
+	const uint32 Hash = FKeyFuncs::GetKeyHash(Src);
+	if (const FName* Name = Names.FindByHash(Hash, Src))
+	{
+		return *Name;
+	}
+	return Names.AddByHash(Hash, Src, FName(Src));
+}
+
+template<typename NameFactoryType>
+static void ParseCompactFullName(FCompactFullName& Out, const FStringView& InSrc, NameFactoryType&& MakeName)
 {
 	TArray<FStringView, TInlineAllocator<64>> Fields;
 	// do not split by '/' as this splits the original FName into per-path components
@@ -537,28 +717,38 @@ void FCompactFullName::ParseFromString(const FStringView& InSrc)
 		[&Fields](FStringView Field) { if (!Field.IsEmpty()) { Fields.Add(Field); } });
 	if (Fields.Num() == 1 && Fields[0] == TEXTVIEW("empty"))
 	{
-		ObjectClassAndPath.Empty();
+		Out.ObjectClassAndPath.Empty();
 	}
 	// fix up old format that removed the leading '/'
 	else if (Fields.Num() == 3 && Fields[1][0] != TEXT('/'))
 	{
-		ObjectClassAndPath.Empty(3);
-		ObjectClassAndPath.Emplace(Fields[0]);
+		Out.ObjectClassAndPath.Empty(3);
+		Out.ObjectClassAndPath.Emplace(MakeName(Fields[0]));
 		FString Fixup(TEXT("/"));
 		Fixup += Fields[1];
-		ObjectClassAndPath.Emplace(Fixup);
-		ObjectClassAndPath.Emplace(Fields[2]);
+		Out.ObjectClassAndPath.Emplace(Fixup);
+		Out.ObjectClassAndPath.Emplace(MakeName(Fields[2]));
 	}
 	else
 	{
-		ObjectClassAndPath.Empty(Fields.Num());
+		Out.ObjectClassAndPath.Empty(Fields.Num());
 		for (const FStringView& Item : Fields)
 		{
-			ObjectClassAndPath.Emplace(Item);
+			Out.ObjectClassAndPath.Emplace(MakeName(Item));
 		}
 	}
 }
 
+void FCompactFullName::ParseFromString(const FStringView& InSrc)
+{
+	ParseCompactFullName(*this, InSrc, [](const FStringView& Name) { return FName(Name); });
+}
+
+void FCompactFullName::ParseFromString(const FStringView& InSrc, FStableShaderKeyNameCache& NameCache)
+{
+	ParseCompactFullName(*this, InSrc, [&NameCache](const FStringView& Name) { return NameCache.FindOrAdd(Name); });
+}
+
 #if WITH_EDITOR
 void FCompactFullName::SetCompactFullNameFromObject(UObject* InDepObject)
 {
@@ -632,7 +822,8 @@ void FStableShaderKeyAndValue::ComputeKeyHash()
 	KeyHash = HashCombine(KeyHash, GetTypeHash(PipelineHash));
 }
 
-void FStableShaderKeyAndValue::ParseFromString(const FStringView& Src)
+template<typename ParsePathType, typename NameFactoryType>
+static void ParseStableShaderKey(FStableShaderKeyAndValue& Key, const FStringView& Src, ParsePathType&& ParsePath, NameFactoryType&& MakeName)
 {
 	TArray<FStringView, TInlineAllocator<12>> Fields;
 	UE::String::ParseTokens(Src.TrimStartAndEnd(), TEXT(','), [&Fields](FStringView Field) { Fields.Add(Field); });
@@ -649,84 +840,57 @@ void FStableShaderKeyAndValue::ParseFromString(const FStringView& Src)
 	check(Fields.Num() == 11 || Fields.Num() == 12);
 
 	int32 Index = 0;
-	ClassNameAndObjectPath.ParseFromString(Fields[Index++]);
+	ParsePath(Fields[Index++]);
 
-	ShaderType = FName(Fields[Index++]);
-	ShaderClass = FName(Fields[Index++]);
-	MaterialDomain = FName(Fields[Index++]);
-	FeatureLevel = FName(Fields[Index++]);
+	Key.ShaderType = MakeName(Fields[Index++]);
+	Key.ShaderClass = MakeName(Fields[Index++]);
+	Key.MaterialDomain = MakeName(Fields[Index++]);
+	Key.FeatureLevel = MakeName(Fields[Index++]);
 
-	QualityLevel = FName(Fields[Index++]);
-	TargetFrequency = FName(Fields[Index++]);
-	TargetPlatform = FName(Fields[Index++]);
+	Key.QualityLevel = MakeName(Fields[Index++]);
+	Key.TargetFrequency = MakeName(Fields[Index++]);
+	Key.TargetPlatform = MakeName(Fields[Index++]);
 
-	VFType = FName(Fields[Index++]);
-	PermutationId = FName(Fields[Index++]);
+	Key.VFType = MakeName(Fields[Index++]);
+	Key.PermutationId = MakeName(Fields[Index++]);
 
-	OutputHash.FromString(Fields[Index++]);
+	Key.OutputHash.FromString(Fields[Index++]);
 
 	check(Index == 11);
 
 	if (Fields.Num() == 12)
 	{
-		PipelineHash.FromString(Fields[Index++]);
+		Key.PipelineHash.FromString(Fields[Index++]);
 	}
 	else
 	{
-		PipelineHash = FSHAHash();
+		Key.PipelineHash = FSHAHash();
 	}
 
-	ComputeKeyHash();
+	Key.ComputeKeyHash();
 }
 
+void FStableShaderKeyAndValue::ParseFromString(const FStringView& Src)
+{
+	ParseStableShaderKey(*this, Src,
+		[this](const FStringView& Path) { ClassNameAndObjectPath.ParseFromString(Path); },
+		[](const FStringView& Name) { return FName(Name); });
+}
 
 void FStableShaderKeyAndValue::ParseFromStringCached(const FStringView& Src, TMap<uint32, FName>& NameCache)
 {
-	TArray<FStringView, TInlineAllocator<12>> Fields;
-	UE::String::ParseTokens(Src.TrimStartAndEnd(), TEXT(','), [&Fields](FStringView Field) { Fields.Add(Field); });
-
-	/* disabled, should not be happening since 1H 2018
-	if (Fields.Num() > 11)
-	{
-		// hack fix for unsanitized names, should not occur anymore.
-		FixupUnsanitizedNames(Src, Fields);
-	}
-	*/
-
-	// for a while, accept old .scl.csv without pipelinehash
-	check(Fields.Num() == 11 || Fields.Num() == 12);
-
-	int32 Index = 0;
-	ClassNameAndObjectPath.ParseFromString(Fields[Index++]);
-
-	// There is a high level of uniformity on the following FNames, use
+	// There is a high level of uniformity on the names following the object path, use
 	// the local name cache to accelerate lookup
-	ShaderType = ParseFNameCached(Fields[Index++], NameCache);
-	ShaderClass = ParseFNameCached(Fields[Index++], NameCache);
-	MaterialDomain = ParseFNameCached(Fields[Index++], NameCache);
-	FeatureLevel = ParseFNameCached(Fields[Index++], NameCache);
-
-	QualityLevel = ParseFNameCached(Fields[Index++], NameCache);
-	TargetFrequency = ParseFNameCached(Fields[Index++], NameCache);
-	TargetPlatform = ParseFNameCached(Fields[Index++], NameCache);
-
-	VFType = ParseFNameCached(Fields[Index++], NameCache);
-	PermutationId = ParseFNameCached(Fields[Index++], NameCache);
-
-	OutputHash.FromString(Fields[Index++]);
-
-	check(Index == 11);
-
-	if (Fields.Num() == 12)
-	{
-		PipelineHash.FromString(Fields[Index++]);
-	}
-	else
-	{
-		PipelineHash = FSHAHash();
-	}
+	ParseStableShaderKey(*this, Src,
+		[this](const FStringView& Path) { ClassNameAndObjectPath.ParseFromString(Path); },
+		[&NameCache](const FStringView& Name) { return ParseFNameCached(Name, NameCache); });
+}
 
-	ComputeKeyHash();
+void FStableShaderKeyAndValue::ParseFromString(const FStringView& Src, FStableShaderKeyNameCache& NameCache)
+{
+	ParseStableShaderKey(*this, Src,
+		[this, &NameCache](const FStringView& Path) { ClassNameAndObjectPath.ParseFromString(Path, NameCache); },
+		[&NameCache](const FStringView& Name) { return NameCache.FindOrAdd(Name); });
 }
 
 FString FStableShaderKeyAndValue::ToString() const
@@ -1132,6 +1296,7 @@ public:
 	{
 		TRefCountPtr<FShaderMapResource_SharedCode> OutResource;
 		bool bPreload = false;
+		bool bPrefetch = false;
 		{
 			FRWScopeLock Locker(ResourceLock, SLT_Write);
 			FShaderMapResource_SharedCode* PrevResource = Resources[ShaderMapIndex];
@@ -1140,6 +1305,7 @@ public:
 				Resources[ShaderMapIndex] = new FShaderMapResource_SharedCode(this, ShaderMapIndex);
 				OutResource = Resources[ShaderMapIndex];
 				bPreload = !GRHILazyShaderCodeLoading && GPreloadShaderMaps;
+				bPrefetch = true;
 			}
 			else
 			{
@@ -1162,6 +1328,11 @@ public:
 			}
 		}
 
+		if (bPrefetch)
+		{
+			OutResource->BeginPrefetchRecordedShaders();
+		}
+
 		return OutResource;
 	}
 
@@ -1277,6 +1448,7 @@ public:
 				Resource->bEntireShaderMapPreloaded = Library->PreloadShaderMap(ShaderMapIndex, AttachShaderReadRequestFunc);
 			}
 			BeginInitResource(Resource);
+			Resource->BeginPrefetchRecordedShaders();
 		}
 		Resource->AddRef();
 	}
@@ -1362,6 +1534,8 @@ FShaderMapResource_SharedCode::FShaderMapResource_SharedCode(FShaderLibraryInsta
 	, LibraryInstance(InLibraryInstance)
 	, ShaderMapIndex(InShaderMapIndex)
 	, bEntireShaderMapPreloaded(false)
+	, bCancelPrefetch(false)
+	, PrefetchedBytes(0)
 {
 	if (GShaderMapResourceRef)
 	{
@@ -1383,7 +1557,74 @@ FShaderMapResource_SharedCode::FShaderMapResource_SharedCode(FShaderLibraryInsta
 
 FShaderMapResource_SharedCode::~FShaderMapResource_SharedCode()
 {
-	
+	FinishPrefetchRecordedShaders();
+}
+
+void FShaderMapResource_SharedCode::BeginPrefetchRecordedShaders()
+{
+	if (!GShaderUsagePrefetch || GShaderUsageRecord || !GRHISupportsMultithreadedShaderCreation || !LibraryInstance)
+	{
+		return;
+	}
+
+	TArray<int32> ShaderIndices;
+	if (!FShaderUsageProfile::Get().GetShaderIndices(GetShaderMapHash(), GetNumShaders(), ShaderIndices))
+	{
+		return;
+	}
+
+	// Take as many recorded shaders as fit in what is left of the budget
+	const int64 BudgetBytes = int64(GShaderUsagePrefetchBudgetMB) * 1024 * 1024;
+	int64 AvailableBytes = BudgetBytes - GShaderUsagePrefetchedBytes.load(std::memory_order_relaxed);
+	int32 NumToPrefetch = 0;
+	for (; NumToPrefetch < ShaderIndices.Num(); ++NumToPrefetch)
+	{
+		const int64 ShaderBytes = GetShaderSizeBytes(ShaderIndices[NumToPrefetch]);
+		if (ShaderBytes > AvailableBytes)
+		{
+			break;
+		}
+		AvailableBytes -= ShaderBytes;
+		PrefetchedBytes += ShaderBytes;
+	}
+
+	if (NumToPrefetch == 0)
+	{
+		return;
+	}
+
+	ShaderIndices.SetNum(NumToPrefetch, EAllowShrinking::No);
+	GShaderUsagePrefetchedBytes.fetch_add(PrefetchedBytes, std::memory_order_relaxed);
+
+	// The task doesn't hold a reference: ReleaseRHI() and the destructor cancel and wait for it before the resource goes away
+	PrefetchTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, ShaderIndices = MoveTemp(ShaderIndices)]()
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FShaderMapResource_SharedCode::PrefetchRecordedShaders);
+		for (int32 ShaderIndex : ShaderIndices)
+		{
+			if (bCancelPrefetch.load(std::memory_order_relaxed))
+			{
+				break;
+			}
+			GetShader(ShaderIndex, false /*bRequired*/);
+		}
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+void FShaderMapResource_SharedCode::FinishPrefetchRecordedShaders()
+{
+	if (PrefetchTask.IsValid())
+	{
+		bCancelPrefetch.store(true, std::memory_order_relaxed);
+		PrefetchTask.Wait();
+		PrefetchTask = UE::Tasks::FTask();
+	}
+
+	if (PrefetchedBytes > 0)
+	{
+		GShaderUsagePrefetchedBytes.fetch_sub(PrefetchedBytes, std::memory_order_relaxed);
+		PrefetchedBytes = 0;
+	}
 }
 
 FSHAHash FShaderMapResource_SharedCode::GetShaderHash(int32 ShaderIndex)
@@ -1407,6 +1648,11 @@ FRHIShader* FShaderMapResource_SharedCode::CreateRHIShaderOrCrash(int32 ShaderIn
 		return nullptr;
 	}
 
+	if (GShaderUsageRecord)
+	{
+		FShaderUsageProfile::Get().RecordShader(GetShaderMapHash(), GetNumShaders(), ShaderIndex);
+	}
+
 	CreatedShader->AddRef();
 	return CreatedShader;
 }
@@ -1465,6 +1711,8 @@ void DiagnoseLeakingShaderMapResourceRefs(const FShaderMapResource_SharedCode* I
 
 void FShaderMapResource_SharedCode::ReleaseRHI()
 {
+	FinishPrefetchRecordedShaders();
+
 	if (LibraryInstance && ensureMsgf(LibraryInstance->Library, TEXT("LibraryInstance->Library pointer is expected to be valid as long as library's FShaderMapResource are alive.")))
 	{
 		const int32 NumShaders = GetNumShaders();
@@ -3489,6 +3737,13 @@ public:
 		return LibraryInstance != nullptr && LibraryInstance->Library->GetName() == LogicalLibraryName;
 	}
 
+	uint32 GetShaderSizeBytes(const FSHAHash& Hash)
+	{
+		int32 ShaderIndex = INDEX_NONE;
+		FShaderLibraryInstance* LibraryInstance = FindShaderLibraryForShader(Hash, ShaderIndex);
+		return LibraryInstance ? LibraryInstance->Library->GetShaderSizeBytes(ShaderIndex) : 0;
+	}
+
 #if WITH_EDITOR
 
 	FString GetFormatAndPlatformName(const FName& Format)
@@ -4112,6 +4367,11 @@ void FShaderCodeLibrary::InitForRuntime(EShaderPlatform ShaderPlatform)
 			{
 				FShaderCodeLibrary::OpenPluginShaderLibrary(*Plugins[Index]);
 			});
+
+			if (GShaderUsagePrefetch && !GShaderUsageRecord)
+			{
+				LoadShaderUsageProfile(TEXT("Session"));
+			}
 		}
 		else
 		{
@@ -4157,6 +4417,12 @@ void FShaderCodeLibrary::Shutdown()
 
 	UE::ShaderLibrary::Private::PluginsToIgnoreOnMount.Empty();
 
+	if (GShaderUsageRecord)
+	{
+		SaveShaderUsageProfile(TEXT("Session"));
+	}
+	FShaderUsageProfile::Get().Reset();
+
 	if (FShaderLibrariesCollection::Impl)
 	{
 		delete FShaderLibrariesCollection::Impl;
@@ -4177,6 +4443,35 @@ bool FShaderCodeLibrary::AreShaderMapsPreloadedAtLoadTime()
 	return GPreloadShaderMaps > 0;
 }
 
+bool FShaderCodeLibrary::SaveShaderUsageProfile(const FString& ProfileName)
+{
+	if (FShaderLibrariesCollection::Impl == nullptr || FShaderUsageProfile::Get().IsEmpty())
+	{
+		return false;
+	}
+
+	const EShaderPlatform Platform = FShaderLibrariesCollection::Impl->GetRuntimeShaderPlatform();
+	return FShaderUsageProfile::Get().Save(GetShaderUsageProfileFilename(FPaths::ProjectSavedDir(), ProfileName, Platform));
+}
+
+bool FShaderCodeLibrary::LoadShaderUsageProfile(const FString& ProfileName)
+{
+	if (FShaderLibrariesCollection::Impl == nullptr)
+	{
+		return false;
+	}
+
+	// Profiles recorded locally take precedence over ones shipped with the content
+	const EShaderPlatform Platform = FShaderLibrariesCollection::Impl->GetRuntimeShaderPlatform();
+	return FShaderUsageProfile::Get().Load(GetShaderUsageProfileFilename(FPaths::ProjectSavedDir(), ProfileName, Platform))
+		|| FShaderUsageProfile::Get().Load(GetShaderUsageProfileFilename(FPaths::ProjectContentDir(), ProfileName, Platform));
+}
+
+void FShaderCodeLibrary::ResetShaderUsageProfile()
+{
+	FShaderUsageProfile::Get().Reset();
+}
+
 bool FShaderCodeLibrary::ContainsShaderCode(const FSHAHash& Hash)
 {
 	if (FShaderLibrariesCollection::Impl)
@@ -4195,6 +4490,15 @@ bool FShaderCodeLibrary::ContainsShaderCode(const FSHAHash& Hash, const FString&
 	return false;
 }
 
+uint32 FShaderCodeLibrary::GetShaderSizeBytes(const FSHAHash& Hash)
+{
+	if (FShaderLibrariesCollection::Impl)
+	{
+		return FShaderLibrariesCollection::Impl->GetShaderSizeBytes(Hash);
+	}
+	return 0;
+}
+
 TRefCountPtr<FShaderMapResource> FShaderCodeLibrary::LoadResource(const FSHAHash& Hash, FArchive* Ar)
 {
 	if (FShaderLibrariesCollection::Impl)
@@ -4850,6 +5154,37 @@ void UE::ShaderLibrary::Private::FNamedShaderLibrary::DumpLibraryContents(const
 }
 #endif
 
+static FAutoConsoleCommandWithArgsAndOutputDevice GSaveShaderUsageProfileCmd(
+	TEXT("r.ShaderCodeLibrary.ShaderUsage.Save"),
+	TEXT("Writes the recorded shader usage to a named profile (default 'Session'), e.g. before leaving a level."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Params, FOutputDevice& Out)
+		{
+			const FString ProfileName = Params.Num() > 0 ? Params[0] : FString(TEXT("Session"));
+			if (!FShaderCodeLibrary::SaveShaderUsageProfile(ProfileName))
+			{
+				Out.Logf(TEXT("Shader usage profile %s was not saved (shader library disabled or nothing recorded)"), *ProfileName);
+			}
+		}));
+
+static FAutoConsoleCommandWithArgsAndOutputDevice GLoadShaderUsageProfileCmd(
+	TEXT("r.ShaderCodeLibrary.ShaderUsage.Load"),
+	TEXT("Loads a named shader usage profile (default 'Session') to prefetch shaders of shader maps loaded afterwards, e.g. before loading a level."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(
+		[](const TArray<FString>& Params, FOutputDevice& Out)
+		{
+			const FString ProfileName = Params.Num() > 0 ? Params[0] : FString(TEXT("Session"));
+			if (!FShaderCodeLibrary::LoadShaderUsageProfile(ProfileName))
+			{
+				Out.Logf(TEXT("Shader usage profile %s could not be loaded"), *ProfileName);
+			}
+		}));
+
+static FAutoConsoleCommand GResetShaderUsageProfileCmd(
+	TEXT("r.ShaderCodeLibrary.ShaderUsage.Reset"),
+	TEXT("Discards the recorded or loaded shader usage profile."),
+	FConsoleCommandDelegate::CreateStatic(&FShaderCodeLibrary::ResetShaderUsageProfile));
+
 FAutoConsoleCommandWithArgsAndOutputDevice GListShaderLibrariesCmd(
 	TEXT("ListShaderLibraries"),
 	TEXT("Spits out a csv table containing stats of all shader libraries"),
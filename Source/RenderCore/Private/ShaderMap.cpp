@@ -501,9 +501,42 @@ void FShaderMapBase::DestroyContent()
 	NumFrozenShaders = 0u;
 }
 
+static uint64 MakeShaderKey(const FHashedName& TypeName, int32 PermutationId)
+{
+	return CityHash128to64({ TypeName.GetHash(), (uint64)PermutationId });
+}
+
 static uint16 MakeShaderHash(const FHashedName& TypeName, int32 PermutationId)
 {
-	return (uint16)CityHash128to64({ TypeName.GetHash(), (uint64)PermutationId });
+	return (uint16)MakeShaderKey(TypeName, PermutationId);
+}
+
+static FORCEINLINE uint8 GetShaderIndexTag(uint64 Key)
+{
+	// Top 7 bits, so a tag can never collide with the empty marker (0x80)
+	return (uint8)(Key >> 57);
+}
+
+/** Returns a bitmask of the tags in a group equal to Tag, and of the empty tags in the group. */
+static FORCEINLINE void MatchShaderIndexGroup(const uint8* RESTRICT GroupTags, uint8 Tag, uint32& OutMatchMask, uint32& OutEmptyMask)
+{
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS
+	// SSE2 only, which every x86 target with vector intrinsics has
+	const __m128i Tags = _mm_loadu_si128((const __m128i*)GroupTags);
+	OutMatchMask = (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(Tags, _mm_set1_epi8((char)Tag)));
+	// Only empty tags have the high bit set
+	OutEmptyMask = (uint32)_mm_movemask_epi8(Tags);
+#else
+	uint32 MatchMask = 0u;
+	uint32 EmptyMask = 0u;
+	for (uint32 TagIndex = 0u; TagIndex < 16u; ++TagIndex)
+	{
+		MatchMask |= (uint32)(GroupTags[TagIndex] == Tag) << TagIndex;
+		EmptyMask |= (uint32)(GroupTags[TagIndex] >> 7) << TagIndex;
+	}
+	OutMatchMask = MatchMask;
+	OutEmptyMask = EmptyMask;
+#endif
 }
 
 FShaderMapContent::FShaderMapContent(EShaderPlatform InPlatform)
@@ -524,6 +557,15 @@ FShader* FShaderMapContent::GetShader(const FHashedName& TypeName, int32 Permuta
 {
 	// TRACE_CPUPROFILER_EVENT_SCOPE(FShaderMapContent::GetShader); -- this function is called too frequently, so don't add the scope by default
 
+	const int32 Index = ShaderIndexTags.Num() > 0
+		? FindShaderIndexFromLookupIndex(TypeName, PermutationId)
+		: FindShaderIndexFromHashChain(TypeName, PermutationId);
+
+	return Index != INDEX_NONE ? Shaders[Index].GetChecked() : nullptr;
+}
+
+int32 FShaderMapContent::FindShaderIndexFromHashChain(const FHashedName& TypeName, int32 PermutationId) const
+{
 	const uint16 Hash = MakeShaderHash(TypeName, PermutationId);
 	const FHashedName* RESTRICT LocalShaderTypes = ShaderTypes.GetData();
 	const int32* RESTRICT LocalShaderPermutations = ShaderPermutations.GetData();
@@ -535,17 +577,115 @@ FShader* FShaderMapContent::GetShader(const FHashedName& TypeName, int32 Permuta
 		checkSlow(Index < NumShaders);
 		if (LocalShaderTypes[Index] == TypeName && LocalShaderPermutations[Index] == PermutationId)
 		{
-			return Shaders[Index].GetChecked();
+			return (int32)Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+int32 FShaderMapContent::FindShaderIndexFromLookupIndex(const FHashedName& TypeName, int32 PermutationId) const
+{
+	const uint32 NumGroups = (uint32)ShaderIndexTags.Num() / ShaderIndexGroupSize;
+	if (NumGroups == 0u)
+	{
+		return INDEX_NONE;
+	}
+
+	const uint64 Key = MakeShaderKey(TypeName, PermutationId);
+	const uint8 Tag = GetShaderIndexTag(Key);
+	const uint8* RESTRICT LocalTags = ShaderIndexTags.GetData();
+	const uint64* RESTRICT LocalKeys = ShaderIndexKeys.GetData();
+	const int32* RESTRICT LocalSlots = ShaderIndexSlots.GetData();
+	const uint32 GroupMask = NumGroups - 1u;
+
+	uint32 Group = (uint32)Key & GroupMask;
+	for (uint32 Probe = 0u; Probe < NumGroups; ++Probe)
+	{
+		const uint32 FirstSlot = Group * ShaderIndexGroupSize;
+
+		uint32 MatchMask;
+		uint32 EmptyMask;
+		MatchShaderIndexGroup(LocalTags + FirstSlot, Tag, MatchMask, EmptyMask);
+
+		while (MatchMask)
+		{
+			const uint32 Slot = FirstSlot + FMath::CountTrailingZeros(MatchMask);
+			if (LocalKeys[Slot] == Key)
+			{
+				const int32 Index = LocalSlots[Slot];
+				if (ShaderTypes[Index] == TypeName && ShaderPermutations[Index] == PermutationId)
+				{
+					return Index;
+				}
+			}
+			MatchMask &= MatchMask - 1u;
+		}
+
+		// Entries are inserted into the first group with a free slot, so an empty slot ends the probe sequence
+		if (EmptyMask)
+		{
+			break;
 		}
+		Group = (Group + 1u) & GroupMask;
 	}
 
-	return nullptr;
+	return INDEX_NONE;
+}
+
+void FShaderMapContent::BuildShaderLookupIndex()
+{
+	ResetShaderLookupIndex();
+
+	const uint32 NumShaders = Shaders.Num();
+	if (NumShaders == 0u)
+	{
+		return;
+	}
+
+	// Keep the load factor under 7/8 so every probe sequence hits an empty slot quickly
+	const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(FMath::Max((NumShaders * 8u) / 7u + 1u, ShaderIndexGroupSize));
+	const uint32 GroupMask = NumSlots / ShaderIndexGroupSize - 1u;
+
+	ShaderIndexTags.Init(ShaderIndexEmptyTag, NumSlots);
+	ShaderIndexKeys.Init(0u, NumSlots);
+	ShaderIndexSlots.Init(INDEX_NONE, NumSlots);
+
+	for (uint32 Index = 0u; Index < NumShaders; ++Index)
+	{
+		const uint64 Key = MakeShaderKey(ShaderTypes[Index], ShaderPermutations[Index]);
+
+		uint32 Group = (uint32)Key & GroupMask;
+		for (;;)
+		{
+			uint32 MatchMask;
+			uint32 EmptyMask;
+			MatchShaderIndexGroup(ShaderIndexTags.GetData() + Group * ShaderIndexGroupSize, 0u, MatchMask, EmptyMask);
+			if (EmptyMask)
+			{
+				const uint32 Slot = Group * ShaderIndexGroupSize + FMath::CountTrailingZeros(EmptyMask);
+				ShaderIndexTags[Slot] = GetShaderIndexTag(Key);
+				ShaderIndexKeys[Slot] = Key;
+				ShaderIndexSlots[Slot] = (int32)Index;
+				break;
+			}
+			Group = (Group + 1u) & GroupMask;
+		}
+	}
+}
+
+void FShaderMapContent::ResetShaderLookupIndex()
+{
+	ShaderIndexTags.Empty();
+	ShaderIndexKeys.Empty();
+	ShaderIndexSlots.Empty();
 }
 
 void FShaderMapContent::AddShader(const FHashedName& TypeName, int32 PermutationId, FShader* Shader)
 {
 	check(!Shader->IsFrozen());
 	checkSlow(!HasShader(TypeName, PermutationId));
+	ResetShaderLookupIndex();
 
 	const uint16 Hash = MakeShaderHash(TypeName, PermutationId);
 	const int32 Index = Shaders.Add(Shader);
@@ -570,6 +710,7 @@ FShader* FShaderMapContent::FindOrAddShader(const FHashedName& TypeName, int32 P
 		}
 	}
 
+	ResetShaderLookupIndex();
 	const int32 Index = Shaders.Add(Shader);
 	ShaderHash.Add(Hash, Index);
 	ShaderTypes.Add(TypeName);
@@ -617,6 +758,7 @@ void FShaderMapContent::RemoveShaderTypePermutaion(const FHashedName& TypeName,
 		if (ShaderTypes[Index] == TypeName && ShaderPermutations[Index] == PermutationId)
 		{
 			DeleteObjectFromLayout(Shader);
+			ResetShaderLookupIndex();
 
 			// Replace the shader we're removing with the last shader in the list
 			Shaders.RemoveAtSwap(Index, 1, EAllowShrinking::No);
@@ -726,6 +868,43 @@ void FShaderMapContent::DumpShaderList(const FShaderMapBase& InShaderMap, FShade
 		}
 	}
 }
+
+void FShaderMapContent::BenchmarkShaderLookup(int32 NumIterations, double& OutHashChainSeconds, double& OutLookupIndexSeconds) const
+{
+	OutHashChainSeconds = 0.0;
+	OutLookupIndexSeconds = 0.0;
+
+	const int32 NumShaders = Shaders.Num();
+	if (NumShaders == 0 || ShaderIndexTags.Num() == 0)
+	{
+		return;
+	}
+
+	// Sum the found indices so the lookups can't be optimized away, and so both paths can be checked against each other
+	int64 HashChainChecksum = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		for (int32 Index = 0; Index < NumShaders; ++Index)
+		{
+			HashChainChecksum += FindShaderIndexFromHashChain(ShaderTypes[Index], ShaderPermutations[Index]);
+		}
+	}
+	OutHashChainSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int64 LookupIndexChecksum = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		for (int32 Index = 0; Index < NumShaders; ++Index)
+		{
+			LookupIndexChecksum += FindShaderIndexFromLookupIndex(ShaderTypes[Index], ShaderPermutations[Index]);
+		}
+	}
+	OutLookupIndexSeconds = FPlatformTime::Seconds() - StartTime;
+
+	ensureMsgf(HashChainChecksum == LookupIndexChecksum, TEXT("Shader map lookup index disagrees with the hash chain (%lld vs %lld)"), HashChainChecksum, LookupIndexChecksum);
+}
 #endif // !UE_BUILD_SHIPPING
 
 void FShaderMapContent::GetShaderList(const FShaderMapBase& InShaderMap, const FSHAHash& InMaterialShaderMapHash, TMap<FShaderId, TShaderRef<FShader>>& OutShaders) const
@@ -1012,6 +1191,8 @@ void FShaderMapContent::Finalize(const FShaderMapResourceCode* Code)
 
 	Shaders = MoveTemp(NewShaders);
 	ShaderHash = MoveTemp(NewShaderHash);
+
+	BuildShaderLookupIndex();
 }
 
 void FShaderMapContent::UpdateHash(FSHA1& Hasher) const
@@ -1043,6 +1224,7 @@ void FShaderMapContent::Empty()
 	ShaderTypes.Empty();
 	ShaderPermutations.Empty();
 	ShaderHash.Clear();
+	ResetShaderLookupIndex();
 }
 
 void FShaderMapContent::EmptyShaderPipelines()
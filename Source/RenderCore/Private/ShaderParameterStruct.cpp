@@ -5,6 +5,10 @@
 =============================================================================*/
 
 #include "ShaderParameterStruct.h"
+#include "GlobalRenderResources.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderingThread.h"
+#include "RHIStaticStates.h"
 
 FRDGTextureAccess::FRDGTextureAccess(FRDGTexture* InTexture, ERHIAccess InAccess)
 	: FRDGTextureAccess(InTexture, InTexture ? InTexture->GetSubresourceRange() : FRDGTextureSubresourceRange(), InAccess)
@@ -310,6 +314,8 @@ void FShaderParameterBindings::BindForLegacyShaderParameters(const FShader* Shad
 	StructureLayoutHash = StructMetaData.GetLayoutHash();
 	RootParameterBufferIndex = kInvalidBufferIndex;
 
+	CompileBindingProgram();
+
 	TArray<FString> AllParameterNames;
 	ParametersMap.GetAllParameterNames(AllParameterNames);
 	if (bShouldBindEverything && BindingContext.ShaderGlobalScopeBindings.Num() != AllParameterNames.Num())
@@ -377,6 +383,8 @@ void FShaderParameterBindings::BindForRootShaderParameters(const FShader* Shader
 		}
 	}
 
+	CompileBindingProgram();
+
 	TArray<FString> AllParameterNames;
 	ParametersMap.GetAllParameterNames(AllParameterNames);
 	if (BindingContext.ShaderGlobalScopeBindings.Num() != AllParameterNames.Num())
@@ -397,6 +405,98 @@ void FShaderParameterBindings::BindForRootShaderParameters(const FShader* Shader
 	}
 }
 
+/** Resource kinds that are bound the same way share a group in the binding program. */
+static EUniformBufferBaseType GetResourceParameterGroupType(EUniformBufferBaseType BaseType)
+{
+	switch (BaseType)
+	{
+	case UBMT_RDG_TEXTURE_NON_PIXEL_SRV:
+	case UBMT_RDG_BUFFER_SRV:
+		return UBMT_RDG_TEXTURE_SRV;
+	case UBMT_RDG_BUFFER_UAV:
+		return UBMT_RDG_TEXTURE_UAV;
+	default:
+		return BaseType;
+	}
+}
+
+template<typename ParameterType>
+static void CompileResourceParameterGroups(
+	const TMemoryImageArray<ParameterType>& Parameters,
+	TMemoryImageArray<ParameterType>& OutParametersByKind,
+	TMemoryImageArray<FShaderParameterBindings::FResourceParameterGroup>& OutGroups)
+{
+	TArray<ParameterType> SortedParameters(Parameters.GetData(), Parameters.Num());
+
+	// Stable so that each group keeps reading the parameter struct in increasing address order.
+	SortedParameters.StableSort([](const ParameterType& A, const ParameterType& B)
+	{
+		return GetResourceParameterGroupType(A.BaseType) < GetResourceParameterGroupType(B.BaseType);
+	});
+
+	OutParametersByKind.Empty(SortedParameters.Num());
+	OutGroups.Empty();
+
+	for (int32 Index = 0; Index < SortedParameters.Num(); ++Index)
+	{
+		const EUniformBufferBaseType GroupType = GetResourceParameterGroupType(SortedParameters[Index].BaseType);
+
+		if (OutGroups.Num() == 0 || OutGroups[OutGroups.Num() - 1].BaseType != GroupType)
+		{
+			FShaderParameterBindings::FResourceParameterGroup Group;
+			Group.First = uint16(Index);
+			Group.Num = 0;
+			Group.BaseType = GroupType;
+			OutGroups.Add(Group);
+		}
+
+		OutGroups[OutGroups.Num() - 1].Num++;
+		OutParametersByKind.Add(SortedParameters[Index]);
+	}
+}
+
+void FShaderParameterBindings::CompileBindingProgram()
+{
+	checkf(ResourceParameters.Num() <= MAX_uint16 && BindlessResourceParameters.Num() <= MAX_uint16, TEXT("Too many resource parameters for the binding program."));
+
+	// Coalesce loose parameters that are contiguous in both the parameter struct and the destination constant buffer.
+	if (Parameters.Num() > 1)
+	{
+		TArray<FParameter> SortedParameters(Parameters.GetData(), Parameters.Num());
+		SortedParameters.Sort([](const FParameter& A, const FParameter& B)
+		{
+			return A.BufferIndex != B.BufferIndex ? A.BufferIndex < B.BufferIndex : A.BaseIndex < B.BaseIndex;
+		});
+
+		Parameters.Empty(SortedParameters.Num());
+		Parameters.Add(SortedParameters[0]);
+
+		for (int32 Index = 1; Index < SortedParameters.Num(); ++Index)
+		{
+			const FParameter& Parameter = SortedParameters[Index];
+			FParameter& LastParameter = Parameters[Parameters.Num() - 1];
+
+			const bool bContiguous =
+				LastParameter.BufferIndex == Parameter.BufferIndex &&
+				uint32(LastParameter.BaseIndex) + LastParameter.ByteSize == Parameter.BaseIndex &&
+				uint32(LastParameter.ByteOffset) + LastParameter.ByteSize == Parameter.ByteOffset &&
+				uint32(LastParameter.ByteSize) + Parameter.ByteSize <= MAX_uint16;
+
+			if (bContiguous)
+			{
+				LastParameter.ByteSize += Parameter.ByteSize;
+			}
+			else
+			{
+				Parameters.Add(Parameter);
+			}
+		}
+	}
+
+	CompileResourceParameterGroups(ResourceParameters, ResourceParametersByKind, ResourceParameterGroups);
+	CompileResourceParameterGroups(BindlessResourceParameters, BindlessResourceParametersByKind, BindlessResourceParameterGroups);
+}
+
 bool FRenderTargetBinding::Validate() const
 {
 	if (!Texture)
@@ -879,6 +979,117 @@ static void ExtractShaderParameterResources(
 	}
 }
 
+template<typename RHIResourceType, typename ParameterType, typename AddFunctionType>
+FORCEINLINE static void ExecuteRHIResourceParameterGroup(const FShaderParameterReader Reader, TConstArrayView<ParameterType> Parameters, AddFunctionType& AddFunction)
+{
+	for (const ParameterType& Parameter : Parameters)
+	{
+		RHIResourceType* Resource = Reader.Read<RHIResourceType*>(Parameter);
+		checkSlow(Resource);
+		AddFunction(FRHIShaderParameterResource(Resource, GetParameterIndex(Parameter)));
+	}
+}
+
+template<typename RDGResourceType, typename ParameterType, typename AddFunctionType>
+FORCEINLINE static void ExecuteRDGResourceParameterGroup(const FShaderParameterReader Reader, TConstArrayView<ParameterType> Parameters, AddFunctionType& AddFunction)
+{
+	for (const ParameterType& Parameter : Parameters)
+	{
+		RDGResourceType* Resource = Reader.Read<RDGResourceType*>(Parameter);
+		checkSlow(Resource);
+		Resource->MarkResourceAsUsed();
+		AddFunction(FRHIShaderParameterResource(Resource->GetRHI(), GetParameterIndex(Parameter)));
+	}
+}
+
+/** Executes the resource part of a binding program compiled by FShaderParameterBindings::CompileBindingProgram(). Branches once per group rather than per resource. */
+template<typename ParameterType, typename AddFunctionType>
+static void ExecuteResourceParameterGroups(
+	const FShaderParameterReader Reader,
+	const TMemoryImageArray<ParameterType>& ParametersByKind,
+	const TMemoryImageArray<FShaderParameterBindings::FResourceParameterGroup>& Groups,
+	AddFunctionType&& AddFunction)
+{
+	const TConstArrayView<ParameterType> AllParameters(ParametersByKind.GetData(), ParametersByKind.Num());
+
+	for (const FShaderParameterBindings::FResourceParameterGroup& Group : Groups)
+	{
+		const TConstArrayView<ParameterType> Parameters = AllParameters.Slice(Group.First, Group.Num);
+
+		switch (Group.BaseType)
+		{
+		case UBMT_TEXTURE:
+			ExecuteRHIResourceParameterGroup<FRHITexture>(Reader, Parameters, AddFunction);
+			break;
+		case UBMT_SRV:
+			ExecuteRHIResourceParameterGroup<FRHIShaderResourceView>(Reader, Parameters, AddFunction);
+			break;
+		case UBMT_UAV:
+			ExecuteRHIResourceParameterGroup<FRHIUnorderedAccessView>(Reader, Parameters, AddFunction);
+			break;
+		case UBMT_SAMPLER:
+			ExecuteRHIResourceParameterGroup<FRHISamplerState>(Reader, Parameters, AddFunction);
+			break;
+		case UBMT_RDG_TEXTURE:
+			ExecuteRDGResourceParameterGroup<FRDGTexture>(Reader, Parameters, AddFunction);
+			break;
+		case UBMT_RDG_TEXTURE_SRV:
+			ExecuteRDGResourceParameterGroup<FRDGShaderResourceView>(Reader, Parameters, AddFunction);
+			break;
+		case UBMT_RDG_TEXTURE_UAV:
+			ExecuteRDGResourceParameterGroup<FRDGUnorderedAccessView>(Reader, Parameters, AddFunction);
+			break;
+		default:
+			checkf(false, TEXT("Unhandled resource type?"));
+			break;
+		}
+	}
+}
+
+static void ExecuteShaderParameterBindingProgram(
+	FRHIBatchedShaderParameters& BatchedParameters,
+	const FShaderParameterBindings& Bindings,
+	TConstArrayView<uint8> ParametersData,
+	EUniformBufferBindingFlags UniformBufferBindingFlags)
+{
+	checkSlow(Bindings.ResourceParametersByKind.Num() == Bindings.ResourceParameters.Num());
+
+	const FShaderParameterReader Reader(ParametersData);
+
+	for (const FShaderParameterBindings::FParameter& Parameter : Bindings.Parameters)
+	{
+		BatchedParameters.SetShaderParameter(Parameter.BufferIndex, Parameter.BaseIndex, Parameter.ByteSize, ParametersData.GetData() + Parameter.ByteOffset);
+	}
+
+#if PLATFORM_SUPPORTS_BINDLESS_RENDERING
+	ExecuteResourceParameterGroups(Reader, Bindings.BindlessResourceParametersByKind, Bindings.BindlessResourceParameterGroups,
+		[&BatchedParameters](const FRHIShaderParameterResource& Resource) { BatchedParameters.AddBindlessParameter(Resource); });
+#endif
+
+	ExecuteResourceParameterGroups(Reader, Bindings.ResourceParametersByKind, Bindings.ResourceParameterGroups,
+		[&BatchedParameters](const FRHIShaderParameterResource& Resource) { BatchedParameters.AddResourceParameter(Resource); });
+
+	for (const FShaderParameterBindings::FParameterStructReference& Parameter : Bindings.GraphUniformBuffers)
+	{
+		const FRDGUniformBufferBinding& UniformBufferBinding = Reader.Read<FRDGUniformBufferBinding>(Parameter);
+		if (EnumHasAnyFlags(UniformBufferBinding.GetBindingFlags(), UniformBufferBindingFlags))
+		{
+			UniformBufferBinding->MarkResourceAsUsed();
+
+			BatchedParameters.AddResourceParameter(UniformBufferBinding->GetRHI(), GetParameterIndex(Parameter));
+		}
+	}
+
+	for (const FShaderParameterBindings::FParameterStructReference& Parameter : Bindings.ParameterReferences)
+	{
+		const FUniformBufferBinding& UniformBufferBinding = Reader.Read<FUniformBufferBinding>(Parameter);
+		if (EnumHasAnyFlags(UniformBufferBinding.GetBindingFlags(), UniformBufferBindingFlags))
+		{
+			BatchedParameters.AddResourceParameter(UniformBufferBinding.GetUniformBuffer(), GetParameterIndex(Parameter));
+		}
+	}
+}
+
 /** Set batched parameters from a parameters struct. */
 void SetShaderParameters(
 	FRHIBatchedShaderParameters& BatchedParameters,
@@ -888,12 +1099,7 @@ void SetShaderParameters(
 {
 	TConstArrayView<uint8> FullParametersData((const uint8*)InParametersData, ParametersMetadata->GetSize());
 
-	for (const FShaderParameterBindings::FParameter& Parameter : Bindings.Parameters)
-	{
-		BatchedParameters.SetShaderParameter(Parameter.BufferIndex, Parameter.BaseIndex, Parameter.ByteSize, FullParametersData.GetData() + Parameter.ByteOffset);
-	}
-
-	ExtractShaderParameterResources(BatchedParameters, Bindings, FullParametersData, EUniformBufferBindingFlags::Shader);
+	ExecuteShaderParameterBindingProgram(BatchedParameters, Bindings, FullParametersData, EUniformBufferBindingFlags::Shader);
 }
 
 /** Set shader's parameters from its parameters struct. */
@@ -1190,3 +1396,119 @@ void SetRayTracingShaderParameters(
 
 
 #endif // RHI_RAYTRACING
+
+/**
+ * Binds synthetic parameter structs sized like small, Nanite and Lumen passes with both the per-member path
+ * and the compiled binding program, and logs the time per bind. Only RHI textures and samplers are used so
+ * that no graph is required.
+ */
+static void BenchmarkShaderParameterBindingProgram(const TArray<FString>& Args)
+{
+	const int32 NumIterations = FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000, 1);
+
+	ENQUEUE_RENDER_COMMAND(BenchmarkShaderParameterBindingProgram)([NumIterations](FRHICommandListImmediate& RHICmdList)
+	{
+		struct FStructDesc
+		{
+			const TCHAR* Name;
+			int32 NumLooseParameters;
+			int32 NumTextures;
+			int32 NumSamplers;
+		};
+
+		const FStructDesc StructDescs[] =
+		{
+			{ TEXT("Small"),  8,  4, 2 },
+			{ TEXT("Nanite"), 48, 24, 4 },
+			{ TEXT("Lumen"),  96, 48, 8 },
+		};
+
+		FRHITexture* Texture = GBlackTexture->TextureRHI;
+		FRHISamplerState* Sampler = TStaticSamplerState<>::GetRHI();
+
+		for (const FStructDesc& StructDesc : StructDescs)
+		{
+			TArray<uint8> ParametersData;
+			FShaderParameterBindings Bindings;
+			FShaderParameterBindings CompiledBindings;
+
+			// Loose parameters first, one float4 each, followed by textures with samplers interleaved the way typical structs declare them.
+			uint16 ByteOffset = 0;
+			for (int32 Index = 0; Index < StructDesc.NumLooseParameters; ++Index, ByteOffset += 16)
+			{
+				FShaderParameterBindings::FParameter Parameter;
+				Parameter.BufferIndex = 0;
+				Parameter.BaseIndex = ByteOffset;
+				Parameter.ByteOffset = ByteOffset;
+				Parameter.ByteSize = 16;
+				Bindings.Parameters.Add(Parameter);
+				CompiledBindings.Parameters.Add(Parameter);
+			}
+
+			ParametersData.SetNumZeroed(ByteOffset + (StructDesc.NumTextures + StructDesc.NumSamplers) * SHADER_PARAMETER_POINTER_ALIGNMENT);
+
+			const int32 TexturesPerSampler = FMath::Max(StructDesc.NumTextures / FMath::Max(StructDesc.NumSamplers, 1), 1);
+			int32 NumTextures = 0;
+			int32 NumSamplers = 0;
+			for (int32 Index = 0; Index < StructDesc.NumTextures + StructDesc.NumSamplers; ++Index, ByteOffset += SHADER_PARAMETER_POINTER_ALIGNMENT)
+			{
+				const bool bSampler = NumSamplers < StructDesc.NumSamplers && (NumTextures == StructDesc.NumTextures || (Index % (TexturesPerSampler + 1)) == TexturesPerSampler);
+
+				FShaderParameterBindings::FResourceParameter Parameter;
+				Parameter.ByteOffset = ByteOffset;
+				Parameter.BaseIndex = uint8(bSampler ? NumSamplers++ : NumTextures++);
+				Parameter.BaseType = bSampler ? UBMT_SAMPLER : UBMT_TEXTURE;
+				Bindings.ResourceParameters.Add(Parameter);
+				CompiledBindings.ResourceParameters.Add(Parameter);
+
+				if (bSampler)
+				{
+					*reinterpret_cast<FRHISamplerState**>(&ParametersData[ByteOffset]) = Sampler;
+				}
+				else
+				{
+					*reinterpret_cast<FRHITexture**>(&ParametersData[ByteOffset]) = Texture;
+				}
+			}
+
+			CompiledBindings.CompileBindingProgram();
+
+			FRHIBatchedShaderParameters& BatchedParameters = RHICmdList.GetScratchShaderParameters();
+
+			const uint64 StartPerMemberCycles = FPlatformTime::Cycles64();
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				for (const FShaderParameterBindings::FParameter& Parameter : Bindings.Parameters)
+				{
+					BatchedParameters.SetShaderParameter(Parameter.BufferIndex, Parameter.BaseIndex, Parameter.ByteSize, ParametersData.GetData() + Parameter.ByteOffset);
+				}
+				ExtractShaderParameterResources(BatchedParameters, Bindings, ParametersData, EUniformBufferBindingFlags::Shader);
+				BatchedParameters.Reset();
+			}
+			const uint64 PerMemberCycles = FPlatformTime::Cycles64() - StartPerMemberCycles;
+
+			const uint64 StartProgramCycles = FPlatformTime::Cycles64();
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				ExecuteShaderParameterBindingProgram(BatchedParameters, CompiledBindings, ParametersData, EUniformBufferBindingFlags::Shader);
+				BatchedParameters.Reset();
+			}
+			const uint64 ProgramCycles = FPlatformTime::Cycles64() - StartProgramCycles;
+
+			UE_LOG(LogShaders, Display, TEXT("%s: %d loose parameters (%d after coalescing), %d resources in %d groups: per-member %.1f ns/bind, binding program %.1f ns/bind"),
+				StructDesc.Name,
+				Bindings.Parameters.Num(), CompiledBindings.Parameters.Num(),
+				CompiledBindings.ResourceParametersByKind.Num(), CompiledBindings.ResourceParameterGroups.Num(),
+				FPlatformTime::ToMilliseconds64(PerMemberCycles) * 1.0e6 / NumIterations,
+				FPlatformTime::ToMilliseconds64(ProgramCycles) * 1.0e6 / NumIterations);
+		}
+	});
+
+	FlushRenderingCommands();
+}
+
+static FAutoConsoleCommand GBenchmarkShaderParameterBindingProgramCmd(
+	TEXT("r.ShaderParameters.BenchmarkBindingProgram"),
+	TEXT("Compares per-member shader parameter binding against the compiled binding program on synthetic parameter structs.\n")
+	TEXT("Usage: r.ShaderParameters.BenchmarkBindingProgram [NumIterations=10000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkShaderParameterBindingProgram));
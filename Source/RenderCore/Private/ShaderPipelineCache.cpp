@@ -23,6 +23,7 @@
 #include "Async/AsyncFileHandle.h"
 #include "Misc/ScopeLock.h"
 #include <Algo/RemoveIf.h>
+#include "Tasks/Task.h"
 #include "Modules/BuildVersion.h"
 
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Outstanding Tasks"), STAT_ShaderPipelineTaskCount, STATGROUP_PipelineStateCache );
@@ -280,9 +281,39 @@ static FAutoConsoleVariableRef CVarShaderPipelineCacheDoNotPrecompileRayTracingP
 );
 
 
+static int32 GShaderPipelineCacheParallelPrecompile = 1;
+static FAutoConsoleVariableRef CVarShaderPipelineCacheParallelPrecompile(
+	TEXT("r.ShaderPipelineCache.ParallelPrecompile"),
+	GShaderPipelineCacheParallelPrecompile,
+	TEXT("When enabled, precompilation outside of the Background batch mode is pipelined: PSO reads and shader preloads are kept in flight within r.ShaderPipelineCache.ParallelPrecompile.MemoryBudgetMB, ")
+	TEXT("RHI shaders are created on worker threads as soon as their code has been read and the render thread submits the PSOs whose shaders are ready for up to BatchTime ms per frame.\n")
+	TEXT("Requires an RHI that supports multithreaded shader creation. When disabled, PSOs are fetched, preloaded and compiled in batches of BatchSize on the render thread."),
+	ECVF_RenderThreadSafe
+);
+
+static int32 GShaderPipelineCacheParallelPrecompileMemoryBudgetMB = 128;
+static FAutoConsoleVariableRef CVarShaderPipelineCacheParallelPrecompileMemoryBudgetMB(
+	TEXT("r.ShaderPipelineCache.ParallelPrecompile.MemoryBudgetMB"),
+	GShaderPipelineCacheParallelPrecompileMemoryBudgetMB,
+	TEXT("Estimated memory (in MB) that PSOs being read, holding preloaded shader code or created shaders may use at any time when r.ShaderPipelineCache.ParallelPrecompile is enabled.\n")
+	TEXT("A PSO is estimated from the code size of its shaders, counted once for the preloaded code and once more for the created shaders. ")
+	TEXT("PSOs whose descriptors are still being read are estimated from the average of the PSOs preloaded so far. At least one PSO is always in flight."),
+	ECVF_RenderThreadSafe
+);
+
+/** Estimate for a PSO whose shaders haven't been looked up yet, until the average of preloaded PSOs is known. */
+static constexpr uint64 GShaderPipelineCacheDefaultJobBytes = 64 * 1024;
+
 uint32 FShaderPipelineCache::BatchSize = 0;
 float FShaderPipelineCache::BatchTime = 0.0f;
 
+static FShaderPipelineCache::BatchMode GShaderPipelineCacheBatchMode = FShaderPipelineCache::BatchMode::Fast;
+
+static bool UseParallelPrecompile()
+{
+	return GShaderPipelineCacheParallelPrecompile && GRHISupportsMultithreadedShaderCreation && GShaderPipelineCacheBatchMode != FShaderPipelineCache::BatchMode::Background;
+}
+
 class FShaderPipelineCacheArchive final : public FArchive
 {
 public:
@@ -380,6 +411,15 @@ namespace UE
 			/** Tracks whether the shaders were preloaded. */
 			bool bShadersPreloaded = false;
 
+			/** Estimated memory held by the job: the preloaded shader code, plus the created shaders once CreateShadersTask was launched. */
+			uint64 EstimatedMemoryBytes = 0;
+
+			/** Worker task creating the RHI shaders of the PSO once their code has been read. Only used for parallel precompilation. */
+			UE::Tasks::FTask CreateShadersTask;
+
+			/** Shaders created by CreateShadersTask, kept alive in the shader library cache until the PSO has been compiled. */
+			TSharedPtr<TArray<TRefCountPtr<FRHIShader>>, ESPMode::ThreadSafe> CreatedShaders;
+
 			/**
 			 * Schedules preload for all the shaders in the PSO. No shaders are preloaded if one of them isn't in the library.
 			 * Multiple jobs can request to preload the same shaders and then release them independently.
@@ -394,6 +434,12 @@ namespace UE
 			 * Multiple jobs can request to preload the same shaders and then release them independently.
 			 */
 			void ReleasePreloadedShaders();
+
+			/** Launches CreateShadersTask. The shader code reads must have completed. */
+			void LaunchCreateShaders(EShaderPlatform Platform);
+
+			/** Releases the created shaders; the task must have completed. */
+			void ReleaseCreatedShaders();
 		};
 	}
 }
@@ -429,6 +475,8 @@ public:
 	bool ReadyForPrecompile();
 	void PrecompilePipelineBatch();
 	bool ReadyForNextBatch() const;
+	uint64 GetEstimatedJobBytes() const;
+	uint64 GetInFlightMemoryBytes() const;
 	bool ReadyForAutoSave() const;
 	void PollShutdownItems();
 	void Flush();
@@ -444,6 +492,10 @@ private:
 	TDoubleLinkedList<FPipelineCacheFileFormatPSORead*> FetchTasks;
 	FGuid CacheFileGuid;
 
+	/** Totals over the jobs preloaded so far, used to estimate the memory of jobs that are still being fetched. */
+	uint64 TotalPreloadedJobBytes = 0;
+	uint64 NumPreloadedJobs = 0;
+
 	TSet<uint64> CompletedMasks;
 	FShaderPipelineCache::FShaderCachePrecompileContext PrecompileContext;
 	bool bPreOptimizing = false;
@@ -541,8 +593,9 @@ namespace UE
 					for (uint32 i = 0; i < (uint32)ShutdownReadCompileTasks.Num(); )
 					{
 						check(ShutdownReadCompileTasks[i].ReadRequests);
-						if (ShutdownReadCompileTasks[i].ReadRequests->PollExternalReadDependencies())
+						if (ShutdownReadCompileTasks[i].ReadRequests->PollExternalReadDependencies() && ShutdownReadCompileTasks[i].CreateShadersTask.IsCompleted())
 						{
+							ShutdownReadCompileTasks[i].ReleaseCreatedShaders();
 							ShutdownReadCompileTasks[i].ReleasePreloadedShaders();
 							delete ShutdownReadCompileTasks[i].ReadRequests;
 							ShutdownReadCompileTasks[i].ReadRequests = nullptr;
@@ -597,6 +650,8 @@ namespace UE
 					if (Entry.ReadRequests != nullptr)
 					{
 						Entry.ReadRequests->BlockingWaitComplete();
+						Entry.CreateShadersTask.Wait();
+						Entry.ReleaseCreatedShaders();
 						Entry.ReleasePreloadedShaders();
 						delete Entry.ReadRequests;
 						Entry.ReadRequests = nullptr;
@@ -777,6 +832,8 @@ void FShaderPipelineCache::SetBatchMode(BatchMode Mode)
 {
 	if (ShaderPipelineCache)
 	{
+		GShaderPipelineCacheBatchMode = Mode;
+
 		uint32 PreviousBatchSize = ShaderPipelineCache->BatchSize;
 		float PreviousBatchTime = ShaderPipelineCache->BatchTime;
 		switch (Mode)
@@ -1212,7 +1269,9 @@ bool UE::ShaderPipeline::CompileJob::PreloadShaders(TSet<FSHAHash>& OutRequiredS
 	bool bOK = true;
 	TArray<FSHAHash> ShadersToUnpreloadInCaseOfFailure;
 
-	auto PreloadShader = [&bOK, &ShadersToUnpreloadInCaseOfFailure](const FSHAHash& ShaderHash, FShaderPipelineCacheArchive* ReadReqs)
+	uint64 PreloadedBytes = 0;
+
+	auto PreloadShader = [&bOK, &ShadersToUnpreloadInCaseOfFailure, &PreloadedBytes](const FSHAHash& ShaderHash, FShaderPipelineCacheArchive* ReadReqs)
 	{
 		if (bOK && ShaderHash != EmptySHA)
 		{
@@ -1220,6 +1279,7 @@ bool UE::ShaderPipeline::CompileJob::PreloadShaders(TSet<FSHAHash>& OutRequiredS
 			if (bOK)
 			{
 				ShadersToUnpreloadInCaseOfFailure.Add(ShaderHash);
+				PreloadedBytes += FShaderCodeLibrary::GetShaderSizeBytes(ShaderHash);
 			}
 			UE_CLOG(!bOK, LogRHI, Verbose, TEXT("Failed to read shader: %s"), *(ShaderHash.ToString()));
 		}
@@ -1322,8 +1382,10 @@ bool UE::ShaderPipeline::CompileJob::PreloadShaders(TSet<FSHAHash>& OutRequiredS
 			FShaderCodeLibrary::ReleasePreloadedShader(PreloadedShader);
 		}
 		ShadersToUnpreloadInCaseOfFailure.Empty();
+		PreloadedBytes = 0;
 	}
 	
+	EstimatedMemoryBytes = PreloadedBytes;
 	bShadersPreloaded = bOK;
 	return bShadersPreloaded;
 }
@@ -1366,6 +1428,85 @@ void UE::ShaderPipeline::CompileJob::ReleasePreloadedShaders()
 	}
 }
 
+void UE::ShaderPipeline::CompileJob::LaunchCreateShaders(EShaderPlatform Platform)
+{
+	check(!CreatedShaders.IsValid());
+	CreatedShaders = MakeShared<TArray<TRefCountPtr<FRHIShader>>, ESPMode::ThreadSafe>();
+
+	// The created shaders are estimated at the size of their code, on top of the preloaded code that is held until the PSO is compiled.
+	EstimatedMemoryBytes *= 2;
+
+	// Creating the RHI shaders (decompression and driver compilation) is the expensive part of Precompile() that does not need the render thread.
+	// The library caches the shaders, so Precompile() only finds them while the references are held here.
+	CreateShadersTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Platform, PSO = PSO, Shaders = CreatedShaders]()
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FShaderPipelineCache::CreateShaders);
+		static FSHAHash EmptySHA;
+
+		auto AddShader = [&Shaders](FRHIShader* Shader)
+		{
+			if (Shader)
+			{
+				Shaders->Add(Shader);
+			}
+		};
+
+		if (PSO.Type == FPipelineCacheFileFormatPSO::DescriptorType::Graphics)
+		{
+			if (PSO.GraphicsDesc.MeshShader != EmptySHA)
+			{
+				if (GRHISupportsMeshShadersTier0)
+				{
+					AddShader(FShaderCodeLibrary::CreateMeshShader(Platform, PSO.GraphicsDesc.MeshShader));
+					if (PSO.GraphicsDesc.AmplificationShader != EmptySHA)
+					{
+						AddShader(FShaderCodeLibrary::CreateAmplificationShader(Platform, PSO.GraphicsDesc.AmplificationShader));
+					}
+				}
+			}
+			else
+			{
+				if (PSO.GraphicsDesc.VertexShader != EmptySHA)
+				{
+					AddShader(FShaderCodeLibrary::CreateVertexShader(Platform, PSO.GraphicsDesc.VertexShader));
+				}
+#if PLATFORM_SUPPORTS_GEOMETRY_SHADERS
+				if (PSO.GraphicsDesc.GeometryShader != EmptySHA)
+				{
+					AddShader(FShaderCodeLibrary::CreateGeometryShader(Platform, PSO.GraphicsDesc.GeometryShader));
+				}
+#endif
+			}
+
+			if (PSO.GraphicsDesc.FragmentShader != EmptySHA)
+			{
+				AddShader(FShaderCodeLibrary::CreatePixelShader(Platform, PSO.GraphicsDesc.FragmentShader));
+			}
+		}
+		else if (PSO.Type == FPipelineCacheFileFormatPSO::DescriptorType::Compute)
+		{
+			if (!GShaderPipelineCacheDoNotPrecompileComputePSO)
+			{
+				AddShader(FShaderCodeLibrary::CreateComputeShader(Platform, PSO.ComputeDesc.ComputeShader));
+			}
+		}
+		else if (PSO.Type == FPipelineCacheFileFormatPSO::DescriptorType::RayTracing)
+		{
+			if (!GShaderPipelineCacheDoNotPrecompileRayTracingPSO && IsRayTracingEnabled())
+			{
+				AddShader(FShaderCodeLibrary::CreateRayTracingShader(Platform, PSO.RayTracingDesc.ShaderHash, PSO.RayTracingDesc.Frequency));
+			}
+		}
+	});
+}
+
+void UE::ShaderPipeline::CompileJob::ReleaseCreatedShaders()
+{
+	check(CreateShadersTask.IsCompleted());
+	CreateShadersTask = UE::Tasks::FTask();
+	CreatedShaders.Reset();
+}
+
 void FShaderPipelineCacheTask::PreparePipelineBatch(TDoubleLinkedList<FPipelineCacheFileFormatPSORead*>& PipelineBatch)
 {
 	TDoubleLinkedList<FPipelineCacheFileFormatPSORead*>::TDoubleLinkedListNode* CurrentNode = PipelineBatch.GetHead();
@@ -1406,6 +1547,8 @@ void FShaderPipelineCacheTask::PreparePipelineBatch(TDoubleLinkedList<FPipelineC
 			// Otherwise this job needs to be put in the shutdown list to correctly release shader code
 			if (bOK && bCompatible)
 			{
+				TotalPreloadedJobBytes += AsyncJob.EstimatedMemoryBytes;
+				NumPreloadedJobs++;
 				ReadTasks.Add(AsyncJob);
 			}
 			else
@@ -1465,12 +1608,34 @@ static FAutoConsoleVariableRef GPipelinePrecompileTasksInFlightVar(
 
 bool FShaderPipelineCacheTask::ReadyForPrecompile()
 {
+	const bool bParallelPrecompile = UseParallelPrecompile();
+
 	for(uint32 i = 0; i < (uint32)ReadTasks.Num();/*NOP*/)
 	{
-		check(ReadTasks[i].ReadRequests);
-		if (ReadTasks[i].ReadRequests->PollExternalReadDependencies())
+		UE::ShaderPipeline::CompileJob& ReadTask = ReadTasks[i];
+		check(ReadTask.ReadRequests);
+
+		bool bReadyToCompile = false;
+		if (ReadTask.CreateShadersTask.IsValid())
+		{
+			bReadyToCompile = ReadTask.CreateShadersTask.IsCompleted();
+		}
+		else if (ReadTask.ReadRequests->PollExternalReadDependencies())
 		{
-			CompileTasks.Add(ReadTasks[i]);
+			// Chain the shader creation onto the completed reads. Jobs stay in ReadTasks until their shaders exist.
+			if (bParallelPrecompile)
+			{
+				ReadTask.LaunchCreateShaders(ShaderPlatform);
+			}
+			else
+			{
+				bReadyToCompile = true;
+			}
+		}
+
+		if (bReadyToCompile)
+		{
+			CompileTasks.Add(ReadTask);
 			ReadTasks.RemoveAt(i);
 		}
 		else
@@ -1488,23 +1653,36 @@ void FShaderPipelineCacheTask::PrecompilePipelineBatch()
 	INC_DWORD_STAT(STAT_PreCompileBatchTotal);
 	INC_DWORD_STAT(STAT_PreCompileBatchNum);
 	
-    int32 NumToPrecompile = FMath::Min<int32>(CompileTasks.Num(), FShaderPipelineCache::BatchSize);
+	// With parallel precompilation the shaders were already created on worker threads and the PSO compiles themselves are asynchronous,
+	// so the render thread submits as many ready PSOs as fit in the time budget instead of a fixed batch.
+	const bool bUseTimeBudget = UseParallelPrecompile() && FShaderPipelineCache::BatchTime > 0.0f;
+	const int32 MaxToPrecompile = bUseTimeBudget ? CompileTasks.Num() : FMath::Min<int32>(CompileTasks.Num(), FShaderPipelineCache::BatchSize);
+	const uint64 TimeBudgetCycles = bUseTimeBudget ? uint64(FShaderPipelineCache::BatchTime / (1000.0 * FPlatformTime::GetSecondsPerCycle64())) : 0;
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	int32 NumToPrecompile = 0;
 
 	FShaderPipelineCacheTask* UserCacheTask = FShaderPipelineCache::Get()->GetTask(FShaderPipelineCache::UserCacheTaskKey);
 
-	for(uint32 i = 0; i < (uint32)NumToPrecompile; i++)
+	for(uint32 i = 0; i < (uint32)MaxToPrecompile; i++)
 	{
+		if (bUseTimeBudget && i > 0 && FPlatformTime::Cycles64() - StartCycles >= TimeBudgetCycles)
+		{
+			break;
+		}
+
 		UE::ShaderPipeline::CompileJob& CompileTask = CompileTasks[i];
+		++NumToPrecompile;
 		
 		check(CompileTask.ReadRequests && CompileTask.ReadRequests->PollExternalReadDependencies());
 		
 		FRHICommandListImmediate& RHICmdList = GRHICommandList.GetImmediateCommandList();
 		
 		uint32 PSOHash = GetTypeHash(CompileTask.PSO);
-		UE_LOG(LogRHI, Verbose, TEXT("Precompiling PSO %u (type %d) (%d/%d)"), PSOHash, int(CompileTask.PSO.Type), i+1, NumToPrecompile);
+		UE_LOG(LogRHI, Verbose, TEXT("Precompiling PSO %u (type %d) (%d/%d)"), PSOHash, int(CompileTask.PSO.Type), i+1, MaxToPrecompile);
 		Precompile(RHICmdList, GMaxRHIShaderPlatform, CompileTask.PSO);
 		FShaderPipelineCache::Get()->CompiledHashes.Add(PSOHash);
 
+		CompileTask.ReleaseCreatedShaders();
 		CompileTask.ReleasePreloadedShaders();
 		delete CompileTask.ReadRequests;
 		CompileTask.ReadRequests = nullptr;
@@ -1544,9 +1722,34 @@ void FShaderPipelineCacheTask::PrecompilePipelineBatch()
 
 bool FShaderPipelineCacheTask::ReadyForNextBatch() const
 {
+	if (UseParallelPrecompile())
+	{
+		const uint64 InFlightBytes = GetInFlightMemoryBytes();
+		return InFlightBytes == 0 || InFlightBytes < uint64(FMath::Max(GShaderPipelineCacheParallelPrecompileMemoryBudgetMB, 0)) * 1024 * 1024;
+	}
 	return ReadTasks.Num() == 0;
 }
 
+uint64 FShaderPipelineCacheTask::GetEstimatedJobBytes() const
+{
+	// Preloaded code is doubled once the shaders are created, see CompileJob::LaunchCreateShaders. Libraries that don't report code sizes keep the default.
+	return TotalPreloadedJobBytes > 0 ? FMath::Max<uint64>(2 * TotalPreloadedJobBytes / NumPreloadedJobs, sizeof(UE::ShaderPipeline::CompileJob)) : GShaderPipelineCacheDefaultJobBytes;
+}
+
+uint64 FShaderPipelineCacheTask::GetInFlightMemoryBytes() const
+{
+	uint64 Bytes = FetchTasks.Num() * GetEstimatedJobBytes();
+	for (const UE::ShaderPipeline::CompileJob& ReadTask : ReadTasks)
+	{
+		Bytes += FMath::Max<uint64>(ReadTask.EstimatedMemoryBytes, sizeof(UE::ShaderPipeline::CompileJob));
+	}
+	for (const UE::ShaderPipeline::CompileJob& CompileTask : CompileTasks)
+	{
+		Bytes += FMath::Max<uint64>(CompileTask.EstimatedMemoryBytes, sizeof(UE::ShaderPipeline::CompileJob));
+	}
+	return Bytes;
+}
+
 void FShaderPipelineCacheTask::Flush()
 {
 	// reset everything
@@ -1598,11 +1801,13 @@ FShaderPipelineCache::FShaderPipelineCache(EShaderPlatform Platform)
 		case 2:
 			BatchSize = CVarPSOFileCacheBackgroundBatchSize.GetValueOnAnyThread();
 			BatchTime = CVarPSOFileCacheBackgroundBatchTime.GetValueOnAnyThread();
+			GShaderPipelineCacheBatchMode = BatchMode::Background;
 			break;
 		case 1:
 		default:
 			BatchSize = CVarPSOFileCacheBatchSize.GetValueOnAnyThread();
 			BatchTime = CVarPSOFileCacheBatchTime.GetValueOnAnyThread();
+			GShaderPipelineCacheBatchMode = BatchMode::Fast;
 			break;
 	}
 	
@@ -1892,7 +2097,8 @@ void FShaderPipelineCacheTask::Tick(float DeltaTime)
 
 		uint32 End = FPlatformTime::Cycles();
 
-		if (FShaderPipelineCache::BatchTime > 0.0f)
+		// The parallel pipeline applies BatchTime directly in PrecompilePipelineBatch.
+		if (FShaderPipelineCache::BatchTime > 0.0f && !UseParallelPrecompile())
 		{
 			float ElapsedMs = FPlatformTime::ToMilliseconds(End - Start);
 			if (ElapsedMs < FShaderPipelineCache::BatchTime)
@@ -1915,18 +2121,39 @@ void FShaderPipelineCacheTask::Tick(float DeltaTime)
 	
 	if (ReadyForNextBatch() && (OrderedCompileTasks.Num() || FetchTasks.Num()))
 	{
+		const bool bParallelPrecompile = UseParallelPrecompile();
+
         uint32 Num = 0;
-        if (FShaderPipelineCache::BatchSize > static_cast<uint32>(FetchTasks.Num()))
-        {
-            Num = FShaderPipelineCache::BatchSize - FetchTasks.Num();
-        }
-        Num = FMath::Min(Num, (uint32)OrderedCompileTasks.Num());
+		bool bFetchNewBatch = false;
+		if (bParallelPrecompile)
+		{
+			// Refill the pipeline up to the memory budget; reads, shader creation and PSO compilation of earlier jobs overlap with these.
+			// ReadyForNextBatch() guarantees some budget is left, so at least one PSO is fetched even if it alone exceeds the budget.
+			const uint64 BudgetBytes = uint64(FMath::Max(GShaderPipelineCacheParallelPrecompileMemoryBudgetMB, 0)) * 1024 * 1024;
+			const uint64 InFlightBytes = GetInFlightMemoryBytes();
+			const uint64 FreeBytes = BudgetBytes > InFlightBytes ? BudgetBytes - InFlightBytes : 0;
+			Num = (uint32)FMath::Min<uint64>(FMath::Max<uint64>(FreeBytes / GetEstimatedJobBytes(), 1), (uint64)OrderedCompileTasks.Num());
+			bFetchNewBatch = Num > 0;
+		}
+		else
+		{
+			if (FShaderPipelineCache::BatchSize > static_cast<uint32>(FetchTasks.Num()))
+			{
+				Num = FShaderPipelineCache::BatchSize - FetchTasks.Num();
+			}
+			Num = FMath::Min(Num, (uint32)OrderedCompileTasks.Num());
+
+			bFetchNewBatch = FetchTasks.Num() < (int32)Num;
+			if (bFetchNewBatch)
+			{
+				Num -= FetchTasks.Num();
+			}
+		}
             
-		if (FetchTasks.Num() < (int32)Num)
+		if (bFetchNewBatch)
 		{
 			TDoubleLinkedList<FPipelineCacheFileFormatPSORead*> NewBatch;
 		
-			Num -= FetchTasks.Num();
             for (int32 Index = OrderedCompileTasks.Num() - 1; Index >= 0 && Num > 0; --Index)
             {
                 bool bHasShaders = true;
@@ -1954,7 +2181,7 @@ void FShaderPipelineCacheTask::Tick(float DeltaTime)
 			FPipelineFileCacheManager::FetchPSODescriptors(PSOCacheKey, NewBatch);
 		}
 
-        if (static_cast<uint32>(FetchTasks.Num()) > FShaderPipelineCache::BatchSize)
+        if (!bParallelPrecompile && static_cast<uint32>(FetchTasks.Num()) > FShaderPipelineCache::BatchSize)
         {
             UE_LOG(LogRHI, Warning, TEXT("FShaderPipelineCache: Attempting to pre-compile more jobs (%d) than the batch size (%d)"), FetchTasks.Num(), FShaderPipelineCache::BatchSize);
         }
@@ -1,6 +1,9 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "UnifiedBuffer.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "RenderCore.h"
 #include "Containers/ResourceArray.h"
 #include "RHI.h"
 #include "ShaderParameters.h"
@@ -913,6 +916,12 @@ void FRDGScatterUploader::Lock(FRHICommandListBase& RHICmdList)
 void FRDGScatterUploader::Unlock(FRHICommandListBase& RHICmdList)
 {
 	check(State == EState::Locked);
+
+	// Producers are joined before Unlock, so every reserved slot has been written by now.
+	const uint32 NumReservedScatters = NumConcurrentScatters.exchange(0, std::memory_order_acquire);
+	check(NumReservedScatters == 0 || NumScatters == 0);
+	NumScatters += NumReservedScatters;
+
 	State = EState::Unlocked;
 	RHICmdList.UnlockBuffer(ScatterBuffer);
 	RHICmdList.UnlockBuffer(UploadBuffer);
@@ -1076,6 +1085,104 @@ UE::Tasks::FTask FRDGScatterUploadBuilder::Execute(FRDGBuilder& GraphBuilder)
 	return Task;
 }
 
+/** Fills an uploader backed by CPU memory from a varying number of concurrent producers to measure reservation scaling. */
+class FRDGScatterUploaderProducerBenchmark final : public FRDGScatterUploader
+{
+public:
+	FRDGScatterUploaderProducerBenchmark(uint32 InMaxScatters, uint32 InNumBytesPerElement)
+	{
+		MaxScatters = InMaxScatters;
+		NumBytesPerElement = InNumBytesPerElement;
+		ScatterData = (uint32*)FMemory::Malloc(MaxScatters * sizeof(uint32));
+		UploadData = (uint8*)FMemory::Malloc(MaxScatters * NumBytesPerElement);
+	}
+
+	~FRDGScatterUploaderProducerBenchmark()
+	{
+		FMemory::Free(ScatterData);
+		FMemory::Free(UploadData);
+	}
+
+	/** Returns whether every destination in [0, MaxScatters) was written exactly once with its matching payload. */
+	bool Validate() const
+	{
+		TBitArray<> Written(false, MaxScatters);
+
+		for (uint32 Slot = 0; Slot < MaxScatters; ++Slot)
+		{
+			const uint32 Index = ScatterData[Slot];
+
+			if (Index >= MaxScatters || Written[Index] || *reinterpret_cast<const uint32*>(UploadData + Slot * NumBytesPerElement) != Index)
+			{
+				return false;
+			}
+
+			Written[Index] = true;
+		}
+
+		return true;
+	}
+
+	static void Run(const TArray<FString>& Args)
+	{
+		const uint32 NumElements = Args.Num() > 0 ? (uint32)FMath::Max(FCString::Atoi(*Args[0]), 1) : 1u << 20;
+		const uint32 NumBytesPerElement = Args.Num() > 1 ? (uint32)FMath::Max(FCString::Atoi(*Args[1]) & ~3, 4) : 64u;
+		const uint32 NumElementsPerBatch = 64;
+
+		UE_LOG(LogRendererCore, Display, TEXT("Scatter uploader producer scaling: %u elements of %u bytes, %d worker threads"),
+			NumElements, NumBytesPerElement, FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+		double SingleProducerMilliseconds = 0.0;
+
+		for (int32 NumProducers = 1; NumProducers <= 32; NumProducers *= 2)
+		{
+			FRDGScatterUploaderProducerBenchmark Uploader(NumElements, NumBytesPerElement);
+
+			const uint32 NumElementsPerProducer = FMath::DivideAndRoundUp(NumElements, (uint32)NumProducers);
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+
+			ParallelFor(NumProducers, [&](int32 ProducerIndex)
+			{
+				const uint32 FirstIndex = ProducerIndex * NumElementsPerProducer;
+				const uint32 LastIndex = FMath::Min(FirstIndex + NumElementsPerProducer, NumElements);
+
+				for (uint32 BatchIndex = FirstIndex; BatchIndex < LastIndex; BatchIndex += NumElementsPerBatch)
+				{
+					const uint32 NumBatchElements = FMath::Min(NumElementsPerBatch, LastIndex - BatchIndex);
+					uint8* Data = (uint8*)Uploader.AddConcurrent_GetRef(BatchIndex, NumBatchElements);
+
+					for (uint32 Index = 0; Index < NumBatchElements; ++Index, Data += NumBytesPerElement)
+					{
+						FMemory::Memset(Data, 0, NumBytesPerElement);
+						*reinterpret_cast<uint32*>(Data) = BatchIndex + Index;
+					}
+				}
+			}, EParallelForFlags::Unbalanced);
+
+			const double Milliseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+			if (NumProducers == 1)
+			{
+				SingleProducerMilliseconds = Milliseconds;
+			}
+
+			UE_LOG(LogRendererCore, Display, TEXT("  %2d producers: %.3f ms, %.2f GB/s, %.2fx%s"),
+				NumProducers,
+				Milliseconds,
+				double(NumElements) * (NumBytesPerElement + sizeof(uint32)) / (Milliseconds * 1.0e6),
+				SingleProducerMilliseconds / FMath::Max(Milliseconds, UE_DOUBLE_SMALL_NUMBER),
+				Uploader.Validate() ? TEXT("") : TEXT(" (VALIDATION FAILED)"));
+		}
+	}
+};
+
+static FAutoConsoleCommand GBenchmarkScatterUploaderProducersCmd(
+	TEXT("r.ScatterUpload.BenchmarkProducers"),
+	TEXT("Fills a CPU backed scatter uploader from 1 to 32 concurrent producers using AddConcurrent_GetRef and reports the scaling.\n")
+	TEXT("Usage: r.ScatterUpload.BenchmarkProducers [NumElements=1048576] [NumBytesPerElement=64]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FRDGScatterUploaderProducerBenchmark::Run));
+
 template<typename ResourceType>
 void MemsetResource(FRHICommandList& RHICmdList, const ResourceType& DstBuffer, const FMemsetResourceParams& Params)
 {
@@ -1507,7 +1614,7 @@ void FScatterUploadBuffer::Init( uint32 NumElements, uint32 InNumBytesPerElement
 	uint32 UploadBytes = NumElements * NumBytesPerElement;
 	uint32 UploadBufferSize = FMath::RoundUpToPowerOfTwo( UploadBytes );
 
-	if (bUploadViaCreate)
+	if (UsesCPUStaging())
 	{
 		if (ScatterBytes > ScatterDataSize || ScatterBufferSize < ScatterDataSize / 2)
 		{
@@ -1523,10 +1630,15 @@ void FScatterUploadBuffer::Init( uint32 NumElements, uint32 InNumBytesPerElement
 			UploadDataSize = UploadBufferSize;
 		}
 	}
-	else
+
+	if (!bUploadViaCreate)
 	{
-		check(ScatterData == nullptr);
-		check(UploadData == nullptr);
+		// Coalesced uploads are staged on the CPU and only lock the buffers once the final sizes are known.
+		if (Mode == EMode::Default)
+		{
+			check(ScatterData == nullptr);
+			check(UploadData == nullptr);
+		}
 
 		if (ScatterBytes > ScatterBuffer.NumBytes || ScatterBufferSize < ScatterBuffer.NumBytes / 2)
 		{
@@ -1556,8 +1668,11 @@ void FScatterUploadBuffer::Init( uint32 NumElements, uint32 InNumBytesPerElement
 			UploadBuffer.SRV = RHICmdList.CreateShaderResourceView(UploadBuffer.Buffer, FRHIViewDesc::CreateBufferSRV().SetTypeFromBuffer(UploadBuffer.Buffer));
 		}
 
-		ScatterData = (uint32*)RHICmdList.LockBuffer(ScatterBuffer.Buffer, 0, ScatterBytes, RLM_WriteOnly);
-		UploadData = (uint8*)RHICmdList.LockBuffer(UploadBuffer.Buffer, 0, UploadBytes, RLM_WriteOnly);
+		if (Mode == EMode::Default)
+		{
+			ScatterData = (uint32*)RHICmdList.LockBuffer(ScatterBuffer.Buffer, 0, ScatterBytes, RLM_WriteOnly);
+			UploadData = (uint8*)RHICmdList.LockBuffer(UploadBuffer.Buffer, 0, UploadBytes, RLM_WriteOnly);
+		}
 	}
 }
 
@@ -1574,11 +1689,58 @@ void FScatterUploadBuffer::InitPreSized(uint32 NumElements, uint32 InNumBytesPer
 	NumScatters = NumElements;
 }
 
+uint32 FScatterUploadBuffer::CoalesceScatters(uint32* DstScatterData, uint8* DstUploadData) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FScatterUploadBuffer::CoalesceScatters);
+	check(ScatterData && UploadData);
+
+	// Key each element by its destination, then by write order, so the last write to each destination sorts last.
+	TArray<uint64> Keys;
+	Keys.SetNumUninitialized(NumScatters);
+
+	bool bStrictlyIncreasing = true;
+	for (uint32 Index = 0; Index < NumScatters; ++Index)
+	{
+		Keys[Index] = (uint64(ScatterData[Index]) << 32) | Index;
+		bStrictlyIncreasing &= Index == 0 || ScatterData[Index] > ScatterData[Index - 1];
+	}
+
+	// Strictly increasing destinations are already sorted and contain no duplicates.
+	if (!bStrictlyIncreasing)
+	{
+		Algo::Sort(Keys);
+	}
+
+	const auto GetDstIndex = [](uint64 Key) { return uint32(Key >> 32); };
+	const auto GetSrcIndex = [](uint64 Key) { return uint32(Key); };
+
+	// Keep only the last write to each destination. The survivors use the regular one scatter index per element layout.
+	uint32 NumElements = 0;
+
+	for (uint32 Index = 0; Index < NumScatters; ++Index)
+	{
+		const uint32 DstIndex = GetDstIndex(Keys[Index]);
+
+		if (Index + 1 < NumScatters && GetDstIndex(Keys[Index + 1]) == DstIndex)
+		{
+			continue;
+		}
+
+		DstScatterData[NumElements] = DstIndex;
+		FMemory::Memcpy(DstUploadData + NumElements * NumBytesPerElement, UploadData + GetSrcIndex(Keys[Index]) * NumBytesPerElement, NumBytesPerElement);
+		NumElements++;
+	}
+
+	return NumElements;
+}
+
 template<typename ResourceType>
 void FScatterUploadBuffer::ResourceUploadTo(FRHICommandList& RHICmdList, const ResourceType& DstBuffer, bool bFlush)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(FScatterUploadBuffer::ResourceUploadTo);
 
+	uint32 NumUploadScatters = NumScatters;
+
 	if (bUploadViaCreate)
 	{
 		ScatterBuffer.Release();
@@ -1587,18 +1749,46 @@ void FScatterUploadBuffer::ResourceUploadTo(FRHICommandList& RHICmdList, const R
 		ScatterBuffer.NumBytes = ScatterDataSize;
 		UploadBuffer.NumBytes = UploadDataSize;
 
+		const uint32* SrcScatterData = ScatterData;
+		const uint8* SrcUploadData = UploadData;
+		TArray<uint32> CoalescedScatterData;
+		TArray<uint8> CoalescedUploadData;
+
+		if (Mode == EMode::Coalesce && NumScatters > 0)
+		{
+			CoalescedScatterData.SetNumUninitialized(ScatterDataSize / sizeof(uint32));
+			CoalescedUploadData.SetNumUninitialized(UploadDataSize);
+			NumUploadScatters = CoalesceScatters(CoalescedScatterData.GetData(), CoalescedUploadData.GetData());
+
+			SrcScatterData = CoalescedScatterData.GetData();
+			SrcUploadData = CoalescedUploadData.GetData();
+		}
+
 		const uint32 TypeSize = bFloat4Buffer ? 16 : 4;
 		const EBufferUsageFlags Usage = EBufferUsageFlags::StructuredBuffer | EBufferUsageFlags::ShaderResource | EBufferUsageFlags::Volatile | (bFloat4Buffer ? EBufferUsageFlags::None : EBufferUsageFlags::ByteAddressBuffer);
 
 		{
-			ScatterBuffer.Buffer = UE::RHIResourceUtils::CreateBufferFromArray(RHICmdList, TEXT("ScatterResourceArray"), Usage, sizeof(uint32), ScatterData, ScatterDataSize);
+			ScatterBuffer.Buffer = UE::RHIResourceUtils::CreateBufferFromArray(RHICmdList, TEXT("ScatterResourceArray"), Usage, sizeof(uint32), SrcScatterData, ScatterDataSize);
 			ScatterBuffer.SRV = RHICmdList.CreateShaderResourceView(ScatterBuffer.Buffer, FRHIViewDesc::CreateBufferSRV().SetTypeFromBuffer(ScatterBuffer.Buffer));
 		}
 		{
-			UploadBuffer.Buffer = UE::RHIResourceUtils::CreateBufferFromArray(RHICmdList, TEXT("ScatterUploadBuffer"), Usage, TypeSize, UploadData, UploadDataSize);
+			UploadBuffer.Buffer = UE::RHIResourceUtils::CreateBufferFromArray(RHICmdList, TEXT("ScatterUploadBuffer"), Usage, TypeSize, SrcUploadData, UploadDataSize);
 			UploadBuffer.SRV = RHICmdList.CreateShaderResourceView(UploadBuffer.Buffer, FRHIViewDesc::CreateBufferSRV().SetTypeFromBuffer(UploadBuffer.Buffer));
 		}
 	}
+	else if (Mode == EMode::Coalesce)
+	{
+		if (NumScatters > 0)
+		{
+			uint32* LockedScatterData = (uint32*)RHICmdList.LockBuffer(ScatterBuffer.Buffer, 0, NumScatters * sizeof(uint32), RLM_WriteOnly);
+			uint8* LockedUploadData = (uint8*)RHICmdList.LockBuffer(UploadBuffer.Buffer, 0, NumScatters * NumBytesPerElement, RLM_WriteOnly);
+
+			NumUploadScatters = CoalesceScatters(LockedScatterData, LockedUploadData);
+
+			RHICmdList.UnlockBuffer(ScatterBuffer.Buffer);
+			RHICmdList.UnlockBuffer(UploadBuffer.Buffer);
+		}
+	}
 	else
 	{
 		RHICmdList.UnlockBuffer(ScatterBuffer.Buffer);
@@ -1614,7 +1804,7 @@ void FScatterUploadBuffer::ResourceUploadTo(FRHICommandList& RHICmdList, const R
 	}
 
 	const FScatterUploadConfig Config = GetScatterUploadConfig(NumBytesPerElement);
-	const FScatterUploadDispatchConfig DispatchConfig = GetScatterUploadDispatchConfig(Config, NumScatters);
+	const FScatterUploadDispatchConfig DispatchConfig = GetScatterUploadDispatchConfig(Config, NumUploadScatters);
 
 	EByteBufferResourceType ResourceTypeEnum;
 
@@ -1622,7 +1812,7 @@ void FScatterUploadBuffer::ResourceUploadTo(FRHICommandList& RHICmdList, const R
 	Parameters.Common.Size = Config.NumThreadsPerScatter;
 	Parameters.Common.SrcOffset = 0;
 	Parameters.Common.DstOffset = 0;
-	Parameters.NumScatters = NumScatters;
+	Parameters.NumScatters = NumUploadScatters;
 
 	check(bFloat4Buffer || ResourceTypeTraits<ResourceType>::Type == EResourceType::BYTEBUFFER);
 
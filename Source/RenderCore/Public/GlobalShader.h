@@ -238,6 +238,11 @@ public:
 
 	RENDERCORE_API void BeginCreateAllShaders();
 
+#if !UE_BUILD_SHIPPING
+	/** Compares hash chain and lookup index performance over every section of the map. */
+	RENDERCORE_API void BenchmarkShaderLookup(int32 NumIterations, FOutputDevice& Out) const;
+#endif // !UE_BUILD_SHIPPING
+
 #if WITH_EDITOR
 	RENDERCORE_API void GetOutdatedTypes(TArray<const FShaderType*>& OutdatedShaderTypes, TArray<const FShaderPipelineType*>& OutdatedShaderPipelineTypes, TArray<const FVertexFactoryType*>& OutdatedFactoryTypes) const;
 	RENDERCORE_API void SaveShaderStableKeys(EShaderPlatform TargetShaderPlatform);
@@ -68,6 +68,25 @@ namespace PipelineCacheUtilities
 	 */
 	RENDERCORE_API bool LoadStableKeysFile(const FStringView& Filename, TArray<FStableShaderKeyAndValue>& InOutArray);
 
+	/**
+	 * Loads a text stable shader keys file (.scl.csv), one FStableShaderKeyAndValue::ToString() line per key. The file is streamed in blocks
+	 * that are parsed in parallel while the next block is read. Lines that are not stable keys (e.g. the header line) are skipped.
+	 *
+	 * @param Filename filename (with path if needed)
+	 * @param InOutArray array to put the file contents, in file order. Existing array contents will be preserved and appended to
+	 * @return true if successful
+	 */
+	RENDERCORE_API bool LoadStableKeysTextFile(const FStringView& Filename, TArray<FStableShaderKeyAndValue>& InOutArray);
+
+	/**
+	 * Parses text stable shader keys already in memory, see LoadStableKeysTextFile. The text is split into line aligned chunks that are
+	 * parsed in parallel, each with its own name cache.
+	 *
+	 * @param Text contents of a text stable shader keys file
+	 * @param InOutArray array to put the parsed keys, in text order. Existing array contents will be preserved and appended to
+	 */
+	RENDERCORE_API void ParseStableKeysText(const FStringView& Text, TArray<FStableShaderKeyAndValue>& InOutArray);
+
 #if WITH_EDITOR	// limit what's compiled for the cooked games
 
 	/** 
@@ -23,14 +23,8 @@ class FRDGAllocator;
 class FRDGAllocator
 {
 public:
-	class FObject
-	{
-	public:
-		virtual ~FObject() = default;
-	};
-
 	template <typename T>
-	class TObject final : FObject
+	class TObject final
 	{
 		friend class FRDGAllocator;
 	private:
@@ -42,6 +36,9 @@ public:
 		T Alloc;
 	};
 
+	/** Size of the pages the allocator carves allocations out of. Larger allocations receive a dedicated page. */
+	static constexpr uint32 PageSize = 64 * 1024;
+
 	RENDERCORE_API static FRDGAllocator& GetTLS();
 
 	FRDGAllocator();
@@ -52,19 +49,11 @@ public:
 	/** Allocates raw memory. */
 	inline void* Alloc(uint64 SizeInBytes, uint32 AlignInBytes)
 	{
-		void* Memory;
-
 #if RDG_ALLOCATOR_DEBUG
 		AcquireAccess();
 #endif
 
-#if RDG_USE_MALLOC
-		Memory = FMemory::Malloc(SizeInBytes, AlignInBytes);
-		Mallocs.Emplace(Memory);
-		NumMallocBytes += SizeInBytes;
-#else
-		Memory = MemStack.Alloc(SizeInBytes, AlignInBytes);
-#endif
+		void* Memory = AllocInternal(SizeInBytes, AlignInBytes);
 
 #if RDG_ALLOCATOR_DEBUG
 		ReleaseAccess();
@@ -80,7 +69,7 @@ public:
 		return reinterpret_cast<PODType*>(Alloc(sizeof(PODType) * Count, alignof(PODType)));
 	}
 
-	/** Allocates and constructs an object and tracks it for destruction. */
+	/** Allocates and constructs an object and tracks it for destruction. Trivially destructible types are not tracked. */
 	template <typename T, typename... TArgs>
 	inline T* Alloc(TArgs&&... Args)
 	{
@@ -88,14 +77,13 @@ public:
 		AcquireAccess();
 #endif
 
-#if RDG_USE_MALLOC
-		TObject<T>* Object = new TObject<T>(Forward<TArgs&&>(Args)...);
-		NumMallocBytes += sizeof(Object);
-#else
-		TObject<T>* Object = new(MemStack) TObject<T>(Forward<TArgs&&>(Args)...);
-#endif
+		TObject<T>* Object = new(AllocInternal(sizeof(TObject<T>), alignof(TObject<T>))) TObject<T>(Forward<TArgs&&>(Args)...);
 		check(Object);
-		Objects.Add(Object);
+
+		if constexpr (!std::is_trivially_destructible_v<TObject<T>>)
+		{
+			GetTypeBatch<T>().Objects.Add(Object);
+		}
 
 #if RDG_ALLOCATOR_DEBUG
 		ReleaseAccess();
@@ -115,20 +103,103 @@ public:
 #if RDG_USE_MALLOC
 		return static_cast<int32>(NumMallocBytes);
 #else
-		return MemStack.GetByteCount();
+		return static_cast<int32>(NumPageBytes - (End - Top));
 #endif
 	}
 
 	void ReleaseAll();
 
+	/** Returns the number of pages currently held by the process-wide page cache. */
+	RENDERCORE_API static int32 GetNumCachedPages();
+
+	/** Frees pages from the process-wide page cache until it holds at most NumPagesToKeep pages. */
+	RENDERCORE_API static void TrimPageCache(int32 NumPagesToKeep = 0);
+
 private:
+	/** All tracked objects of one type, destructed together in a single non-virtual loop. */
+	struct FTypeBatch
+	{
+		using FDestructFunction = void(void* const* Objects, int32 NumObjects);
+
+		FDestructFunction* Destruct = nullptr;
+		TArray<void*> Objects;
+	};
+
+	template <typename T>
+	static void DestructObjects(void* const* Objects, int32 NumObjects)
+	{
+		for (int32 Index = NumObjects - 1; Index >= 0; --Index)
+		{
+			static_cast<TObject<T>*>(Objects[Index])->~TObject();
+		}
+	}
+
+	template <typename T>
+	inline FTypeBatch& GetTypeBatch()
+	{
+		static const int32 TypeIndex = AllocateTypeIndex();
+
+		if (TypeIndex >= TypeBatches.Num())
+		{
+			TypeBatches.SetNum(TypeIndex + 1);
+		}
+
+		FTypeBatch& Batch = TypeBatches[TypeIndex];
+
+		if (!Batch.Destruct)
+		{
+			Batch.Destruct = &DestructObjects<T>;
+			TypeBatchOrder.Emplace(TypeIndex);
+		}
+
+		return Batch;
+	}
+
+	RENDERCORE_API static int32 AllocateTypeIndex();
+
+	inline void* AllocInternal(uint64 SizeInBytes, uint32 AlignInBytes)
+	{
+#if RDG_USE_MALLOC
+		void* Memory = FMemory::Malloc(SizeInBytes, AlignInBytes);
+		Mallocs.Emplace(Memory);
+		NumMallocBytes += SizeInBytes;
+		return Memory;
+#else
+		uint8* Memory = Align(Top, AlignInBytes);
+
+		if (UNLIKELY(!Top || Memory + SizeInBytes > End))
+		{
+			return AllocPage(SizeInBytes, AlignInBytes);
+		}
+
+		Top = Memory + SizeInBytes;
+		return Memory;
+#endif
+	}
+
 #if RDG_USE_MALLOC
 	TArray<void*> Mallocs;
 	uint64 NumMallocBytes = 0;
 #else
-	FMemStackBase MemStack;
+	/** Header placed at the start of each page. Pages form a singly linked list, most recent first. */
+	struct FPage
+	{
+		FPage* Next;
+		uint64 Size;
+	};
+
+	RENDERCORE_API void* AllocPage(uint64 SizeInBytes, uint32 AlignInBytes);
+	void ReleasePages();
+
+	FPage* Pages = nullptr;
+	uint8* Top = nullptr;
+	uint8* End = nullptr;
+	uint64 NumPageBytes = 0;
 #endif
-	TArray<FObject*> Objects;
+
+	/** Destruction batches indexed by type index, and the type indices in order of first use. */
+	TArray<FTypeBatch> TypeBatches;
+	TArray<int32> TypeBatchOrder;
 
 #if RDG_ALLOCATOR_DEBUG
 	RENDERCORE_API void AcquireAccess();
@@ -34,6 +34,7 @@
 
 enum class ERenderTargetTexture : uint8;
 struct FParallelPassSet;
+struct FRDGCompileCacheEntry;
 struct FRHIRenderPassInfo;
 struct FRHITrackedAccessInfo;
 struct FRHITransientAliasingInfo;
@@ -484,6 +485,15 @@ private:
 	uint32 AsyncComputePassCount = 0;
 	uint32 RasterPassCount = 0;
 
+	/** Whether passes hash their resource accesses for the compile cache. Latched at construction so every pass of the graph agrees. */
+	bool bCompileCacheEnabled = false;
+
+	/** Pass barriers recorded by an earlier graph with the same compile cache key and replayed by this one, or the entry this graph
+	 *  records for later graphs. At most one is set, and only between Compile and the collection of pass barriers.
+	 */
+	TSharedPtr<const FRDGCompileCacheEntry, ESPMode::ThreadSafe> CompileCacheReplayEntry;
+	TSharedPtr<FRDGCompileCacheEntry, ESPMode::ThreadSafe> CompileCacheRecordEntry;
+
 	/** Tracks dispatch passes that need to launch tasks. */
 	TArray<FRDGDispatchPass*, FRDGArrayAllocator> DispatchPasses;
 
@@ -528,6 +538,7 @@ private:
 
 	void Compile();
 	void CompilePassOps(FRDGPass* Pass);
+	uint64 ComputeCompileCacheKey() const;
 
 	void ExecuteSerialPass(FRHIComputeCommandList& RHICmdListPass, FRDGPass* Pass);
 
@@ -692,6 +703,7 @@ private:
 
 	/** Allocates resources using the provided lifetime op arrays. */
 	void AllocateTransientResources(TConstArrayView<FCollectResourceOp> Ops);
+	void PlanTransientResources(TConstArrayView<FCollectResourceOp> Ops);
 	void AllocatePooledTextures(FRHICommandListBase& RHICmdList, TConstArrayView<FCollectResourceOp> Ops);
 	void AllocatePooledBuffers(FRHICommandListBase& RHICmdList, TConstArrayView<FCollectResourceOp> Ops);
 
@@ -744,6 +756,14 @@ private:
 	void CompilePassBarriers();
 	void CollectPassBarriers();
 	void CollectPassBarriers(FRDGPassHandle PassHandle);
+	void CompileAndCollectPassBarriersParallel();
+	void RecordPassBarrierEndStates(FRDGCompileCacheEntry& Entry);
+	void ReplayPassBarriers(const FRDGCompileCacheEntry& Entry);
+
+	template <typename GetBeginMergeStateLambdaType>
+	void MergeTextureState(FRDGPassHandle PassHandle, ERHIPipeline PassPipeline, FRDGPass::FTextureState& PassState, GetBeginMergeStateLambdaType&& GetBeginMergeState);
+	void SplitUniformMergeState(FRDGTexture* Texture, FRDGPassHandle PassHandle);
+	void SplitUniformPassState(FRDGPass::FTextureState& PassState);
 	void CreatePassBarriers();
 	void FinalizeResources();
 
@@ -755,12 +775,27 @@ private:
 
 	void AddCulledReservedCommitTransition(FRDGBufferRef Buffer);
 
+	template <typename FilterSubresourceLambdaType, typename AddTransitionLambdaType>
+	void AddTextureTransition(
+		FRDGTextureRef Texture,
+		FRDGTextureSubresourceState& StateBefore,
+		FRDGTextureSubresourceState& StateAfter,
+		FilterSubresourceLambdaType&& FilterSubresourceLambda,
+		AddTransitionLambdaType&& AddTransitionLambda);
+
 	template <typename FilterSubresourceLambdaType>
 	void AddTextureTransition(
 		FRDGTextureRef Texture,
 		FRDGTextureSubresourceState& StateBefore,
 		FRDGTextureSubresourceState& StateAfter,
-		FilterSubresourceLambdaType&& FilterSubresourceLambda);
+		FilterSubresourceLambdaType&& FilterSubresourceLambda)
+	{
+		AddTextureTransition(Texture, StateBefore, StateAfter, Forward<FilterSubresourceLambdaType>(FilterSubresourceLambda),
+			[this](FRDGViewableResource* Resource, const FRDGSubresourceState& SubresourceStateBefore, const FRDGSubresourceState& SubresourceStateAfter, const FRDGTransitionInfo& Info)
+		{
+			AddTransition(Resource, SubresourceStateBefore, SubresourceStateAfter, Info);
+		});
+	}
 
 	void AddTextureTransition(
 		FRDGTextureRef Texture,
@@ -770,12 +805,27 @@ private:
 		AddTextureTransition(Texture, StateBefore, StateAfter, [](FRDGSubresourceState*, int32) { return true; });
 	}
 
+	template <typename FilterSubresourceLambdaType, typename AddTransitionLambdaType>
+	void AddBufferTransition(
+		FRDGBufferRef Buffer,
+		FRDGSubresourceState*& StateBefore,
+		FRDGSubresourceState* StateAfter,
+		FilterSubresourceLambdaType&& FilterSubresourceLambda,
+		AddTransitionLambdaType&& AddTransitionLambda);
+
 	template <typename FilterSubresourceLambdaType>
 	void AddBufferTransition(
 		FRDGBufferRef Buffer,
 		FRDGSubresourceState*& StateBefore,
 		FRDGSubresourceState* StateAfter,
-		FilterSubresourceLambdaType&& FilterSubresourceLambda);
+		FilterSubresourceLambdaType&& FilterSubresourceLambda)
+	{
+		AddBufferTransition(Buffer, StateBefore, StateAfter, Forward<FilterSubresourceLambdaType>(FilterSubresourceLambda),
+			[this](FRDGViewableResource* Resource, const FRDGSubresourceState& SubresourceStateBefore, const FRDGSubresourceState& SubresourceStateAfter, const FRDGTransitionInfo& Info)
+		{
+			AddTransition(Resource, SubresourceStateBefore, SubresourceStateAfter, Info);
+		});
+	}
 
 	void AddBufferTransition(
 		FRDGBufferRef Buffer,
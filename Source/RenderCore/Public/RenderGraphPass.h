@@ -64,6 +64,11 @@ struct FRDGTransitionInfo
 	uint64 ResourceType            : 3;  // 61
 	uint64 ResourceTransitionFlags : 3;  // 64
 
+	/** Texture subresource values used when a single transition covers every subresource of the texture. */
+	static constexpr uint16 AllArraySlices = MAX_uint16;
+	static constexpr uint8  AllMips        = MAX_uint8;
+	static constexpr uint8  AllPlaneSlices = MAX_uint8;
+
 	union
 	{
 		struct
@@ -472,6 +477,9 @@ protected:
 	/** Number of transitions to reserve. Basically an estimate of the number of textures / buffers. */
 	uint32 NumTransitionsToReserve = 0;
 
+	/** Hash of the resource accesses recorded during setup. Only computed when the compile cache is enabled. */
+	uint64 SetupHash = 0;
+
 	/** Lists of producer passes and the full list of cross-pipeline consumer passes. */
 	TArray<FRDGPassHandle, FRDGArrayAllocator> CrossPipelineConsumers;
 	TArray<FRDGPass*, FRDGArrayAllocator> Producers;
@@ -492,6 +500,9 @@ protected:
 		FRDGTextureSubresourceState State;
 		FRDGTextureSubresourceState MergeState;
 		uint32 ReferenceCount = 0;
+
+		/** Every access in the pass covered the whole texture, so all subresources reference a single shared state. */
+		bool bUniform = false;
 	};
 
 	struct FBufferState
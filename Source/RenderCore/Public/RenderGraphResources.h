@@ -648,6 +648,12 @@ private:
 	/** Tracks merged subresource states as the graph is built. */
 	FRDGTextureSubresourceState MergeState;
 
+	/** First pass of the current merge run in which all subresources share one merge state. Valid while bUniformMergeState is set. */
+	FRDGPassHandle UniformMergePass;
+
+	/** Whether all subresources reference the same merge state (or none yet). Cleared when a subresource-granular access splits it. */
+	bool bUniformMergeState = true;
+
 	/** Tracks pass producers for each subresource as the graph is built. */
 	TRDGTextureSubresourceArray<FRDGProducerStatesByPipeline, FRDGArrayAllocator> LastProducers;
 
@@ -12,20 +12,39 @@ class FRDGBuilder;
 class FRDGPass;
 class FRDGTexture;
 class FRDGViewableResource;
+class FRHICommandListImmediate;
+struct FRDGGraphCapture;
 namespace UE { namespace Trace { class FChannel; } }
 
 #if RDG_ENABLE_TRACE
 
 UE_TRACE_CHANNEL_EXTERN(RDGChannel, RENDERCORE_API);
 
+/** Time spent in the phases of FRDGBuilder::Execute. Compile covers everything from graph compilation up to the first pass executing. */
+struct FRDGPhaseTimings
+{
+	uint64 CompileCycles = 0;
+	uint64 ExecuteCycles = 0;
+};
+
 class FRDGTrace
 {
 public:
 	RENDERCORE_API FRDGTrace();
 
+	RENDERCORE_API void OutputGraphCompileBegin();
 	RENDERCORE_API void OutputGraphBegin();
 	RENDERCORE_API void OutputGraphEnd(const FRDGBuilder& GraphBuilder);
 
+	/** Returns whether r.RDG.CaptureGraph has requested a capture that has not been taken yet. */
+	static bool IsGraphCaptureRequested();
+
+	/** Writes the graph to the requested capture file if the builder name matches the capture filter. Called just before compilation. */
+	void CaptureGraph(const FRDGBuilder& GraphBuilder);
+
+	/** Rebuilds a captured graph into a new builder with empty pass lambdas and executes it. */
+	static void ReplayGraph(FRHICommandListImmediate& RHICmdList, const FRDGGraphCapture& Capture, FRDGPhaseTimings& OutTimings);
+
 	RENDERCORE_API void AddResource(FRDGViewableResource* Resource);
 	RENDERCORE_API void AddTexturePassDependency(FRDGTexture* Texture, FRDGPass* Pass);
 	RENDERCORE_API void AddBufferPassDependency(FRDGBuffer* Buffer, FRDGPass* Pass);
@@ -34,7 +53,11 @@ public:
 
 	RENDERCORE_API bool IsEnabled() const;
 
+	/** When set, the owning builder writes its phase timings here once it has executed. */
+	FRDGPhaseTimings* PhaseTimings = nullptr;
+
 private:
+	uint64 CompileStartCycles{};
 	uint64 GraphStartCycles{};
 	uint32 ResourceOrder{};
 	bool bEnabled;
@@ -778,6 +778,15 @@ public:
 		LAYOUT_FIELD(uint16, ByteOffset);
 	};
 
+	/** Contiguous range of a binding program's resource array that shares the same resource kind. */
+	struct FResourceParameterGroup
+	{
+		DECLARE_INLINE_TYPE_LAYOUT(FResourceParameterGroup, NonVirtual);
+		LAYOUT_FIELD(uint16, First);
+		LAYOUT_FIELD(uint16, Num);
+		LAYOUT_FIELD(EUniformBufferBaseType, BaseType);
+	};
+
 	DECLARE_EXPORTED_TYPE_LAYOUT(FShaderParameterBindings, RENDERCORE_API, NonVirtual);
 public:
 	static constexpr uint16 kInvalidBufferIndex = 0xFFFF;
@@ -785,12 +794,28 @@ public:
 	RENDERCORE_API void BindForLegacyShaderParameters(const FShader* Shader, int32 PermutationId, const FShaderParameterMap& ParameterMaps, const FShaderParametersMetadata& StructMetaData, bool bShouldBindEverything = false);
 	RENDERCORE_API void BindForRootShaderParameters(const FShader* Shader, int32 PermutationId, const FShaderParameterMap& ParameterMaps);
 
+	/**
+	 * Compiles the bindings into the compact binding program executed by SetShaderParameters(): contiguous loose parameters
+	 * are coalesced into single copies, and resources are grouped by kind so that each group is bound by a tight loop.
+	 * Called at the end of the Bind*() functions, so the program is frozen along with the rest of the bindings.
+	 */
+	RENDERCORE_API void CompileBindingProgram();
+
+	// Loose parameters, sorted by buffer and base index and coalesced where both source and destination are contiguous.
 	LAYOUT_FIELD(TMemoryImageArray<FParameter>, Parameters);
+
+	// Resources sorted by byte offset, as expected by ClearUnusedGraphResources().
 	LAYOUT_FIELD(TMemoryImageArray<FResourceParameter>, ResourceParameters);
 	LAYOUT_FIELD(TMemoryImageArray<FBindlessResourceParameter>, BindlessResourceParameters);
 	LAYOUT_FIELD(TMemoryImageArray<FParameterStructReference>, GraphUniformBuffers);
 	LAYOUT_FIELD(TMemoryImageArray<FParameterStructReference>, ParameterReferences);
 
+	// Binding program: the same resources as above, reordered by kind and split into groups.
+	LAYOUT_FIELD(TMemoryImageArray<FResourceParameter>, ResourceParametersByKind);
+	LAYOUT_FIELD(TMemoryImageArray<FResourceParameterGroup>, ResourceParameterGroups);
+	LAYOUT_FIELD(TMemoryImageArray<FBindlessResourceParameter>, BindlessResourceParametersByKind);
+	LAYOUT_FIELD(TMemoryImageArray<FResourceParameterGroup>, BindlessResourceParameterGroups);
+
 	// Hash of the shader parameter structure when doing the binding.
 	LAYOUT_FIELD_INITIALIZED(uint32, StructureLayoutHash, 0);
 
@@ -2397,6 +2422,9 @@ public:
 
 #if !UE_BUILD_SHIPPING
 	RENDERCORE_API void DumpShaderList(const FShaderMapBase& InShaderMap, FShaderListReport& Out) const;
+
+	/** Times NumIterations lookups of every shader in the map through the hash chain and through the finalized lookup index. */
+	RENDERCORE_API void BenchmarkShaderLookup(int32 NumIterations, double& OutHashChainSeconds, double& OutLookupIndexSeconds) const;
 #endif // !UE_BUILD_SHIPPING
 
 	/** Builds a list of the shaders in a shader map. */
@@ -2461,9 +2489,27 @@ public:
 protected:
 	RENDERCORE_API void EmptyShaderPipelines();
 
+	/** Number of tag bytes matched together when probing the lookup index. */
+	static constexpr uint32 ShaderIndexGroupSize = 16u;
+
+	/** Tag value marking an unused slot of the lookup index; occupied slots hold the top 7 bits of the key. */
+	static constexpr uint8 ShaderIndexEmptyTag = 0x80u;
+
+	RENDERCORE_API int32 FindShaderIndexFromHashChain(const FHashedName& TypeName, int32 PermutationId) const;
+	RENDERCORE_API int32 FindShaderIndexFromLookupIndex(const FHashedName& TypeName, int32 PermutationId) const;
+	RENDERCORE_API void BuildShaderLookupIndex();
+	RENDERCORE_API void ResetShaderLookupIndex();
+
 	using FMemoryImageHashTable = THashTable<FMemoryImageAllocator>;
 
 	LAYOUT_FIELD(FMemoryImageHashTable, ShaderHash);
+	/**
+	 * Open-addressing index over Shaders, built by Finalize() and discarded on any mutation.
+	 * Slots are probed a group of ShaderIndexGroupSize tags at a time; the full 64-bit key is checked before the type/permutation compare.
+	 */
+	LAYOUT_FIELD(TMemoryImageArray<uint8>, ShaderIndexTags);
+	LAYOUT_FIELD(TMemoryImageArray<uint64>, ShaderIndexKeys);
+	LAYOUT_FIELD(TMemoryImageArray<int32>, ShaderIndexSlots);
 	LAYOUT_FIELD(TMemoryImageArray<FHashedName>, ShaderTypes);
 	LAYOUT_FIELD(TMemoryImageArray<int32>, ShaderPermutations);
 	LAYOUT_FIELD(TMemoryImageArray<TMemoryImagePtr<FShader>>, Shaders);
@@ -13,6 +13,7 @@
 #include "Containers/Set.h"
 #include "Containers/SparseArray.h"
 #include "Containers/StringFwd.h"
+#include "Containers/StringView.h"
 #include "Containers/UnrealString.h"
 #include "Delegates/Delegate.h"
 #include "HAL/Platform.h"
@@ -91,6 +92,26 @@ struct FShaderCodeLibraryPipeline
 	}
 };
 
+/**
+ * Interns the names of parsed stable shader keys. Stable key files repeat a small set of names millions of times, so each distinct
+ * string is only looked up in the global name table once per cache. The keys are views into the parsed text, which must outlive
+ * the cache. Not thread safe; use one cache per parsing thread.
+ */
+class FStableShaderKeyNameCache
+{
+public:
+	RENDERCORE_API FName FindOrAdd(const FStringView& Src);
+
+private:
+	struct FKeyFuncs : TDefaultMapHashableKeyFuncs<FStringView, FName, false>
+	{
+		static bool Matches(const FStringView& A, const FStringView& B);
+		static uint32 GetKeyHash(const FStringView& Key);
+	};
+
+	TMap<FStringView, FName, FDefaultSetAllocator, FKeyFuncs> Names;
+};
+
 struct FCompactFullName
 {
 	TArray<FName, TInlineAllocator<16>> ObjectClassAndPath;
@@ -105,6 +126,7 @@ struct FCompactFullName
 	RENDERCORE_API void AppendString(FStringBuilderBase& Out) const;
 	RENDERCORE_API void AppendString(FAnsiStringBuilderBase& Out) const;
 	RENDERCORE_API void ParseFromString(const FStringView& Src);
+	RENDERCORE_API void ParseFromString(const FStringView& Src, FStableShaderKeyNameCache& NameCache);
 	friend RENDERCORE_API uint32 GetTypeHash(const FCompactFullName& A);
 
 #if WITH_EDITOR
@@ -140,6 +162,8 @@ struct FStableShaderKeyAndValue
 	RENDERCORE_API void ComputeKeyHash();
 	RENDERCORE_API void ParseFromString(const FStringView& Src);
 	RENDERCORE_API void ParseFromStringCached(const FStringView& Src, class TMap<uint32, FName>& NameCache);
+	/** Parses every name, including the object path, through NameCache. Used for bulk loading of stable key files. */
+	RENDERCORE_API void ParseFromString(const FStringView& Src, FStableShaderKeyNameCache& NameCache);
 	RENDERCORE_API FString ToString() const;
 	RENDERCORE_API void ToString(FString& OutResult) const;
 	RENDERCORE_API void AppendString(FAnsiStringBuilderBase& Out) const;
@@ -220,6 +244,21 @@ struct FShaderCodeLibrary
 
 	static RENDERCORE_API bool AreShaderMapsPreloadedAtLoadTime();
 
+	/**
+	 * Writes the shaders recorded so far (see r.ShaderCodeLibrary.ShaderUsage.Record) to a named usage profile, e.g. one per level.
+	 * Profiles are written to Saved/ShaderUsage.
+	 */
+	static RENDERCORE_API bool SaveShaderUsageProfile(const FString& ProfileName);
+
+	/**
+	 * Loads a named usage profile from Saved/ShaderUsage, falling back to Content/ShaderUsage. Shader maps loaded afterwards
+	 * create the shaders recorded for them on a background task (see r.ShaderCodeLibrary.ShaderUsage.Prefetch).
+	 */
+	static RENDERCORE_API bool LoadShaderUsageProfile(const FString& ProfileName);
+
+	/** Discards the recorded or loaded shader usage profile. */
+	static RENDERCORE_API void ResetShaderUsageProfile();
+
 	/**
 	 * Makes a number of ChunkIDs known to the library.
 	 * 
@@ -251,6 +290,9 @@ struct FShaderCodeLibrary
 	static RENDERCORE_API bool ContainsShaderCode(const FSHAHash& Hash);
     static RENDERCORE_API bool ContainsShaderCode(const FSHAHash& Hash, const FString& LogicalLibraryName);
 
+	/** Returns the uncompressed code size of a shader in the open libraries, or 0 if it isn't in any of them. */
+	static RENDERCORE_API uint32 GetShaderSizeBytes(const FSHAHash& Hash);
+
 	static RENDERCORE_API TRefCountPtr<FShaderMapResource> LoadResource(const FSHAHash& Hash, FArchive* Ar);
 
 	static RENDERCORE_API bool PreloadShader(const FSHAHash& Hash, FArchive* Ar);
@@ -49,6 +49,7 @@ struct FRasterizerStateInitializerRHI;
  *		+ Default: Loaded in the order specified in the file.
  *		+ FirstToLatestUsed: Start with the PSOs with the lowest first-frame used and work toward those with the highest.
  *		+ MostToLeastUsed: Start with the most often used PSOs working toward the least.
+ *		+ CostModel: Start with the PSOs most likely to hitch early in gameplay, based on the creation times, hitches and first use recorded in the cache, and finish with cheap or rarely used ones.
  *   Will use "Default" within FShaderPipelineCache::Initialize & OpenPipelineFileCache if nothing is specified.
  * - The GameVersionKey is a read-only integer specified in the GGameIni that specifies the game content version to disambiguate incompatible versions of the game content. By default this is taken from the FEngineVersion changlist.
  *
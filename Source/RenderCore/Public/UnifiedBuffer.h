@@ -69,6 +69,20 @@ RENDERCORE_API bool ResizeResourceIfNeeded(FRDGBuilder& GraphBuilder, FRWBuffer&
 class FScatterUploadBuffer
 {
 public:
+	/** Controls how scatters are encoded when the buffer is uploaded. */
+	enum class EMode : uint8
+	{
+		/** Every added element is uploaded and scattered, one scatter index per element. */
+		Default,
+
+		/**
+		 * Elements are staged in CPU memory. On upload, duplicate scatter indices are removed (the last write wins) and the
+		 * remaining elements are uploaded in destination order, still with one scatter index per element.
+		 * Set_GetRef / GetRef are still supported; elements not written before upload contain undefined data as usual.
+		 */
+		Coalesce
+	};
+
 	FByteAddressBuffer ScatterBuffer;
 	FByteAddressBuffer UploadBuffer;
 
@@ -83,6 +97,7 @@ public:
 
 	bool	bFloat4Buffer = false;
 	bool    bUploadViaCreate = false;
+	EMode	Mode = EMode::Default;
 
 	~FScatterUploadBuffer()
 	{
@@ -135,7 +150,7 @@ public:
 		ScatterBuffer.Release();
 		UploadBuffer.Release();
 
-		if (bUploadViaCreate)
+		if (UsesCPUStaging())
 		{
 			if (ScatterData)
 			{
@@ -187,6 +202,30 @@ public:
 			bUploadViaCreate = bInUploadViaCreate;
 		}
 	}
+
+	void SetMode(EMode InMode)
+	{
+		if (InMode != Mode)
+		{
+			// The mode decides who owns the staging memory, so free everything before switching.
+			Release();
+
+			Mode = InMode;
+		}
+	}
+
+private:
+	/** Whether ScatterData / UploadData point at CPU memory rather than at locked buffers. */
+	bool UsesCPUStaging() const
+	{
+		return bUploadViaCreate || Mode == EMode::Coalesce;
+	}
+
+	/**
+	 * Writes the deduplicated scatter and upload data into the destination memory, which must hold at least NumScatters elements.
+	 * Returns the number of unique elements written.
+	 */
+	RENDERCORE_API uint32 CoalesceScatters(uint32* DstScatterData, uint8* DstUploadData) const;
 };
 
 extern RENDERCORE_API void MemsetResource(FRDGBuilder& GraphBuilder, FRDGBuffer* DstResource, const FMemsetResourceParams& Params);
@@ -320,6 +359,39 @@ public:
 	RENDERCORE_API void Lock(FRHICommandListBase& RHICmdList);
 	RENDERCORE_API void Unlock(FRHICommandListBase& RHICmdList);
 
+	/**
+	 * Thread-safe slot reservation for multiple producers filling the uploader concurrently. Reserves Num consecutive slots and
+	 * returns the first one; the producer then fills them with Set_GetRef. All producers must have finished before Unlock, which
+	 * publishes the final scatter count. Don't mix with Add or with pre-sized uploaders. Writes to the same destination from
+	 * different producers land in an unspecified order.
+	 */
+	uint32 ReserveConcurrent(uint32 Num)
+	{
+		checkSlow(!bNumScattersPreSized && NumScatters == 0);
+		const uint32 FirstSlot = NumConcurrentScatters.fetch_add(Num, std::memory_order_relaxed);
+		checkSlow(FirstSlot + Num <= MaxScatters);
+		return FirstSlot;
+	}
+
+	/** Thread-safe version of Add_GetRef. See ReserveConcurrent. */
+	void* AddConcurrent_GetRef(uint32 Index, uint32 Num = 1)
+	{
+		return Set_GetRef(ReserveConcurrent(Num), Index, Num);
+	}
+
+	template <typename T>
+	TArrayView<T> AddConcurrent_GetRef(uint32 Index, uint32 Num = 1)
+	{
+		return MakeArrayView(reinterpret_cast<T*>(AddConcurrent_GetRef(Index, Num)), Num);
+	}
+
+	/** Thread-safe version of Add. See ReserveConcurrent. */
+	void AddConcurrent(uint32 Index, const void* Data, uint32 Num = 1)
+	{
+		void* Dst = AddConcurrent_GetRef(Index, Num);
+		FMemory::ParallelMemcpy(Dst, Data, Num * NumBytesPerElement, EMemcpyCachePolicy::StoreUncached);
+	}
+
 	FRDGViewableResource* GetDstResource() const
 	{
 		return DstResource;
@@ -339,6 +411,9 @@ private:
 	uint32 UploadBytes = 0;
 	bool bNumScattersPreSized = false;
 
+	/** Slots reserved by concurrent producers, folded into NumScatters on Unlock. */
+	std::atomic<uint32> NumConcurrentScatters{ 0 };
+
 	enum class EState : uint8
 	{
 		Empty,